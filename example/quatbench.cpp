@@ -0,0 +1,155 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+// ------------------------------------------------------------------
+// Compares the batch quaternion operations (QuatBatchd and QuatBatchf)
+// against the per-object Quatd operations on arrays of orientations and
+// points. Usage: Ravelin-quat-bench [number of quaternions]
+// ------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <Ravelin/QuatBatchd.h>
+#include <Ravelin/QuatBatchf.h>
+
+using namespace Ravelin;
+
+// number of times each operation is repeated
+const unsigned REPS = 10;
+
+static double rand_unit()
+{
+  return (double) rand() / RAND_MAX * 2.0 - 1.0;
+}
+
+// gets the time (in seconds) per repetition since t0
+static double elapsed(std::clock_t t0)
+{
+  return (double) (std::clock() - t0) / CLOCKS_PER_SEC / REPS;
+}
+
+static void report(const char* op, double scalar, double batch_d, double batch_f)
+{
+  std::printf("%-12s %10.4f %10.4f %10.4f %8.1fx %8.1fx\n", op, scalar, batch_d, batch_f, scalar/batch_d, scalar/batch_f);
+}
+
+int main(int argc, char* argv[])
+{
+  const unsigned N = (argc > 1) ? (unsigned) std::atoi(argv[1]) : 1000000;
+
+  // setup random orientations and points
+  std::vector<Quatd> a(N), b(N), r(N);
+  std::vector<Origin3d> p(N), pr(N);
+  for (unsigned i=0; i< N; i++)
+  {
+    a[i] = Quatd(rand_unit(), rand_unit(), rand_unit(), rand_unit());
+    b[i] = Quatd(rand_unit(), rand_unit(), rand_unit(), rand_unit());
+    a[i].normalize();
+    b[i].normalize();
+    p[i] = Origin3d(rand_unit(), rand_unit(), rand_unit());
+  }
+
+  // setup the batches
+  MatrixNd A, B, R(N, 4), P(N, 3), PR(N, 3);
+  QuatBatchd::pack(a, A);
+  QuatBatchd::pack(b, B);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 3; j++)
+      P(i,j) = p[i][j];
+  MatrixNf Af(N, 4), Bf(N, 4), Rf(N, 4), Pf(N, 3), PRf(N, 3);
+  for (unsigned i=0; i< N; i++)
+  {
+    for (unsigned j=0; j< 4; j++)
+    {
+      Af(i,j) = (float) A(i,j);
+      Bf(i,j) = (float) B(i,j);
+    }
+    for (unsigned j=0; j< 3; j++)
+      Pf(i,j) = (float) P(i,j);
+  }
+
+  std::printf("%u quaternions; seconds per pass (scalar Quatd, QuatBatchd, QuatBatchf) and speedups\n", N);
+  double ts, td, tf;
+  std::clock_t t0;
+
+  // composition
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    for (unsigned i=0; i< N; i++)
+      r[i] = a[i]*b[i];
+  ts = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchd::mult(N, A.data(), N, B.data(), N, R.data(), N);
+  td = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchf::mult(N, Af.data(), N, Bf.data(), N, Rf.data(), N);
+  tf = elapsed(t0);
+  report("mult", ts, td, tf);
+
+  // rotation of points
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    for (unsigned i=0; i< N; i++)
+      pr[i] = a[i]*p[i];
+  ts = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchd::rotate(N, A.data(), N, P.data(), N, PR.data(), N);
+  td = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchf::rotate(N, Af.data(), N, Pf.data(), N, PRf.data(), N);
+  tf = elapsed(t0);
+  report("rotate", ts, td, tf);
+
+  // normalization (of the products computed above)
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    for (unsigned i=0; i< N; i++)
+      r[i].normalize();
+  ts = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchd::normalize(N, R.data(), N);
+  td = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchf::normalize(N, Rf.data(), N);
+  tf = elapsed(t0);
+  report("normalize", ts, td, tf);
+
+  // interpolation: scalar slerp vs. batch nlerp, and scalar vs. batch slerp
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    for (unsigned i=0; i< N; i++)
+      r[i] = Quatd::slerp(a[i], b[i], 0.3);
+  ts = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchd::nlerp(N, A.data(), N, B.data(), N, 0.3, R.data(), N);
+  td = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchf::nlerp(N, Af.data(), N, Bf.data(), N, 0.3f, Rf.data(), N);
+  tf = elapsed(t0);
+  report("nlerp", ts, td, tf);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchd::slerp(N, A.data(), N, B.data(), N, 0.3, R.data(), N);
+  td = elapsed(t0);
+  t0 = std::clock();
+  for (unsigned k=0; k< REPS; k++)
+    QuatBatchf::slerp(N, Af.data(), N, Bf.data(), N, 0.3f, Rf.data(), N);
+  tf = elapsed(t0);
+  report("slerp", ts, td, tf);
+
+  return 0;
+}
+
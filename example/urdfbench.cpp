@@ -0,0 +1,218 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+// ------------------------------------------------------------------
+// Compares the DOM-based URDF reader (URDFReaderd::read()) against the
+// streaming reader (URDFReaderd::read_streaming()) on a URDF file and on
+// a synthetic model with many links, compares constructing the synthetic 
+// articulated body from URDF against loading it from a compiled model file
+// (RCArticulatedBodyd::load_compiled()) and cloning it, and then reads many copies of the
+// file one at a time and with URDFReaderd::read_many(). Usage:
+//   Ravelin-urdf-bench [URDF file] [number of synthetic links] [number of copies]
+// ------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/time.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <Ravelin/URDFReaderd.h>
+#include <Ravelin/RigidBodyd.h>
+#include <Ravelin/Jointd.h>
+#include <Ravelin/RCArticulatedBodyd.h>
+
+using std::vector;
+using std::string;
+using boost::shared_ptr;
+using namespace Ravelin;
+
+// number of times each file is read
+const unsigned REPS = 10;
+
+// gets the time (in seconds) per repetition since t0
+static double elapsed(std::clock_t t0)
+{
+  return (double) (std::clock() - t0) / CLOCKS_PER_SEC / REPS;
+}
+
+// gets the wall clock time (in seconds)
+static double wall_time()
+{
+  timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + t.tv_usec * 1e-6;
+}
+
+// creates a synthetic model: a tree of links with revolute joints, in which
+// every fourth link starts a new branch from the base
+static string synthetic_urdf(unsigned n)
+{
+  std::ostringstream out;
+  out << "<robot name=\"synthetic\">" << std::endl;
+  for (unsigned i=0; i< n; i++)
+  {
+    out << "  <link name=\"link" << i << "\">" << std::endl;
+    out << "    <inertial>" << std::endl;
+    out << "      <origin xyz=\"0 0 0.05\" rpy=\"0 0 0\"/>" << std::endl;
+    out << "      <mass value=\"" << 1.0 + 0.001*i << "\"/>" << std::endl;
+    out << "      <inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>" << std::endl;
+    out << "    </inertial>" << std::endl;
+    out << "  </link>" << std::endl;
+  }
+  for (unsigned i=1; i< n; i++)
+  {
+    unsigned parent = (i % 4 == 0) ? 0 : i-1;
+    out << "  <joint name=\"joint" << i << "\" type=\"revolute\">" << std::endl;
+    out << "    <parent link=\"link" << parent << "\"/>" << std::endl;
+    out << "    <child link=\"link" << i << "\"/>" << std::endl;
+    out << "    <origin xyz=\"0 0 0.1\" rpy=\"0 0.1 0\"/>" << std::endl;
+    out << "    <axis xyz=\"" << (i % 3 == 0) << " " << (i % 3 == 1) << " " << (i % 3 == 2) << "\"/>" << std::endl;
+    out << "  </joint>" << std::endl;
+  }
+  out << "</robot>" << std::endl;
+  return out.str();
+}
+
+// gets the largest difference between the link poses read by the two readers
+static double max_pose_difference(const vector<shared_ptr<RigidBodyd> >& links1, const vector<shared_ptr<RigidBodyd> >& links2)
+{
+  double diff = 0.0;
+  for (unsigned i=0; i< links1.size() && i< links2.size(); i++)
+  {
+    Pose3d P1 = *links1[i]->get_pose(), P2 = *links2[i]->get_pose();
+    P1.update_relative_pose(shared_ptr<const Pose3d>());
+    P2.update_relative_pose(shared_ptr<const Pose3d>());
+    diff = std::max(diff, (P1.x - P2.x).norm());
+    diff = std::max(diff, Quatd::calc_angle(P1.q, P2.q));
+  }
+  return diff;
+}
+
+// reads the content with both readers and reports the times
+static void compare(const char* label, const string& content)
+{
+  vector<shared_ptr<RigidBodyd> > links1, links2;
+  vector<shared_ptr<Jointd> > joints1, joints2;
+  string name;
+
+  // time the DOM-based reader
+  std::clock_t t0 = std::clock();
+  for (unsigned i=0; i< REPS; i++)
+  {
+    links1.clear();
+    joints1.clear();
+    URDFReaderd::read_from_string(content, name, links1, joints1);
+  }
+  double dom = elapsed(t0);
+
+  // time the streaming reader
+  t0 = std::clock();
+  for (unsigned i=0; i< REPS; i++)
+  {
+    links2.clear();
+    joints2.clear();
+    URDFReaderd::read_streaming_from_string(content, name, links2, joints2);
+  }
+  double streaming = elapsed(t0);
+
+  std::printf("%-24s %6u %6u %10.4f %10.4f %8.1fx %10.2g\n", label, (unsigned) links2.size(), (unsigned) joints2.size(), dom, streaming, dom/streaming, max_pose_difference(links1, links2));
+  if (links1.size() != links2.size() || joints1.size() != joints2.size())
+    std::printf("  ** readers disagree: %u links, %u joints (DOM)\n", (unsigned) links1.size(), (unsigned) joints1.size());
+}
+
+// constructs an articulated body from URDF, from a compiled model file and 
+// by cloning
+static void compare_compiled(const char* label, const string& content)
+{
+  const char* COMPILED_FNAME = "urdfbench.rcab";
+  shared_ptr<RCArticulatedBodyd> body;
+  string name;
+
+  // time reading the URDF and compiling the body
+  std::clock_t t0 = std::clock();
+  for (unsigned i=0; i< REPS; i++)
+  {
+    vector<shared_ptr<RigidBodyd> > links;
+    vector<shared_ptr<Jointd> > joints;
+    URDFReaderd::read_streaming_from_string(content, name, links, joints);
+    body = shared_ptr<RCArticulatedBodyd>(new RCArticulatedBodyd);
+    body->set_links_and_joints(links, joints);
+  }
+  double urdf = elapsed(t0);
+
+  // time loading the compiled body
+  body->save_compiled(COMPILED_FNAME);
+  t0 = std::clock();
+  for (unsigned i=0; i< REPS; i++)
+    body = RCArticulatedBodyd::load_compiled(COMPILED_FNAME);
+  double compiled = elapsed(t0);
+  std::remove(COMPILED_FNAME);
+
+  // time cloning the body
+  const unsigned NCLONES = 100;
+  t0 = std::clock();
+  for (unsigned i=0; i< NCLONES; i++)
+    body->clone();
+  double clone = (double) (std::clock() - t0) / CLOCKS_PER_SEC / NCLONES;
+
+  std::printf("\n%s: URDF + compile() %.4f s, load_compiled() %.4f s (%.1fx), clone() %.1f us\n", label, urdf, compiled, urdf/compiled, clone*1e6);
+}
+
+// reads n copies of a file one at a time and then concurrently
+static void compare_many(const char* fname, unsigned n)
+{
+  vector<string> fnames(n, fname), names;
+  vector<vector<shared_ptr<RigidBodyd> > > links;
+  vector<vector<shared_ptr<Jointd> > > joints;
+  string name;
+
+  // read the files one at a time
+  double t0 = wall_time();
+  for (unsigned i=0; i< n; i++)
+  {
+    vector<shared_ptr<RigidBodyd> > links1;
+    vector<shared_ptr<Jointd> > joints1;
+    URDFReaderd::read(fnames[i], name, links1, joints1);
+  }
+  double serial = wall_time() - t0;
+
+  // read the files concurrently 
+  t0 = wall_time();
+  unsigned nread = URDFReaderd::read_many(fnames, names, links, joints);
+  double concurrent = wall_time() - t0;
+
+  std::printf("\n%u copies of %s (%u read): read() %.4f s, read_many() %.4f s (%.1fx)\n", n, fname, nread, serial, concurrent, serial/concurrent);
+}
+
+int main(int argc, char* argv[])
+{
+  const char* fname = (argc > 1) ? argv[1] : "../test/pr2.urdf";
+  const unsigned N = (argc > 2) ? (unsigned) std::atoi(argv[2]) : 5000;
+  const unsigned NCOPIES = (argc > 3) ? (unsigned) std::atoi(argv[3]) : 100;
+
+  // read the file into memory, so that only parsing is timed
+  std::ifstream in(fname);
+  if (!in)
+  {
+    std::fprintf(stderr, "unable to open %s\n", fname);
+    return -1;
+  }
+  std::ostringstream content;
+  content << in.rdbuf();
+
+  std::printf("%-24s %6s %6s %10s %10s %9s %10s\n", "model", "links", "joints", "DOM (s)", "stream (s)", "speedup", "pose diff");
+  compare(fname, content.str());
+  std::ostringstream label;
+  label << "synthetic (" << N << ")";
+  compare(label.str().c_str(), synthetic_urdf(N));
+  compare_compiled(label.str().c_str(), synthetic_urdf(N));
+  compare_many(fname, NCOPIES);
+
+  return 0;
+}
+
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef BLOCKSPARSEMATRIXN
+#error This class is not to be included by the user directly. Use BlockSparseMatrixNd.h or BlockSparseMatrixNf.h instead.
+#endif
+
+/// A block compressed sparse row (BSR) matrix with B x B blocks
+/**
+ * Nonzeros are stored as dense B x B blocks (column-major, like MATRIXN),
+ * so that only one column index is stored per block and the block kernels
+ * (which have compile-time sizes) can be unrolled and vectorized by the
+ * compiler. Typical block sizes are 6 (spatial quantities) and 3 (contact
+ * frames). Block column indices within each block row are sorted.
+ */
+template <unsigned B>
+class BLOCKSPARSEMATRIXN
+{
+  public:
+    /// The block size
+    static const unsigned BLOCK_SIZE = B;
+
+    BLOCKSPARSEMATRIXN() { _mb = _nb = 0; _ptr.resize(1, 0); }
+    BLOCKSPARSEMATRIXN(unsigned mb, unsigned nb) { _mb = mb; _nb = nb; _ptr.resize(mb+1, 0); }
+    explicit BLOCKSPARSEMATRIXN(const SPARSEMATRIXN& s) { from_sparse(s); }
+    BLOCKSPARSEMATRIXN& set_from_blocks(unsigned mb, unsigned nb, const std::vector<unsigned>& brows, const std::vector<unsigned>& bcols, const std::vector<REAL>& values);
+    BLOCKSPARSEMATRIXN& set_pattern(unsigned mb, unsigned nb, const std::vector<unsigned>& brows, const std::vector<unsigned>& bcols);
+    BLOCKSPARSEMATRIXN& from_sparse(const SPARSEMATRIXN& s);
+    SPARSEMATRIXN& to_sparse(SPARSEMATRIXN& s) const;
+    MATRIXN& to_dense(MATRIXN& m) const;
+    VECTORN& mult(const VECTORN& x, VECTORN& result) const;
+    VECTORN& transpose_mult(const VECTORN& x, VECTORN& result) const;
+    MATRIXN& mult(const MATRIXN& X, MATRIXN& result) const;
+    MATRIXN& transpose_mult(const MATRIXN& X, MATRIXN& result) const;
+    BLOCKSPARSEMATRIXN& block_jacobi_inverse(BLOCKSPARSEMATRIXN& result) const;
+    REAL* find_block(unsigned i, unsigned j);
+    const REAL* find_block(unsigned i, unsigned j) const;
+    void set_block(unsigned k, const MATRIXN& m);
+    void set_block(unsigned k, const std::vector<SVELOCITY>& v);
+    void set_block(unsigned k, const std::vector<SFORCE>& w);
+    void set_block_transpose(unsigned k, const std::vector<SVELOCITY>& v);
+    void set_block_transpose(unsigned k, const std::vector<SFORCE>& w);
+    BLOCKSPARSEMATRIXN& set_zero() { std::fill(_data.begin(), _data.end(), (REAL) 0.0); return *this; }
+    BLOCKSPARSEMATRIXN& operator*=(REAL scalar);
+
+    /// Gets the number of (scalar) rows
+    unsigned rows() const { return _mb*B; }
+
+    /// Gets the number of (scalar) columns
+    unsigned columns() const { return _nb*B; }
+
+    /// Gets the number of block rows
+    unsigned block_rows() const { return _mb; }
+
+    /// Gets the number of block columns
+    unsigned block_columns() const { return _nb; }
+
+    /// Gets the number of nonzero blocks
+    unsigned get_nnzb() const { return _indices.size(); }
+
+    /// Gets the block row pointers (block_rows()+1 entries)
+    const unsigned* get_ptr() const { return &_ptr.front(); }
+
+    /// Gets the block column indices of the nonzero blocks (get_nnzb() entries)
+    const unsigned* get_indices() const { return (_indices.empty()) ? NULL : &_indices.front(); }
+
+    /// Gets the k-th nonzero block (B x B, column-major)
+    REAL* block(unsigned k) { return &_data[k*B*B]; }
+
+    /// Gets the k-th nonzero block (B x B, column-major)
+    const REAL* block(unsigned k) const { return &_data[k*B*B]; }
+
+  private:
+    static bool invert_block(REAL* a);
+
+    unsigned _mb, _nb;                 // numbers of block rows and columns
+    std::vector<unsigned> _ptr;        // starting index of block row i
+    std::vector<unsigned> _indices;    // block column indices
+    std::vector<REAL> _data;           // blocks (B*B values each)
+}; // end class
+
+#include "BlockSparseMatrixN.inl"
+
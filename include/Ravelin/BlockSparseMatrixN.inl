@@ -0,0 +1,518 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+/// Sets up the nonzero pattern from block (row, column) pairs, zeroing all blocks
+/**
+ * Duplicate pairs are merged. Block column indices in each block row are
+ * sorted using a counting sort.
+ * \param mb the number of block rows
+ * \param nb the number of block columns
+ */
+template <unsigned B>
+BLOCKSPARSEMATRIXN<B>& BLOCKSPARSEMATRIXN<B>::set_pattern(unsigned mb, unsigned nb, const std::vector<unsigned>& brows, const std::vector<unsigned>& bcols)
+{
+  const unsigned NB = brows.size();
+
+  #ifndef NEXCEPT
+  if (bcols.size() != NB)
+    throw MissizeException();
+  for (unsigned k=0; k< NB; k++)
+    if (brows[k] >= mb || bcols[k] >= nb)
+      throw InvalidIndexException();
+  #endif
+
+  _mb = mb;
+  _nb = nb;
+
+  // counting sort by block column, then (stably) by block row
+  std::vector<unsigned> cnt(nb+1, 0), perm(NB);
+  for (unsigned k=0; k< NB; k++)
+    cnt[bcols[k]+1]++;
+  for (unsigned j=0; j< nb; j++)
+    cnt[j+1] += cnt[j];
+  for (unsigned k=0; k< NB; k++)
+    perm[cnt[bcols[k]]++] = k;
+  _ptr.assign(mb+1, 0);
+  for (unsigned k=0; k< NB; k++)
+    _ptr[brows[k]+1]++;
+  for (unsigned i=0; i< mb; i++)
+    _ptr[i+1] += _ptr[i];
+  std::vector<unsigned> next(_ptr.begin(), _ptr.end()-1);
+  _indices.resize(NB);
+  for (unsigned t=0; t< NB; t++)
+  {
+    const unsigned k = perm[t];
+    _indices[next[brows[k]]++] = bcols[k];
+  }
+
+  // remove duplicates
+  unsigned nz = 0;
+  for (unsigned i=0, start=0; i< mb; i++)
+  {
+    const unsigned end = _ptr[i+1], row_start = nz;
+    for (unsigned k=start; k< end; k++)
+      if (nz == row_start || _indices[nz-1] != _indices[k])
+        _indices[nz++] = _indices[k];
+    _ptr[i+1] = nz;
+    start = end;
+  }
+  _indices.resize(nz);
+  _data.assign(nz*B*B, (REAL) 0.0);
+
+  return *this;
+}
+
+/// Sets up the matrix from blocks given by (row, column) pairs and values, summing duplicated blocks
+/**
+ * \param values the blocks (B*B column-major values per block, in the
+ *        order of brows/bcols)
+ */
+template <unsigned B>
+BLOCKSPARSEMATRIXN<B>& BLOCKSPARSEMATRIXN<B>::set_from_blocks(unsigned mb, unsigned nb, const std::vector<unsigned>& brows, const std::vector<unsigned>& bcols, const std::vector<REAL>& values)
+{
+  const unsigned BB = B*B;
+
+  #ifndef NEXCEPT
+  if (values.size() != brows.size()*BB)
+    throw MissizeException();
+  #endif
+
+  // setup the pattern and then add in the blocks
+  set_pattern(mb, nb, brows, bcols);
+  for (unsigned k=0; k< brows.size(); k++)
+  {
+    REAL* blk = find_block(brows[k], bcols[k]);
+    const REAL* src = &values[k*BB];
+    for (unsigned l=0; l< BB; l++)
+      blk[l] += src[l];
+  }
+
+  return *this;
+}
+
+/// Finds the block (i,j), returning NULL if it is not in the nonzero pattern
+template <unsigned B>
+REAL* BLOCKSPARSEMATRIXN<B>::find_block(unsigned i, unsigned j)
+{
+  const unsigned* begin = get_indices() + _ptr[i];
+  const unsigned* end = get_indices() + _ptr[i+1];
+  const unsigned* k = std::lower_bound(begin, end, j);
+  return (k == end || *k != j) ? NULL : block(k - get_indices());
+}
+
+/// Finds the block (i,j), returning NULL if it is not in the nonzero pattern
+template <unsigned B>
+const REAL* BLOCKSPARSEMATRIXN<B>::find_block(unsigned i, unsigned j) const
+{
+  const unsigned* begin = get_indices() + _ptr[i];
+  const unsigned* end = get_indices() + _ptr[i+1];
+  const unsigned* k = std::lower_bound(begin, end, j);
+  return (k == end || *k != j) ? NULL : block(k - get_indices());
+}
+
+/// Sets the k-th nonzero block from a B x B matrix
+template <unsigned B>
+void BLOCKSPARSEMATRIXN<B>::set_block(unsigned k, const MATRIXN& m)
+{
+  #ifndef NEXCEPT
+  if (m.rows() != B || m.columns() != B)
+    throw MissizeException();
+  #endif
+
+  REAL* blk = block(k);
+  for (unsigned j=0; j< B; j++)
+    std::copy(m.data()+j*m.leading_dim(), m.data()+j*m.leading_dim()+B, blk+j*B);
+}
+
+/// Sets the columns of the k-th nonzero block from spatial velocities (as in SPARITH::to_matrix()); remaining columns are zeroed
+template <unsigned B>
+void BLOCKSPARSEMATRIXN<B>::set_block(unsigned k, const std::vector<SVELOCITY>& v)
+{
+  const unsigned SPATIAL_DIM = 6;
+
+  #ifndef NEXCEPT
+  if (B != SPATIAL_DIM || v.size() > B)
+    throw MissizeException();
+  #endif
+
+  REAL* blk = block(k);
+  std::fill(blk, blk+B*B, (REAL) 0.0);
+  for (unsigned j=0; j< v.size(); j++)
+    std::copy(v[j].data(), v[j].data()+SPATIAL_DIM, blk+j*B);
+}
+
+/// Sets the columns of the k-th nonzero block from spatial forces (as in SPARITH::to_matrix()); remaining columns are zeroed
+template <unsigned B>
+void BLOCKSPARSEMATRIXN<B>::set_block(unsigned k, const std::vector<SFORCE>& w)
+{
+  const unsigned SPATIAL_DIM = 6;
+
+  #ifndef NEXCEPT
+  if (B != SPATIAL_DIM || w.size() > B)
+    throw MissizeException();
+  #endif
+
+  REAL* blk = block(k);
+  std::fill(blk, blk+B*B, (REAL) 0.0);
+  for (unsigned j=0; j< w.size(); j++)
+    std::copy(w[j].data(), w[j].data()+SPATIAL_DIM, blk+j*B);
+}
+
+/// Sets the rows of the k-th nonzero block from spatial velocities; remaining rows are zeroed
+template <unsigned B>
+void BLOCKSPARSEMATRIXN<B>::set_block_transpose(unsigned k, const std::vector<SVELOCITY>& v)
+{
+  const unsigned SPATIAL_DIM = 6;
+
+  #ifndef NEXCEPT
+  if (B != SPATIAL_DIM || v.size() > B)
+    throw MissizeException();
+  #endif
+
+  REAL* blk = block(k);
+  std::fill(blk, blk+B*B, (REAL) 0.0);
+  for (unsigned i=0; i< v.size(); i++)
+  {
+    const REAL* vdata = v[i].data();
+    for (unsigned j=0; j< SPATIAL_DIM; j++)
+      blk[j*B+i] = vdata[j];
+  }
+}
+
+/// Sets the rows of the k-th nonzero block from spatial forces; remaining rows are zeroed
+template <unsigned B>
+void BLOCKSPARSEMATRIXN<B>::set_block_transpose(unsigned k, const std::vector<SFORCE>& w)
+{
+  const unsigned SPATIAL_DIM = 6;
+
+  #ifndef NEXCEPT
+  if (B != SPATIAL_DIM || w.size() > B)
+    throw MissizeException();
+  #endif
+
+  REAL* blk = block(k);
+  std::fill(blk, blk+B*B, (REAL) 0.0);
+  for (unsigned i=0; i< w.size(); i++)
+  {
+    const REAL* wdata = w[i].data();
+    for (unsigned j=0; j< SPATIAL_DIM; j++)
+      blk[j*B+i] = wdata[j];
+  }
+}
+
+/// Multiplies this matrix by a scalar
+template <unsigned B>
+BLOCKSPARSEMATRIXN<B>& BLOCKSPARSEMATRIXN<B>::operator*=(REAL scalar)
+{
+  for (unsigned k=0; k< _data.size(); k++)
+    _data[k] *= scalar;
+  return *this;
+}
+
+/// Sets this matrix from a sparse matrix
+/**
+ * The numbers of rows and columns of s must be multiples of B; every block
+ * that contains a nonzero of s becomes a nonzero block.
+ */
+template <unsigned B>
+BLOCKSPARSEMATRIXN<B>& BLOCKSPARSEMATRIXN<B>::from_sparse(const SPARSEMATRIXN& s)
+{
+  #ifndef NEXCEPT
+  if (s.rows() % B != 0 || s.columns() % B != 0)
+    throw MissizeException();
+  #endif
+
+  // get the matrix in CSR form
+  SPARSEMATRIXN work;
+  const SPARSEMATRIXN& S = (s.get_storage_type() == SPARSEMATRIXN::eCSR) ? s : s.convert(SPARSEMATRIXN::eCSR, work);
+  const unsigned* ptr = S.get_ptr();
+  const unsigned* indices = S.get_indices();
+  const REAL* data = S.get_data();
+
+  _mb = s.rows() / B;
+  _nb = s.columns() / B;
+  _ptr.assign(_mb+1, 0);
+  _indices.clear();
+
+  // determine the block pattern, one block row at a time
+  std::vector<unsigned> mark(_nb, std::numeric_limits<unsigned>::max());
+  for (unsigned i=0; i< _mb; i++)
+  {
+    const unsigned start = _indices.size();
+    for (unsigned r=i*B; r< (i+1)*B; r++)
+      for (unsigned k=ptr[r]; k< ptr[r+1]; k++)
+      {
+        const unsigned j = indices[k] / B;
+        if (mark[j] != i)
+        {
+          mark[j] = i;
+          _indices.push_back(j);
+        }
+      }
+    std::sort(_indices.begin()+start, _indices.end());
+    _ptr[i+1] = _indices.size();
+  }
+
+  // copy the values
+  _data.assign(_indices.size()*B*B, (REAL) 0.0);
+  for (unsigned i=0; i< _mb; i++)
+    for (unsigned r=0; r< B; r++)
+      for (unsigned k=ptr[i*B+r]; k< ptr[i*B+r+1]; k++)
+      {
+        REAL* blk = find_block(i, indices[k] / B);
+        blk[(indices[k] % B)*B + r] = data[k];
+      }
+
+  return *this;
+}
+
+/// Converts this matrix to a (CSR) sparse matrix, omitting zeros within the blocks
+template <unsigned B>
+SPARSEMATRIXN& BLOCKSPARSEMATRIXN<B>::to_sparse(SPARSEMATRIXN& s) const
+{
+  typename SPARSEMATRIXN::Triplets triplets;
+  triplets.reserve(_data.size());
+  for (unsigned i=0; i< _mb; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      for (unsigned c=0; c< B; c++)
+        for (unsigned r=0; r< B; r++)
+          if (blk[c*B+r] != (REAL) 0.0)
+            triplets.add(i*B+r, _indices[k]*B+c, blk[c*B+r]);
+    }
+
+  s = SPARSEMATRIXN(SPARSEMATRIXN::eCSR, rows(), columns(), triplets);
+  return s;
+}
+
+/// Converts this matrix to a dense matrix
+template <unsigned B>
+MATRIXN& BLOCKSPARSEMATRIXN<B>::to_dense(MATRIXN& m) const
+{
+  m.set_zero(rows(), columns());
+  const unsigned LD = m.leading_dim();
+  for (unsigned i=0; i< _mb; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      REAL* dest = m.data() + _indices[k]*B*LD + i*B;
+      for (unsigned c=0; c< B; c++)
+        std::copy(blk+c*B, blk+(c+1)*B, dest+c*LD);
+    }
+
+  return m;
+}
+
+/// Multiplies this matrix by a vector
+template <unsigned B>
+VECTORN& BLOCKSPARSEMATRIXN<B>::mult(const VECTORN& x, VECTORN& result) const
+{
+  #ifndef NEXCEPT
+  if (x.size() != columns())
+    throw MissizeException();
+  #endif
+
+  result.set_zero(rows());
+  const REAL* xdata = x.data();
+  REAL* y = result.data();
+  for (unsigned i=0; i< _mb; i++, y += B)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      const REAL* xj = xdata + _indices[k]*B;
+      for (unsigned c=0; c< B; c++)
+        for (unsigned r=0; r< B; r++)
+          y[r] += blk[c*B+r]*xj[c];
+    }
+
+  return result;
+}
+
+/// Multiplies the transpose of this matrix by a vector
+template <unsigned B>
+VECTORN& BLOCKSPARSEMATRIXN<B>::transpose_mult(const VECTORN& x, VECTORN& result) const
+{
+  #ifndef NEXCEPT
+  if (x.size() != rows())
+    throw MissizeException();
+  #endif
+
+  result.set_zero(columns());
+  const REAL* xi = x.data();
+  REAL* ydata = result.data();
+  for (unsigned i=0; i< _mb; i++, xi += B)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      REAL* y = ydata + _indices[k]*B;
+      for (unsigned c=0; c< B; c++)
+      {
+        REAL dot = (REAL) 0.0;
+        for (unsigned r=0; r< B; r++)
+          dot += blk[c*B+r]*xi[r];
+        y[c] += dot;
+      }
+    }
+
+  return result;
+}
+
+/// Multiplies this matrix by a dense matrix
+template <unsigned B>
+MATRIXN& BLOCKSPARSEMATRIXN<B>::mult(const MATRIXN& X, MATRIXN& result) const
+{
+  #ifndef NEXCEPT
+  if (X.rows() != columns())
+    throw MissizeException();
+  #endif
+
+  const unsigned NCOLS = X.columns();
+  const unsigned LDX = X.leading_dim();
+  result.set_zero(rows(), NCOLS);
+  const unsigned LDR = result.leading_dim();
+  for (unsigned i=0; i< _mb; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      for (unsigned p=0; p< NCOLS; p++)
+      {
+        const REAL* xj = X.data() + p*LDX + _indices[k]*B;
+        REAL* y = result.data() + p*LDR + i*B;
+        for (unsigned c=0; c< B; c++)
+          for (unsigned r=0; r< B; r++)
+            y[r] += blk[c*B+r]*xj[c];
+      }
+    }
+
+  return result;
+}
+
+/// Multiplies the transpose of this matrix by a dense matrix
+template <unsigned B>
+MATRIXN& BLOCKSPARSEMATRIXN<B>::transpose_mult(const MATRIXN& X, MATRIXN& result) const
+{
+  #ifndef NEXCEPT
+  if (X.rows() != rows())
+    throw MissizeException();
+  #endif
+
+  const unsigned NCOLS = X.columns();
+  const unsigned LDX = X.leading_dim();
+  result.set_zero(columns(), NCOLS);
+  const unsigned LDR = result.leading_dim();
+  for (unsigned i=0; i< _mb; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const REAL* blk = block(k);
+      for (unsigned p=0; p< NCOLS; p++)
+      {
+        const REAL* xi = X.data() + p*LDX + i*B;
+        REAL* y = result.data() + p*LDR + _indices[k]*B;
+        for (unsigned c=0; c< B; c++)
+        {
+          REAL dot = (REAL) 0.0;
+          for (unsigned r=0; r< B; r++)
+            dot += blk[c*B+r]*xi[r];
+          y[c] += dot;
+        }
+      }
+    }
+
+  return result;
+}
+
+/// Inverts a B x B (column-major) block in place using Gauss-Jordan elimination with partial pivoting
+/**
+ * \return <b>false</b> if the block is singular
+ */
+template <unsigned B>
+bool BLOCKSPARSEMATRIXN<B>::invert_block(REAL* a)
+{
+  unsigned piv[B];
+
+  for (unsigned k=0; k< B; k++)
+  {
+    // find the pivot
+    unsigned p = k;
+    for (unsigned i=k+1; i< B; i++)
+      if (std::fabs(a[k*B+i]) > std::fabs(a[k*B+p]))
+        p = i;
+    piv[k] = p;
+    if (a[k*B+p] == (REAL) 0.0)
+      return false;
+
+    // swap rows
+    if (p != k)
+      for (unsigned j=0; j< B; j++)
+        std::swap(a[j*B+k], a[j*B+p]);
+
+    // scale the pivot row
+    const REAL inv = (REAL) 1.0/a[k*B+k];
+    a[k*B+k] = (REAL) 1.0;
+    for (unsigned j=0; j< B; j++)
+      a[j*B+k] *= inv;
+
+    // eliminate the other rows
+    for (unsigned i=0; i< B; i++)
+    {
+      if (i == k)
+        continue;
+      const REAL f = a[k*B+i];
+      a[k*B+i] = (REAL) 0.0;
+      for (unsigned j=0; j< B; j++)
+        a[j*B+i] -= f*a[j*B+k];
+    }
+  }
+
+  // undo the row swaps (as column swaps, in reverse order)
+  for (unsigned k=B; k> 0; k--)
+    if (piv[k-1] != k-1)
+      for (unsigned i=0; i< B; i++)
+        std::swap(a[(k-1)*B+i], a[piv[k-1]*B+i]);
+
+  return true;
+}
+
+/// Computes the block-Jacobi inverse (the block diagonal matrix of the inverses of the diagonal blocks) of this matrix
+/**
+ * \note throws NonsquareMatrixException if the matrix is not block square
+ *       and SingularException if a diagonal block is missing or singular
+ */
+template <unsigned B>
+BLOCKSPARSEMATRIXN<B>& BLOCKSPARSEMATRIXN<B>::block_jacobi_inverse(BLOCKSPARSEMATRIXN<B>& result) const
+{
+  #ifndef NEXCEPT
+  if (_mb != _nb)
+    throw NonsquareMatrixException();
+  #endif
+
+  // get the diagonal blocks (copy first, in case result is this)
+  std::vector<REAL> diag(_mb*B*B);
+  for (unsigned i=0; i< _mb; i++)
+  {
+    const REAL* blk = find_block(i, i);
+    if (!blk)
+      throw SingularException();
+    std::copy(blk, blk+B*B, diag.begin()+i*B*B);
+  }
+
+  // setup the block diagonal pattern and invert the blocks
+  result._mb = result._nb = _mb;
+  result._ptr.resize(_mb+1);
+  result._indices.resize(_mb);
+  for (unsigned i=0; i<= _mb; i++)
+    result._ptr[i] = i;
+  for (unsigned i=0; i< _mb; i++)
+    result._indices[i] = i;
+  result._data.swap(diag);
+  for (unsigned i=0; i< _mb; i++)
+    if (!invert_block(result.block(i)))
+      throw SingularException();
+
+  return result;
+}
+
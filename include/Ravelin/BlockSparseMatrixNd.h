@@ -0,0 +1,33 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _BLOCK_SPARSE_MATRIX_ND_H_
+#define _BLOCK_SPARSE_MATRIX_ND_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/NonsquareMatrixException.h>
+#include <Ravelin/SingularException.h>
+#include <Ravelin/MatrixNd.h>
+#include <Ravelin/VectorNd.h>
+#include <Ravelin/SparseMatrixNd.h>
+#include <Ravelin/SVelocityd.h>
+#include <Ravelin/SForced.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "BlockSparseMatrixN.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
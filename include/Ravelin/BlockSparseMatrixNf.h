@@ -0,0 +1,33 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _BLOCK_SPARSE_MATRIX_NF_H_
+#define _BLOCK_SPARSE_MATRIX_NF_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/NonsquareMatrixException.h>
+#include <Ravelin/SingularException.h>
+#include <Ravelin/MatrixNf.h>
+#include <Ravelin/VectorNf.h>
+#include <Ravelin/SparseMatrixNf.h>
+#include <Ravelin/SVelocityf.h>
+#include <Ravelin/SForcef.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "BlockSparseMatrixN.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -206,13 +206,11 @@ U& transpose_mult(const T& x, U& y, REAL alpha=(REAL) 1.0, REAL beta=(REAL) 0.0)
     y.set_zero();
     return y;
   }
-// TODO: q: why is this commented out?
-//  if (xcols > 1)
-    CBLAS::gemm(CblasColMajor, CblasTrans, CblasNoTrans, columns(), xcols, rows(), alpha, data(), leading_dim(), x.data(), x.leading_dim(), beta, y.data(), y.leading_dim()); 
-/*
+  // gemm() requires contiguous columns, so strided vectors use gemv()
+  if (xcols == 1 && (x.inc() != 1 || y.inc() != 1))
+    CBLAS::gemv(CblasColMajor, CblasTrans, rows(), columns(), alpha, data(), leading_dim(), x.data(), x.inc(), beta, y.data(), y.inc());
   else
-    CBLAS::gemv(CblasTrans, rows(), columns(), alpha, data(), leading_dim(), x.data(), x.inc(), beta, y.data(), y.inc());
-*/
+    CBLAS::gemm(CblasColMajor, CblasTrans, CblasNoTrans, columns(), xcols, rows(), alpha, data(), leading_dim(), x.data(), x.leading_dim(), beta, y.data(), y.leading_dim()); 
   return y;
 }
 
@@ -239,13 +237,11 @@ U& mult(const T& x, U& y, REAL alpha=(REAL) 1.0, REAL beta=(REAL) 0.0) const
     y.set_zero();
     return y;
   }
-// Q: why is this commented out?
-//  if (xcols > 1)
-    CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, rows(), xcols, columns(), alpha, data(), leading_dim(), x.data(), x.leading_dim(), beta, y.data(), y.leading_dim()); 
-/*
+  // gemm() requires contiguous columns, so strided vectors use gemv()
+  if (xcols == 1 && (x.inc() != 1 || y.inc() != 1))
+    CBLAS::gemv(CblasColMajor, CblasNoTrans, rows(), columns(), alpha, data(), leading_dim(), x.data(), x.inc(), beta, y.data(), y.inc());
   else
-    CBLAS::gemv(CblasNoTrans, rows(), columns(), (REAL) 1.0, data(), leading_dim(), x.data(), x.inc(), (REAL) 0.0, y.data(), y.inc());
-*/
+    CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, rows(), xcols, columns(), alpha, data(), leading_dim(), x.data(), x.leading_dim(), beta, y.data(), y.leading_dim()); 
   return y;
 }
 
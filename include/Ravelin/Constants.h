@@ -19,6 +19,7 @@ enum Transposition { eNoTranspose, eTranspose };
 
 // constants
 const unsigned LOG_DYNAMICS = 4;
+const unsigned LOG_OPTIMIZATION = 8;
 const double EPS_DOUBLE = std::sqrt(std::numeric_limits<double>::epsilon());
 const float EPS_FLOAT = std::sqrt(std::numeric_limits<float>::epsilon());
 
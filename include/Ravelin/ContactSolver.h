@@ -0,0 +1,107 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef CONTACT_SOLVER
+#error This class is not to be included by the user directly. Use ContactSolverd.h or ContactSolverf.h instead.
+#endif
+
+/// Solves contact complementarity problems
+/**
+ * The contact problem is posed in impulse (or force) space using the
+ * Delassus matrix W = J inv(M) J', where J is the contact Jacobian and M is
+ * the generalized inertia of the bodies in contact. Since each contact
+ * touches at most a few bodies, W is assembled sparsely from per-body
+ * Jacobian blocks (see calc_delassus()).
+ *
+ * Two solvers are provided: a projected Gauss-Seidel / successive
+ * over-relaxation solver for the bounded (box/friction) problem
+ * lo <= z <= hi, w = Wz + q, and Lemke's algorithm for the standard linear
+ * complementarity problem w = Mz + q, w >= 0, z >= 0, z'w = 0. Both solvers
+ * accept the previous solution as a starting point (warm starting) and
+ * record their progress in residuals.
+ */
+class CONTACT_SOLVER
+{
+  public:
+
+    /// A block of the contact Jacobian with respect to a single body
+    struct JacobianBlock
+    {
+      /// the body that the block acts upon
+      boost::shared_ptr<DYNAMIC_BODY> body;
+
+      /// the first contact row (in the full Jacobian) of the block
+      unsigned row_start;
+
+      /// the block itself (#rows x body->num_generalized_coordinates(eSpatial))
+      MATRIXN J;
+    };
+
+    CONTACT_SOLVER();
+    SPARSEMATRIXN& calc_delassus(unsigned m, const std::vector<JacobianBlock>& blocks, SPARSEMATRIXN& W);
+    MATRIXN& calc_delassus(unsigned m, const std::vector<JacobianBlock>& blocks, MATRIXN& W);
+    bool solve_pgs(const SPARSEMATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, VECTORN& z);
+    bool solve_pgs(const SPARSEMATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const std::vector<int>& friction_index, const VECTORN& mu, VECTORN& z);
+    bool solve_pgs(const MATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, VECTORN& z);
+    bool solve_pgs(const MATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const std::vector<int>& friction_index, const VECTORN& mu, VECTORN& z);
+    bool solve_lemke(const MATRIXN& M, const VECTORN& q, VECTORN& z);
+
+    /// the relaxation parameter for PGS (1.0 is Gauss-Seidel; values in (1,2) over-relax)
+    REAL omega;
+
+    /// the maximum number of PGS sweeps (default 100)
+    unsigned max_iterations;
+
+    /// the maximum number of Lemke pivots (0 selects a default based on the problem size)
+    unsigned max_pivots;
+
+    /// the tolerance on the residual (negative selects a default based on machine epsilon)
+    REAL tolerance;
+
+    /// if <b>true</b>, the solution passed to the solvers is used as the starting point (default <b>true</b>)
+    bool warm_start;
+
+    /// the number of PGS sweeps (Lemke pivots) used by the last solve
+    unsigned iterations;
+
+    /// the residual after each PGS sweep (or the artificial variable after each Lemke pivot) of the last solve
+    std::vector<REAL> residuals;
+
+  private:
+    template <class M>
+    bool pgs(const M& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const std::vector<int>* friction_index, const VECTORN* mu, VECTORN& z);
+
+    template <class M>
+    void accumulate_delassus(unsigned m, const std::vector<JacobianBlock>& blocks, M& W);
+
+    static void get_bounds(unsigned i, const VECTORN& lo, const VECTORN& hi, const std::vector<int>* friction_index, const VECTORN* mu, const VECTORN& z, REAL& l, REAL& h);
+    static REAL row_dot(const SPARSEMATRIXN& A, unsigned i, const VECTORN& z, REAL& aii);
+    static REAL row_dot(const MATRIXN& A, unsigned i, const VECTORN& z, REAL& aii);
+    static void add_block(const std::vector<unsigned>& rows, const MATRIXN& Wb, SPARSEMATRIXN::Triplets& W);
+    static void add_block(const std::vector<unsigned>& rows, const MATRIXN& Wb, MATRIXN& W);
+    bool lemke_factor(const MATRIXN& M, const std::vector<unsigned>& basis);
+    void lemke_solve(VECTORN& x) const;
+    bool lemke_update(const MATRIXN& M, const std::vector<unsigned>& basis, unsigned r, const VECTORN& d);
+    void lemke_column(const MATRIXN& M, unsigned var, REAL* col) const;
+
+    // work variables for Delassus assembly
+    MATRIXN _Jb, _X, _Wb;
+    std::vector<unsigned> _rows;
+    SPARSEMATRIXN::Triplets _triplets;
+
+    // work variables for PGS and Lemke
+    VECTORN _xb, _d, _a;
+    MATRIXN _B;
+    std::vector<int> _piv;
+    std::vector<unsigned> _basis;
+
+    // the basis updates since _B was factored (see lemke_solve()): column k
+    // of _etas is the solution d of the update that replaced column
+    // _eta_rows[k] of the basis
+    MATRIXN _etas;
+    std::vector<unsigned> _eta_rows;
+}; // end class
+
@@ -0,0 +1,27 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0 
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_CONTACT_SOLVERD_H
+#define _RAVELIN_CONTACT_SOLVERD_H
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/MatrixNd.h>
+#include <Ravelin/VectorNd.h>
+#include <Ravelin/SparseMatrixNd.h>
+#include <Ravelin/DynamicBodyd.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "ContactSolver.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
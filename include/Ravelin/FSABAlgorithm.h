@@ -89,9 +89,12 @@ class FSAB_ALGORITHM
 
     /// work variables 
     VECTORN _workv, _workv2, _sTY, _qd_delta, _sIsmu, _Qi, _Q;
-    MATRIXN _sIss, _workM;
+    MATRIXN _sIss, _workM, _sIsU;
     std::vector<SMOMENTUM> _Y;
 
+    /// The articulated body inertias in packed form (accumulated during the backward recursion) 
+    std::vector<PACKED_SPATIAL_AB_INERTIA> _Ipacked;
+
     /// processed vector
     std::vector<bool> _processed;
 
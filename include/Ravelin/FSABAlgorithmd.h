@@ -11,6 +11,7 @@
 #include <queue>
 #include <boost/shared_ptr.hpp>
 #include <Ravelin/SpatialABInertiad.h>
+#include <Ravelin/PackedSpatialABInertiad.h>
 #include <Ravelin/MatrixNd.h>
 #include <Ravelin/LinAlgd.h>
 
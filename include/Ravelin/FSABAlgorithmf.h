@@ -11,6 +11,7 @@
 #include <queue>
 #include <boost/shared_ptr.hpp>
 #include <Ravelin/SpatialABInertiaf.h>
+#include <Ravelin/PackedSpatialABInertiaf.h>
 #include <Ravelin/MatrixNf.h>
 #include <Ravelin/LinAlgf.h>
 
@@ -26,6 +26,10 @@ class FIXEDJOINT : public virtual JOINT
     /// Fixed joint can never be in a singular configuration
     virtual bool is_singular_config() const { return false; }
 
+  protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
+
   private:
     void setup_joint();
 
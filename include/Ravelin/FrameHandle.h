@@ -0,0 +1,68 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef FRAME_HANDLE
+#error This class is not to be included by the user directly. Use FrameHandled.h or FrameHandlef.h instead.
+#endif
+
+class POSE3;
+
+/// A non-owning, pointer-sized reference to a pose
+/**
+ * Copying a handle copies a single pointer; unlike
+ * boost::shared_ptr<const POSE3>, no reference count is touched. When the
+ * library is built with RAVELIN_FRAME_HANDLES defined, VECTOR3, SVECTOR6
+ * (and derived classes), the spatial inertias, and SPATIAL_ARRAY store
+ * their frames as handles (see FRAME_PTR), so that temporaries in the
+ * dynamics inner loops are as cheap to create and copy as plain structs.
+ *
+ * A handle does not keep its pose alive: the pose must be owned elsewhere
+ * (by a FRAME_REGISTRY, a rigid body, a joint, etc.) for as long as any
+ * vector that refers to it is in use. The parts of the API that are used
+ * in the inner loops (e.g., the POSE3 transformations) accept handles 
+ * directly; lock() obtains the boost::shared_ptr<const POSE3> that the
+ * remainder of the API requires, which requires that the pose be owned by
+ * a boost::shared_ptr (and touches its reference count, so it is not 
+ * done implicitly).
+ */
+class FRAME_HANDLE
+{
+  public:
+    FRAME_HANDLE() : _pose(NULL) {}
+    FRAME_HANDLE(const POSE3* pose) : _pose(pose) {}
+    FRAME_HANDLE(const boost::shared_ptr<const POSE3>& pose) : _pose(pose.get()) {}
+    FRAME_HANDLE(const boost::shared_ptr<POSE3>& pose) : _pose(pose.get()) {}
+    boost::shared_ptr<const POSE3> lock() const;
+
+    /// Gets the pose referred to by this handle
+    const POSE3* get() const { return _pose; }
+
+    /// Makes this handle refer to no pose (the global frame)
+    void reset() { _pose = NULL; }
+
+    const POSE3* operator->() const { assert(_pose); return _pose; }
+    const POSE3& operator*() const { assert(_pose); return *_pose; }
+
+    // safe conversion to bool
+    typedef const POSE3* FRAME_HANDLE::*unspecified_bool_type;
+    operator unspecified_bool_type() const { return (_pose) ? &FRAME_HANDLE::_pose : NULL; }
+    bool operator!() const { return !_pose; }
+
+  private:
+    const POSE3* _pose;
+}; // end class
+
+inline bool operator==(const FRAME_HANDLE& a, const FRAME_HANDLE& b) { return a.get() == b.get(); }
+inline bool operator!=(const FRAME_HANDLE& a, const FRAME_HANDLE& b) { return a.get() != b.get(); }
+inline bool operator<(const FRAME_HANDLE& a, const FRAME_HANDLE& b) { return a.get() < b.get(); }
+inline std::ostream& operator<<(std::ostream& out, const FRAME_HANDLE& h) { return out << (const void*) h.get(); }
+
+/// Gets a shared pointer to the pose referred to by a frame pointer (see FRAME_PTR), however frames are stored
+inline boost::shared_ptr<const POSE3> lock_frame(const FRAME_HANDLE& pose) { return pose.lock(); }
+
+/// Gets a shared pointer to the pose referred to by a frame pointer (see FRAME_PTR), however frames are stored
+inline boost::shared_ptr<const POSE3> lock_frame(const boost::shared_ptr<const POSE3>& pose) { return pose; }
+
@@ -0,0 +1,24 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _FRAMEHANDLEF_H
+#define _FRAMEHANDLEF_H
+
+#include <assert.h>
+#include <cstddef>
+#include <ostream>
+#include <boost/shared_ptr.hpp>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "FrameHandle.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -0,0 +1,44 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef FRAME_REGISTRY
+#error This class is not to be included by the user directly. Use FrameRegistryd.h or FrameRegistryf.h instead.
+#endif
+
+/// Owns a set of poses and refers to them by compact integer identifiers
+/**
+ * The registry keeps every pose added to it alive until clear() is called
+ * or the registry is destroyed, so FRAME_HANDLE objects obtained from it
+ * (or from the poses that it owns) remain valid over that lifetime. Poses
+ * are numbered consecutively, starting from zero, in the order in which
+ * they are added; the identifiers may be stored in place of pointers
+ * (e.g., in arrays that are written to disk or shared between threads).
+ */
+class FRAME_REGISTRY
+{
+  public:
+    unsigned add(boost::shared_ptr<POSE3> pose);
+    unsigned add(boost::shared_ptr<const POSE3> pose);
+    unsigned find(FRAME_HANDLE handle) const;
+    void clear();
+
+    /// Gets the number of poses in the registry
+    unsigned size() const { return _poses.size(); }
+
+    /// Determines whether the given handle refers to a pose owned by this registry
+    bool contains(FRAME_HANDLE handle) const { return !handle || _ids.find(handle.get()) != _ids.end(); }
+
+    /// Gets a handle to the pose with the given identifier
+    FRAME_HANDLE operator[](unsigned id) const { return get_handle(id); }
+
+    FRAME_HANDLE get_handle(unsigned id) const;
+    boost::shared_ptr<const POSE3> get_pose(unsigned id) const;
+
+  private:
+    std::vector<boost::shared_ptr<const POSE3> > _poses;
+    std::map<const POSE3*, unsigned> _ids;
+}; // end class
+
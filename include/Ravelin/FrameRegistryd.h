@@ -0,0 +1,25 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _FRAMEREGISTRYD_H
+#define _FRAMEREGISTRYD_H
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/FrameHandled.h>
+#include <Ravelin/Pose3d.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "FrameRegistry.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
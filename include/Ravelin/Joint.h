@@ -13,6 +13,8 @@ class RIGIDBODY;
 /// Defines a bilateral constraint (a joint)
 class JOINT : public virtual_enable_shared_from_this<JOINT>
 {
+  friend class RC_ARTICULATED_BODY;
+
   public:
     enum ConstraintType { eUnknown, eExplicit, eImplicit };
     enum DOFs { DOF_1=0, DOF_2=1, DOF_3=2, DOF_4=3, DOF_5=4, DOF_6=5 };
@@ -149,6 +151,31 @@ class JOINT : public virtual_enable_shared_from_this<JOINT>
     virtual void calc_constraint_jacobian_dot(bool inboard, MATRIXN& Cq) = 0;
 
   protected:
+    /// Maps the frames of an articulated body to the corresponding frames of a copy of it (see RC_ARTICULATED_BODY::clone())
+    typedef boost::unordered_map<const POSE3*, boost::shared_ptr<POSE3> > PoseMap;
+
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
+    void copy_frames(PoseMap& poses);
+    static void copy_frame(boost::shared_ptr<POSE3>& pose, PoseMap& poses);
+
+    /// Makes an object with a frame (e.g., a vector) refer to the corresponding copied frame, if there is one
+    template <class T>
+    static void remap_frame(T& x, const PoseMap& poses)
+    {
+      typename PoseMap::const_iterator i = poses.find(x.pose.get());
+      if (i != poses.end())
+        x.pose = i->second;
+    }
+
+    /// Makes objects with frames refer to the corresponding copied frames, if there are any
+    template <class T>
+    static void remap_frame(std::vector<T>& x, const PoseMap& poses)
+    {
+      for (unsigned i=0; i< x.size(); i++)
+        remap_frame(x[i], poses);
+    }
+
     void calc_constraint_jacobian_numeric(bool inboard, MATRIXN& Cq);
     bool transform_jacobian(MATRIXN& J, bool use_inboard, MATRIXN& output);
     void invalidate_pose_vectors() { get_outboard_link()->invalidate_pose_vectors(); }
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 #include <Ravelin/Pose3d.h>
 #include <Ravelin/RigidBodyd.h>
 #include <Ravelin/MatrixNd.h>
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 #include <Ravelin/Pose3f.h>
 #include <Ravelin/RigidBodyf.h>
 #include <Ravelin/MatrixNf.h>
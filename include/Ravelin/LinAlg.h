@@ -18,6 +18,28 @@ class LINALG
     enum SVD { eSVD1, eSVD2 };
 
   private:
+    /// LAPACK routines whose workspace sizes are queried and cached
+    enum LworkRoutine { eORMQR, eGELSD, eSYSV, eGESDD, eGESVD, eSYEVD, eSYTRF, eGEQP3, eGEQRF, eGETRI, eORGQR, eNumLworkRoutines };
+
+    /// maximum number of cached option variants (e.g., JOBZ) per routine
+    enum { LWORK_VARIANTS = 4 };
+
+    /// a cached LAPACK workspace query, valid for all problems no larger than m x n x k
+    struct LworkEntry
+    {
+      LworkEntry() { valid = false; opt1 = opt2 = ' '; m = n = k = lwork = liwork = 0; }
+      bool valid;
+      char opt1, opt2;
+      INTEGER m, n, k;
+      INTEGER lwork, liwork;
+    };
+
+    /// the table of cached LAPACK workspace queries
+    struct LworkCache
+    {
+      LworkEntry entries[eNumLworkRoutines][LWORK_VARIANTS];
+    };
+
     static REAL log2(REAL x);
     static void lartg_(REAL* F, REAL* G, REAL* CS, REAL* SN, REAL* R);
     static void gtsv_(INTEGER* N, INTEGER* NRHS, REAL* DL, REAL* D, REAL* DU, REAL* B, INTEGER* LDB, INTEGER* INFO);
@@ -44,12 +66,30 @@ LDA, REAL* B, INTEGER* LDB, REAL* RCOND, INTEGER* INFO);
     void getri_(INTEGER* N, REAL* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO);
     static void getrs_(char* TRANS, INTEGER* N, INTEGER* NRHS, REAL* A, INTEGER* LDA, INTEGER* IPIV, REAL* B, INTEGER* LDB, INTEGER* INFO);
     void orgqr_(INTEGER* M, INTEGER* N, INTEGER* K, REAL* A, INTEGER* LDA, REAL* TAU, INTEGER* INFO);
+    void stev_(char* JOBZ, INTEGER* N, REAL* D, REAL* E, REAL* Z, INTEGER* LDZ, INTEGER* INFO);
+    void randn(MATRIXN& M, unsigned rows, unsigned columns);
+    void query_lwork(LworkRoutine r, char opt1, char opt2, INTEGER M, INTEGER N, INTEGER K, INTEGER& LWORK, INTEGER& LIWORK);
+    void workspace(LworkRoutine r, char opt1, char opt2, INTEGER M, INTEGER N, INTEGER K, INTEGER& LWORK, INTEGER& LIWORK);
+    static void resize_work(std::vector<INTEGER>& v, unsigned n);
+
+    /// cached LAPACK workspace queries
+    FastThreadable<LworkCache> lwork_cache;
+
+    /// number of heap allocations made for STL integer work vectors (by each thread)
+    #ifndef REENTRANT
+    static FastThreadable<unsigned long> _nallocs;
+    #endif
+    static void count_allocation();
 
   public:
     void compress();
     void free_memory();
+    void reserve(unsigned max_m, unsigned max_n);
+    static unsigned long allocations();
     static void factor_LDL(MATRIXN& M, std::vector<int>& IPIV);
     MATRIXN& pseudo_invert(MATRIXN& A, REAL tol=(REAL) -1.0);
+    MATRIXN& pseudo_invert_lowrank(MATRIXN& A, unsigned k, REAL tol=(REAL) -1.0);
+    void orthonormalize(MATRIXN& A);
     static void givens(REAL a, REAL b, REAL& c, REAL& s);
     static MATRIX2 givens(REAL c, REAL s);
     static void householder(REAL alpha, const VECTORN& x, REAL& tau, VECTORN& v);
@@ -62,7 +102,7 @@ LDA, REAL* B, INTEGER* LDB, REAL* RCOND, INTEGER* INFO);
     void update_QR_delete_rows(MATRIXN& Q, MATRIXN& R, unsigned k, unsigned p);
 
     /// work matrices
-    FastThreadable<MATRIXN> workM, workM2;
+    FastThreadable<MATRIXN> workM, workM2, workM3;
 
     /// work matrix (for SVD)
     FastThreadable<MATRIXN> U;
@@ -82,6 +122,9 @@ LDA, REAL* B, INTEGER* LDB, REAL* RCOND, INTEGER* INFO);
     /// work STL integer vector (LAPACK routines)
     FastThreadable<std::vector<INTEGER> > iworkv;
 
+    /// random number generator (randomized SVD, Lanczos starting vectors)
+    FastThreadable<boost::mt19937> rng;
+
     // include templated routines here...
     #include "LinAlg.inl"
 
@@ -1,3 +1,26 @@
+/// Copies a (possibly strided) vector into contiguous storage
+template <class X>
+static void copy_to_contiguous(const X& x, VECTORN& y)
+{
+  y.resize(x.rows());
+  const REAL* data = x.data();
+  for (unsigned i=0, j=0; i< x.rows(); i++, j+= x.inc())
+    y[i] = data[j];
+}
+
+/// Copies a contiguous vector back into a (possibly strided) vector
+template <class X>
+static void copy_from_contiguous(const VECTORN& y, X& x)
+{
+  #ifndef NEXCEPT
+  if (y.rows() != x.rows())
+    throw MissizeException();
+  #endif
+  REAL* data = x.data();
+  for (unsigned i=0, j=0; i< y.rows(); i++, j+= x.inc())
+    data[j] = y[i];
+}
+
 /// Solves a tridiagonal system
 /**
  * \param dl the (n-1) elements on the subdiagonal (destroyed on return)
@@ -10,6 +33,17 @@
 template <class X>
 static X& solve_tridiagonal_fast(VECTORN& dl, VECTORN& d, VECTORN& du, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_tridiagonal_fast(dl, d, du, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   // make sure everything is the proper size
   #ifndef NEXCEPT
   if (sizeof(dl.data()) != sizeof(XB.data()))
@@ -144,6 +178,17 @@ X& inverse_LU(X& M, const std::vector<int>& pivwork)
 template <class X, class Y>
 static X& solve_tri_fast(Y& A, bool utri, bool transpose_A, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_tri_fast(A, utri, transpose_A, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (A.rows() != XB.rows())
     throw MissizeException();
@@ -181,6 +226,17 @@ static X& solve_tri_fast(Y& A, bool utri, bool transpose_A, X& XB)
 template <class X>
 static X& solve_LDL_fast(const MATRIXN& M, const std::vector<int>& pivwork, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_LDL_fast(M, pivwork, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (M.rows() != XB.rows())
     throw MissizeException();
@@ -199,14 +255,14 @@ static X& solve_LDL_fast(const MATRIXN& M, const std::vector<int>& pivwork, X& X
   #endif
 
   // setup parameters for LAPACK
-  char UPLO = 'U';
+  char UPLO = 'L';
   INTEGER N = M.rows();
   INTEGER NRHS = XB.columns();
   INTEGER LDB = XB.leading_dim();
   INTEGER INFO;
 
   // call the solver routine
-  sptrs_(&UPLO, &N, &NRHS, M.data(), (int*) &pivwork.front(), XB.data(), &LDB, &INFO);
+  sptrs_(&UPLO, &N, &NRHS, (REAL*) M.data(), (int*) &pivwork.front(), XB.data(), &LDB, &INFO);
   assert(INFO == 0);
 
   return XB;
@@ -220,6 +276,17 @@ static X& solve_LDL_fast(const MATRIXN& M, const std::vector<int>& pivwork, X& X
 template <class X, class Y>
 static X& solve_chol_fast(const Y& M, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_chol_fast(M, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (M.rows() != XB.rows())
     throw MissizeException();
@@ -262,6 +329,17 @@ static X& solve_chol_fast(const Y& M, X& XB)
 template <class Y, class X>
 static X& solve_LU_fast(const Y& M, bool transpose, const std::vector<int>& pivwork, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_LU_fast(M, transpose, pivwork, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (M.rows() != XB.rows())
     throw MissizeException();
@@ -382,6 +460,126 @@ MATRIXN& nullspace(Y& A, MATRIXN& nullspace, REAL tol = -1.0)
   }
 }
 
+/// Calculates the rank of a matrix whose rank is known to be at most k
+/**
+ * Uses a randomized SVD to compute only the k dominant singular values when
+ * k << min(m,n); otherwise, calc_rank() is called.
+ * \param A the matrix (not modified unless calc_rank() is used)
+ * \param k an upper bound on the rank of A
+ * \param tol the tolerance for determining rank; if tol < 0.0, tol is
+ *        computed using machine epsilon
+ */
+template <class X>
+unsigned calc_rank_lowrank(X& A, unsigned k, REAL tol = (REAL) -1.0)
+{
+  // get the dimensions of A
+  const unsigned m = A.rows();
+  const unsigned n = A.columns();
+  const unsigned minmn = std::min(m,n);
+
+  // look for easy out
+  if (minmn == 0 || k == 0)
+    return 0;
+
+  // use the full SVD if k is not substantially smaller than min(m,n)
+  if (4*k >= minmn)
+    return calc_rank(A, tol);
+
+  // compute the k dominant singular values of A
+  MATRIXN& Ux = U();
+  MATRIXN& Vx = V();
+  VECTORN& Sx = S();
+  svd_randomized(A, k, Ux, Sx, Vx);
+
+  // count the singular values above the tolerance
+  const REAL* Sx_data = Sx.data();
+  REAL tolerance = (tol < 0.0) ? Sx_data[0] * std::max(m,n) * std::numeric_limits<REAL>::epsilon() : tol;
+  unsigned rank = 0;
+  for (unsigned i=0; i< Sx.size(); i++)
+    if (Sx_data[i] > tolerance)
+      rank++;
+
+  return rank;
+}
+
+/// Computes the nullspace of a matrix whose rank is known to be at most k
+/**
+ * The k dominant right singular vectors are computed using a randomized SVD;
+ * the nullspace is then the orthogonal complement of those vectors, which
+ * is determined using a QR factorization. This is much cheaper than
+ * nullspace() for tall matrices of low rank. If k is not substantially 
+ * smaller than min(m,n), nullspace() is called instead.
+ * \param A the m x n matrix (destroyed on return if nullspace() is used)
+ * \param k an upper bound on the rank of A
+ * \param ns on return, a n x (n - rank(A)) orthonormal basis for the nullspace
+ * \param tol the tolerance for determining rank; if tol < 0.0, tol is 
+ *        computed using machine epsilon
+ */
+template <class Y>
+MATRIXN& nullspace_lowrank(Y& A, unsigned k, MATRIXN& ns, REAL tol = (REAL) -1.0)
+{
+  #ifndef NEXCEPT
+  if (sizeof(A.data()) != sizeof(ns.data()))
+    throw DataMismatchException();
+  #endif
+
+  // get the dimensions of A
+  const unsigned m = A.rows();
+  const unsigned n = A.columns();
+  const unsigned minmn = std::min(m,n);
+
+  // use the full SVD if k is not substantially smaller than min(m,n)
+  if (m == 0 || k == 0 || 4*k >= minmn)
+    return nullspace(A, ns, tol);
+
+  // compute the k dominant right singular vectors of A
+  MATRIXN& Ux = U();
+  MATRIXN& Vx = V();
+  VECTORN& Sx = S();
+  svd_randomized(A, k, Ux, Sx, Vx);
+
+  // determine the rank
+  const REAL* Sx_data = Sx.data();
+  REAL tolerance = (tol < 0.0) ? Sx_data[0] * std::max(m,n) * std::numeric_limits<REAL>::epsilon() : tol;
+  unsigned r = 0;
+  for (unsigned i=0; i< Sx.size(); i++)
+    if (Sx_data[i] > tolerance)
+      r++;
+
+  // look for a full nullspace 
+  if (r == 0)
+  {
+    ns.set_zero(n, n);
+    for (unsigned i=0; i< n; i++)
+      ns(i,i) = (REAL) 1.0;
+    return ns;
+  }
+
+  // factor the rank-revealing right singular vectors V(:,1:r) = Q*R
+  INTEGER M = n;
+  INTEGER N = r;
+  INTEGER LDA = Vx.leading_dim();
+  INTEGER INFO;
+  VECTORN& tau = workv2();
+  tau.resize(r);
+  geqrf_(&M, &N, Vx.data(), &LDA, tau.data(), &INFO);
+  assert(INFO == 0);
+
+  // form the full n x n matrix Q; its last n-r columns span the nullspace
+  ns.resize(n, n);
+  std::copy(Vx.data(), Vx.data()+n*r, ns.data());
+  INTEGER NN = n;
+  INTEGER LDNS = ns.leading_dim();
+  orgqr_(&M, &NN, &N, ns.data(), &LDNS, tau.data(), &INFO);
+  assert(INFO == 0);
+
+  // shift the nullspace basis to the front
+  COLUMN_ITERATOR bi = ns.block_column_iterator_begin(0, n, r, n);
+  std::copy(bi, bi+(n-r)*n, ns.column_iterator_begin());
+  ns.resize(n, n-r, true);
+  return ns;
+}
+
 /// Computes the condition number of a matrix
 template <class X>
 REAL cond(X& A)
@@ -525,6 +723,149 @@ void eig_symm_plus(X& A_evecs, Y& evals)
     throw NumericalException("Eigenvalue/eigenvector determination did not converge");
 }
 
+/// Computes the k largest eigenvalues (and corresponding eigenvectors) of a symmetric matrix using the Lanczos method
+/**
+ * Lanczos iteration with full reorthogonalization is used to build a Krylov
+ * basis; the Ritz pairs are extracted from the projected tridiagonal matrix.
+ * If the Ritz pairs have not converged, the Krylov dimension is doubled
+ * (up to n, at which point the result is exact to working precision).
+ * \param A a square symmetric matrix (not modified)
+ * \param k the number of eigenvalues to compute
+ * \param evals on return, the k largest eigenvalues in ascending order
+ * \param evecs on return, a n x k matrix of the corresponding eigenvectors
+ * \param ncv the initial dimension of the Krylov subspace (if zero, a 
+ *        default of max(2k+1, k+20) is used)
+ */
+template <class X, class Y, class Z>
+void eig_symm_lanczos(X& A, unsigned k, Y& evals, Z& evecs, unsigned ncv = 0)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != A.columns())
+    throw NonsquareMatrixException();
+
+  if (sizeof(A.data()) != sizeof(evals.data()) || 
+      sizeof(A.data()) != sizeof(evecs.data()))
+    throw DataMismatchException();
+  #endif
+
+  // get the size of A
+  const unsigned n = A.rows();
+  if (k > n)
+    k = n;
+
+  // make sure that A is not zero sized
+  if (k == 0)
+  {
+    evals.resize(0);
+    evecs.resize(n, 0);
+    return;
+  }
+
+  // setup the dimension of the Krylov subspace
+  if (ncv == 0)
+    ncv = std::max(2*k+1, k+20);
+  ncv = std::min(std::max(ncv, k), n);
+
+  // get work matrices and vectors
+  MATRIXN& Q = workM3();
+  MATRIXN& Zx = workM2();
+  VECTORN& alpha = S();
+  VECTORN beta, h;
+  const REAL* Adata = A.data();
+  const INTEGER LDA = A.leading_dim();
+  const REAL TOL = std::sqrt(std::numeric_limits<REAL>::epsilon());
+  const REAL CONV_TOL = std::pow(std::numeric_limits<REAL>::epsilon(), (REAL) 0.75);
+
+  while (true)
+  {
+    // setup the Krylov basis and the tridiagonal matrix
+    Q.resize(n, ncv+1);
+    alpha.resize(ncv);
+    beta.resize(ncv);
+    h.resize(ncv);
+    REAL* Qdata = Q.data();
+
+    // setup a random starting vector
+    randn(workM(), n, 1);
+    std::copy(workM().data(), workM().data()+n, Qdata);
+    CBLAS::scal(n, (REAL) 1.0/CBLAS::nrm2(n, Qdata, 1), Qdata, 1);
+
+    // do the Lanczos iteration
+    unsigned m = ncv;
+    for (unsigned j=0; j< ncv; j++)
+    {
+      REAL* q = Qdata + n*j;
+      REAL* w = Qdata + n*(j+1);
+
+      // w = A*q_j - beta_{j-1}*q_{j-1}
+      CBLAS::gemv(CblasColMajor, CblasNoTrans, n, n, (REAL) 1.0, Adata, LDA, q, 1, (REAL) 0.0, w, 1);
+      alpha[j] = CBLAS::dot(n, q, 1, w, 1);
+
+      // full reorthogonalization against q_0..q_j (applied twice for 
+      // numerical robustness); this subsumes the three-term recurrence
+      for (unsigned pass=0; pass < 2; pass++)
+      {
+        CBLAS::gemv(CblasColMajor, CblasTrans, n, j+1, (REAL) 1.0, Qdata, n, w, 1, (REAL) 0.0, h.data(), 1);
+        CBLAS::gemv(CblasColMajor, CblasNoTrans, n, j+1, (REAL) -1.0, Qdata, n, h.data(), 1, (REAL) 1.0, w, 1);
+      }
+
+      // normalize
+      beta[j] = CBLAS::nrm2(n, w, 1);
+      if (beta[j] < TOL * std::fabs(alpha[j]) + std::numeric_limits<REAL>::min())
+      {
+        // an invariant subspace has been found
+        m = j+1;
+        if (m >= k)
+          break;
+
+        // otherwise, restart with a random vector orthogonal to the basis
+        randn(workM(), n, 1);
+        std::copy(workM().data(), workM().data()+n, w);
+        for (unsigned pass=0; pass < 2; pass++)
+        {
+          CBLAS::gemv(CblasColMajor, CblasTrans, n, j+1, (REAL) 1.0, Qdata, n, w, 1, (REAL) 0.0, h.data(), 1);
+          CBLAS::gemv(CblasColMajor, CblasNoTrans, n, j+1, (REAL) -1.0, Qdata, n, h.data(), 1, (REAL) 1.0, w, 1);
+        }
+        beta[j] = (REAL) 0.0;
+        CBLAS::scal(n, (REAL) 1.0/CBLAS::nrm2(n, w, 1), w, 1);
+        m = ncv;
+      }
+      else
+        CBLAS::scal(n, (REAL) 1.0/beta[j], w, 1);
+    }
+
+    // compute the eigenvalues and eigenvectors of the tridiagonal matrix
+    char JOBZ = 'V';
+    INTEGER M = m;
+    INTEGER LDZ = m;
+    INTEGER INFO;
+    REAL beta_m = beta[m-1];
+    Zx.resize(m, m);
+    stev_(&JOBZ, &M, alpha.data(), beta.data(), Zx.data(), &LDZ, &INFO);
+    if (INFO > 0)
+      throw NumericalException("Eigenvalue/eigenvector determination did not converge");
+
+    // check the residuals of the k largest Ritz pairs
+    bool converged = true;
+    for (unsigned i=m-k; i< m && converged; i++)
+      if (std::fabs(beta_m * Zx(m-1,i)) > CONV_TOL * std::max((REAL) 1.0, std::fabs(alpha[m-1])))
+        converged = false;
+
+    // if converged (or the Krylov basis spans the space), form the Ritz pairs
+    if (converged || ncv == n || m < ncv)
+    {
+      evals.resize(k);
+      std::copy(alpha.data()+m-k, alpha.data()+m, evals.data());
+      evecs.resize(n, k);
+      CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, k, m, (REAL) 1.0, Qdata, n, Zx.data()+m*(m-k), m, (REAL) 0.0, evecs.data(), evecs.leading_dim());
+      return;
+    }
+
+    // increase the size of the Krylov subspace
+    ncv = std::min(2*ncv, n);
+  }
+}
+
 template <class X, class MatU, class VecS, class MatV>
 void svd(X& A, MatU& U, VecS& S, MatV& V)
 {
@@ -683,6 +1024,170 @@ void svd2(X& A, MatU& U, VecS& S, MatV& V)
   V.transpose();
 }
 
+/// Does an 'in place' thin SVD (destroying A), using divide and conquer algorithm
+/**
+ * Only the first min(m,n) columns of U and V are computed (i.e., A = U*S*V',
+ * where U is m x min(m,n) and V is n x min(m,n)).
+ * \param A the matrix on which the SVD will be performed (destroyed on return)
+ * \param U on output, a A.rows() x min(A.rows(), A.columns()) matrix with 
+ *        orthonormal columns
+ * \param S on output, a min(A.rows(), A.columns()) length vector of singular values
+ * \param V on output, a A.columns() x min(A.rows(), A.columns()) matrix with
+ *        orthonormal columns
+ */
+template <class X, class MatU, class VecS, class MatV>
+void svd_thin(X& A, MatU& U, VecS& S, MatV& V)
+{
+  // get the dimensions of A 
+  const unsigned minmn = std::min(A.rows(), A.columns());
+
+  // make sure that A is not zero sized
+  if (minmn == 0)
+  {
+    U.set_zero(A.rows(), 0);
+    S.resize(0);
+    V.set_zero(A.columns(), 0);
+    return;
+  } 
+
+  #ifndef NEXCEPT
+  if (sizeof(A.data()) != sizeof(U.data()))
+    throw DataMismatchException();
+  if (sizeof(A.data()) != sizeof(S.data()))
+    throw DataMismatchException();
+  if (sizeof(A.data()) != sizeof(V.data()))
+    throw DataMismatchException();
+  #endif
+
+  // setup U, S, and V (V will be transposed)
+  U.resize(A.rows(), minmn);
+  S.resize(minmn);
+  V.resize(minmn, A.columns());
+
+  // setup call to LAPACK
+  char JOBZ = 'S';
+  INTEGER M = A.rows();
+  INTEGER N = A.columns();
+  INTEGER LDA = A.leading_dim();
+  INTEGER LDU = U.leading_dim();
+  INTEGER LDVT = V.leading_dim();
+  INTEGER INFO;
+
+  // call LAPACK 
+  gesdd_(&JOBZ, &M, &N, A.data(), &LDA, S.data(), U.data(), &LDU, V.data(), &LDVT, &INFO);
+  assert(INFO >= 0);
+
+  if (INFO > 0)
+    throw NumericalException("Singular value decomposition failed to converge");
+
+  // transpose V
+  V.transpose();
+}
+
+/// Computes the k dominant singular triplets of A (destroying A)
+/**
+ * Computes a thin SVD and discards all but the k largest singular values
+ * and the corresponding singular vectors.
+ * \param A the matrix on which the SVD will be performed (destroyed on return)
+ * \param k the number of singular triplets to keep
+ * \param U on output, a A.rows() x k matrix with orthonormal columns
+ * \param S on output, a k length vector of singular values (descending)
+ * \param V on output, a A.columns() x k matrix with orthonormal columns
+ */
+template <class X, class MatU, class VecS, class MatV>
+void svd_truncated(X& A, unsigned k, MatU& U, VecS& S, MatV& V)
+{
+  // compute the thin SVD
+  svd_thin(A, U, S, V);
+
+  // truncate
+  if (k < S.size())
+  {
+    U.resize(U.rows(), k, true);
+    S.resize(k, true);
+    V.resize(V.rows(), k, true);
+  }
+}
+
+/// Computes an approximation to the k dominant singular triplets of A using a randomized algorithm
+/**
+ * The range of A is sampled using a Gaussian test matrix with k + oversample
+ * columns and refined using subspace (power) iterations; the SVD of the 
+ * small projected matrix is then computed (see Halko, Martinsson, and Tropp, 
+ * "Finding structure with randomness", SIAM Review, 2011). The cost is
+ * O(mnk) rather than O(mn*min(m,n)).
+ * \param A the m x n matrix (not modified)
+ * \param k the number of singular triplets to compute
+ * \param U on output, a m x k matrix with orthonormal columns
+ * \param S on output, a k length vector of singular values (descending)
+ * \param V on output, a n x k matrix with orthonormal columns
+ * \param oversample the number of extra samples of the range of A
+ * \param power_iters the number of power iterations (increase for matrices
+ *        with slowly decaying singular values)
+ */
+template <class X, class MatU, class VecS, class MatV>
+void svd_randomized(X& A, unsigned k, MatU& U, VecS& S, MatV& V, unsigned oversample = 10, unsigned power_iters = 2)
+{
+  // get the dimensions of A
+  const unsigned m = A.rows();
+  const unsigned n = A.columns();
+  const unsigned minmn = std::min(m, n);
+  if (k > minmn)
+    k = minmn;
+
+  // make sure that A is not zero sized
+  if (k == 0)
+  {
+    U.set_zero(m, 0);
+    S.resize(0);
+    V.set_zero(n, 0);
+    return;
+  } 
+
+  #ifndef NEXCEPT
+  if (sizeof(A.data()) != sizeof(U.data()))
+    throw DataMismatchException();
+  if (sizeof(A.data()) != sizeof(S.data()))
+    throw DataMismatchException();
+  if (sizeof(A.data()) != sizeof(V.data()))
+    throw DataMismatchException();
+  #endif
+
+  // determine the number of samples 
+  const unsigned l = std::min(k + oversample, minmn);
+
+  // get work matrices
+  MATRIXN& Y = workM();
+  MATRIXN& Omega = workM2();
+  MATRIXN& B = workM3();
+
+  // sample the range of A: Y = orth(A*Omega)
+  randn(Omega, n, l);
+  A.mult(Omega, Y);
+  orthonormalize(Y);
+
+  // do power iterations, orthonormalizing after each product
+  for (unsigned i=0; i< power_iters; i++)
+  {
+    A.transpose_mult(Y, Omega);
+    orthonormalize(Omega);
+    A.mult(Omega, Y);
+    orthonormalize(Y);
+  }
+
+  // project A onto the sampled range: B = Y'*A (l x n)
+  Y.transpose_mult(A, B);
+
+  // compute the SVD of the small matrix B; U = Y*Ub
+  svd_thin(B, Omega, S, V);
+  Y.mult(Omega, U);
+
+  // truncate to k
+  U.resize(m, k, true);
+  S.resize(k, true);
+  V.resize(n, k, true);
+}
+
 /// Solves a symmetric, indefinite square matrix
 /**
  * \param A the matrix to be solved; the matrix is destroyed on return
@@ -691,6 +1196,17 @@ void svd2(X& A, MatU& U, VecS& S, MatV& V)
 template <class X>
 X& solve_symmetric_fast(MATRIXN& A, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_symmetric_fast(A, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (A.rows() != A.columns())
     throw NonsquareMatrixException();
@@ -715,7 +1231,7 @@ X& solve_symmetric_fast(MATRIXN& A, X& XB)
   INTEGER LDA = A.leading_dim();
   INTEGER NRHS = XB.columns();
   INTEGER LDB = XB.leading_dim();
-  pivwork().resize(N);
+  resize_work(pivwork(), N);
   INTEGER INFO;
 
   // call LAPACK
@@ -753,7 +1269,7 @@ X& inverse_symmetric(X& A)
   INTEGER INFO;
 
   // setup pivot array
-  pivwork().resize(N);
+  resize_work(pivwork(), N);
 
   // perform the necessary factorization
   sytrf_(&UPLO, &N, A.data(), &LDA, &pivwork().front(), &INFO);
@@ -784,6 +1300,17 @@ X& inverse_symmetric(X& A)
 template <class Y, class X>
 static X& solve_SPD_fast(Y& A, X& XB)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_SPD_fast(A, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (A.rows() != A.columns())
     throw NonsquareMatrixException();
@@ -925,6 +1452,17 @@ X& invert(X& A)
 template <class X, class Y, class Vec, class Z>
 X& solve_LS_fast(const Y& U, const Vec& S, const Z& V, X& XB, REAL tol = (REAL) -1.0)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_LS_fast(U, S, V, xb, tol);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   // verify that U, S, V and B are appropriate sizes
   #ifndef NEXCEPT
   if (U.rows() != XB.rows())
@@ -1107,6 +1645,17 @@ X& solve_LS_fast(const Y& U, const Vec& S, const Z& V, X& XB, REAL tol = (REAL)
 template <class X, class Y>
 X& solve_LS_fast(Y& A, X& XB, SVD svd_algo, REAL tol)
 {
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_LS_fast(A, xb, svd_algo, tol);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   // verify that A and B are appropriate sizes
   #ifndef NEXCEPT
   if (A.rows() != XB.rows())
@@ -1266,6 +1815,17 @@ X& solve_LS_fast(Y& A, X& XB, SVD svd_algo, REAL tol)
 template <class X, class Y>
 Y& solve_fast(X& A, Y& XB)
 {  
+  // LAPACK requires contiguous right hand sides; a strided vector is solved
+  // through a contiguous copy
+  if (XB.inc() != 1)
+  {
+    VECTORN xb;
+    copy_to_contiguous(XB, xb);
+    solve_fast(A, xb);
+    copy_from_contiguous(xb, XB);
+    return XB;
+  }
+
   #ifndef NEXCEPT
   if (A.rows() != A.columns())
     throw NonsquareMatrixException();
@@ -1289,7 +1849,7 @@ Y& solve_fast(X& A, Y& XB)
   INTEGER LDA = A.leading_dim();
   INTEGER LDB = XB.leading_dim();
   INTEGER NRHS = XB.columns();
-  pivwork().resize(N);
+  resize_work(pivwork(), N);
   INTEGER INFO;
 
   // call LAPACK (use solving routine that uses LU factorization)
@@ -1413,7 +1973,7 @@ void factor_QR(ARMat& AR, QMat& Q)
   // note: R is m x n, so we don't have to resize
   for (unsigned i=0; i< AR.columns(); i++)
   {
-    RowIteratord coli = AR.block_row_iterator_begin(i+1,AR.rows(),i,i+1);
+    ROW_ITERATOR coli = AR.block_row_iterator_begin(i+1,AR.rows(),i,i+1);
     std::fill(coli, coli.end(), 0.0);
   }
 }
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_LINALG_MIXED_H
+#define _RAVELIN_LINALG_MIXED_H
+
+#include <vector>
+#include <Ravelin/MatrixNd.h>
+#include <Ravelin/MatrixNf.h>
+#include <Ravelin/VectorNd.h>
+
+namespace Ravelin {
+
+/// Mixed precision solvers for dense systems of linear equations
+/**
+ * The matrix is factored in single precision (roughly twice the flop rate
+ * and half the memory traffic of a double precision factorization) and the
+ * solution is then refined to double precision accuracy using iterative
+ * refinement with residuals computed in double precision. If refinement
+ * does not converge (e.g., because the matrix is too ill-conditioned for a
+ * single precision factorization), the matrix is refactored in double
+ * precision instead.
+ */
+class LinAlgMixed
+{
+  public:
+    LinAlgMixed();
+    MatrixNd& solve_LU(const MatrixNd& A, MatrixNd& XB);
+    VectorNd& solve_LU(const MatrixNd& A, VectorNd& xb);
+    MatrixNd& solve_chol(const MatrixNd& A, MatrixNd& XB);
+    VectorNd& solve_chol(const MatrixNd& A, VectorNd& xb);
+    MatrixNd& solve_LDL(const MatrixNd& A, MatrixNd& XB);
+    VectorNd& solve_LDL(const MatrixNd& A, VectorNd& xb);
+
+    /// the maximum number of refinement iterations before falling back to double precision (default 30)
+    unsigned max_iterations;
+
+    /// the number of refinement iterations used by the last solve
+    unsigned iterations;
+
+    /// <b>true</b> if the last solve fell back to a double precision factorization
+    bool fallback;
+
+  private:
+    enum Factorization { eLU, eChol, eLDL };
+    void solve(Factorization f, const MatrixNd& A, unsigned nrhs, double* xb, unsigned ldb);
+    bool factor_single(Factorization f, const MatrixNd& A);
+    void solve_single(Factorization f, MatrixNf& XB);
+    void solve_double(Factorization f, const MatrixNd& A, unsigned nrhs, double* xb, unsigned ldb);
+
+    // single precision factorization and solution
+    MatrixNf _Af, _Xf;
+
+    // double precision right hand sides, residuals, and fallback factorization
+    MatrixNd _B, _R, _Ad;
+
+    // pivots
+    std::vector<int> _piv;
+}; // end class
+
+} // end namespace
+
+#endif
+
@@ -9,6 +9,7 @@
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/algorithm/minmax.hpp>
+#include <boost/random/mersenne_twister.hpp>
 #include <Ravelin/SingularException.h>
 #include <Ravelin/NumericalException.h>
 #include <Ravelin/NonsquareMatrixException.h>
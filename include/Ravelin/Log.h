@@ -1,6 +1,6 @@
 /****************************************************************************
  * Copyright 2015 Evan Drumwright
- * This library is distributed under the terms of the Apache V2.0 
+ * This library is distributed under the terms of the Apache V2.0
  * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
  ****************************************************************************/
 
@@ -9,9 +9,13 @@
 
 #include <iostream>
 #include <ctime>
+#include <cstddef>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <fstream>
+#include <string>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace Ravelin {
@@ -24,39 +28,176 @@ namespace Ravelin {
 #define LOGGING(level) ((level & Log<OutputToFile>::reporting_level) > 0)
 #endif
 
+/// A log message whose arguments are captured in binary form, to be formatted later
+/**
+ * Numbers, characters, and strings are copied into the record as they are;
+ * other types are formatted immediately (with a stream that is reused by the
+ * thread, so no stream is constructed per message). Numbers are also
+ * formatted immediately once a manipulator (e.g., std::setprecision) has
+ * changed the format of the message. Messages of up to INLINE_SIZE bytes
+ * require no memory allocation.
+ */
+class LogRecord
+{
+  public:
+    enum Tag { eText = 1, eBool, eChar, eInt, eUnsigned, eLong, eULong, eLongLong, eULongLong, eDouble };
+
+    /// The header of a record
+    struct Header
+    {
+      boost::uint32_t size;          // the size of the record, including the header
+      boost::uint32_t level;
+      boost::uint64_t sequence;      // the order in which the record was output
+      boost::int64_t time;           // seconds since the epoch
+    };
+
+    LogRecord() { _data = _inline; _capacity = INLINE_SIZE; _size = 0; _text = 0; _formatted = false; _default_format = true; }
+    ~LogRecord() { if (_data != _inline) delete [] _data; }
+    void start(unsigned level);
+    void append_text(const char* s, size_t n);
+
+    /// Gets the record, after setting its size and sequence number in the header
+    const char* finish(boost::uint64_t sequence)
+    {
+      boost::uint32_t size = _size;
+      std::memcpy(_data, &size, sizeof(size));
+      std::memcpy(_data + offsetof(Header, sequence), &sequence, sizeof(sequence));
+      return _data;
+    }
+
+    /// Gets the size of the record
+    size_t size() const { return _size; }
+
+    LogRecord& operator<<(bool x) { return capture(eBool, x); }
+    LogRecord& operator<<(char x) { return capture(eChar, x); }
+    LogRecord& operator<<(int x) { return capture(eInt, x); }
+    LogRecord& operator<<(unsigned x) { return capture(eUnsigned, x); }
+    LogRecord& operator<<(long x) { return capture(eLong, x); }
+    LogRecord& operator<<(unsigned long x) { return capture(eULong, x); }
+    LogRecord& operator<<(long long x) { return capture(eLongLong, x); }
+    LogRecord& operator<<(unsigned long long x) { return capture(eULongLong, x); }
+    LogRecord& operator<<(double x) { return capture(eDouble, x); }
+    LogRecord& operator<<(float x) { return capture(eDouble, (double) x); }
+    LogRecord& operator<<(const char* s) { append_text(s, std::strlen(s)); return *this; }
+    LogRecord& operator<<(const std::string& s) { append_text(s.data(), s.size()); return *this; }
+    LogRecord& operator<<(std::ostream& (*manip)(std::ostream&));
+    LogRecord& operator<<(std::ios_base& (*manip)(std::ios_base&));
+
+    /// Formats any other type immediately
+    template <class T>
+    LogRecord& operator<<(const T& x) { return format(x); }
+
+    /// The number of bytes that records hold without allocating memory
+    static const unsigned INLINE_SIZE = 512;
+
+  private:
+    LogRecord(const LogRecord&);
+    LogRecord& operator=(const LogRecord&);
+    std::ostream& begin_format();
+    void end_format(std::ostream& os);
+    void reserve(size_t n);
+
+    /// Formats a value with the thread's stream
+    template <class T>
+    LogRecord& format(const T& x)
+    {
+      std::ostream& os = begin_format();
+      os << x;
+      end_format(os);
+      return *this;
+    }
+
+    /// Copies a value into the record (or formats it, if the format has changed)
+    template <class T>
+    LogRecord& capture(Tag tag, T x)
+    {
+      if (!_default_format)
+        return format(x);
+      reserve(_size + 1 + sizeof(T));
+      _data[_size++] = (char) tag;
+      std::memcpy(_data + _size, &x, sizeof(T));
+      _size += sizeof(T);
+      _text = 0;
+      return *this;
+    }
+
+    char _inline[INLINE_SIZE];
+    char* _data;
+    size_t _capacity;
+    size_t _size;
+    size_t _text;                    // the offset of the length of the last text item, if it is the last item
+    bool _formatted;                 // whether the thread's stream has been used for this record
+    bool _default_format;            // whether the stream's format is the default
+    void* _previous;                 // the record that the thread's stream wrote to before this one
+}; // end class
+
+/// A log file, opened and closed by the user and written by the background flusher
+class LogFile
+{
+  friend struct OutputToFile;
+
+  public:
+    void open(const char* fname, std::ios_base::openmode mode = std::ios_base::out);
+    void open(const std::string& fname, std::ios_base::openmode mode = std::ios_base::out) { open(fname.c_str(), mode); }
+    void close();
+    bool is_open();
+
+  private:
+    std::ofstream _stream;
+}; // end class
+
+/// Writes log messages to a file (or to stderr, if no file is open) asynchronously
+/**
+ * Each thread copies its records into its own lock-free ring buffer; a
+ * background thread (started with the first message) formats the records,
+ * in the order in which they were output, and writes them. Logging thus
+ * performs no I/O, takes no locks, and reads the time from a cache updated
+ * by the background thread. A thread whose buffer is full writes the
+ * pending messages itself. Messages are written when the program exits,
+ * when the file is opened or closed, and when flush() is called.
+ *
+ * Messages are written in the order in which they were numbered; a message
+ * is held back while a message numbered before it is still being copied into
+ * its ring (messages longer than RING_SIZE, which are written directly, are
+ * the exception). Messages still in the rings when the process terminates
+ * abnormally (a crash, abort(), or _exit()) are lost, since only a normal
+ * exit writes them; call flush_fatal() on such paths to write them first.
+ */
 struct OutputToFile
 {
-  static std::ofstream stream;
+  static LogFile stream;
+
+  static void output(LogRecord& record);
+  static void flush();
+  static void flush_fatal();
 
-  static void output(const std::string& msg);
+  /// The size of the ring buffer of each thread, in bytes
+  static const unsigned RING_SIZE = 1 << 20;
 };
 
 template <typename OutputPolicy>
 class Log
 {
   public:
+    Log() { message_level = 0; }
 
-    std::ostringstream& get(unsigned level = 0)
+    LogRecord& get(unsigned level = 0)
     {
-      time_t rawtime;
-      std::time(&rawtime);
-      tm* ptm = std::gmtime(&rawtime);
-      os << "- " << ptm->tm_hour << ":" << ptm->tm_min << ":" << ptm->tm_sec;
-      os << " " << level << ": ";
       message_level = level;
-      return os;
+      record.start(level);
+      return record;
     }
 
     ~Log()
     {
       if ((message_level & reporting_level) > 0)
-        OutputPolicy::output(os.str()); 
+        OutputPolicy::output(record);
     }
 
     static unsigned reporting_level;
 
   private:
-    std::ostringstream os;
+    LogRecord record;
     unsigned message_level;
 }; // end class
 
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef MATRIX_FILE
+#error This class is not to be included by the user directly. Use MatrixFiled.h or MatrixFilef.h instead.
+#endif
+
+/// Reads and writes vectors and dense and sparse matrices in a binary format
+/**
+ * Each file holds one vector or matrix: a fixed-size header (object type,
+ * dimensions, storage type, leading dimension, number of nonzeros), the
+ * data in native byte order, and an optional checksum. Dense matrices are
+ * stored column-major with the leading dimension equal to the number of
+ * rows; sparse matrices are stored as their row (column, if CSC) pointers,
+ * indices, and nonzeros. Every array in the file is 8-byte aligned, so the
+ * readers can map the file into memory and return views of it without
+ * copying (the mapping is released when the last view of it is destroyed).
+ * The writers stream the data, so writing requires no additional memory.
+ */
+class MATRIX_FILE
+{
+  public:
+    enum ObjectType { eVector = 1, eDenseMatrix = 2, eSparseMatrix = 3 };
+    static bool write(std::ostream& out, const CONST_SHAREDVECTORN& v, bool checksum = false);
+    static bool write(std::ostream& out, const CONST_SHAREDMATRIXN& m, bool checksum = false);
+    static bool write(std::ostream& out, const SPARSEMATRIXN& m, bool checksum = false);
+    static bool write(const std::string& fname, const CONST_SHAREDVECTORN& v, bool checksum = false);
+    static bool write(const std::string& fname, const CONST_SHAREDMATRIXN& m, bool checksum = false);
+    static bool write(const std::string& fname, const SPARSEMATRIXN& m, bool checksum = false);
+    static bool read(const std::string& fname, CONST_SHAREDVECTORN& v, bool verify_checksum = true);
+    static bool read(const std::string& fname, CONST_SHAREDMATRIXN& m, bool verify_checksum = true);
+    static bool read(const std::string& fname, boost::shared_ptr<const SPARSEMATRIXN>& m, bool verify_checksum = true);
+
+    /// Writes a vector to a stream (see write(std::ostream&, const CONST_SHAREDVECTORN&, bool))
+    static bool write(std::ostream& out, const VECTORN& v, bool checksum = false) { return write(out, v.segment(0, v.size()), checksum); }
+
+    /// Writes a matrix to a stream (see write(std::ostream&, const CONST_SHAREDMATRIXN&, bool))
+    static bool write(std::ostream& out, const MATRIXN& m, bool checksum = false) { return write(out, m.block(0, m.rows(), 0, m.columns()), checksum); }
+
+    /// Writes a vector to a file (see write(std::ostream&, const CONST_SHAREDVECTORN&, bool))
+    static bool write(const std::string& fname, const VECTORN& v, bool checksum = false) { return write(fname, v.segment(0, v.size()), checksum); }
+
+    /// Writes a matrix to a file (see write(std::ostream&, const CONST_SHAREDMATRIXN&, bool))
+    static bool write(const std::string& fname, const MATRIXN& m, bool checksum = false) { return write(fname, m.block(0, m.rows(), 0, m.columns()), checksum); }
+
+    /// The version of the file format
+    static const unsigned VERSION = 1;
+
+  private:
+    /// The header of a file
+    struct Header
+    {
+      char magic[8];                 // "RAVELINM"
+      boost::uint32_t version;       // VERSION
+      boost::uint32_t byte_order;    // BYTE_ORDER_MARK, in native byte order
+      boost::uint32_t object;        // ObjectType
+      boost::uint32_t real_size;     // sizeof(REAL)
+      boost::uint32_t storage;       // StorageType (sparse matrices only)
+      boost::uint32_t has_checksum;  // whether a checksum follows the data
+      boost::uint32_t rows;
+      boost::uint32_t columns;
+      boost::uint32_t leading_dim;
+      boost::uint32_t nnz;
+      boost::uint64_t reserved[2];
+    };
+
+    /// A file mapped into memory, unmapped when the last view of it is gone
+    class MappedFile
+    {
+      public:
+        MappedFile(void* data, size_t size) { this->data = data; this->size = size; }
+        ~MappedFile();
+        void* data;
+        size_t size;
+    };
+
+    /// "Deletes" an array in a mapped file by releasing its reference to the mapping
+    template <class T>
+    class MappedArrayDeleter
+    {
+      public:
+        MappedArrayDeleter(boost::shared_ptr<MappedFile> file) : _file(file) { }
+        void operator()(T*) { _file.reset(); }
+
+      private:
+        boost::shared_ptr<MappedFile> _file;
+    };
+
+    /// A checksum (64-bit FNV-1a over 64-bit words) of data that may arrive in pieces of any size
+    class Checksum
+    {
+      public:
+        Checksum() { _value = 14695981039346656037ULL; _npartial = 0; }
+        void update(const void* data, size_t nbytes);
+        boost::uint64_t value() const { return _value; }
+
+      private:
+        boost::uint64_t _value;
+        char _partial[8];
+        unsigned _npartial;
+    };
+
+    static const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static boost::uint64_t padded(boost::uint64_t nbytes) { return (nbytes + 7) & ~((boost::uint64_t) 7); }
+    static void init_header(Header& header, ObjectType object, unsigned rows, unsigned columns, unsigned nnz, bool checksum);
+    static void write_data(std::ostream& out, const void* data, size_t nbytes, Checksum* checksum);
+    static void write_padding(std::ostream& out, size_t nbytes, Checksum* checksum);
+    static bool finish(std::ostream& out, const Checksum* checksum);
+    static boost::shared_ptr<MappedFile> map(const std::string& fname, ObjectType object, bool verify_checksum, const Header*& header, const char*& payload);
+}; // end class
+
@@ -0,0 +1,30 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _MATRIX_FILEF_H
+#define _MATRIX_FILEF_H
+
+#include <iostream>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/shared_array.hpp>
+#include <Ravelin/VectorNf.h>
+#include <Ravelin/MatrixNf.h>
+#include <Ravelin/SharedVectorNf.h>
+#include <Ravelin/SharedMatrixNf.h>
+#include <Ravelin/SparseMatrixNf.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "MatrixFile.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -0,0 +1,41 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_NUMBER_PARSER_H_
+#define _RAVELIN_NUMBER_PARSER_H_
+
+namespace Ravelin {
+
+/// Parses real numbers from text, independently of the current locale
+/**
+ * Numbers are separated by any combination of whitespace, commas, and
+ * semicolons (callers that give semicolons a meaning, like the row
+ * separators of a matrix, pass ranges that stop at them). Decimal numbers
+ * with at most 19 significant digits and small exponents, which covers
+ * nearly all of the numbers written by hand or by XMLAttrib, are converted
+ * in a single pass without allocating memory; the result is correctly
+ * rounded, so values written with enough digits read back exactly. Other
+ * numbers (including "inf", "nan", and hexadecimal numbers) are converted
+ * by strtod()/strtof() in the "C" locale. As with atof(), a token that is not
+ * a number is read as zero.
+ */
+class NumberParser
+{
+  public:
+    static const char* parse_real(const char* s, const char* end, double& value);
+    static const char* parse_real(const char* s, const char* end, float& value);
+    static unsigned parse_reals(const char* s, const char* end, double* values, unsigned n);
+    static unsigned parse_reals(const char* s, const char* end, float* values, unsigned n);
+    static unsigned count_reals(const char* s, const char* end);
+
+    /// Determines whether the given character separates numbers
+    static bool is_delimiter(char c) { return c == ' ' || c == ',' || c == ';' || c == '\t' || c == '\n' || c == '\r'; }
+}; // end class
+
+} // end namespace
+
+#endif
+
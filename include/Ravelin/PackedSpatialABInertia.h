@@ -0,0 +1,74 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef PACKED_SPATIAL_AB_INERTIA
+#error This class is not to be included by the user directly. Use PackedSpatialABInertiad.h or PackedSpatialABInertiaf.h instead.
+#endif
+
+/// A spatial articulated body inertia stored in packed symmetric form
+/**
+ * The spatial AB inertia | H' M |  (see SPATIAL_AB_INERTIA) is symmetric
+ *                        | J  H |
+ * once its rows are reordered to | J  H |, so it has only 21 unique
+ *                                | H' M |
+ * entries: the upper triangles of the symmetric matrices M and J (six
+ * entries each) and the full matrix H (nine entries). The kernels below
+ * (congruence transformation, rank-k update, accumulation) compute only
+ * these entries and write directly into the packed storage, which makes
+ * this form suitable for the backward pass of the articulated body
+ * algorithm. Use to_ab_inertia() to get a SPATIAL_AB_INERTIA for the other
+ * operations (e.g., inverse_mult()).
+ */
+class PACKED_SPATIAL_AB_INERTIA
+{
+  public:
+    PACKED_SPATIAL_AB_INERTIA(FRAME_PTR pose = FRAME_PTR());
+    PACKED_SPATIAL_AB_INERTIA(const PACKED_SPATIAL_AB_INERTIA& source) { operator=(source); }
+    explicit PACKED_SPATIAL_AB_INERTIA(const SPATIAL_AB_INERTIA& source) { operator=(source); }
+    explicit PACKED_SPATIAL_AB_INERTIA(const SPATIAL_RB_INERTIA& source) { operator=(source); }
+    void set_zero();
+    PACKED_SPATIAL_AB_INERTIA& operator=(const PACKED_SPATIAL_AB_INERTIA& source);
+    PACKED_SPATIAL_AB_INERTIA& operator=(const SPATIAL_AB_INERTIA& source);
+    PACKED_SPATIAL_AB_INERTIA& operator=(const SPATIAL_RB_INERTIA& source);
+    PACKED_SPATIAL_AB_INERTIA& operator+=(const PACKED_SPATIAL_AB_INERTIA& m);
+    PACKED_SPATIAL_AB_INERTIA& operator-=(const PACKED_SPATIAL_AB_INERTIA& m);
+    PACKED_SPATIAL_AB_INERTIA& operator*=(REAL scalar);
+    PACKED_SPATIAL_AB_INERTIA& add_transformed(const PACKED_SPATIAL_AB_INERTIA& m);
+    PACKED_SPATIAL_AB_INERTIA& rank_update(const SMOMENTUM& u, REAL dinv);
+    PACKED_SPATIAL_AB_INERTIA& rank_update(const std::vector<SMOMENTUM>& U, const MATRIXN& W);
+    PACKED_SPATIAL_AB_INERTIA& transform(const TRANSFORM3& T, PACKED_SPATIAL_AB_INERTIA& result) const;
+    static PACKED_SPATIAL_AB_INERTIA transform(FRAME_PTR target, const PACKED_SPATIAL_AB_INERTIA& m);
+    SPATIAL_AB_INERTIA& to_ab_inertia(SPATIAL_AB_INERTIA& I) const;
+    SPATIAL_AB_INERTIA to_ab_inertia() const { SPATIAL_AB_INERTIA I; return to_ab_inertia(I); }
+    SFORCE operator*(const SACCEL& s) const { return mult(s); }
+    SFORCE mult(const SACCEL& s) const;
+    std::vector<SFORCE>& mult(const std::vector<SACCEL>& s, std::vector<SFORCE>& result) const;
+    SMOMENTUM operator*(const SVELOCITY& s) const { return mult(s); }
+    SMOMENTUM mult(const SVELOCITY& s) const;
+    std::vector<SMOMENTUM>& mult(const std::vector<SVELOCITY>& s, std::vector<SMOMENTUM>& result) const;
+
+    /// Gets the packed data: upper triangle of M (xx, xy, xz, yy, yz, zz), upper triangle of J (same order), then H (column-major)
+    REAL* data() { return _data; }
+
+    /// Gets the packed data: upper triangle of M (xx, xy, xz, yy, yz, zz), upper triangle of J (same order), then H (column-major)
+    const REAL* data() const { return _data; }
+
+    /// The number of unique entries in the inertia
+    static const unsigned PACKED_SIZE = 21;
+
+    /// The pose that this inertia is defined in
+    FRAME_PTR pose;
+
+  private:
+    void mult_spatial(const SVECTOR6& v, SVECTOR6& result) const;
+    static void transform_packed(const TRANSFORM3& T, const REAL* src, REAL* dest, bool accumulate);
+
+    /// The packed entries (M, J, H)
+    REAL _data[PACKED_SIZE];
+}; // end class
+
+std::ostream& operator<<(std::ostream& out, const PACKED_SPATIAL_AB_INERTIA& m);
+
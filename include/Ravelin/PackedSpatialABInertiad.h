@@ -0,0 +1,31 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _PACKED_SPATIAL_AB_INERTIAD_H
+#define _PACKED_SPATIAL_AB_INERTIAD_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/SForced.h>
+#include <Ravelin/SMomentumd.h>
+#include <Ravelin/SAcceld.h>
+#include <Ravelin/SVelocityd.h>
+#include <Ravelin/SpatialRBInertiad.h>
+#include <Ravelin/SpatialABInertiad.h>
+#include <Ravelin/Transform3d.h>
+#include <Ravelin/Pose3d.h>
+#include <Ravelin/MatrixNd.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "PackedSpatialABInertia.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
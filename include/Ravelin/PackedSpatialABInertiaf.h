@@ -0,0 +1,31 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _PACKED_SPATIAL_AB_INERTIAF_H
+#define _PACKED_SPATIAL_AB_INERTIAF_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/SForcef.h>
+#include <Ravelin/SMomentumf.h>
+#include <Ravelin/SAccelf.h>
+#include <Ravelin/SVelocityf.h>
+#include <Ravelin/SpatialRBInertiaf.h>
+#include <Ravelin/SpatialABInertiaf.h>
+#include <Ravelin/Transform3f.h>
+#include <Ravelin/Pose3f.h>
+#include <Ravelin/MatrixNf.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "PackedSpatialABInertia.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -24,6 +24,9 @@ class PLANARJOINT : public virtual JOINT
     virtual const std::vector<SVELOCITY>& get_spatial_axes_dot() { return _s_dot; }
 
   protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
+
     void update_offset();
 
     /// Vectors orthogonal to the normal vector in the outboard link frame
@@ -34,31 +34,31 @@ class POSE3 : public boost::enable_shared_from_this<POSE3>
     VECTOR3 transform_vector(const VECTOR3& p) const { return transform_vector(rpose, p); }
     VECTOR3 inverse_transform_point(const VECTOR3& p) const;
     VECTOR3 inverse_transform_vector(const VECTOR3& v) const;
-    static VECTOR3 transform_point(boost::shared_ptr<const POSE3> target, const VECTOR3& v);
-    static VECTOR3 transform_vector(boost::shared_ptr<const POSE3> target, const VECTOR3& v);
+    static VECTOR3 transform_point(FRAME_PTR target, const VECTOR3& v);
+    static VECTOR3 transform_vector(FRAME_PTR target, const VECTOR3& v);
     SFORCE transform(const SFORCE& w) const;
     SFORCE inverse_transform(const SFORCE& w) const;
-    static SFORCE transform(boost::shared_ptr<const POSE3> target, const SFORCE& w);
-    static std::vector<SFORCE>& transform(boost::shared_ptr<const POSE3> target, const std::vector<SFORCE>& w, std::vector<SFORCE>& result);
+    static SFORCE transform(FRAME_PTR target, const SFORCE& w);
+    static std::vector<SFORCE>& transform(FRAME_PTR target, const std::vector<SFORCE>& w, std::vector<SFORCE>& result);
     SMOMENTUM transform(const SMOMENTUM& t) const;
     SMOMENTUM inverse_transform(const SMOMENTUM& t) const;
     SVELOCITY transform(const SVELOCITY& t) const;
     SVELOCITY inverse_transform(const SVELOCITY& t) const;
-    static SMOMENTUM transform(boost::shared_ptr<const POSE3> target, const SMOMENTUM& t);
-    static SVELOCITY transform(boost::shared_ptr<const POSE3> target, const SVELOCITY& t);
-    static std::vector<SVELOCITY>& transform(boost::shared_ptr<const POSE3> target, const std::vector<SVELOCITY>& t, std::vector<SVELOCITY>& result);
-    static std::vector<SMOMENTUM>& transform(boost::shared_ptr<const POSE3> target, const std::vector<SMOMENTUM>& t, std::vector<SMOMENTUM>& result);
+    static SMOMENTUM transform(FRAME_PTR target, const SMOMENTUM& t);
+    static SVELOCITY transform(FRAME_PTR target, const SVELOCITY& t);
+    static std::vector<SVELOCITY>& transform(FRAME_PTR target, const std::vector<SVELOCITY>& t, std::vector<SVELOCITY>& result);
+    static std::vector<SMOMENTUM>& transform(FRAME_PTR target, const std::vector<SMOMENTUM>& t, std::vector<SMOMENTUM>& result);
     SACCEL transform(const SACCEL& t) const;
     SACCEL inverse_transform(const SACCEL& t) const;
-    static SACCEL transform(boost::shared_ptr<const POSE3> target, const SACCEL& t);
-    static std::vector<SACCEL>& transform(boost::shared_ptr<const POSE3> target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result);
+    static SACCEL transform(FRAME_PTR target, const SACCEL& t);
+    static std::vector<SACCEL>& transform(FRAME_PTR target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result);
     SPATIAL_RB_INERTIA transform(const SPATIAL_RB_INERTIA& j) const { return transform(rpose, j); }
     SPATIAL_RB_INERTIA inverse_transform(const SPATIAL_RB_INERTIA& j) const;
-    static SPATIAL_RB_INERTIA transform(boost::shared_ptr<const POSE3> target, const SPATIAL_RB_INERTIA& j);
+    static SPATIAL_RB_INERTIA transform(FRAME_PTR target, const SPATIAL_RB_INERTIA& j);
     SPATIAL_AB_INERTIA transform(const SPATIAL_AB_INERTIA& j) const { return transform(rpose, j); }
     SPATIAL_AB_INERTIA inverse_transform(const SPATIAL_AB_INERTIA& j) const;
-    static SPATIAL_AB_INERTIA transform(boost::shared_ptr<const POSE3> target, const SPATIAL_AB_INERTIA& j);
-    static TRANSFORM3 calc_relative_pose(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target) { return calc_transform(source, target); }
+    static SPATIAL_AB_INERTIA transform(FRAME_PTR target, const SPATIAL_AB_INERTIA& j);
+    static TRANSFORM3 calc_relative_pose(FRAME_PTR source, FRAME_PTR target) { return calc_transform(source, target); }
     VECTOR3 qG_mult(REAL qdw, REAL qdx, REAL qdy, REAL qdz) const;
     QUAT qG_transpose_mult(const VECTOR3& omega) const;
     POSE3& set_identity();
@@ -81,7 +81,7 @@ class POSE3 : public boost::enable_shared_from_this<POSE3>
 
     /// Computes a 6x6 matrix that transforms velocity vectors in [w; v] format or force vectors in [f; tau] format
     template <class M>
-    static M& spatial_transform_to_matrix(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target, M& m)
+    static M& spatial_transform_to_matrix(FRAME_PTR source, FRAME_PTR target, M& m)
     {
       const unsigned SPATIAL_DIM = 6;
       m.resize(SPATIAL_DIM, SPATIAL_DIM);
@@ -98,7 +98,7 @@ class POSE3 : public boost::enable_shared_from_this<POSE3>
 
     /// Computes a 6x6 matrix that transforms velocity vectors in [v w] format 
     template <class M>
-    static M& spatial_transform_to_matrix2(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target, M& m)
+    static M& spatial_transform_to_matrix2(FRAME_PTR source, FRAME_PTR target, M& m)
     {
       const unsigned SPATIAL_DIM = 6;
       m.resize(SPATIAL_DIM, SPATIAL_DIM);
@@ -115,7 +115,7 @@ class POSE3 : public boost::enable_shared_from_this<POSE3>
 
     /// Computes the time derivative of a 6x6 matrix that transforms velocity vectors in [v w] format 
     template <class M>
-    static M& dot_spatial_transform_to_matrix2(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target, M& m)
+    static M& dot_spatial_transform_to_matrix2(FRAME_PTR source, FRAME_PTR target, M& m)
     {
       const unsigned SPATIAL_DIM = 6;
       m.resize(SPATIAL_DIM, SPATIAL_DIM);
@@ -140,13 +140,13 @@ class POSE3 : public boost::enable_shared_from_this<POSE3>
     boost::shared_ptr<const POSE3> rpose; 
 
   private:
-    static void transform_spatial(boost::shared_ptr<const POSE3> target, const SVECTOR6& v, SVECTOR6& result);
-    static void transform_spatial(boost::shared_ptr<const POSE3> target, const SVECTOR6& v, const VECTOR3& rv, const MATRIX3& E, SVECTOR6& result);
+    static void transform_spatial(FRAME_PTR target, const SVECTOR6& v, SVECTOR6& result);
+    static void transform_spatial(FRAME_PTR target, const SVECTOR6& v, const VECTOR3& rv, const MATRIX3& E, SVECTOR6& result);
     void get_r_E(VECTOR3& r, MATRIX3& E, bool inverse) const;
     static void get_r_E(const TRANSFORM3& T, VECTOR3& r, MATRIX3& E);
-    TRANSFORM3 calc_transform(boost::shared_ptr<const POSE3> p) const { return calc_transform(shared_from_this(), p); }
-    static TRANSFORM3 calc_transform(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target);
-    static bool is_common(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> p, unsigned& i);
+    TRANSFORM3 calc_transform(FRAME_PTR p) const { return calc_transform(shared_from_this(), p); }
+    static TRANSFORM3 calc_transform(FRAME_PTR source, FRAME_PTR target);
+    static bool is_common(const POSE3* source, const POSE3* p, unsigned& i);
 }; // end class
 
 std::ostream& operator<<(std::ostream& out, const POSE3& m);
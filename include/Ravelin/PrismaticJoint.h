@@ -27,6 +27,8 @@ class PRISMATICJOINT : public virtual JOINT
     virtual bool is_singular_config() const { return false; }
 
   protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
 
     /// The axis of the joint (inboard pose frame)
     VECTOR3 _u;
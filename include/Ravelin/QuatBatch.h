@@ -0,0 +1,57 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef QUAT_BATCH
+#error This class is not to be included by the user directly. Use QuatBatchd.h or QuatBatchf.h instead.
+#endif
+
+/// Quaternion and rotation operations on arrays of quaternions and points
+/**
+ * Quaternions are stored as a structure of arrays: a buffer of n
+ * quaternions with leading dimension ld (ld >= n) holds the x, y, z, and w
+ * components of quaternion i at q[i], q[ld+i], q[2*ld+i], and q[3*ld+i].
+ * This is the layout of a column-major n x 4 matrix, so an n x 4 MATRIXN
+ * can be passed as (Q.data(), Q.leading_dim()) (see pack() and unpack()).
+ * Points (n x 3) and rotation matrices (n x 9, with the entries of each
+ * matrix in the column-major order of MATRIX3::data()) are stored in the
+ * same way. Outputs may overwrite inputs that have the same leading
+ * dimension.
+ *
+ * The operations process 2 to 16 quaternions per instruction, depending on
+ * the scalar type and the instruction sets (AVX2, AVX-512) that the
+ * processor supports; the widest available instruction set is selected at
+ * run time. Single precision normalization uses the hardware reciprocal
+ * square root estimate refined by one Newton step (a relative error of a
+ * few ulps), so results may differ from those of QUAT::normalize() in the
+ * last bits.
+ */
+class QUAT_BATCH
+{
+  public:
+    static void pack(const std::vector<QUAT>& q, MATRIXN& Q);
+    static void unpack(const MATRIXN& Q, std::vector<QUAT>& q);
+    static void mult(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL* r, unsigned ldr);
+    static void mult(const QUAT& a, unsigned n, const REAL* b, unsigned ldb, REAL* r, unsigned ldr);
+    static void rotate(unsigned n, const REAL* q, unsigned ldq, const REAL* p, unsigned ldp, REAL* r, unsigned ldr);
+    static void rotate(const QUAT& q, unsigned n, const REAL* p, unsigned ldp, REAL* r, unsigned ldr);
+    static void normalize(unsigned n, REAL* q, unsigned ldq);
+    static void nlerp(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL alpha, REAL* r, unsigned ldr);
+    static void slerp(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL alpha, REAL* r, unsigned ldr);
+    static void deriv(unsigned n, const REAL* q, unsigned ldq, const REAL* w, unsigned ldw, REAL* qd, unsigned ldqd);
+    static void to_matrix(unsigned n, const REAL* q, unsigned ldq, REAL* R, unsigned ldr);
+    static void from_axis_angle(unsigned n, const REAL* axis, unsigned lda, const REAL* angle, REAL* q, unsigned ldq);
+
+    /// Gets the largest angle (in radians) by which the rotation computed by nlerp() can differ from that computed by slerp()
+    /**
+     * \param theta the angle of the rotation between the two orientations
+     *        (0 <= theta <= pi)
+     */
+    static REAL nlerp_error(REAL theta) { return theta*theta*theta/(REAL) 200.0; }
+
+  private:
+    static void check_ld(unsigned n, unsigned ld);
+}; // end class
+
@@ -0,0 +1,23 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _QUATBATCHD_H
+#define _QUATBATCHD_H
+
+#include <vector>
+#include <Ravelin/Quatd.h>
+#include <Ravelin/MatrixNd.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "QuatBatch.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -0,0 +1,23 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _QUATBATCHF_H
+#define _QUATBATCHF_H
+
+#include <vector>
+#include <Ravelin/Quatf.h>
+#include <Ravelin/MatrixNf.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "QuatBatch.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -111,6 +111,14 @@ class RC_ARTICULATED_BODY : public virtual ARTICULATED_BODY
     /// Gets the vector of explicit joint constraints
     virtual const std::vector<boost::shared_ptr<JOINT> >& get_implicit_joints() const { return _ijoints; }
 
+    boost::shared_ptr<RC_ARTICULATED_BODY> clone() const;
+    bool save_compiled(const std::string& fname, boost::uint64_t source_hash = 0) const;
+    static boost::shared_ptr<RC_ARTICULATED_BODY> load_compiled(const std::string& fname, boost::uint64_t source_hash = 0);
+    static boost::uint64_t calc_file_hash(const std::string& fname);
+
+    /// The version of the compiled model format written by save_compiled()
+    static const unsigned COMPILED_VERSION = 2;
+
   protected:
     /// Whether this body uses a floating base
     bool _floating_base;
@@ -140,6 +148,42 @@ class RC_ARTICULATED_BODY : public virtual ARTICULATED_BODY
 
 
   private:
+    enum CompiledJointType { eCompiledFixed, eCompiledRevolute, eCompiledPrismatic };
+
+    /// The header of a compiled model file (see save_compiled())
+    class CompiledHeader
+    {
+      public:
+        char magic[8];
+        boost::uint32_t version, real_size, nlinks, njoints;
+        boost::uint32_t algorithm, rftype, body_id_size, reserved;
+        boost::uint64_t source_hash, strings_size;
+    };
+
+    /// A link record of a compiled model file
+    class CompiledLink
+    {
+      public:
+        boost::uint32_t id_offset, id_size, enabled, inner_joint;
+        REAL x[3], q[4];                // pose relative to the inner joint (global for the base) 
+        REAL m, h[3], J[9];             // inertia in the link pose
+        REAL xd[6];                     // velocity in the link pose (base only) 
+    };
+
+    /// A joint record of a compiled model file
+    class CompiledJoint
+    {
+      public:
+        boost::uint32_t id_offset, id_size, type, implicit;
+        boost::uint32_t inboard, outboard, order, ndof;
+        REAL F[7], Fb[7];               // joint pose relative to the inboard and outboard link poses (x, q)
+        REAL axis[3];                   // joint axis in the joint pose
+        REAL q_tare[6], q[6], qd[6];
+    };
+
+    bool write_compiled(std::string& data, boost::uint64_t source_hash) const;
+    void attach_joints(const std::vector<boost::shared_ptr<JOINT> >& joints);
+    static bool read_compiled(const char* data, size_t size, boost::uint64_t source_hash, boost::shared_ptr<RC_ARTICULATED_BODY> body);
     RC_ARTICULATED_BODY(const RC_ARTICULATED_BODY& rcab) {}
     virtual MATRIXN& calc_jacobian_column(boost::shared_ptr<JOINT> joint, const VECTOR3& point, MATRIXN& Jc);
 /*
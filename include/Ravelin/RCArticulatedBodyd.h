@@ -10,8 +10,10 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
 #include <pthread.h>
+#include <boost/cstdint.hpp>
 #include <map>
 #include <list>
+#include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <Ravelin/Vector3d.h>
@@ -27,6 +27,8 @@ class REVOLUTEJOINT : public virtual JOINT
     virtual bool is_singular_config() const { return false; }
 
   protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
 
     /// The joint axis (defined in inner relative pose coordinates)
     VECTOR3 _u;
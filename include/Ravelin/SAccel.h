@@ -15,34 +15,39 @@ class SACCEL : public SVECTOR6
 {
   public:
     /// Constructs a acceleration with zero linear and zero angular components
-    SACCEL(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(pose) {}
+    SACCEL(FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(pose) {}
 
     /// Constructs a acceleration with zero linear and zero angular components
     SACCEL(boost::shared_ptr<POSE3> pose) : SVECTOR6(pose) {}
 
+    #ifdef RAVELIN_FRAME_HANDLES
+    /// Constructs a spatial acceleration with zero components (avoids ambiguity with the SVECTOR6 conversion)
+    SACCEL(boost::shared_ptr<const POSE3> pose) : SVECTOR6(pose) {}
+    #endif
+
     /// Constructs a acceleration from a SVector6
     explicit SACCEL(const SVECTOR6& v) : SVECTOR6(v.get_upper(), v.get_lower(), v.pose) {} 
 
     /// Constructs a acceleration from six values (first three angualr, next three linear) and a pose
-    SACCEL(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
+    SACCEL(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
 
     /// Constructs a acceleration from six values (first three angualr, next three linear) and a pose
     SACCEL(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, boost::shared_ptr<POSE3> pose) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
 
     /// Constructs a acceleration from six values (first three angular, next three linear) and a pose
-    SACCEL(const REAL* array, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
+    SACCEL(const REAL* array, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a acceleration from six values (first three angular, next three linear) and a pose
     SACCEL(const REAL* array, boost::shared_ptr<POSE3> pose) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a acceleration from linear and angular components and a pose
-    SACCEL(const VECTOR3& angular, const VECTOR3& linear, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(angular, linear, pose) {}
+    SACCEL(const VECTOR3& angular, const VECTOR3& linear, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(angular, linear, pose) {}
 
     /// Constructs a acceleration from linear and angular components and a pose
     SACCEL(const VECTOR3& angular, const VECTOR3& linear, boost::shared_ptr<POSE3> pose) : SVECTOR6(angular, linear, pose) {}
 
     /// Returns a zero acceleration
-    static SACCEL zero(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { SACCEL t(pose); t.set_zero(); return t; }
+    static SACCEL zero(FRAME_PTR pose = FRAME_PTR()) { SACCEL t(pose); t.set_zero(); return t; }
 
     /// Returns a zero acceleration
     static SACCEL zero(boost::shared_ptr<POSE3> pose) { SACCEL t(pose); t.set_zero(); return t; }
@@ -60,7 +65,7 @@ class SACCEL : public SVECTOR6
     }
 
     template <class V>
-    static SACCEL from_vector(const V& v, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>())
+    static SACCEL from_vector(const V& v, FRAME_PTR pose = FRAME_PTR())
     {
       const unsigned SPATIAL_DIM = 6;
       if (v.size() != SPATIAL_DIM)
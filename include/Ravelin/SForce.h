@@ -17,40 +17,45 @@ class SFORCE : public SVECTOR6
 
   public:
     /// Constructs a spatial force with zero force and torque components
-    SFORCE(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(pose) {} 
+    SFORCE(FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(pose) {} 
 
     /// Constructs a spatial force with zero force and torque components
     SFORCE(boost::shared_ptr<POSE3> pose) : SVECTOR6(pose) {} 
 
+    #ifdef RAVELIN_FRAME_HANDLES
+    /// Constructs a spatial force with zero components (avoids ambiguity with the SVECTOR6 conversion)
+    SFORCE(boost::shared_ptr<const POSE3> pose) : SVECTOR6(pose) {}
+    #endif
+
     /// Constructs a spatial force from the SVector6 
     explicit SFORCE(const SVECTOR6& w) : SVECTOR6(w.get_upper(), w.get_lower(), w.pose) { }
 
     /// Constructs a spatial force using six values- first three force, second three torque- and a pose
-    SFORCE(REAL fx, REAL fy, REAL fz, REAL tx, REAL ty, REAL tz, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(fx, fy, fz, tx, ty, tz, pose) {};
+    SFORCE(REAL fx, REAL fy, REAL fz, REAL tx, REAL ty, REAL tz, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(fx, fy, fz, tx, ty, tz, pose) {};
 
     /// Constructs a spatial force using six values- first three force, second three torque- and a pose
     SFORCE(REAL fx, REAL fy, REAL fz, REAL tx, REAL ty, REAL tz, boost::shared_ptr<POSE3> pose) : SVECTOR6(fx, fy, fz, tx, ty, tz, pose) {};
 
     /// Constructs a spatial force using six values- first three force, second three torque0 and a pose
-    SFORCE(const REAL* array, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
+    SFORCE(const REAL* array, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a spatial force using six values- first three force, second three torque0 and a pose
     SFORCE(const REAL* array, boost::shared_ptr<POSE3> pose) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a spatial force using given force and torque and pose
-    SFORCE(const VECTOR3& f, const VECTOR3& t, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(f, t, pose) {}
+    SFORCE(const VECTOR3& f, const VECTOR3& t, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(f, t, pose) {}
 
     /// Constructs a spatial force using given force and torque and pose
     SFORCE(const VECTOR3& f, const VECTOR3& t, boost::shared_ptr<POSE3> pose) : SVECTOR6(f, t, pose) {}
 
     /// Constructs a zero spatial force
-    static SFORCE zero(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { SFORCE w(pose); w.set_zero(); return w; }
+    static SFORCE zero(FRAME_PTR pose = FRAME_PTR()) { SFORCE w(pose); w.set_zero(); return w; }
 
     /// Constructs a zero spatial force
     static SFORCE zero(boost::shared_ptr<POSE3> pose) { SFORCE w(pose); w.set_zero(); return w; }
 
     template <class V>
-    static SFORCE from_vector(const V& v, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>())
+    static SFORCE from_vector(const V& v, FRAME_PTR pose = FRAME_PTR())
     {
       const unsigned SPATIAL_DIM = 6;
       if (v.size() != SPATIAL_DIM)
@@ -23,22 +23,25 @@ class SVECTOR6
 {
   public:
     SVECTOR6();
-    SVECTOR6(boost::shared_ptr<const POSE3> pose); 
+    SVECTOR6(FRAME_PTR pose); 
     SVECTOR6(boost::shared_ptr<POSE3> pose); 
+    #ifdef RAVELIN_FRAME_HANDLES
+    SVECTOR6(boost::shared_ptr<const POSE3> pose) { std::fill_n(_data, 6, (REAL) 0.0); this->pose = pose; }
+    #endif
     SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c);
-    SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c, boost::shared_ptr<const POSE3> pose);
+    SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c, FRAME_PTR pose);
     SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c, boost::shared_ptr<POSE3> pose);
     SVECTOR6(const REAL* array);
-    SVECTOR6(const REAL* array, boost::shared_ptr<const POSE3> pose);
+    SVECTOR6(const REAL* array, FRAME_PTR pose);
     SVECTOR6(const REAL* array, boost::shared_ptr<POSE3> pose);
     SVECTOR6(const VECTOR3& upper, const VECTOR3& lower);
-    SVECTOR6(const VECTOR3& upper, const VECTOR3& lower, boost::shared_ptr<const POSE3> pose);
+    SVECTOR6(const VECTOR3& upper, const VECTOR3& lower, FRAME_PTR pose);
     SVECTOR6(const VECTOR3& upper, const VECTOR3& lower, boost::shared_ptr<POSE3> pose);
     unsigned size() const { return 6; }
-    static SVECTOR6 zero(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { return SVECTOR6(0,0,0,0,0,0, pose); }
+    static SVECTOR6 zero(FRAME_PTR pose = FRAME_PTR()) { return SVECTOR6(0,0,0,0,0,0, pose); }
     static SVECTOR6 zero(boost::shared_ptr<POSE3> pose = boost::shared_ptr<POSE3>()) { return SVECTOR6(0,0,0,0,0,0, pose); }
     SVECTOR6& set_zero() { std::fill_n(_data, 6, (REAL) 0.0); return *this; }
-    SVECTOR6& set_zero(boost::shared_ptr<const POSE3> pose) { std::fill_n(_data, 6, (REAL) 0.0); this->pose = pose; return *this; }
+    SVECTOR6& set_zero(FRAME_PTR pose) { std::fill_n(_data, 6, (REAL) 0.0); this->pose = pose; return *this; }
     void set_lower(const VECTOR3& lower);
     void set_upper(const VECTOR3& upper);
     VECTOR3 get_lower() const;
@@ -93,10 +96,10 @@ class SVECTOR6
 */
 
     /// The frame that this vector is defined in
-    boost::shared_ptr<const POSE3> pose;
+    FRAME_PTR pose;
 
     template <class V>
-    static SVECTOR6 from_vector(const V& v, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>())
+    static SVECTOR6 from_vector(const V& v, FRAME_PTR pose = FRAME_PTR())
     {
       const unsigned SPATIAL_DIM = 6;
       if (v.size() != SPATIAL_DIM)
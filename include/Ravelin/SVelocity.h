@@ -16,34 +16,39 @@ class SVELOCITY : public SVECTOR6
 {
   public:
     /// Constructs a velocity with zero linear and zero angular components
-    SVELOCITY(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(pose) {}
+    SVELOCITY(FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(pose) {}
 
     /// Constructs a velocity with zero linear and zero angular components
     SVELOCITY(boost::shared_ptr<POSE3> pose) : SVECTOR6(pose) {}
 
+    #ifdef RAVELIN_FRAME_HANDLES
+    /// Constructs a spatial velocity with zero components (avoids ambiguity with the SVECTOR6 conversion)
+    SVELOCITY(boost::shared_ptr<const POSE3> pose) : SVECTOR6(pose) {}
+    #endif
+
     /// Constructs a velocity from a SVector6
     explicit SVELOCITY(const SVECTOR6& v) : SVECTOR6(v.get_upper(), v.get_lower(), v.pose) {} 
 
     /// Constructs a velocity from six values (first three linear, next three angular) and a pose
-    SVELOCITY(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
+    SVELOCITY(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
 
     /// Constructs a velocity from six values (first three linear, next three angular) and a pose
     SVELOCITY(REAL ax, REAL ay, REAL az, REAL lx, REAL ly, REAL lz, boost::shared_ptr<POSE3> pose) : SVECTOR6(ax, ay, az, lx, ly, lz, pose) {};
 
     /// Constructs a velocity from six values (first three angular, next three linear) and a pose
-    SVELOCITY(const REAL* array, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
+    SVELOCITY(const REAL* array, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a velocity from six values (first three angular, next three linear) and a pose
     SVELOCITY(const REAL* array, boost::shared_ptr<POSE3> pose) : SVECTOR6(array[0], array[1], array[2], array[3], array[4], array[5], pose) {}
 
     /// Constructs a velocity from linear and angular components and a pose
-    SVELOCITY(const VECTOR3& angular, const VECTOR3& linear, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) : SVECTOR6(angular, linear, pose) {}
+    SVELOCITY(const VECTOR3& angular, const VECTOR3& linear, FRAME_PTR pose = FRAME_PTR()) : SVECTOR6(angular, linear, pose) {}
 
     /// Constructs a velocity from linear and angular components and a pose
     SVELOCITY(const VECTOR3& angular, const VECTOR3& linear, boost::shared_ptr<POSE3> pose) : SVECTOR6(angular, linear, pose) {}
 
     /// Returns a zero velocity
-    static SVELOCITY zero(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { SVELOCITY t(pose); t.set_zero(); return t; }
+    static SVELOCITY zero(FRAME_PTR pose = FRAME_PTR()) { SVELOCITY t(pose); t.set_zero(); return t; }
 
     /// Returns a zero velocity
     static SVELOCITY zero(boost::shared_ptr<POSE3> pose) { SVELOCITY t(pose); t.set_zero(); return t; }
@@ -61,7 +66,7 @@ class SVELOCITY : public SVECTOR6
     }
 
     template <class V>
-    static SVELOCITY from_vector(const V& v, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>())
+    static SVELOCITY from_vector(const V& v, FRAME_PTR pose = FRAME_PTR())
     {
       const unsigned SPATIAL_DIM = 6;
       if (v.size() != SPATIAL_DIM)
@@ -26,6 +26,7 @@ class CONST_SHAREDMATRIXN
     CONST_SHAREDMATRIXN(const SHAREDMATRIXN& source);
     CONST_SHAREDMATRIXN(const CONST_SHAREDMATRIXN& source);
     CONST_SHAREDMATRIXN(unsigned rows, unsigned cols, unsigned leading_dim, unsigned start, SharedResizable<REAL> data);
+    CONST_SHAREDMATRIXN(const REAL* data, unsigned rows, unsigned cols, unsigned leading_dim = 0);
     const SHAREDMATRIXN get() const;
     void reset_from(const CONST_SHAREDMATRIXN& source);
     void reset_from(const SHAREDMATRIXN& source);
@@ -34,6 +35,7 @@ class CONST_SHAREDMATRIXN
     unsigned rows() const { return _rows; }
     unsigned columns() const { return _columns; }
     unsigned leading_dim() const { return _ld; }
+    unsigned inc() const { return 1; }
     CONST_SHAREDMATRIXN& resize(unsigned rows, unsigned columns, bool preserve = false);
     const REAL& operator()(unsigned i, unsigned j) const;
     const REAL* data() const { return _data.get()+_start; }    
@@ -65,6 +67,7 @@ class SHAREDMATRIXN
     SHAREDMATRIXN();
     SHAREDMATRIXN(const SHAREDMATRIXN& source);
     SHAREDMATRIXN(unsigned rows, unsigned cols, unsigned leading_dim, unsigned start, SharedResizable<REAL> data);
+    SHAREDMATRIXN(REAL* data, unsigned rows, unsigned cols, unsigned leading_dim = 0);
     void reset_from(const SHAREDMATRIXN& source);
     SHAREDMATRIXN& set_identity();
     bool is_symmetric(REAL tolerance = (REAL) -1.0) const;
@@ -74,6 +77,7 @@ class SHAREDMATRIXN
     unsigned rows() const { return _rows; }
     unsigned columns() const { return _columns; }
     unsigned leading_dim() const { return _ld; }
+    unsigned inc() const { return 1; }
     SHAREDMATRIXN& resize(unsigned rows, unsigned columns, bool preserve = false);
     SHAREDMATRIXN& negate();
     SHAREDMATRIXN& set_zero();
@@ -26,6 +26,7 @@ class SHAREDVECTORN
     SHAREDVECTORN();
     SHAREDVECTORN(const SHAREDVECTORN& source) { reset_from(source); }
     SHAREDVECTORN(unsigned len, unsigned inc, unsigned start, SharedResizable<REAL> data);
+    SHAREDVECTORN(REAL* data, unsigned len, unsigned inc = 1);
     void reset_from(const SHAREDVECTORN& source);
     virtual ~SHAREDVECTORN() {}
     SHAREDVECTORN& normalize() { assert(norm() > EPS); operator*=((REAL) 1.0/norm()); return *this; }
@@ -87,6 +88,7 @@ class CONST_SHAREDVECTORN
   public:
     CONST_SHAREDVECTORN();
     CONST_SHAREDVECTORN(unsigned len, unsigned inc, unsigned start, SharedResizable<REAL> data);
+    CONST_SHAREDVECTORN(const REAL* data, unsigned len, unsigned inc = 1);
     CONST_SHAREDVECTORN(const SHAREDVECTORN& source) { reset_from(source); }
     CONST_SHAREDVECTORN(const CONST_SHAREDVECTORN& source) { reset_from(source); }
     const SHAREDVECTORN get() const; 
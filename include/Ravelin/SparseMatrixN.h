@@ -4,9 +4,28 @@ class SPARSEMATRIXN
   public:
     enum StorageType { eCSR, eCSC };
 
+    /// A list of (row, column, value) triplets for building sparse matrices
+    /**
+     * Triplets may be added in any order; duplicate entries are summed when
+     * the matrix is built.
+     */
+    class Triplets
+    {
+      public:
+        void reserve(unsigned nnz) { rows.reserve(nnz); columns.reserve(nnz); values.reserve(nnz); }
+        void clear() { rows.clear(); columns.clear(); values.clear(); }
+        void add(unsigned i, unsigned j, REAL v) { rows.push_back(i); columns.push_back(j); values.push_back(v); }
+        unsigned size() const { return rows.size(); }
+
+        std::vector<unsigned> rows;
+        std::vector<unsigned> columns;
+        std::vector<REAL> values;
+    };
+
     SPARSEMATRIXN();
     SPARSEMATRIXN(StorageType s);
     SPARSEMATRIXN(StorageType s, unsigned m, unsigned n, const std::map<std::pair<unsigned, unsigned>, REAL>& values);
+    SPARSEMATRIXN(StorageType s, unsigned m, unsigned n, const Triplets& triplets);
     SPARSEMATRIXN(StorageType s, unsigned m, unsigned n, boost::shared_array<unsigned> ptr, boost::shared_array<unsigned> indices, boost::shared_array<REAL> data);
     SPARSEMATRIXN(const MATRIXN& m, REAL tol=EPS);
     SPARSEMATRIXN(StorageType s, const MATRIXN& m, REAL tol=EPS);
@@ -15,6 +34,7 @@ class SPARSEMATRIXN
     static SPARSEMATRIXN identity(StorageType stype, unsigned n);
     VECTORN& mult(const VECTORN& x, VECTORN& result) const;
     VECTORN& transpose_mult(const VECTORN& x, VECTORN& result) const;
+    VECTORN& dot_rows(const std::vector<unsigned>& rows, const VECTORN& x, VECTORN& result) const;
     MATRIXN& mult(const MATRIXN& m, MATRIXN& result) const;
     MATRIXN& mult_transpose(const MATRIXN& m, MATRIXN& result) const;
     MATRIXN& transpose_mult(const MATRIXN& m, MATRIXN& result) const;
@@ -35,10 +55,40 @@ class SPARSEMATRIXN
     SPARSEMATRIXN& operator-=(const SPARSEMATRIXN& m);
     SPARSEMATRIXN& operator+=(const SPARSEMATRIXN& m);
     SPARSEMATRIXN& operator*=(REAL scalar);
+    SPARSEMATRIXN& axpy(REAL alpha, const SPARSEMATRIXN& m);
+    SPARSEMATRIXN& set_from_triplets(unsigned m, unsigned n, const Triplets& triplets);
+    void get_triplets(Triplets& triplets) const;
+    bool same_pattern(const SPARSEMATRIXN& m) const;
+    void build_position_map();
+    unsigned find_slot(unsigned i, unsigned j);
+    void add_to(unsigned i, unsigned j, REAL v);
+    void set_values(unsigned row, unsigned n, const unsigned* col_indices, const REAL* values);
+    void get_slots(const Triplets& triplets, std::vector<unsigned>& slots);
+    SPARSEMATRIXN& refill(const Triplets& triplets);
+    SPARSEMATRIXN& refill(const std::vector<unsigned>& slots, const std::vector<REAL>& values);
     SPARSEMATRIXN& negate();
     static SPARSEMATRIXN& outer_square(const VECTORN& g, SPARSEMATRIXN& result);
     static SPARSEMATRIXN& outer_square(const SPARSEVECTORN& v, SPARSEMATRIXN& result);
     MATRIXN& to_dense(MATRIXN& m) const;
+    SPARSEMATRIXN& transpose(SPARSEMATRIXN& result) const;
+    SPARSEMATRIXN& convert(StorageType stype, SPARSEMATRIXN& result) const;
+    static SPARSEMATRIXN& mult(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_symbolic(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_numeric(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& transpose_mult_self(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& transpose_mult_self_symbolic(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& transpose_mult_self_numeric(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_transpose_self(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_transpose_self_symbolic(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_transpose_self_numeric(const SPARSEMATRIXN& A, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_diag_transpose(const SPARSEMATRIXN& A, const VECTORN& d, SPARSEMATRIXN& C);
+    static SPARSEMATRIXN& mult_diag_transpose_numeric(const SPARSEMATRIXN& A, const VECTORN& d, SPARSEMATRIXN& C);
+    void calc_amd_ordering(std::vector<unsigned>& perm) const;
+    void calc_rcm_ordering(std::vector<unsigned>& perm) const;
+    void calc_nested_dissection_ordering(std::vector<unsigned>& perm) const;
+    SPARSEMATRIXN& permute(const std::vector<unsigned>& row_perm, const std::vector<unsigned>& col_perm, SPARSEMATRIXN& result) const;
+    SPARSEMATRIXN& permute_symmetric(const std::vector<unsigned>& perm, SPARSEMATRIXN& result) const;
+    static std::vector<unsigned>& invert_permutation(const std::vector<unsigned>& perm, std::vector<unsigned>& iperm);
     void set_capacities(unsigned nnz_capacity, unsigned ptr_capacity, bool preserve);
     void get_values(std::map<std::pair<unsigned, unsigned>, REAL>& values) const;
 
@@ -78,6 +128,18 @@ class SPARSEMATRIXN
 
   private:
     void set(unsigned rows, unsigned columns, const std::map<std::pair<unsigned, unsigned>, REAL>& values);
+    void set_minor(unsigned idx, const VECTORN& v);
+    void transpose_storage(SPARSEMATRIXN& result) const;
+    const SPARSEMATRIXN& get_storage(StorageType stype, SPARSEMATRIXN& work) const;
+    static void product_symbolic(const SPARSEMATRIXN& L, const SPARSEMATRIXN& R, unsigned m, unsigned n, SPARSEMATRIXN& C);
+    static void product_numeric(const SPARSEMATRIXN& L, const REAL* d, const SPARSEMATRIXN& R, unsigned m, unsigned n, SPARSEMATRIXN& C);
+    unsigned lookup_position(unsigned major, unsigned minor) const;
+    void get_symmetric_graph(std::vector<unsigned>& xadj, std::vector<unsigned>& adj) const;
+
+    std::vector<boost::uint64_t> _pos_keys;  // position map keys (major*#minor + minor)
+    std::vector<unsigned> _pos_slots;        // position map slots in _data
+    unsigned _pos_shift;                     // position map hash shift
+    std::vector<unsigned> _product_pos;      // product_numeric() scratch (one slice of column positions per thread)
 }; // end class
 
 std::ostream& operator<<(std::ostream& out, const SPARSEMATRIXN& s);
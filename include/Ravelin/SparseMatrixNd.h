@@ -8,7 +8,9 @@
 #define _SPARSE_MATRIX_ND_H_
 
 #include <map>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <Ravelin/SparseVectorNd.h>
 #include <Ravelin/MatrixNd.h>
 #include <Ravelin/VectorNd.h>
@@ -8,7 +8,9 @@
 #define _SPARSE_MATRIX_NF_H_
 
 #include <map>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <Ravelin/SparseVectorNf.h>
 #include <Ravelin/MatrixNf.h>
 #include <Ravelin/VectorNf.h>
@@ -3,6 +3,10 @@
 #endif
 
 /// A sparse vector represented in 'CSR' format
+/**
+ * Indices of the nonzeros are assumed to be unique and sorted in increasing
+ * order (as they are for all vectors constructed by this class). 
+ */
 class SPARSEVECTORN
 {
   public:
@@ -11,6 +15,12 @@ class SPARSEVECTORN
     SPARSEVECTORN(unsigned n, unsigned nnz, boost::shared_array<unsigned> indices, boost::shared_array<REAL> data);
     SPARSEVECTORN(const VECTORN& v);
     REAL dot(const VECTORN& x) const;
+    REAL dot(const SPARSEVECTORN& x) const;
+    VECTORN& add_to(REAL alpha, VECTORN& y) const;
+    SPARSEVECTORN& axpy(REAL alpha, const SPARSEVECTORN& x);
+    static SPARSEVECTORN& axpy(REAL alpha, const SPARSEVECTORN& x, const SPARSEVECTORN& y, SPARSEVECTORN& result);
+    SPARSEVECTORN& operator+=(const SPARSEVECTORN& x) { return axpy((REAL) 1.0, x); }
+    SPARSEVECTORN& operator-=(const SPARSEVECTORN& x) { return axpy((REAL) -1.0, x); }
     REAL square() const;
     unsigned size() const { return _size; }
     unsigned num_elements() const { return _nelm; }
@@ -20,9 +20,9 @@ class POSE3;
 class SPATIAL_AB_INERTIA 
 {
   public:
-    SPATIAL_AB_INERTIA(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    SPATIAL_AB_INERTIA(FRAME_PTR pose = FRAME_PTR());
     SPATIAL_AB_INERTIA(boost::shared_ptr<POSE3> pose);
-    SPATIAL_AB_INERTIA(const MATRIX3& M, const MATRIX3& H, const MATRIX3& J, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    SPATIAL_AB_INERTIA(const MATRIX3& M, const MATRIX3& H, const MATRIX3& J, FRAME_PTR pose = FRAME_PTR());
     SPATIAL_AB_INERTIA(const MATRIX3& M, const MATRIX3& H, const MATRIX3& J, boost::shared_ptr<POSE3> pose = boost::shared_ptr<POSE3>());
     SPATIAL_AB_INERTIA(const SPATIAL_AB_INERTIA& source) { operator=(source); }
     SPATIAL_AB_INERTIA(const SPATIAL_RB_INERTIA& source) { operator=(source); }
@@ -56,7 +56,7 @@ class SPATIAL_AB_INERTIA
     static SPATIAL_AB_INERTIA inverse_inertia(const SPATIAL_AB_INERTIA& I);    
 
     template <class Mat>
-    static SPATIAL_AB_INERTIA from_matrix(const Mat& m, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>())
+    static SPATIAL_AB_INERTIA from_matrix(const Mat& m, FRAME_PTR pose = FRAME_PTR())
     {
       SPATIAL_AB_INERTIA I(pose);
 
@@ -100,7 +100,7 @@ class SPATIAL_AB_INERTIA
     MATRIX3 M;
 
     /// The pose that this inertia is defined in
-    boost::shared_ptr<const POSE3> pose;
+    FRAME_PTR pose;
 
   private:
     void mult_spatial(const SVECTOR6& v, SVECTOR6& result) const;
@@ -200,9 +200,9 @@ static X& transpose_mult(const std::vector<SMOMENTUM>& w, const SVELOCITY& t, X&
   static VECTORN& concat(const VECTORN& v, const SFORCE& w, VECTORN& result);
   static VECTORN& concat(const VECTORN& v, const SMOMENTUM& w, VECTORN& result);
   static SVELOCITY mult(const std::vector<SVELOCITY>& a, const VECTORN& v);
-  static SACCEL transform_accel(boost::shared_ptr<const POSE3> target, const SACCEL& a);
-  static std::vector<SACCEL>& transform_accel(boost::shared_ptr<const POSE3> target, const std::vector<SACCEL>& asrc, std::vector<SACCEL>& atgt);
-  static void transform_accel(boost::shared_ptr<const POSE3> target, const SACCEL& w, const VECTOR3& r, const MATRIX3& E, SACCEL& result);
+  static SACCEL transform_accel(FRAME_PTR target, const SACCEL& a);
+  static std::vector<SACCEL>& transform_accel(FRAME_PTR target, const std::vector<SACCEL>& asrc, std::vector<SACCEL>& atgt);
+  static void transform_accel(FRAME_PTR target, const SACCEL& w, const VECTOR3& r, const MATRIX3& E, SACCEL& result);
 
 }; // end class 
 
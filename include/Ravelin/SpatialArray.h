@@ -0,0 +1,100 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef SPATIAL_ARRAY
+#error This class is not to be included by the user directly. Use SpatialArrayd.h or SpatialArrayf.h instead.
+#endif
+
+/// A contiguous array of spatial vectors (velocities, forces, accelerations, or momenta) defined in a single frame
+/**
+ * The vectors are stored as the columns of a 6 x n column-major matrix, in 
+ * the [upper; lower] layout of SVECTOR6::data() and SPARITH::to_matrix().
+ * Unlike std::vector<SVELOCITY>, etc., the frame is stored once for the
+ * whole array, and the array can be viewed as a SHAREDMATRIXN (see
+ * matrix()) and passed to BLAS without copying. Typical uses are joint
+ * spatial axes, Jacobian columns, and arrays of link forces.
+ */
+class SPATIAL_ARRAY
+{
+  public:
+    SPATIAL_ARRAY() {}
+    SPATIAL_ARRAY(unsigned n, FRAME_PTR pose = FRAME_PTR());
+
+    /// Constructs an array from a vector of spatial vectors (which must all be defined in the same frame)
+    template <class V>
+    explicit SPATIAL_ARRAY(const std::vector<V>& v) { from_vector(v); }
+
+    SPATIAL_ARRAY& resize(unsigned n);
+    SPATIAL_ARRAY& set_zero() { _m.set_zero(); return *this; }
+    SPATIAL_ARRAY& set_zero(unsigned n, FRAME_PTR pose) { _m.set_zero(SPATIAL_DIM, n); this->pose = pose; return *this; }
+    void set(unsigned i, const SVECTOR6& v);
+    SPATIAL_ARRAY& transform(boost::shared_ptr<const POSE3> target, SPATIAL_ARRAY& result) const;
+    VECTORN& mult(const VECTORN& x, VECTORN& result) const;
+
+    /// Transforms this array to the target frame in place
+    SPATIAL_ARRAY& transform(boost::shared_ptr<const POSE3> target) { return transform(target, *this); }
+
+    /// Gets the number of spatial vectors in the array
+    unsigned size() const { return _m.columns(); }
+
+    /// Gets the i-th spatial vector (an SVELOCITY, SFORCE, SACCEL, or SMOMENTUM)
+    template <class V>
+    V get(unsigned i) const { return V(column_data(i), pose); }
+
+    /// Sets this array from a vector of spatial vectors (which must all be defined in the same frame)
+    template <class V>
+    SPATIAL_ARRAY& from_vector(const std::vector<V>& v)
+    {
+      _m.resize(SPATIAL_DIM, v.size());
+      pose = (v.empty()) ? FRAME_PTR() : v.front().pose;
+      for (unsigned i=0; i< v.size(); i++)
+        set(i, v[i]);
+      return *this;
+    }
+
+    /// Gets this array as a vector of spatial vectors (SVELOCITY, SFORCE, SACCEL, or SMOMENTUM)
+    template <class V>
+    std::vector<V>& to_vector(std::vector<V>& v) const
+    {
+      v.clear();
+      v.reserve(size());
+      for (unsigned i=0; i< size(); i++)
+        v.push_back(V(column_data(i), pose));
+      return v;
+    }
+
+    /// Gets the data of the array (6 values per spatial vector)
+    REAL* data() { return _m.data(); }
+
+    /// Gets the data of the array (6 values per spatial vector)
+    const REAL* data() const { return _m.data(); }
+
+    /// Gets the data of the i-th spatial vector 
+    REAL* column_data(unsigned i) { assert(i < size()); return _m.data() + i*SPATIAL_DIM; }
+
+    /// Gets the data of the i-th spatial vector 
+    const REAL* column_data(unsigned i) const { assert(i < size()); return _m.data() + i*SPATIAL_DIM; }
+
+    /// Gets the array as a (6 x size()) matrix that shares this array's data 
+    SHAREDMATRIXN matrix() { return _m.block(0, SPATIAL_DIM, 0, size()); }
+
+    /// Gets the array as a (6 x size()) matrix that shares this array's data 
+    CONST_SHAREDMATRIXN matrix() const { return _m.block(0, SPATIAL_DIM, 0, size()); }
+
+    /// Gets the i-th spatial vector as a vector that shares this array's data
+    SHAREDVECTORN column(unsigned i) { return _m.column(i); }
+
+    /// Gets the i-th spatial vector as a vector that shares this array's data
+    CONST_SHAREDVECTORN column(unsigned i) const { return _m.column(i); }
+
+    /// The frame that all of the spatial vectors are defined in
+    FRAME_PTR pose;
+
+  private:
+    static const unsigned SPATIAL_DIM = 6;
+    MATRIXN _m;
+}; // end class
+
@@ -0,0 +1,28 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _SPATIAL_ARRAYD_H_
+#define _SPATIAL_ARRAYD_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/Pose3d.h>
+#include <Ravelin/SVector6d.h>
+#include <Ravelin/MatrixNd.h>
+#include <Ravelin/VectorNd.h>
+#include <Ravelin/SharedMatrixNd.h>
+#include <Ravelin/SharedVectorNd.h>
+
+namespace Ravelin {
+
+#include "ddefs.h"
+#include "SpatialArray.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -0,0 +1,28 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _SPATIAL_ARRAYF_H_
+#define _SPATIAL_ARRAYF_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Ravelin/Pose3f.h>
+#include <Ravelin/SVector6f.h>
+#include <Ravelin/MatrixNf.h>
+#include <Ravelin/VectorNf.h>
+#include <Ravelin/SharedMatrixNf.h>
+#include <Ravelin/SharedVectorNf.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "SpatialArray.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
@@ -25,9 +25,9 @@ class POSE3;
 class SPATIAL_RB_INERTIA
 {
   public:
-    SPATIAL_RB_INERTIA(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    SPATIAL_RB_INERTIA(FRAME_PTR pose = FRAME_PTR());
     SPATIAL_RB_INERTIA(boost::shared_ptr<POSE3> pose);
-    SPATIAL_RB_INERTIA(REAL m, const VECTOR3& h, const MATRIX3& J, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    SPATIAL_RB_INERTIA(REAL m, const VECTOR3& h, const MATRIX3& J, FRAME_PTR pose = FRAME_PTR());
     SPATIAL_RB_INERTIA(REAL m, const VECTOR3& h, const MATRIX3& J, boost::shared_ptr<POSE3> pose);
     SPATIAL_RB_INERTIA(const SPATIAL_RB_INERTIA& source) { operator=(source); }
     void set_zero();
@@ -63,7 +63,7 @@ class SPATIAL_RB_INERTIA
     MATRIX3 J;
 
     /// The pose that this inertia is defined in
-    boost::shared_ptr<const POSE3> pose;
+    FRAME_PTR pose;
 
     /// Converts this to a matrix
     template <class Mat>
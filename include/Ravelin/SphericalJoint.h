@@ -38,6 +38,9 @@ class SPHERICALJOINT : public virtual JOINT
 
 
   protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
+
     bool assign_axes();
     static bool rel_equal(REAL x, REAL y);
     MATRIX3 get_rotation() const;
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef TRAJECTORY_RECORDER
+#error This class is not to be included by the user directly. Use TrajectoryRecorderd.h or TrajectoryRecorderf.h instead.
+#endif
+
+class TRAJECTORY_LOG;
+
+/// Records the states of bodies to a columnar binary log without disturbing the caller's timing
+/**
+ * Each call to record() samples the generalized coordinates (q), velocities
+ * (qd), accelerations (qdd), and forces (tau) of the added bodies, as
+ * selected, and the poses of the added links. Each of these quantities is a
+ * channel (a column) of the log. The values are written directly into a
+ * preallocated chunk that holds a block of consecutive frames, so recording
+ * neither allocates memory nor performs I/O. Full chunks are handed to a
+ * background thread, which compresses them (optionally) and writes them to
+ * the file; if that thread falls behind and no chunk is free, record() drops
+ * the frame rather than wait (see dropped_frames()). Read logs with
+ * TRAJECTORY_LOG.
+ *
+ * Velocities, accelerations, and forces are in spatial generalized
+ * coordinates. A link pose is stored as its position followed by its
+ * orientation (w, x, y, z), relative to the global frame. The numbers of
+ * generalized coordinates of the bodies must not change during recording.
+ */
+class TRAJECTORY_RECORDER
+{
+  friend class TRAJECTORY_LOG;
+
+  public:
+    enum Quantity { eQ = 1, eQd = 2, eQdd = 4, eTau = 8, eAllQuantities = 15 };
+    enum Codec { eNoCompression = 0, eXorDelta = 1 };
+
+    TRAJECTORY_RECORDER();
+    ~TRAJECTORY_RECORDER();
+    void add_body(boost::shared_ptr<DYNAMIC_BODY> body, unsigned quantities = eAllQuantities);
+    void add_link_pose(boost::shared_ptr<RIGIDBODY> link);
+    bool open(const std::string& fname, Codec codec = eNoCompression, unsigned chunk_frames = 1024, unsigned nchunks = 8);
+    bool record(REAL t);
+    bool close();
+
+    /// Determines whether a log is open for recording
+    bool is_open() const { return _running; }
+
+    /// Gets the number of frames recorded since the log was opened
+    unsigned long recorded_frames() const { return _nrecorded; }
+
+    /// Gets the number of frames dropped (because the writer fell behind) since the log was opened
+    unsigned long dropped_frames() const { return _ndropped; }
+
+    /// The version of the file format
+    static const unsigned VERSION = 1;
+
+  private:
+    enum ChannelType { eQChannel, eQdChannel, eQddChannel, eTauChannel, ePoseChannel };
+
+    /// The header of a log
+    struct Header
+    {
+      char magic[8];                 // "RAVELINT"
+      boost::uint32_t version;       // VERSION
+      boost::uint32_t byte_order;    // BYTE_ORDER_MARK, in native byte order
+      boost::uint32_t real_size;     // sizeof(REAL)
+      boost::uint32_t codec;         // Codec
+      boost::uint32_t nchannels;
+      boost::uint32_t chunk_frames;  // the maximum number of frames in a chunk
+      boost::uint64_t reserved[4];
+    };
+
+    /// The description of a channel in a log, followed by its name (padded to 8 bytes)
+    struct ChannelHeader
+    {
+      boost::uint32_t width;         // the number of reals per frame
+      boost::uint32_t name_length;
+    };
+
+    /// The header of a chunk, followed by its data (padded to 8 bytes)
+    struct ChunkHeader
+    {
+      char magic[4];                 // "RCHK"
+      boost::uint32_t nframes;
+      boost::uint64_t stored_bytes;  // the size of the (possibly compressed) data
+      double t0;                     // the time of the first frame
+      double t1;                     // the time of the last frame
+    };
+
+    /// A channel being recorded
+    struct Channel
+    {
+      ChannelType type;
+      std::string name;
+      unsigned width;
+      unsigned offset;               // the number of reals per frame in the preceding channels
+      boost::shared_ptr<DYNAMIC_BODY> body;
+      boost::shared_ptr<RIGIDBODY> link;
+    };
+
+    /// A block of frames, stored as the time column followed by the column of each channel
+    struct Chunk
+    {
+      REAL* data;
+      unsigned nframes;
+    };
+
+    static const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static size_t padded(size_t nbytes) { return (nbytes + 7) & ~((size_t) 7); }
+    static void* writer_thread(void* arg);
+    void sample(const Channel& channel, REAL* values);
+    void submit(unsigned chunk);
+    void write_chunk(const Chunk& chunk);
+
+    std::vector<boost::shared_ptr<DYNAMIC_BODY> > _bodies;
+    std::vector<unsigned> _body_quantities;
+    std::vector<boost::shared_ptr<RIGIDBODY> > _links;
+    std::vector<Channel> _channels;
+    unsigned _frame_size;            // the number of reals per frame, including the time
+    unsigned _chunk_frames;
+    Codec _codec;
+    std::vector<REAL> _buffer;       // the storage of all chunks
+    std::vector<Chunk> _chunks;
+    std::vector<unsigned char> _encoded;
+    std::ofstream _out;
+    bool _write_error;
+    unsigned long _nrecorded;
+    unsigned long _ndropped;
+
+    // the chunk being filled by record() (accessed only by the recording thread)
+    int _current;
+
+    // the free chunks and the queue of full chunks, protected by _mutex
+    std::vector<unsigned> _free;
+    std::vector<unsigned> _queue;
+    unsigned _queue_head;
+    unsigned _queue_size;
+    bool _stop;
+
+    bool _running;
+    pthread_t _thread;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _cond;
+}; // end class
+
+/// Reads logs written by TRAJECTORY_RECORDER, with random access by frame and time
+/**
+ * The log is mapped into memory rather than read. Values from uncompressed
+ * logs are returned as views of the mapping, without copying; compressed
+ * chunks are decoded when first accessed (the most recently decoded chunk
+ * is cached). A log whose recording was interrupted is readable up to its
+ * last complete chunk. Times are assumed to be nondecreasing.
+ */
+class TRAJECTORY_LOG
+{
+  public:
+    TRAJECTORY_LOG();
+    bool open(const std::string& fname);
+    void close();
+    int find_channel(const std::string& name) const;
+    REAL time(unsigned frame);
+    unsigned find_frame(REAL t);
+    CONST_SHAREDVECTORN get(unsigned channel, unsigned frame);
+
+    /// Gets the number of frames in the log
+    unsigned num_frames() const { return _nframes; }
+
+    /// Gets the number of channels in the log
+    unsigned num_channels() const { return _channels.size(); }
+
+    /// Gets the name of a channel (e.g., "arm/q" or "gripper/pose")
+    const std::string& channel_name(unsigned i) const { return _channels[i].name; }
+
+    /// Gets the number of reals per frame in a channel
+    unsigned channel_width(unsigned i) const { return _channels[i].width; }
+
+  private:
+    /// A channel in the log
+    struct Channel
+    {
+      std::string name;
+      unsigned width;
+      unsigned offset;               // the number of reals per frame in the preceding channels
+    };
+
+    /// The location of a chunk in the log
+    struct ChunkInfo
+    {
+      const char* data;
+      size_t stored_bytes;
+      unsigned first_frame;
+      unsigned nframes;
+      double t0;
+    };
+
+    /// Unmaps the log when the last view of it is gone
+    class Unmapper
+    {
+      public:
+        Unmapper(size_t size) { _size = size; }
+        void operator()(char* data) const;
+
+      private:
+        size_t _size;
+    };
+
+    unsigned find_chunk(unsigned frame) const;
+    const REAL* chunk_data(unsigned chunk, boost::shared_array<REAL>& owner);
+
+    boost::shared_array<char> _file;
+    TRAJECTORY_RECORDER::Codec _codec;
+    unsigned _frame_size;
+    unsigned _nframes;
+    std::vector<Channel> _channels;
+    std::vector<ChunkInfo> _chunks;
+
+    // the most recently decoded chunk (compressed logs only)
+    int _decoded_chunk;
+    boost::shared_array<REAL> _decoded;
+}; // end class
+
@@ -0,0 +1,30 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _TRAJECTORY_RECORDERF_H
+#define _TRAJECTORY_RECORDERF_H
+
+#include <pthread.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/shared_array.hpp>
+#include <Ravelin/SharedVectorNf.h>
+#include <Ravelin/DynamicBodyf.h>
+#include <Ravelin/RigidBodyf.h>
+
+namespace Ravelin {
+
+#include "fdefs.h"
+#include "TrajectoryRecorder.h"
+#include "undefs.h"
+
+} // end namespace
+
+#endif
+
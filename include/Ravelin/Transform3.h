@@ -70,10 +70,10 @@ class TRANSFORM3
     ORIGIN3 x;
 
     /// the "source" pose
-    boost::shared_ptr<const POSE3> source; 
+    FRAME_PTR source; 
 
     /// the "target" pose
-    boost::shared_ptr<const POSE3> target; 
+    FRAME_PTR target; 
 
   private:
     void transform_spatial(const SVECTOR6& w, SVECTOR6& result) const;
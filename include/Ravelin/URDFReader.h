@@ -14,6 +14,9 @@ class URDFREADER
   public:
     static bool read(const std::string& fname, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints);
     static bool read_from_string(const std::string& content, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints);    
+    static bool read_streaming(const std::string& fname, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints);
+    static bool read_streaming_from_string(const std::string& content, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints);
+    static unsigned read_many(const std::vector<std::string>& fnames, std::vector<std::string>& names, std::vector<std::vector<boost::shared_ptr<RIGIDBODY> > >& links, std::vector<std::vector<boost::shared_ptr<JOINT> > >& joints, unsigned nthreads = 0);
   
   private:
     class URDFData
@@ -26,21 +29,52 @@ class URDFREADER
         std::map<boost::shared_ptr<JOINT>, boost::shared_ptr<RIGIDBODY> > joint_parent, joint_child;
         std::map<boost::shared_ptr<RIGIDBODY>, boost::shared_ptr<POSE3> > inertial_poses;
         std::map<std::string, std::pair<VectorNd, std::string> > materials;
+        boost::unordered_map<std::string, boost::shared_ptr<RIGIDBODY> > link_ids;
     };
 
+    /// A joint read by the streaming reader (joints are constructed once all links have been read)
+    class URDFJointSpec
+    {
+      public:
+        URDFJointSpec() : axis(1,0,0), axis_specified(false) { xyz.set_zero(); rpy.set_zero(); }
+
+        std::string name, type, parent, child;
+        ORIGIN3 xyz, rpy, axis;
+        bool axis_specified;
+    };
+
+    /// The files to be read by the threads of read_many() 
+    class URDFReadQueue
+    {
+      public:
+        const std::vector<std::string>* fnames;
+        std::vector<std::string>* names;
+        std::vector<std::vector<boost::shared_ptr<RIGIDBODY> > >* links;
+        std::vector<std::vector<boost::shared_ptr<JOINT> > >* joints;
+        std::vector<unsigned char> success;
+        unsigned next;
+        pthread_mutex_t mutex;
+    };
+
+    static void* read_many_thread(void* arg);
     static void find_outboards(const URDFData& data, boost::shared_ptr<RIGIDBODY> link, std::vector<std::pair<boost::shared_ptr<JOINT>, boost::shared_ptr<RIGIDBODY> > >& outboards, std::map<boost::shared_ptr<RIGIDBODY>, boost::shared_ptr<RIGIDBODY> >& parents);
+    static bool read_stream(xmlTextReaderPtr reader, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints);
+    static boost::shared_ptr<JOINT> create_joint(const std::string& type);
+    static void set_inertial(URDFData& data, boost::shared_ptr<RIGIDBODY> link, REAL mass, const MATRIX3& inertia, const POSE3& origin);
+    static void attach_joint(URDFData& data, boost::shared_ptr<JOINT> joint, boost::shared_ptr<RIGIDBODY> inboard, boost::shared_ptr<RIGIDBODY> outboard, const POSE3& origin);
+    static void set_axis(boost::shared_ptr<JOINT> joint, VECTOR3 axis, bool axis_specified);
     static void output_data(const URDFData& data, boost::shared_ptr<RIGIDBODY> link);
     static boost::shared_ptr<JOINT> find_joint(const URDFData& data, boost::shared_ptr<RIGIDBODY> outboard_link);
     static void find_children(const URDFData& data, boost::shared_ptr<RIGIDBODY> link, std::queue<boost::shared_ptr<RIGIDBODY> >& q, std::map<boost::shared_ptr<RIGIDBODY>, boost::shared_ptr<RIGIDBODY> >& parents);
     static MATRIX3 read_inertia(boost::shared_ptr<const XMLTree> node, URDFData& data);
-    static double read_mass(boost::shared_ptr<const XMLTree> node, URDFData& data);
+    static REAL read_mass(boost::shared_ptr<const XMLTree> node, URDFData& data);
     static POSE3 read_origin(boost::shared_ptr<const XMLTree> node, URDFData& data);
     static void read_inertial(boost::shared_ptr<const XMLTree> node, URDFData& data, boost::shared_ptr<RIGIDBODY> link);
     static void read_axis(boost::shared_ptr<const XMLTree> node, URDFData& data, boost::shared_ptr<JOINT> joint); 
-    static boost::shared_ptr<RIGIDBODY> read_parent(boost::shared_ptr<const XMLTree> node, URDFData& data, const std::vector<boost::shared_ptr<RIGIDBODY> >& links); 
-    static boost::shared_ptr<RIGIDBODY> read_child(boost::shared_ptr<const XMLTree> node, URDFData& data, const std::vector<boost::shared_ptr<RIGIDBODY> >& links); 
-    static void read_joint(boost::shared_ptr<const XMLTree> node, URDFData& data, const std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints); 
-    static void read_joints(boost::shared_ptr<const XMLTree> node, URDFData& data, const std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints); 
+    static boost::shared_ptr<RIGIDBODY> read_parent(boost::shared_ptr<const XMLTree> node, URDFData& data); 
+    static boost::shared_ptr<RIGIDBODY> read_child(boost::shared_ptr<const XMLTree> node, URDFData& data); 
+    static void read_joint(boost::shared_ptr<const XMLTree> node, URDFData& data, std::vector<boost::shared_ptr<JOINT> >& joints); 
+    static void read_joints(boost::shared_ptr<const XMLTree> node, URDFData& data, std::vector<boost::shared_ptr<JOINT> >& joints); 
     static void read_links(boost::shared_ptr<const XMLTree> node, URDFData& data, std::vector<boost::shared_ptr<RIGIDBODY> >& links); 
     static void read_link(boost::shared_ptr<const XMLTree> node, URDFData& data, std::vector<boost::shared_ptr<RIGIDBODY> >& links); 
     static bool read_robot(boost::shared_ptr<const XMLTree> node, URDFData& data, std::string& name, std::vector<boost::shared_ptr<RIGIDBODY> >& links, std::vector<boost::shared_ptr<JOINT> >& joints); 
@@ -16,6 +16,9 @@
 #include <Ravelin/MatrixNd.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
+#include <pthread.h>
+#include <libxml/xmlreader.h>
 #include <Ravelin/XMLTree.h>
 #include <Ravelin/DynamicBodyd.h>
 
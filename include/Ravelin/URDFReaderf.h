@@ -16,6 +16,9 @@
 #include <Ravelin/MatrixNf.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
+#include <pthread.h>
+#include <libxml/xmlreader.h>
 #include <Ravelin/DynamicBodyf.h>
 
 namespace Ravelin {
@@ -29,6 +29,9 @@ class UNIVERSALJOINT : public virtual JOINT
     virtual bool is_singular_config() const { return false; }
 
   protected:
+    virtual JOINT* copy(PoseMap& poses) const;
+    virtual void remap_frames(const PoseMap& poses);
+
     bool assign_axes();
     MATRIX3 get_rotation() const;
 
@@ -15,14 +15,14 @@ class MATRIX3;
 class VECTOR3
 {
   public:
-    VECTOR3(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { this->pose = pose; }
+    VECTOR3(FRAME_PTR pose = FRAME_PTR()) { this->pose = pose; }
     VECTOR3(boost::shared_ptr<POSE3> pose) { this->pose = boost::const_pointer_cast<const POSE3>(pose); }
-    VECTOR3(REAL x, REAL y, REAL z, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    VECTOR3(REAL x, REAL y, REAL z, FRAME_PTR pose = FRAME_PTR());
     VECTOR3(REAL x, REAL y, REAL z, boost::shared_ptr<POSE3> pose);
-    VECTOR3(const REAL* array, boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>());
+    VECTOR3(const REAL* array, FRAME_PTR pose = FRAME_PTR());
     VECTOR3(const REAL* array, boost::shared_ptr<POSE3> pose);
     VECTOR3(const VECTOR3& source) { operator=(source); }
-    VECTOR3(const ORIGIN3& source, boost::shared_ptr<const POSE3> pose) { this->pose = pose; operator=(source); }
+    VECTOR3(const ORIGIN3& source, FRAME_PTR pose) { this->pose = pose; operator=(source); }
     VECTOR3(const ORIGIN3& source, boost::shared_ptr<POSE3> pose) { this->pose = boost::const_pointer_cast<const POSE3>(pose); operator=(source); }
     REAL dot(const VECTOR3& v) const { return dot(*this, v); }
     static REAL dot(const VECTOR3& v1, const VECTOR3& v2);
@@ -38,10 +38,10 @@ class VECTOR3
     static REAL norm_sq(const VECTOR3& v) { return v.dot(v); }
     VECTOR3& set_zero() { _data[0] = _data[1] = _data[2] = 0.0; return *this; }
     VECTOR3& set_one() { _data[0] = _data[1] = _data[2] = 1.0; return *this; }
-    VECTOR3& set_zero(boost::shared_ptr<const POSE3> pose) { _data[0] = _data[1] = _data[2] = 0.0; this->pose = pose; return *this; }
-    VECTOR3& set_one(boost::shared_ptr<const POSE3> pose) { _data[0] = _data[1] = _data[2] = 1.0; this->pose = pose; return *this; }
-    static VECTOR3 zero(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { return VECTOR3(0.0, 0.0, 0.0, pose); }
-    static VECTOR3 one(boost::shared_ptr<const POSE3> pose = boost::shared_ptr<const POSE3>()) { return VECTOR3(1.0, 1.0, 1.0, pose); }
+    VECTOR3& set_zero(FRAME_PTR pose) { _data[0] = _data[1] = _data[2] = 0.0; this->pose = pose; return *this; }
+    VECTOR3& set_one(FRAME_PTR pose) { _data[0] = _data[1] = _data[2] = 1.0; this->pose = pose; return *this; }
+    static VECTOR3 zero(FRAME_PTR pose = FRAME_PTR()) { return VECTOR3(0.0, 0.0, 0.0, pose); }
+    static VECTOR3 one(FRAME_PTR pose = FRAME_PTR()) { return VECTOR3(1.0, 1.0, 1.0, pose); }
     bool operator<(const VECTOR3& v) const;
     VECTOR3& operator=(const ORIGIN3& o) { x() = o.x(); y() = o.y(); z() = o.z(); return *this; }
     VECTOR3& operator=(const VECTOR3& v) { pose = v.pose; x() = v.x(); y() = v.y(); z() = v.z(); return *this; }
@@ -102,7 +102,7 @@ class VECTOR3
     }
 
     /// The frame that this vector is defined in
-    boost::shared_ptr<const POSE3> pose;
+    FRAME_PTR pose;
 
   private:
     REAL _data[3];
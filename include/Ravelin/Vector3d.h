@@ -14,6 +14,7 @@
 #include <iostream>
 #include <boost/shared_ptr.hpp>
 #include <Ravelin/FrameException.h>
+#include <Ravelin/FrameHandled.h>
 #include <Ravelin/Origin3d.h>
 #include <Ravelin/ColumnIteratord.h>
 #include <Ravelin/RowIteratord.h>
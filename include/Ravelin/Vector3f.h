@@ -14,6 +14,7 @@
 #include <iostream>
 #include <boost/shared_ptr.hpp>
 #include <Ravelin/FrameException.h>
+#include <Ravelin/FrameHandlef.h>
 #include <Ravelin/Origin3f.h>
 #include <Ravelin/ColumnIteratorf.h>
 #include <Ravelin/RowIteratord.h>
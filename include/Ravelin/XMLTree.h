@@ -8,9 +8,12 @@
 #define _RAVELIN_XML_TREE_H
 
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
 #include <list>
 #include <string>
 #include <set>
+#include <vector>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <Ravelin/Origin3d.h>
@@ -112,17 +115,33 @@ class XMLAttrib
 class XMLTree : public boost::enable_shared_from_this<XMLTree>
 {
   public:
+    /// Iterator over the children of a node that share a name
+    typedef std::vector<boost::shared_ptr<XMLTree> >::const_iterator ChildIterator;
+
     XMLTree(const std::string& name);
     XMLTree(const std::string& name, const std::list<XMLAttrib>& attributes);
+    XMLTree(const XMLTree& tree);
+    XMLTree& operator=(const XMLTree& tree);
     static boost::shared_ptr<const XMLTree> read_from_xml(const std::string& name);
     static boost::shared_ptr<const XMLTree> read_from_string(const std::string& content);
     XMLAttrib* get_attrib(const std::string& attrib_name) const;
     std::list<boost::shared_ptr<const XMLTree> > find_child_nodes(const std::string& name) const;
     std::list<boost::shared_ptr<const XMLTree> > find_child_nodes(const std::list<std::string>& name) const;
     std::list<boost::shared_ptr<const XMLTree> > find_descendant_nodes(const std::string& name) const;
-
-    /// Adds a child tree to this tree; also sets the parent node
-    void add_child(boost::shared_ptr<XMLTree> child) { children.push_back(child); child->set_parent(shared_from_this()); }
+    std::pair<ChildIterator, ChildIterator> find_children(const std::string& name) const;
+    boost::shared_ptr<const XMLTree> find_child(const std::string& name) const;
+    void add_child(boost::shared_ptr<XMLTree> child);
+
+    /// Calls f on each child (not including further descendants) matching the given name (case insensitive), in document order
+    /**
+     * Unlike find_child_nodes(), this does not allocate any memory.
+     */
+    template <class F>
+    F for_each_child(const std::string& name, F f) const
+    {
+      std::pair<ChildIterator, ChildIterator> range = find_children(name);
+      return std::for_each(range.first, range.second, f);
+    }
 
     /// Sets the parent of this tree (if any)
     void set_parent(boost::shared_ptr<XMLTree> parent) { _parent = parent; }
@@ -130,14 +149,22 @@ class XMLTree : public boost::enable_shared_from_this<XMLTree>
     /// Gets the parent of this tree (if any)
     boost::weak_ptr<XMLTree> get_parent() const { return _parent; }
 
-    /// The set of attributes of this node
-    std::set<XMLAttrib> attribs;  
+    /// Gets the children of this node, in document order (use add_child() to add to them)
+    const std::list<boost::shared_ptr<XMLTree> >& get_children() const { return _children; }
 
-    /// The list of children of this node
-    std::list<boost::shared_ptr<XMLTree> > children;
+    /// Gets the name of this node
+    const std::string& get_name() const { return _name; }
 
-    /// The name of this node
-    std::string name;
+    void set_name(const std::string& name);
+
+    /// The name of this node (read-only; deprecated in favor of get_name(), and set with set_name())
+    const std::string& name;
+
+    /// The children of this node, in document order (read-only; deprecated in favor of get_children(), and added to with add_child())
+    const std::list<boost::shared_ptr<XMLTree> >& children;
+
+    /// The set of attributes of this node
+    std::set<XMLAttrib> attribs;  
 
     /// The ID of this node
     std::string id;
@@ -152,6 +179,29 @@ class XMLTree : public boost::enable_shared_from_this<XMLTree>
     bool processed;
 
   private:
+    /// Hashes a node name, ignoring case
+    struct NameHash
+    {
+      std::size_t operator()(const std::string& name) const;
+    };
+
+    /// Compares two node names, ignoring case
+    struct NameEqual
+    {
+      bool operator()(const std::string& name1, const std::string& name2) const;
+    };
+
+    void reindex_children(const std::string& name);
+
+    /// The name of this node
+    std::string _name;
+
+    /// The children of this node, in document order
+    std::list<boost::shared_ptr<XMLTree> > _children;
+
+    /// The children of this node, indexed by (case-folded) name; kept consistent with _children (and the names of the children) by add_child() and set_name()
+    boost::unordered_map<std::string, std::vector<boost::shared_ptr<XMLTree> >, NameHash, NameEqual> _child_index;
+
     boost::weak_ptr<XMLTree> _parent;
     static boost::shared_ptr<const XMLTree> construct_xml_tree(xmlNode* root);
 }; // end class
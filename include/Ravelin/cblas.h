@@ -327,6 +327,15 @@ __END_DECLS
 class CBLAS
 {
   public:
+    /// The implementation used for the level 3 routines (gemm, syrk, trsm) and for Cholesky/LU factorization 
+    enum Backend { eExternal, eBuiltin };
+
+    /// Selects the external BLAS/LAPACK (eExternal) or the built-in blocked, multithreaded kernels (eBuiltin)
+    static void set_backend(Backend backend) { _backend = backend; }
+
+    /// Gets the selected backend (the default is chosen at build time)
+    static Backend get_backend() { return _backend; }
+
     template <class T>
     static void rotg(T& a, T& b, T& c, T& s);
 
@@ -366,6 +375,9 @@ class CBLAS
     template <class T>
     static void gemm(enum CBLAS_ORDER order, CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int M, int N, int K, T alpha, const T* A, int lda, const T* B, int ldb, T beta, T* C, int ldc);
 
+    template <class T>
+    static void syrk(enum CBLAS_ORDER order, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int N, int K, T alpha, const T* A, int lda, T beta, T* C, int ldc);
+
     template <class T>
     static void trsm(enum CBLAS_SIDE side,
                      enum CBLAS_UPLO uplo, enum CBLAS_TRANSPOSE transA,
@@ -401,6 +413,9 @@ class CBLAS
     {
       return (trans == CblasNoTrans) ? m.columns() : m.rows();
     }
+
+  private:
+    static Backend _backend;
 };
 
 #endif /* __GSL_CBLAS_H__ */
@@ -58,4 +58,20 @@
 #define FSAB_ALGORITHM FSABAlgorithmd
 #define RNE_ALGORITHM RNEAlgorithmd
 #define URDFREADER URDFReaderd 
+#define CONTACT_SOLVER ContactSolverd
+#define BLOCKSPARSEMATRIXN BlockSparseMatrixNd
+#define SPATIAL_ARRAY SpatialArrayd
+#define FRAME_HANDLE FrameHandled
+#define FRAME_REGISTRY FrameRegistryd
+#define QUAT_BATCH QuatBatchd
+#define PACKED_SPATIAL_AB_INERTIA PackedSpatialABInertiad
+#define MATRIX_FILE MatrixFiled
+#define TRAJECTORY_RECORDER TrajectoryRecorderd
+#define TRAJECTORY_LOG TrajectoryLogd
+#include <Ravelin/Config.h>
+#ifdef RAVELIN_FRAME_HANDLES
+#define FRAME_PTR FrameHandled
+#else
+#define FRAME_PTR boost::shared_ptr<const Pose3d>
+#endif
 
@@ -58,5 +58,21 @@
 #define FSAB_ALGORITHM FSABAlgorithmf
 #define RNE_ALGORITHM RNEAlgorithmf
 #define URDFREADER URDFReaderf 
+#define CONTACT_SOLVER ContactSolverf
+#define BLOCKSPARSEMATRIXN BlockSparseMatrixNf
+#define SPATIAL_ARRAY SpatialArrayf
+#define FRAME_HANDLE FrameHandlef
+#define FRAME_REGISTRY FrameRegistryf
+#define QUAT_BATCH QuatBatchf
+#define PACKED_SPATIAL_AB_INERTIA PackedSpatialABInertiaf
+#define MATRIX_FILE MatrixFilef
+#define TRAJECTORY_RECORDER TrajectoryRecorderf
+#define TRAJECTORY_LOG TrajectoryLogf
+#include <Ravelin/Config.h>
+#ifdef RAVELIN_FRAME_HANDLES
+#define FRAME_PTR FrameHandlef
+#else
+#define FRAME_PTR boost::shared_ptr<const Pose3f>
+#endif
 
  
@@ -58,4 +58,15 @@
 #undef FSAB_ALGORITHM 
 #undef RNE_ALGORITHM 
 #undef URDFREADER 
+#undef CONTACT_SOLVER
+#undef BLOCKSPARSEMATRIXN
+#undef SPATIAL_ARRAY
+#undef FRAME_HANDLE
+#undef FRAME_REGISTRY
+#undef QUAT_BATCH
+#undef PACKED_SPATIAL_AB_INERTIA
+#undef MATRIX_FILE
+#undef TRAJECTORY_RECORDER
+#undef TRAJECTORY_LOG
+#undef FRAME_PTR
 
@@ -0,0 +1,563 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+using std::map;
+using std::vector;
+using std::pair;
+using std::make_pair;
+using boost::shared_ptr;
+
+CONTACT_SOLVER::CONTACT_SOLVER()
+{
+  omega = (REAL) 1.0;
+  max_iterations = 100;
+  max_pivots = 0;
+  tolerance = (REAL) -1.0;
+  warm_start = true;
+  iterations = 0;
+}
+
+/// Assembles the (sparse) Delassus matrix W = J inv(M) J' from per-body Jacobian blocks
+/**
+ * For every body, the rows of the Jacobian that act on that body are
+ * gathered into a single dense block J_b, inv(M_b) J_b' is computed with a
+ * single call to DYNAMIC_BODY::transpose_solve_generalized_inertia(), and
+ * the product J_b inv(M_b) J_b' is added into W. W therefore only contains
+ * nonzeros between contact rows that share a body.
+ * \param m the number of contact rows (the size of W)
+ * \param blocks the Jacobian blocks; blocks for the same body and row are
+ *        summed
+ * \param W contains the Delassus matrix (in CSR format) on return
+ */
+SPARSEMATRIXN& CONTACT_SOLVER::calc_delassus(unsigned m, const vector<JacobianBlock>& blocks, SPARSEMATRIXN& W)
+{
+  _triplets.clear();
+  accumulate_delassus(m, blocks, _triplets);
+  if (W.get_storage_type() == SPARSEMATRIXN::eCSR)
+    W.set_from_triplets(m, m, _triplets);
+  else
+    W = SPARSEMATRIXN(SPARSEMATRIXN::eCSR, m, m, _triplets);
+  return W;
+}
+
+/// Assembles the dense Delassus matrix W = J inv(M) J' from per-body Jacobian blocks
+/**
+ * \param m the number of contact rows (the size of W)
+ * \param blocks the Jacobian blocks; blocks for the same body and row are
+ *        summed
+ * \param W contains the Delassus matrix on return
+ */
+MATRIXN& CONTACT_SOLVER::calc_delassus(unsigned m, const vector<JacobianBlock>& blocks, MATRIXN& W)
+{
+  W.set_zero(m, m);
+  accumulate_delassus(m, blocks, W);
+  return W;
+}
+
+/// Adds a dense per-body block of the Delassus matrix into a sparse accumulator (duplicates are summed when the matrix is built)
+void CONTACT_SOLVER::add_block(const vector<unsigned>& rows, const MATRIXN& Wb, SPARSEMATRIXN::Triplets& W)
+{
+  W.reserve(W.size() + rows.size()*rows.size());
+  for (unsigned j=0; j< rows.size(); j++)
+  {
+    const REAL* col = Wb.data() + j*Wb.leading_dim();
+    for (unsigned i=0; i< rows.size(); i++)
+      W.add(rows[i], rows[j], col[i]);
+  }
+}
+
+/// Adds a dense per-body block of the Delassus matrix into a dense matrix
+void CONTACT_SOLVER::add_block(const vector<unsigned>& rows, const MATRIXN& Wb, MATRIXN& W)
+{
+  for (unsigned j=0; j< rows.size(); j++)
+  {
+    const REAL* col = Wb.data() + j*Wb.leading_dim();
+    REAL* wcol = W.data() + rows[j]*W.leading_dim();
+    for (unsigned i=0; i< rows.size(); i++)
+      wcol[rows[i]] += col[i];
+  }
+}
+
+/// Computes J_b inv(M_b) J_b' for every body and adds it into W
+template <class M>
+void CONTACT_SOLVER::accumulate_delassus(unsigned m, const vector<JacobianBlock>& blocks, M& W)
+{
+  // group the blocks by body (in order of first appearance, so that the
+  // summation order does not depend on pointer values)
+  map<DYNAMIC_BODY*, unsigned> body_index;
+  vector<vector<unsigned> > groups;
+  for (unsigned i=0; i< blocks.size(); i++)
+  {
+    #ifndef NEXCEPT
+    if (!blocks[i].body)
+      throw std::runtime_error("CONTACT_SOLVER::calc_delassus() - Jacobian block has no body");
+    if (blocks[i].row_start + blocks[i].J.rows() > m)
+      throw MissizeException();
+    #endif
+    map<DYNAMIC_BODY*, unsigned>::const_iterator b = body_index.find(blocks[i].body.get());
+    if (b == body_index.end())
+    {
+      body_index[blocks[i].body.get()] = groups.size();
+      groups.push_back(vector<unsigned>(1, i));
+    }
+    else
+      groups[b->second].push_back(i);
+  }
+
+  // process each body
+  for (unsigned g=0; g< groups.size(); g++)
+  {
+    const vector<unsigned>& group = groups[g];
+    shared_ptr<DYNAMIC_BODY> body = blocks[group.front()].body;
+    const unsigned NGC = body->num_generalized_coordinates(DYNAMIC_BODY::eSpatial);
+
+    // determine the contact rows that act on this body
+    _rows.clear();
+    for (unsigned i=0; i< group.size(); i++)
+    {
+      const JacobianBlock& block = blocks[group[i]];
+      for (unsigned r=0; r< block.J.rows(); r++)
+        _rows.push_back(block.row_start + r);
+    }
+    std::sort(_rows.begin(), _rows.end());
+    _rows.erase(std::unique(_rows.begin(), _rows.end()), _rows.end());
+
+    // gather the rows into a single block
+    _Jb.set_zero(_rows.size(), NGC);
+    for (unsigned i=0; i< group.size(); i++)
+    {
+      const JacobianBlock& block = blocks[group[i]];
+      #ifndef NEXCEPT
+      if (block.J.columns() != NGC)
+        throw MissizeException();
+      #endif
+      // (the rows of a block are consecutive in _rows)
+      const unsigned r0 = std::lower_bound(_rows.begin(), _rows.end(), block.row_start) - _rows.begin();
+      for (unsigned j=0; j< NGC; j++)
+      {
+        const REAL* src = block.J.data() + j*block.J.leading_dim();
+        REAL* dest = _Jb.data() + j*_Jb.leading_dim();
+        for (unsigned r=0; r< block.J.rows(); r++)
+          dest[r0+r] += src[r];
+      }
+    }
+
+    // compute inv(M) J' and J inv(M) J'
+    body->transpose_solve_generalized_inertia(_Jb, _X);
+    _Jb.mult(_X, _Wb);
+
+    // add the block into W
+    add_block(_rows, _Wb, W);
+  }
+}
+
+/// Solves a bounded linear complementarity problem using projected Gauss-Seidel / SOR
+/**
+ * Finds z such that lo <= z <= hi and, for each i, w_i = (Az + q)_i satisfies
+ * w_i >= 0 if z_i = lo_i, w_i <= 0 if z_i = hi_i, and w_i = 0 otherwise. Zero
+ * lower bounds and infinite upper bounds give the standard LCP.
+ * \param A the (sparse) problem matrix with positive diagonal; if A is
+ *        stored in CSC format, it must be symmetric (as is the Delassus
+ *        matrix)
+ * \param z the initial guess on input (if warm_start is set and z is sized
+ *        properly; zero is used otherwise), the solution on return
+ * \return <b>true</b> if the residual dropped below the tolerance within
+ *         max_iterations sweeps
+ */
+bool CONTACT_SOLVER::solve_pgs(const SPARSEMATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, VECTORN& z)
+{
+  return pgs(A, q, lo, hi, NULL, NULL, z);
+}
+
+/// Solves a bounded linear complementarity problem with friction cone (box) bounds using projected Gauss-Seidel / SOR
+/**
+ * \param friction_index for each row i, the index of the normal row that
+ *        bounds it (-1 if row i uses lo/hi); row i is then bounded by
+ *        +/- mu_i z_friction_index[i]
+ * \param mu the friction coefficient for each row (used only for rows with
+ *        friction_index[i] >= 0)
+ * \see solve_pgs(const SPARSEMATRIXN&, const VECTORN&, const VECTORN&, const VECTORN&, VECTORN&)
+ */
+bool CONTACT_SOLVER::solve_pgs(const SPARSEMATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const vector<int>& friction_index, const VECTORN& mu, VECTORN& z)
+{
+  return pgs(A, q, lo, hi, &friction_index, &mu, z);
+}
+
+/// Solves a bounded linear complementarity problem using projected Gauss-Seidel / SOR (dense matrix)
+/**
+ * \see solve_pgs(const SPARSEMATRIXN&, const VECTORN&, const VECTORN&, const VECTORN&, VECTORN&)
+ */
+bool CONTACT_SOLVER::solve_pgs(const MATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, VECTORN& z)
+{
+  return pgs(A, q, lo, hi, NULL, NULL, z);
+}
+
+/// Solves a bounded linear complementarity problem with friction cone (box) bounds using projected Gauss-Seidel / SOR (dense matrix)
+/**
+ * \see solve_pgs(const SPARSEMATRIXN&, const VECTORN&, const VECTORN&, const VECTORN&, const std::vector<int>&, const VECTORN&, VECTORN&)
+ */
+bool CONTACT_SOLVER::solve_pgs(const MATRIXN& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const vector<int>& friction_index, const VECTORN& mu, VECTORN& z)
+{
+  return pgs(A, q, lo, hi, &friction_index, &mu, z);
+}
+
+/// Gets the bounds on z_i
+void CONTACT_SOLVER::get_bounds(unsigned i, const VECTORN& lo, const VECTORN& hi, const vector<int>* friction_index, const VECTORN* mu, const VECTORN& z, REAL& l, REAL& h)
+{
+  if (friction_index && (*friction_index)[i] >= 0)
+  {
+    h = (*mu)[i] * z[(*friction_index)[i]];
+    l = -h;
+  }
+  else
+  {
+    l = lo[i];
+    h = hi[i];
+  }
+}
+
+/// Computes the dot product of row i of A and z, also returning A(i,i)
+REAL CONTACT_SOLVER::row_dot(const SPARSEMATRIXN& A, unsigned i, const VECTORN& z, REAL& aii)
+{
+  const unsigned* ptr = A.get_ptr();
+  const unsigned* indices = A.get_indices();
+  const REAL* data = A.get_data();
+  const REAL* zdata = z.data();
+
+  aii = (REAL) 0.0;
+  REAL dot = (REAL) 0.0;
+  for (unsigned k=ptr[i]; k< ptr[i+1]; k++)
+  {
+    const unsigned j = indices[k];
+    if (j == i)
+      aii += data[k];
+    dot += data[k]*zdata[j];
+  }
+
+  return dot;
+}
+
+/// Computes the dot product of row i of A and z, also returning A(i,i)
+REAL CONTACT_SOLVER::row_dot(const MATRIXN& A, unsigned i, const VECTORN& z, REAL& aii)
+{
+  const unsigned n = A.columns();
+  const unsigned LDA = A.leading_dim();
+  const REAL* a = A.data() + i;
+  const REAL* zdata = z.data();
+
+  aii = a[i*LDA];
+  REAL dot = (REAL) 0.0;
+  for (unsigned j=0; j< n; j++)
+    dot += a[j*LDA]*zdata[j];
+
+  return dot;
+}
+
+/// The projected Gauss-Seidel / SOR solver
+template <class M>
+bool CONTACT_SOLVER::pgs(const M& A, const VECTORN& q, const VECTORN& lo, const VECTORN& hi, const vector<int>* friction_index, const VECTORN* mu, VECTORN& z)
+{
+  const unsigned n = q.size();
+
+  #ifndef NEXCEPT
+  if (A.rows() != n || A.columns() != n || lo.size() != n || hi.size() != n)
+    throw MissizeException();
+  if (friction_index && (friction_index->size() != n || mu->size() != n))
+    throw MissizeException();
+  #endif
+
+  // setup the starting point
+  if (!warm_start || z.size() != n)
+    z.set_zero(n);
+
+  // determine the tolerance
+  const REAL TOL = (tolerance < (REAL) 0.0) ? std::sqrt(std::numeric_limits<REAL>::epsilon()) * std::max((REAL) 1.0, q.norm_inf()) : tolerance;
+
+  iterations = 0;
+  residuals.clear();
+  if (n == 0)
+    return true;
+
+  // the warm start may violate the bounds; project it
+  for (unsigned i=0; i< n; i++)
+  {
+    REAL l, h;
+    get_bounds(i, lo, hi, friction_index, mu, z, l, h);
+    z[i] = std::max(l, std::min(h, z[i]));
+  }
+
+  for (iterations = 0; iterations < max_iterations; )
+  {
+    // do one sweep
+    for (unsigned i=0; i< n; i++)
+    {
+      REAL aii, l, h;
+      const REAL wi = row_dot(A, i, z, aii) + q[i];
+      if (aii <= (REAL) 0.0)
+        continue;
+      get_bounds(i, lo, hi, friction_index, mu, z, l, h);
+      const REAL zi = z[i] - omega*wi/aii;
+      z[i] = std::max(l, std::min(h, zi));
+    }
+    iterations++;
+
+    // compute the natural residual ||z - proj(z - w)||_inf
+    REAL resid = (REAL) 0.0;
+    for (unsigned i=0; i< n; i++)
+    {
+      REAL aii, l, h;
+      const REAL wi = row_dot(A, i, z, aii) + q[i];
+      get_bounds(i, lo, hi, friction_index, mu, z, l, h);
+      const REAL pi = std::max(l, std::min(h, z[i] - wi));
+      resid = std::max(resid, std::fabs(z[i] - pi));
+    }
+    residuals.push_back(resid);
+    FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_pgs() - iteration " << iterations << " residual: " << resid << std::endl;
+
+    if (resid <= TOL)
+      return true;
+  }
+
+  return false;
+}
+
+/// Gets the column of the Lemke tableau for the given variable
+/**
+ * Variables 0..n-1 are w, n..2n-1 are z, and 2n is the artificial variable.
+ */
+void CONTACT_SOLVER::lemke_column(const MATRIXN& M, unsigned var, REAL* col) const
+{
+  const unsigned n = M.rows();
+  if (var < n)
+  {
+    std::fill(col, col+n, (REAL) 0.0);
+    col[var] = (REAL) 1.0;
+  }
+  else if (var < 2*n)
+  {
+    const REAL* m = M.data() + (var-n)*M.leading_dim();
+    for (unsigned i=0; i< n; i++)
+      col[i] = -m[i];
+  }
+  else
+    std::fill(col, col+n, (REAL) -1.0);
+}
+
+/// Forms and factors the basis matrix for the given basis, discarding any updates
+/**
+ * \return <b>false</b> if the basis is singular
+ */
+bool CONTACT_SOLVER::lemke_factor(const MATRIXN& M, const vector<unsigned>& basis)
+{
+  const unsigned n = basis.size();
+
+  _B.resize(n, n);
+  for (unsigned j=0; j< n; j++)
+    lemke_column(M, basis[j], _B.data() + j*_B.leading_dim());
+  _eta_rows.clear();
+  return LINALG::factor_LU(_B, _piv);
+}
+
+/// Solves B x = b, where B is the factored basis matrix with all updates since it was factored applied
+/**
+ * \param x the right hand side on input, the solution on return
+ */
+void CONTACT_SOLVER::lemke_solve(VECTORN& x) const
+{
+  const unsigned n = x.size();
+
+  // solve using the factorization
+  LINALG::solve_LU_fast(_B, false, _piv, x);
+
+  // apply the inverse of each update, in order: the update that replaces
+  // column r of B_k with a gives B_k+1 = B_k E, where E is the identity with
+  // column r replaced by d = inv(B_k) a
+  for (unsigned k=0; k< _eta_rows.size(); k++)
+  {
+    const unsigned r = _eta_rows[k];
+    const REAL* d = _etas.data() + k*_etas.leading_dim();
+    const REAL xr = x[r]/d[r];
+    for (unsigned i=0; i< n; i++)
+      x[i] -= d[i]*xr;
+    x[r] = xr;
+  }
+}
+
+/// Replaces column r of the basis matrix, given the solution d of B d = a for the new column a
+/**
+ * The update is stored in product form (see lemke_solve()); the basis is
+ * refactored once n/2 updates have accumulated, which roughly balances the
+ * O(n^3) cost of factoring against the O(n) cost of applying each update.
+ * \return <b>false</b> if a refactored basis is singular
+ */
+bool CONTACT_SOLVER::lemke_update(const MATRIXN& M, const vector<unsigned>& basis, unsigned r, const VECTORN& d)
+{
+  const unsigned n = d.size();
+  const unsigned MAX_UPDATES = std::max(n/2, (unsigned) 1);
+
+  if (_eta_rows.size() >= MAX_UPDATES)
+    return lemke_factor(M, basis);
+
+  if (_etas.rows() != n || _etas.columns() < MAX_UPDATES)
+    _etas.resize(n, MAX_UPDATES);
+  std::copy(d.begin(), d.end(), _etas.data() + _eta_rows.size()*_etas.leading_dim());
+  _eta_rows.push_back(r);
+  return true;
+}
+
+/// Solves a linear complementarity problem using Lemke's algorithm
+/**
+ * Finds z such that w = Mz + q, w >= 0, z >= 0, and z'w = 0. The initial
+ * basis is factored using LINALG::factor_LU(); each pivot then updates the
+ * factorization in product form (O(n^2) work), and the basis is refactored
+ * every n/2 pivots. If warm_start is set and z is sized
+ * properly, the complementary basis implied by the positive components of z
+ * is tried first; if it yields a feasible solution, no pivoting is done.
+ * \param z the initial guess on input, the solution on return
+ * \return <b>true</b> if a solution was found; <b>false</b> on ray
+ *         termination, singular bases, or if max_pivots was exceeded
+ */
+bool CONTACT_SOLVER::solve_lemke(const MATRIXN& M, const VECTORN& q, VECTORN& z)
+{
+  const unsigned n = q.size();
+
+  #ifndef NEXCEPT
+  if (M.rows() != n || M.columns() != n)
+    throw MissizeException();
+  #endif
+
+  // determine the tolerance and maximum number of pivots
+  const REAL TOL = (tolerance < (REAL) 0.0) ? std::sqrt(std::numeric_limits<REAL>::epsilon()) * std::max((REAL) 1.0, q.norm_inf()) : tolerance;
+  const REAL PIV_TOL = std::sqrt(std::numeric_limits<REAL>::epsilon());
+  const unsigned MAX_PIVOTS = (max_pivots > 0) ? max_pivots : std::min((unsigned) 1000, 50*n);
+
+  iterations = 0;
+  residuals.clear();
+
+  // trivial solution?
+  unsigned t = 0;
+  for (unsigned i=1; i< n; i++)
+    if (q[i] < q[t])
+      t = i;
+  if (n == 0 || q[t] >= (REAL) 0.0)
+  {
+    z.set_zero(n);
+    return true;
+  }
+
+  // try the warm start basis
+  if (warm_start && z.size() == n)
+  {
+    _basis.resize(n);
+    for (unsigned i=0; i< n; i++)
+      _basis[i] = (z[i] > (REAL) 0.0) ? n+i : i;
+    bool feasible = lemke_factor(M, _basis);
+    if (feasible)
+    {
+      _xb = q;
+      lemke_solve(_xb);
+      feasible = (*std::min_element(_xb.begin(), _xb.end()) >= -TOL);
+    }
+    if (feasible)
+    {
+      z.set_zero(n);
+      for (unsigned i=0; i< n; i++)
+        if (_basis[i] >= n)
+          z[_basis[i]-n] = std::max(_xb[i], (REAL) 0.0);
+      FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - warm start basis is a solution" << std::endl;
+      return true;
+    }
+  }
+
+  // initial basis: all w, with the artificial variable replacing the most
+  // negative w; the complement of the leaving variable enters
+  _basis.resize(n);
+  for (unsigned i=0; i< n; i++)
+    _basis[i] = i;
+  _basis[t] = 2*n;
+  unsigned entering = n+t;
+
+  if (!lemke_factor(M, _basis))
+  {
+    FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - singular basis" << std::endl;
+    return false;
+  }
+
+  _a.resize(n);
+  for (iterations = 0; iterations < MAX_PIVOTS; iterations++)
+  {
+    // compute the current basic solution and the direction of the entering
+    // variable
+    lemke_column(M, entering, _a.data());
+    _xb = q;
+    lemke_solve(_xb);
+    _d = _a;
+    lemke_solve(_d);
+
+    // do the ratio test, preferring the artificial variable on ties
+    unsigned r = n;
+    REAL theta = std::numeric_limits<REAL>::max();
+    for (unsigned i=0; i< n; i++)
+    {
+      if (_d[i] <= PIV_TOL)
+        continue;
+      const REAL ratio = std::max(_xb[i], (REAL) 0.0)/_d[i];
+      if (ratio < theta - PIV_TOL || (ratio <= theta + PIV_TOL && _basis[i] == 2*n))
+      {
+        theta = std::min(ratio, theta);
+        r = i;
+      }
+    }
+
+    // check for ray termination
+    if (r == n)
+    {
+      FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - ray termination" << std::endl;
+      return false;
+    }
+
+    // pivot
+    const unsigned leaving = _basis[r];
+    _basis[r] = entering;
+
+    // record the value of the artificial variable
+    REAL z0 = (REAL) 0.0;
+    for (unsigned i=0; i< n; i++)
+      if (_basis[i] == 2*n)
+        z0 = _xb[i] - theta*_d[i];
+    residuals.push_back(z0);
+
+    // check for termination; the final basis is refactored for accuracy
+    if (leaving == 2*n)
+    {
+      iterations++;
+      if (!lemke_factor(M, _basis))
+        return false;
+      _xb = q;
+      lemke_solve(_xb);
+      z.set_zero(n);
+      for (unsigned i=0; i< n; i++)
+        if (_basis[i] >= n)
+          z[_basis[i]-n] = std::max(_xb[i], (REAL) 0.0);
+      FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - solved in " << iterations << " pivots" << std::endl;
+      return true;
+    }
+
+    // update the factorization for the new basis
+    if (!lemke_update(M, _basis, r, _d))
+    {
+      FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - singular basis" << std::endl;
+      return false;
+    }
+
+    // the complement of the leaving variable enters
+    entering = (leaving < n) ? leaving+n : leaving-n;
+  }
+
+  FILE_LOG(LOG_OPTIMIZATION) << "CONTACT_SOLVER::solve_lemke() - maximum number of pivots exceeded" << std::endl;
+  return false;
+}
+
@@ -0,0 +1,23 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0 
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <map>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <Ravelin/Constants.h>
+#include <Ravelin/Log.h>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/LinAlgf.h>
+#include <Ravelin/ContactSolverf.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/fdefs.h>
+#include "ContactSolver.cpp"
+#include <Ravelin/undefs.h>
+
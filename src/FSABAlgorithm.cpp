@@ -769,7 +769,6 @@ void FSAB_ALGORITHM::calc_spatial_inertias(shared_ptr<RC_ARTICULATED_BODY> body)
 {
   FILE_LOG(LOG_DYNAMICS) << "calc_spatial_zero_accelerations() entered" << endl;
   vector<SVELOCITY> sprime;
-  MATRIXN tmp, tmp2, tmp3;
 
   // get the set of links
   const vector<shared_ptr<RIGIDBODY> >& links = body->get_links();
@@ -777,6 +776,7 @@ void FSAB_ALGORITHM::calc_spatial_inertias(shared_ptr<RC_ARTICULATED_BODY> body)
   // clear spatial values for all links
   _rank_deficient.resize(links.size());
   _I.resize(links.size());
+  _Ipacked.resize(links.size());
   _Is.resize(links.size());
   _sIs.resize(links.size());
   _usIs.resize(links.size());
@@ -800,6 +800,7 @@ void FSAB_ALGORITHM::calc_spatial_inertias(shared_ptr<RC_ARTICULATED_BODY> body)
     // set the articulated body inertia for this link to be its isolated
     // spatial inertia (this will be updated in the phase below)
    _I[i] = link->get_inertia();
+   _Ipacked[i] = link->get_inertia();
 
     // check for degenerate inertia
     #ifndef NDEBUG
@@ -838,6 +839,9 @@ void FSAB_ALGORITHM::calc_spatial_inertias(shared_ptr<RC_ARTICULATED_BODY> body)
     if (!body->all_children_processed(link))
       continue; 
   
+    // all children have been accumulated into the packed inertia; unpack it
+    _Ipacked[i].to_ab_inertia(_I[i]);
+
     // indicate that this link has been processed
     body->_processed[i] = true;
 
@@ -890,25 +894,31 @@ FILE_LOG(LOG_DYNAMICS) << "added link " << parent << " to queue for processing"
     if (!body->is_floating_base() && parent->is_base())
       continue;
  
-    // compute a couple of necessary matrices
-    transpose_solve_sIs(i, sprime, _sIss);
-    SPARITH::mult(Is, _sIss, tmp);
-    I.to_matrix(tmp2);
-    MATRIXN::mult(tmp, tmp2, tmp3);
-    SPATIAL_AB_INERTIA uI = I - SPATIAL_AB_INERTIA::from_matrix(tmp3, I.pose);
+    // compute the inertial update I - Is*inv(s'Is)*(Is)' in place (the
+    // packed inertia for this link is not needed after this point)
+    PACKED_SPATIAL_AB_INERTIA& uI = _Ipacked[i];
+    if (_sIs[i].rows() == 1)
+      uI.rank_update(Is.front(), _sIs[i].data()[0]);
+    else if (!Is.empty())
+    {
+      SPARITH::to_matrix(Is, _workM).transpose();
+      solve_sIs(i, _workM, _sIsU);
+      uI.rank_update(Is, _sIsU);
+    }
 
     // output the updates
     if (LOGGING(LOG_DYNAMICS) && _Is[i].size() > 0)
       FILE_LOG(LOG_DYNAMICS) << "  Is: " << _Is[i][0] << std::endl;
-    FILE_LOG(LOG_DYNAMICS) << "  s/(s'Is): " << _sIss << std::endl;
-    FILE_LOG(LOG_DYNAMICS) << "  Is*s/(s'Is): " << std::endl << tmp;
-    FILE_LOG(LOG_DYNAMICS) << "  Is*s/(s'Is)*I: " << std::endl << tmp3;
     FILE_LOG(LOG_DYNAMICS) << "  inertial update: " << uI << std::endl;
-    FILE_LOG(LOG_DYNAMICS) << "  transformed I: " << POSE3::transform(_I[h].pose, uI) << std::endl;
+    FILE_LOG(LOG_DYNAMICS) << "  transformed I: " << PACKED_SPATIAL_AB_INERTIA::transform(_Ipacked[h].pose, uI) << std::endl;
 
     // update the parent inertia
-    _I[h] += POSE3::transform(_I[h].pose, uI);
+    _Ipacked[h].add_transformed(uI);
   }
+
+  // unpack the inertia of a floating base (it is not processed above) 
+  if (body->is_floating_base())
+    _Ipacked.front().to_ab_inertia(_I.front());
 }
 
 /// Computes joint and spatial link accelerations 
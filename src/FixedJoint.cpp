@@ -158,4 +158,22 @@ void FIXEDJOINT::evaluate_constraints(REAL C[])
   C[5] = ZZ - _rconst[Z];
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* FIXEDJOINT::copy(PoseMap& poses) const
+{
+  FIXEDJOINT* joint = new FIXEDJOINT(*this);
+  joint->copy_frames(poses);
+  copy_frame(joint->_T, poses);
+  copy_frame(joint->_F1, poses);
+  copy_frame(joint->_F2, poses);
+  return joint;
+}
 
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void FIXEDJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_rconst, poses);
+  remap_frame(_ui, poses);
+  remap_frame(_s_dot, poses);
+}
@@ -0,0 +1,18 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+/// Gets a shared pointer to the pose referred to by this handle
+/**
+ * \note the pose must be owned by a boost::shared_ptr (boost::bad_weak_ptr
+ *       is thrown otherwise)
+ */
+boost::shared_ptr<const POSE3> FRAME_HANDLE::lock() const
+{
+  if (!_pose)
+    return boost::shared_ptr<const POSE3>();
+  return _pose->shared_from_this();
+}
+
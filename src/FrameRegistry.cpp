@@ -0,0 +1,75 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+using boost::shared_ptr;
+
+/// Adds a pose to the registry (if it is not already there) and returns its identifier
+unsigned FRAME_REGISTRY::add(shared_ptr<POSE3> pose)
+{
+  return add(boost::const_pointer_cast<const POSE3>(pose));
+}
+
+/// Adds a pose to the registry (if it is not already there) and returns its identifier
+unsigned FRAME_REGISTRY::add(shared_ptr<const POSE3> pose)
+{
+  #ifndef NEXCEPT
+  if (!pose)
+    throw NullPointerException("Attempt to register a null pose");
+  #endif
+
+  // see whether the pose is already registered
+  std::map<const POSE3*, unsigned>::const_iterator i = _ids.find(pose.get());
+  if (i != _ids.end())
+    return i->second;
+
+  // add the pose
+  const unsigned ID = _poses.size();
+  _poses.push_back(pose);
+  _ids[pose.get()] = ID;
+  return ID;
+}
+
+/// Gets the identifier of the pose referred to by the given handle
+unsigned FRAME_REGISTRY::find(FRAME_HANDLE handle) const
+{
+  std::map<const POSE3*, unsigned>::const_iterator i = _ids.find(handle.get());
+  #ifndef NEXCEPT
+  if (i == _ids.end())
+    throw FrameException();
+  #endif
+  return i->second;
+}
+
+/// Gets a handle to the pose with the given identifier
+FRAME_HANDLE FRAME_REGISTRY::get_handle(unsigned id) const
+{
+  #ifndef NEXCEPT
+  if (id >= _poses.size())
+    throw InvalidIndexException();
+  #endif
+  return FRAME_HANDLE(_poses[id]);
+}
+
+/// Gets the pose with the given identifier
+shared_ptr<const POSE3> FRAME_REGISTRY::get_pose(unsigned id) const
+{
+  #ifndef NEXCEPT
+  if (id >= _poses.size())
+    throw InvalidIndexException();
+  #endif
+  return _poses[id];
+}
+
+/// Removes all poses from the registry
+/**
+ * \note handles to poses that are not owned elsewhere become invalid
+ */
+void FRAME_REGISTRY::clear()
+{
+  _poses.clear();
+  _ids.clear();
+}
+
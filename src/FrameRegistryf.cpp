@@ -0,0 +1,17 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <Ravelin/FrameException.h>
+#include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/NullPointerException.h>
+#include <Ravelin/FrameRegistryf.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/fdefs.h>
+#include "FrameRegistry.cpp"
+#include <Ravelin/undefs.h>
+
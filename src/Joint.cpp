@@ -93,6 +93,50 @@ void JOINT::update_spatial_axes()
     _s[i].pose = get_pose();
 }
 
+/// Creates a copy of this joint, with copies of its frames, for a copy of its articulated body
+/**
+ * The copy is made by a joint type's copy constructor, so its frames (and 
+ * its links) are initially those of this joint: this function replaces the
+ * frames with copies (see copy_frames()), and RC_ARTICULATED_BODY::clone()
+ * then calls remap_frames() on the copy, once all frames have been copied.
+ * Joint types that do not override this function cannot be copied.
+ * \param poses a map from the frames of the articulated body to their 
+ *        copies, to which the frames of this joint are added
+ * 
+ * \return the copy, or NULL if the joint cannot be copied
+ */
+JOINT* JOINT::copy(PoseMap&) const
+{
+  return NULL;
+}
+
+/// Replaces the frames of this (copied) joint with copies of them
+void JOINT::copy_frames(PoseMap& poses)
+{
+  copy_frame(_F, poses);
+  copy_frame(_Fb, poses);
+  copy_frame(_Fprime, poses);
+}
+
+/// Replaces a frame with a copy of it, recording the copy in the map
+void JOINT::copy_frame(shared_ptr<POSE3>& pose, PoseMap& poses)
+{
+  if (!pose)
+    return;
+  shared_ptr<POSE3> copy(new POSE3(*pose));
+  poses[pose.get()] = copy;
+  pose = copy;
+}
+
+/// Makes the vectors of this (copied) joint refer to the copied frames 
+/**
+ * Joint types with additional vectors override this function (and call it).
+ */
+void JOINT::remap_frames(const PoseMap& poses)
+{
+  remap_frame(_s, poses);
+}
+
 /// Sets the number of degrees-of-freedom for this joint
 /**
  * \note resets all joint values (q) to zero
@@ -1,8 +1,178 @@
+#ifndef REENTRANT
+FastThreadable<unsigned long> LINALG::_nallocs;
+#endif
+
+/// Gets the number of heap allocations made on the calling thread for work matrices and vectors (and all other vectors and matrices of this precision)
+/**
+ * This counter is intended for verifying that real-time code does not
+ * allocate memory after warmup: sample it before and after the code of
+ * interest, on the thread that runs that code. Allocations are counted 
+ * only in debug, non-reentrant builds (i.e., when neither NDEBUG nor 
+ * REENTRANT is defined); otherwise, this is always zero.
+ */
+unsigned long LINALG::allocations()
+{
+  #if !defined(NDEBUG) && !defined(REENTRANT)
+  return SharedResizable<REAL>::allocations() + _nallocs();
+  #else
+  return 0;
+  #endif
+}
+
+/// Counts a heap allocation (in debug, non-reentrant builds only)
+void LINALG::count_allocation()
+{
+  #if !defined(NDEBUG) && !defined(REENTRANT)
+  _nallocs()++;
+  #endif
+}
+
+/// Resizes an STL integer work vector, counting heap allocations
+void LINALG::resize_work(vector<INTEGER>& v, unsigned n)
+{
+  if (n > v.capacity())
+    count_allocation();
+  v.resize(n);
+}
+
+/// Gets the LAPACK workspace sizes for a routine, querying LAPACK only if no cached query covers the problem size
+/**
+ * Optimal workspace sizes are nondecreasing in the problem dimensions, so a
+ * query made for a m x n x k problem is valid for any smaller problem.
+ * \param r the LAPACK routine
+ * \param opt1 the first option character (e.g., JOBZ) that affects the workspace size, or ' '
+ * \param opt2 the second option character that affects the workspace size, or ' '
+ * \param LWORK on return, the size of the floating point workspace
+ * \param LIWORK on return, the size of the integer workspace
+ */
+void LINALG::workspace(LworkRoutine r, char opt1, char opt2, INTEGER M, INTEGER N, INTEGER K, INTEGER& LWORK, INTEGER& LIWORK)
+{
+  LworkEntry* entries = lwork_cache().entries[r];
+
+  // look for a cached query with the same options that covers this problem
+  unsigned slot = LWORK_VARIANTS;
+  for (unsigned i=0; i< LWORK_VARIANTS; i++)
+  {
+    if (!entries[i].valid)
+    {
+      if (slot == LWORK_VARIANTS)
+        slot = i;
+      continue;
+    }
+    if (entries[i].opt1 != opt1 || entries[i].opt2 != opt2)
+      continue;
+    if (M <= entries[i].m && N <= entries[i].n && K <= entries[i].k)
+    {
+      LWORK = entries[i].lwork;
+      LIWORK = entries[i].liwork;
+      return;
+    }
+
+    // the cached query is too small; it will be replaced
+    slot = i;
+    break;
+  }
+
+  // no such query; query LAPACK for the componentwise largest problem seen 
+  // so far, so that the cache grows monotonically
+  if (slot == LWORK_VARIANTS)
+    slot = 0;
+  LworkEntry& e = entries[slot];
+  if (e.valid && e.opt1 == opt1 && e.opt2 == opt2)
+  {
+    M = std::max(M, e.m);
+    N = std::max(N, e.n);
+    K = std::max(K, e.k);
+  }
+  query_lwork(r, opt1, opt2, M, N, K, LWORK, LIWORK);
+
+  // cache the query
+  e.valid = true;
+  e.opt1 = opt1;
+  e.opt2 = opt2;
+  e.m = M;
+  e.n = N;
+  e.k = K;
+  e.lwork = LWORK;
+  e.liwork = LIWORK;
+}
+
+/// Preallocates all work matrices and LAPACK workspace for problems up to a given size
+/**
+ * After calling this method, factorizations and solves on matrices with at 
+ * most max_m rows and max_n columns (and square matrices of size at most 
+ * max(max_m, max_n)) will not allocate memory nor query LAPACK for 
+ * workspace sizes; allocations() can be used to verify this.
+ * \param max_m the maximum number of rows of a matrix to be operated upon
+ * \param max_n the maximum number of columns of a matrix (or right hand 
+ *        sides) to be operated upon
+ */
+void LINALG::reserve(unsigned max_m, unsigned max_n)
+{
+  const INTEGER M = std::max(max_m, (unsigned) 1);
+  const INTEGER N = std::max(max_n, (unsigned) 1);
+  const INTEGER MX = std::max(M, N);
+  const INTEGER MINMN = std::min(M, N);
+
+  // query (and cache) the workspace for each routine
+  INTEGER lwork = 2*MX, liwork = 8*MX, LWORK, LIWORK;
+  workspace(eORMQR, 'L', ' ', M, MX, MINMN, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eGELSD, ' ', ' ', M, N, MX, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  liwork = std::max(liwork, LIWORK);
+  workspace(eSYSV, ' ', ' ', MX, MX, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eGESDD, 'A', ' ', M, N, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  liwork = std::max(liwork, LIWORK);
+  workspace(eGESDD, 'S', ' ', M, N, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  liwork = std::max(liwork, LIWORK);
+  workspace(eGESVD, 'A', 'A', M, N, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eSYEVD, 'N', ' ', MX, 0, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  liwork = std::max(liwork, LIWORK);
+  workspace(eSYEVD, 'V', ' ', MX, 0, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  liwork = std::max(liwork, LIWORK);
+  workspace(eSYTRF, ' ', ' ', MX, 0, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eGEQP3, ' ', ' ', M, N, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eGEQRF, ' ', ' ', MX, MX, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eGETRI, ' ', ' ', MX, 0, 0, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+  workspace(eORGQR, ' ', ' ', MX, MX, MX, LWORK, LIWORK);
+  lwork = std::max(lwork, LWORK);
+
+  // preallocate the LAPACK workspace 
+  workv().resize(lwork);
+  workv2().resize(MX);
+  if ((unsigned) liwork > iworkv().capacity())
+    count_allocation();
+  iworkv().reserve(liwork);
+  if ((unsigned) MX > pivwork().capacity())
+    count_allocation();
+  pivwork().reserve(MX);
+
+  // preallocate the work matrices
+  workM().resize(MX, MX);
+  workM2().resize(MX, MX);
+  workM3().resize(MX, MX);
+  U().resize(MX, MX);
+  V().resize(MX, MX);
+  S().resize(MX);
+}
+
 /// Frees all allocated memory
 void LINALG::free_memory()
 {
   workM().resize(0,0);
   workM2().resize(0,0);
+  workM3().resize(0,0);
   U().resize(0,0);
   pivwork().resize(0);
   V().resize(0,0);
@@ -10,6 +180,7 @@ void LINALG::free_memory()
   workv().resize(0);
   workv2().resize(0);
   iworkv().resize(0);
+  lwork_cache() = LworkCache();
   compress();
 }
 
@@ -18,6 +189,7 @@ void LINALG::compress()
 {
   workM().compress();
   workM2().compress();
+  workM3().compress();
   U().compress();
 //  pivwork().shrink_to_fit();
   V().compress();
@@ -131,6 +303,99 @@ MATRIXN& LINALG::pseudo_invert(MATRIXN& A, REAL tol)
   return A;
 }
 
+/// Computes the psuedo-inverse of a matrix of (numerical) rank at most k
+/**
+ * Uses a randomized SVD to determine only the k dominant singular triplets
+ * of A; this is much cheaper than pseudo_invert() when k << min(m,n). If
+ * k is not much smaller than min(m,n), pseudo_invert() is called instead.
+ * \param A the m x n matrix; contains the n x m pseudo-inverse on return
+ * \param k an upper bound on the rank of A
+ * \param tol the tolerance for zeroing singular values; if tol < 0.0,
+ *        tol is computed using machine epsilon
+ */
+MATRIXN& LINALG::pseudo_invert_lowrank(MATRIXN& A, unsigned k, REAL tol)
+{
+  // get the dimensionality of A
+  const unsigned m = A.rows();
+  const unsigned n = A.columns();
+  const unsigned minmn = std::min(m, n);
+
+  // use the full SVD if k is not substantially smaller than min(m,n)
+  if (k == 0 || minmn == 0 || 4*k >= minmn)
+    return pseudo_invert(A, tol);
+
+  // compute the randomized svd (A is not modified)
+  MATRIXN& Ux = U();
+  MATRIXN& Vx = V();
+  VECTORN& Sx = S();
+  svd_randomized(A, k, Ux, Sx, Vx);
+  REAL* Sx_data = Sx.data();
+
+  // determine new tolerance based on first singular value if necessary
+  if (tol < 0.0)
+    tol = Sx_data[0] * std::max(m,n) * std::numeric_limits<REAL>::epsilon();
+
+  // compute inv(s) and scale the columns of V (n x k)
+  for (unsigned i=0; i< k; i++)
+  {
+    Sx_data[i] = (std::fabs(Sx_data[i]) > tol) ? (REAL) 1.0/Sx_data[i] : (REAL) 0.0;
+    CBLAS::scal(n, Sx_data[i], Vx.data()+Vx.leading_dim()*i, 1);
+  }
+
+  // size the result properly
+  A.resize(n, m);
+
+  // do the multiplication (V * U')
+  CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasTrans, n, m, k, (REAL) 1.0, Vx.data(), Vx.leading_dim(), Ux.data(), Ux.leading_dim(), (REAL) 0.0, A.data(), A.leading_dim());
+
+  return A;
+}
+
+/// Replaces the columns of a m x n matrix (m >= n) with an orthonormal basis for their span
+/**
+ * \param A a m x n matrix with m >= n; on return, the matrix Q from the 
+ *        thin QR factorization A = Q*R
+ */
+void LINALG::orthonormalize(MATRIXN& A)
+{
+  // look for easy out
+  if (A.rows() == 0 || A.columns() == 0)
+    return;
+
+  #ifndef NEXCEPT
+  if (A.rows() < A.columns())
+    throw MissizeException();
+  #endif
+
+  // setup LAPACK parameters
+  INTEGER M = A.rows();
+  INTEGER N = A.columns();
+  INTEGER LDA = A.leading_dim();
+  INTEGER INFO;
+
+  // setup tau vector
+  VECTORN& tau = workv2();
+  tau.resize(N);
+
+  // do the QR factorization and then form Q
+  geqrf_(&M, &N, A.data(), &LDA, tau.data(), &INFO);
+  assert(INFO == 0);
+  orgqr_(&M, &N, &N, A.data(), &LDA, tau.data(), &INFO);
+  assert(INFO == 0);
+}
+
+/// Fills a matrix with samples drawn from the standard normal distribution
+void LINALG::randn(MATRIXN& M, unsigned rows, unsigned columns)
+{
+  boost::normal_distribution<REAL> normal((REAL) 0.0, (REAL) 1.0);
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<REAL> > gen(rng(), normal);
+
+  M.resize(rows, columns);
+  REAL* data = M.data();
+  for (unsigned i=0, n = rows*columns; i< n; i++)
+    data[i] = gen();
+}
+
 /// Less robust least squares solver (solves Ax = b)
 /**
  * \note this method does not work!
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <Ravelin/cblas.h>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/NonsquareMatrixException.h>
+#include <Ravelin/SingularException.h>
+#include <Ravelin/LinAlgf.h>
+#include <Ravelin/LinAlgd.h>
+#include <Ravelin/LinAlgMixed.h>
+
+using namespace Ravelin;
+
+LinAlgMixed::LinAlgMixed()
+{
+  max_iterations = 30;
+  iterations = 0;
+  fallback = false;
+}
+
+/// Solves a general system of linear equations AX = B using a single precision LU factorization and double precision refinement
+/**
+ * \param A a square, nonsingular matrix (not modified)
+ * \param XB the right hand sides on input, the solutions on return
+ * \note throws SingularException if A is singular
+ */
+MatrixNd& LinAlgMixed::solve_LU(const MatrixNd& A, MatrixNd& XB)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != XB.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eLU, A, XB.columns(), XB.data(), XB.leading_dim());
+  return XB;
+}
+
+/// Solves a general system of linear equations Ax = b using a single precision LU factorization and double precision refinement
+VectorNd& LinAlgMixed::solve_LU(const MatrixNd& A, VectorNd& xb)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != xb.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eLU, A, 1, xb.data(), xb.rows());
+  return xb;
+}
+
+/// Solves a symmetric, positive definite system of linear equations AX = B using a single precision Cholesky factorization and double precision refinement
+/**
+ * \param A a symmetric, positive definite matrix (not modified)
+ * \param XB the right hand sides on input, the solutions on return
+ * \note throws SingularException if A is not positive definite
+ */
+MatrixNd& LinAlgMixed::solve_chol(const MatrixNd& A, MatrixNd& XB)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != XB.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eChol, A, XB.columns(), XB.data(), XB.leading_dim());
+  return XB;
+}
+
+/// Solves a symmetric, positive definite system of linear equations Ax = b using a single precision Cholesky factorization and double precision refinement
+VectorNd& LinAlgMixed::solve_chol(const MatrixNd& A, VectorNd& xb)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != xb.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eChol, A, 1, xb.data(), xb.rows());
+  return xb;
+}
+
+/// Solves a symmetric, indefinite system of linear equations AX = B using a single precision LDL' factorization and double precision refinement
+/**
+ * \param A a symmetric, nonsingular matrix (not modified)
+ * \param XB the right hand sides on input, the solutions on return
+ */
+MatrixNd& LinAlgMixed::solve_LDL(const MatrixNd& A, MatrixNd& XB)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != XB.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eLDL, A, XB.columns(), XB.data(), XB.leading_dim());
+  return XB;
+}
+
+/// Solves a symmetric, indefinite system of linear equations Ax = b using a single precision LDL' factorization and double precision refinement
+VectorNd& LinAlgMixed::solve_LDL(const MatrixNd& A, VectorNd& xb)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != xb.rows())
+    throw MissizeException();
+  #endif
+
+  solve(eLDL, A, 1, xb.data(), xb.rows());
+  return xb;
+}
+
+/// Factors a single precision copy of A
+/**
+ * \return <b>false</b> if A cannot be represented in single precision or
+ *         the factorization failed
+ */
+bool LinAlgMixed::factor_single(Factorization f, const MatrixNd& A)
+{
+  const unsigned n = A.rows();
+  const double FLT_MAX_D = (double) std::numeric_limits<float>::max();
+
+  // copy A to single precision, checking for overflow
+  _Af.resize(n, n);
+  const double* a = A.data();
+  float* af = _Af.data();
+  for (unsigned j=0; j< n; j++, a += A.leading_dim(), af += _Af.leading_dim())
+    for (unsigned i=0; i< n; i++)
+    {
+      if (std::fabs(a[i]) > FLT_MAX_D)
+        return false;
+      af[i] = (float) a[i];
+    }
+
+  // do the factorization
+  switch (f)
+  {
+    case eLU:
+      return LinAlgf::factor_LU(_Af, _piv);
+
+    case eChol:
+      return LinAlgf::factor_chol(_Af);
+
+    case eLDL:
+      LinAlgf::factor_LDL(_Af, _piv);
+      return true;
+  }
+
+  return false;
+}
+
+/// Solves using the single precision factorization
+void LinAlgMixed::solve_single(Factorization f, MatrixNf& XB)
+{
+  switch (f)
+  {
+    case eLU:
+      LinAlgf::solve_LU_fast(_Af, false, _piv, XB);
+      break;
+
+    case eChol:
+      LinAlgf::solve_chol_fast(_Af, XB);
+      break;
+
+    case eLDL:
+      LinAlgf::solve_LDL_fast(_Af, _piv, XB);
+      break;
+  }
+}
+
+/// Solves using a double precision factorization of A
+/**
+ * \param xb the right hand sides on input, the solutions on return
+ */
+void LinAlgMixed::solve_double(Factorization f, const MatrixNd& A, unsigned nrhs, double* xb, unsigned ldb)
+{
+  const unsigned n = A.rows();
+
+  // copy the right hand sides
+  _R.resize(n, nrhs);
+  for (unsigned j=0; j< nrhs; j++)
+    std::copy(xb+j*ldb, xb+j*ldb+n, _R.data()+j*n);
+
+  // factor A and solve
+  _Ad = A;
+  switch (f)
+  {
+    case eLU:
+      if (!LinAlgd::factor_LU(_Ad, _piv))
+        throw SingularException();
+      LinAlgd::solve_LU_fast(_Ad, false, _piv, _R);
+      break;
+
+    case eChol:
+      if (!LinAlgd::factor_chol(_Ad))
+        throw SingularException();
+      LinAlgd::solve_chol_fast(_Ad, _R);
+      break;
+
+    case eLDL:
+      LinAlgd::factor_LDL(_Ad, _piv);
+      LinAlgd::solve_LDL_fast(_Ad, _piv, _R);
+      break;
+  }
+
+  // copy the solutions
+  for (unsigned j=0; j< nrhs; j++)
+    std::copy(_R.data()+j*n, _R.data()+(j+1)*n, xb+j*ldb);
+}
+
+/// Solves AX = B using a single precision factorization and double precision iterative refinement
+/**
+ * Refinement stops when, for every right hand side, the residual satisfies
+ * ||b - Ax||_inf <= ||x||_inf * ||A||_inf * eps * sqrt(n) (the criterion used
+ * by LAPACK's dsgesv), where eps is double precision machine epsilon.
+ * \param xb the n x nrhs right hand sides (with leading dimension ldb) on
+ *        input, the solutions on return
+ */
+void LinAlgMixed::solve(Factorization f, const MatrixNd& A, unsigned nrhs, double* xb, unsigned ldb)
+{
+  #ifndef NEXCEPT
+  if (A.rows() != A.columns())
+    throw NonsquareMatrixException();
+  #endif
+
+  const unsigned n = A.rows();
+  iterations = 0;
+  fallback = false;
+
+  // check for empty matrices
+  if (n == 0 || nrhs == 0)
+    return;
+
+  // save the right hand sides
+  _B.resize(n, nrhs);
+  for (unsigned j=0; j< nrhs; j++)
+    std::copy(xb+j*ldb, xb+j*ldb+n, _B.data()+j*n);
+
+  // factor in single precision; fall back to double precision on failure
+  if (!factor_single(f, A))
+  {
+    fallback = true;
+    solve_double(f, A, nrhs, xb, ldb);
+    return;
+  }
+
+  // compute the infinity norm of A and the refinement tolerance
+  double anrm = 0.0;
+  for (unsigned i=0; i< n; i++)
+  {
+    double rowsum = 0.0;
+    for (unsigned j=0; j< n; j++)
+      rowsum += std::fabs(A.data()[j*A.leading_dim()+i]);
+    anrm = std::max(anrm, rowsum);
+  }
+  const double CTE = anrm * std::numeric_limits<double>::epsilon() * std::sqrt((double) n);
+
+  // compute the initial solution in single precision: x = inv(A)*b
+  _Xf.resize(n, nrhs);
+  std::copy(_B.data(), _B.data()+n*nrhs, _Xf.data());
+  solve_single(f, _Xf);
+  for (unsigned j=0; j< nrhs; j++)
+    std::copy(_Xf.data()+j*n, _Xf.data()+(j+1)*n, xb+j*ldb);
+
+  for (iterations = 0; ; iterations++)
+  {
+    // compute the residual in double precision: r = b - A*x
+    _R = _B;
+    CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, nrhs, n, -1.0, A.data(), A.leading_dim(), xb, ldb, 1.0, _R.data(), n);
+
+    // check for convergence (and for non-finite solutions)
+    bool converged = true, finite = true;
+    for (unsigned j=0; j< nrhs && finite; j++)
+    {
+      double xnrm = 0.0, rnrm = 0.0;
+      for (unsigned i=0; i< n; i++)
+      {
+        xnrm = std::max(xnrm, std::fabs(xb[j*ldb+i]));
+        rnrm = std::max(rnrm, std::fabs(_R.data()[j*n+i]));
+      }
+      if (!(xnrm <= std::numeric_limits<double>::max()) || !(rnrm <= std::numeric_limits<double>::max()))
+        finite = false;
+      else if (rnrm > xnrm*CTE)
+        converged = false;
+    }
+    if (finite && converged)
+      return;
+    if (!finite || iterations == max_iterations)
+      break;
+
+    // compute the correction in single precision and update the solution
+    std::copy(_R.data(), _R.data()+n*nrhs, _Xf.data());
+    solve_single(f, _Xf);
+    for (unsigned j=0; j< nrhs; j++)
+    {
+      const float* d = _Xf.data()+j*n;
+      double* x = xb+j*ldb;
+      for (unsigned i=0; i< n; i++)
+        x[i] += (double) d[i];
+    }
+  }
+
+  // refinement did not converge; restore the right hand sides and solve in
+  // double precision
+  fallback = true;
+  for (unsigned j=0; j< nrhs; j++)
+    std::copy(_B.data()+j*n, _B.data()+(j+1)*n, xb+j*ldb);
+  solve_double(f, A, nrhs, xb, ldb);
+}
+
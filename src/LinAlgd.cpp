@@ -13,8 +13,11 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <boost/algorithm/minmax.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
 #include <Ravelin/cblas.h>
 #include "clapack.h"
+#include "blocked_blas.h"
 #include <Ravelin/MissizeException.h>
 #include <Ravelin/NonsquareMatrixException.h>
 #include <Ravelin/NumericalException.h>
@@ -55,13 +58,10 @@ void LinAlgd::trtrs_(char* UPLO, char* TRANS, INTEGER* N, INTEGER* NRHS, DOUBLE*
 void LinAlgd::ormqr_(char* SIDE, char* TRANS, INTEGER* M, INTEGER* N, INTEGER* K, DOUBLE* A, INTEGER* LDA, DOUBLE* TAU, DOUBLE* C, INTEGER* LDC, INTEGER* INFO)
 {
   // determine workspace size
-  INTEGER LWORK = -1;
-  DOUBLE WORK_QUERY;
-  dormqr_(SIDE, TRANS, M, N, K, A, LDA, TAU, C, LDC, &WORK_QUERY, &LWORK, INFO);
-  assert(*INFO == 0);
+  INTEGER LWORK, LIWORK;
+  workspace(eORMQR, *SIDE, ' ', *M, *N, *K, LWORK, LIWORK);
 
   // declare memory
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // do the real call now
@@ -88,29 +88,14 @@ void LinAlgd::gelsd_(INTEGER* M, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER*
   INTEGER min_mn = std::min(*M, *N);
   workv2().resize(min_mn);
 
-   // necessary for computing WORK sizes
-  INTEGER ISPEC = (INTEGER) 9;
-  INTEGER TMP = (INTEGER) 0;
-  const char* NAME = "DGELSD";
-  const char* OPTS = " ";
-  INTEGER smlsiz = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, M, N, NRHS, &TMP, strlen(NAME), strlen(OPTS));
-  assert(smlsiz > (INTEGER) 0);
-  INTEGER NLVL = std::max((INTEGER) 0, (INTEGER) (log2((double) min_mn/(double) (smlsiz+1))+1));
-  INTEGER LIWORK = std::max((INTEGER) 1, 3*min_mn*NLVL + 11*min_mn);
-  iworkv().resize(LIWORK);
+  // determine workspace sizes
+  INTEGER LWORK, LIWORK;
+  workspace(eGELSD, ' ', ' ', *M, *N, *NRHS, LWORK, LIWORK);
   INTEGER RANK;
 
-  // first do WORK query
-  double WORK_QUERY;
-  INTEGER LWORK = -1;
-  dgelsd_(M, N, NRHS, A, M, B, LDB, workv2().data(), RCOND, &RANK, &WORK_QUERY, &LWORK, &LIWORK, INFO);
-  assert(*INFO == 0);
-
-  // setup LWORK 
-  LWORK = (INTEGER) WORK_QUERY;
-
-  // setup WORK array
-  workv().resize(std::max((INTEGER) 1, LWORK));
+  // setup WORK arrays
+  workv().resize(LWORK);
+  resize_work(iworkv(), LIWORK);
 
   // compute
   dgelsd_(M, N, NRHS, A, M, B, LDB, workv2().data(), RCOND, &RANK, workv().data(), &LWORK, &iworkv().front(), INFO);
@@ -119,17 +104,11 @@ void LinAlgd::gelsd_(INTEGER* M, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER*
 /// Calls appropriate LAPACK function for solving systems of linear equations Ax=b, where A is symmetric indefinite
 void LinAlgd::sysv_(char* UPLO, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, DOUBLE* B, INTEGER* LDB, INTEGER* INFO)
 { 
-  INTEGER LWORK = -1;
-  double WORK_QUERY;
-
-  // first, determine workspace size
-  dsysv_(UPLO, N, NRHS, A, LDA, IPIV, B, LDA, &WORK_QUERY, &LWORK, INFO);
-  assert(*INFO >= 0);
-  if (*INFO > 0)
-    return; 
+  // determine workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eSYSV, ' ', ' ', *N, *NRHS, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // call LAPACK
@@ -139,55 +118,42 @@ void LinAlgd::sysv_(char* UPLO, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER* L
 /// Calls LAPACK function for svd (divide and conquer)
 void LinAlgd::gesdd_(char* JOBZ, INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, DOUBLE* S, DOUBLE* U, INTEGER* LDU, DOUBLE* V, INTEGER* LDVT, INTEGER* INFO)
 {
-  double WORK_QUERY;
-  INTEGER minmn = std::min(*M, *N);
-  INTEGER LWORK = -1;
-  iworkv().resize(8*minmn);
-
-  // call LAPACK to determine the optimal workspace size
-  dgesdd_(JOBZ, M, N, A, LDA, S, U, LDU, V, LDVT, &WORK_QUERY, &LWORK, &iworkv().front(), INFO);
+  // determine the optimal workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eGESDD, *JOBZ, ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK); 
+  resize_work(iworkv(), LIWORK);
 
-  // call LAPACK once again
+  // call LAPACK 
   dgesdd_(JOBZ, M, N, A, LDA, S, U, LDU, V, LDVT, workv().data(), &LWORK, &iworkv().front(), INFO);
 }
 
 /// Calls LAPACK function for svd
 void LinAlgd::gesvd_(char* JOBU, char* JOBV, INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, DOUBLE* S, DOUBLE* U, INTEGER* LDU, DOUBLE* V, INTEGER* LDVT, INTEGER* INFO)
 {
-  double WORK_QUERY;
-  INTEGER minmn = std::min(*M, *N);
-  INTEGER LWORK = -1;
-
-  // call LAPACK to determine the optimal workspace size
-  dgesvd_(JOBU, JOBV, M, N, A, LDA, S, U, LDU, V, LDVT, &WORK_QUERY, &LWORK, INFO);
+  // determine the optimal workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eGESVD, *JOBU, *JOBV, *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK); 
 
-  // call LAPACK once again
+  // call LAPACK 
   dgesvd_(JOBU, JOBV, M, N, A, LDA, S, U, LDU, V, LDVT, workv().data(), &LWORK, INFO);
 }
 
 /// Calls LAPACK function for computing eigenvalues and eigenvectors
 void LinAlgd::syevd_(char* JOBZ, char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, DOUBLE* EVALS, INTEGER* INFO)
 {
-  // do work query first
-  double WORK_QUERY;
-  INTEGER LWORK = -1;
-  INTEGER IWORK_QUERY;
-  INTEGER LIWORK = -1;
-  dsyevd_(JOBZ, UPLO, N, A, LDA, EVALS, &WORK_QUERY, &LWORK, &IWORK_QUERY, &LIWORK, INFO);
+  // determine the optimal workspace sizes
+  INTEGER LWORK, LIWORK;
+  workspace(eSYEVD, *JOBZ, ' ', *N, 0, 0, LWORK, LIWORK);
 
   // set array sizes
-  LWORK = (INTEGER) WORK_QUERY;
-  LIWORK = IWORK_QUERY;
   workv().resize(LWORK);
-  iworkv().resize(LIWORK);
+  resize_work(iworkv(), LIWORK);
 
   dsyevd_(JOBZ, UPLO, N, A, LDA, EVALS, workv().data(), &LWORK, &iworkv().front(), &LIWORK, INFO);
 }
@@ -195,6 +161,18 @@ void LinAlgd::syevd_(char* JOBZ, char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA
 /// Calls LAPACK function for solving system of linear equations using LU factorization
 void LinAlgd::gesv_(INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, DOUBLE* X, INTEGER* LDX, INTEGER* INFO)
 {
+  // use the built-in blocked LU factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::getrf(*N, *N, A, *LDA, IPIV);
+    if (*INFO == 0)
+    {
+      char TRANS = 'N';
+      dgetrs_(&TRANS, N, NRHS, A, LDA, IPIV, X, LDX, INFO);
+    }
+    return;
+  }
+
   dgesv_(N, NRHS, A, LDA, IPIV, X, LDX, INFO);
 }
 
@@ -213,12 +191,28 @@ void LinAlgd::potri_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* I
 /// Calls LAPACK function for Cholesky factorization
 void LinAlgd::potrf_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* INFO)
 {
+  // use the built-in blocked Cholesky factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::potrf((*UPLO == 'U' || *UPLO == 'u') ? CblasUpper : CblasLower, *N, A, *LDA);
+    return;
+  }
+
   dpotrf_(UPLO, N, A, LDA, INFO);
 }
 
 /// Calls LAPACK function for solving system of equations Ax=b, where A is PSD
 void LinAlgd::posv_(char* UPLO, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER* LDA, DOUBLE* B, INTEGER* LDB, INTEGER* INFO)
 {
+  // use the built-in blocked Cholesky factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::potrf((*UPLO == 'U' || *UPLO == 'u') ? CblasUpper : CblasLower, *N, A, *N);
+    if (*INFO == 0)
+      dpotrs_(UPLO, N, NRHS, A, N, B, LDB, INFO);
+    return;
+  }
+
   dposv_(UPLO, N, NRHS, A, N, B, LDB, INFO);
 }
 
@@ -230,18 +224,13 @@ void LinAlgd::sytri_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* I
 }
 
 /// Calls LAPACK function for factorizing symmetric, indefinite matrix 
-void LinAlgd::sytrf_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER *INFO) 
+void LinAlgd::sytrf_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER *INFO)
 {
-  // perform workspace query for factorization
-  double WORK_QUERY;
-  INTEGER LWORK = -1;
-  dsytrf_(UPLO, N, A, LDA, IPIV, &WORK_QUERY, &LWORK, INFO);
-  assert(*INFO >= 0);
-  if (*INFO > 0)
-    return; 
+  // determine workspace size for factorization
+  INTEGER LWORK, LIWORK;
+  workspace(eSYTRF, ' ', ' ', *N, 0, 0, LWORK, LIWORK);
 
   // setup WORK array
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // perform the necessary factorization
@@ -252,12 +241,10 @@ void LinAlgd::sytrf_(char* UPLO, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* I
 void LinAlgd::geqp3_(INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* JPVT, DOUBLE* TAU, INTEGER* INFO)
 {
   // determine workspace size
-  INTEGER LWORK = -1;
-  DOUBLE work_query;
-  dgeqp3_(M, N, A, LDA, JPVT, TAU, &work_query, &LWORK, INFO);
+  INTEGER LWORK, LIWORK;
+  workspace(eGEQP3, ' ', ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) work_query;
   workv().resize(LWORK);
 
   // do QR factorization
@@ -268,15 +255,10 @@ void LinAlgd::geqp3_(INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* J
 void LinAlgd::geqrf_(INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, DOUBLE* TAU, INTEGER* INFO)
 {
   // determine LWORK
-  const char* NAME = "DGEQRF";
-  const char* OPTS = " ";
-  INTEGER ISPEC = 1L;
-  INTEGER TMP = -1;
-  INTEGER NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, M, N, &TMP, &TMP, strlen(NAME), strlen(OPTS));
-  assert(NB > 0);
+  INTEGER LWORK, LIWORK;
+  workspace(eGEQRF, ' ', ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup WORK vectors
-  INTEGER LWORK = NB*(*N);
   workv().resize(LWORK);
   dgeqrf_(M, N, A, LDA, TAU, workv().data(), &LWORK, INFO);
 }
@@ -284,21 +266,22 @@ void LinAlgd::geqrf_(INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, DOUBLE* TA
 /// Calls LAPACK function for LU factorization 
 void LinAlgd::getrf_(INTEGER* M, INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO)
 {
+  // use the built-in blocked LU factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::getrf(*M, *N, A, *LDA, IPIV);
+    return;
+  }
+
   dgetrf_(M, N, A, LDA, IPIV, INFO);
 }
 
 /// Calls LAPACK function for matrix inversion using LU factorization
 void LinAlgd::getri_(INTEGER* N, DOUBLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO)
 { 
-  // compute block size
-  INTEGER TMP = -1;
-  INTEGER ISPEC = 1;
-  const char* NAME = "DGETRI";
-  const char* OPTS = " ";
-  INTEGER NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, N, &TMP, &TMP, &TMP, strlen(NAME), strlen(OPTS));
-
-  // setup LAPACK parameters
-  INTEGER LWORK = (*N)*NB;
+  // determine LWORK
+  INTEGER LWORK, LIWORK;
+  workspace(eGETRI, ' ', ' ', *N, 0, 0, LWORK, LIWORK);
 
   // setup work vector 
   workv().resize(LWORK);
@@ -315,19 +298,125 @@ void LinAlgd::getrs_(char* TRANS, INTEGER* N, INTEGER* NRHS, DOUBLE* A, INTEGER*
 /// Calls LAPACK function for forming Q from a QR factorization
 void LinAlgd::orgqr_(INTEGER* M, INTEGER* N, INTEGER* K, DOUBLE* A, INTEGER* LDA, DOUBLE* TAU, INTEGER* INFO)
 {
-  // do a workspace query
-  INTEGER LWORK = -1;
-  DOUBLE WORK_QUERY;
-  dorgqr_(M, N, K, A, LDA, TAU, &WORK_QUERY, &LWORK, INFO);
+  // determine workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eORGQR, ' ', ' ', *M, *N, *K, LWORK, LIWORK);
 
   // initialize the work array
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
-  // call the function for real
+  // call the function 
   dorgqr_(M, N, K, A, LDA, TAU, workv().data(), &LWORK, INFO);
 }
 
+/// Calls LAPACK function for computing eigenvalues and eigenvectors of a symmetric tridiagonal matrix
+void LinAlgd::stev_(char* JOBZ, INTEGER* N, DOUBLE* D, DOUBLE* E, DOUBLE* Z, INTEGER* LDZ, INTEGER* INFO)
+{
+  // setup workspace
+  workv().resize(std::max((INTEGER) 1, 2*(*N)-2));
+
+  dstev_(JOBZ, N, D, E, Z, LDZ, workv().data(), INFO);
+}
+
+/// Performs a LAPACK workspace query for a routine and problem size
+/**
+ * LAPACK does not reference the matrix arguments during workspace queries,
+ * so dummy arrays are passed (with leading dimensions large enough to be
+ * valid for the problem size).
+ * \param M the number of rows (or the order, for square routines)
+ * \param N the number of columns (or right hand sides, for sysv)
+ * \param K the number of reflectors (ormqr/orgqr) or right hand sides (gelsd)
+ */
+void LinAlgd::query_lwork(LworkRoutine r, char opt1, char opt2, INTEGER M, INTEGER N, INTEGER K, INTEGER& LWORK, INTEGER& LIWORK)
+{
+  DOUBLE DUMMY[1], WORK_QUERY = (DOUBLE) 1.0, RCOND = (DOUBLE) -1.0;
+  INTEGER IDUMMY[1], IWORK_QUERY = 1, INFO = 0, RANK;
+  INTEGER LD = std::max((INTEGER) 1, std::max(M, std::max(N, K)));
+  INTEGER minmn = std::min(M, N);
+  INTEGER TMP = -1, ISPEC = 1, NB;
+  char UPLO = 'U', TRANS = 'T';
+  const char* OPTS = " ";
+  LWORK = -1;
+  LIWORK = 1;
+
+  switch (r)
+  {
+    case eORMQR:
+      dormqr_(&opt1, &TRANS, &M, &N, &K, DUMMY, &LD, DUMMY, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGELSD:
+    {
+      // compute the integer workspace size 
+      const char* NAME = "DGELSD";
+      ISPEC = 9;
+      TMP = 0;
+      INTEGER smlsiz = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &N, &K, &TMP, strlen(NAME), strlen(OPTS));
+      assert(smlsiz > (INTEGER) 0);
+      INTEGER NLVL = std::max((INTEGER) 0, (INTEGER) (log2((DOUBLE) minmn/(DOUBLE) (smlsiz+1))+1));
+      LIWORK = std::max((INTEGER) 1, 3*minmn*NLVL + 11*minmn);
+      dgelsd_(&M, &N, &K, DUMMY, &LD, DUMMY, &LD, DUMMY, &RCOND, &RANK, &WORK_QUERY, &LWORK, IDUMMY, &INFO);
+      break;
+    }
+
+    case eSYSV:
+      dsysv_(&UPLO, &M, &N, DUMMY, &LD, IDUMMY, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGESDD:
+      LIWORK = std::max((INTEGER) 1, 8*minmn);
+      dgesdd_(&opt1, &M, &N, DUMMY, &LD, DUMMY, DUMMY, &LD, DUMMY, &LD, &WORK_QUERY, &LWORK, IDUMMY, &INFO);
+      break;
+
+    case eGESVD:
+      dgesvd_(&opt1, &opt2, &M, &N, DUMMY, &LD, DUMMY, DUMMY, &LD, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eSYEVD:
+      LIWORK = -1;
+      dsyevd_(&opt1, &UPLO, &M, DUMMY, &LD, DUMMY, &WORK_QUERY, &LWORK, &IWORK_QUERY, &LIWORK, &INFO);
+      LIWORK = std::max((INTEGER) 1, IWORK_QUERY);
+      break;
+
+    case eSYTRF:
+      dsytrf_(&UPLO, &M, DUMMY, &LD, IDUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGEQP3:
+      dgeqp3_(&M, &N, DUMMY, &LD, IDUMMY, DUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGEQRF:
+    {
+      const char* NAME = "DGEQRF";
+      NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &N, &TMP, &TMP, strlen(NAME), strlen(OPTS));
+      assert(NB > 0);
+      WORK_QUERY = (DOUBLE) (NB*N);
+      break;
+    }
+
+    case eGETRI:
+    {
+      const char* NAME = "DGETRI";
+      NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &TMP, &TMP, &TMP, strlen(NAME), strlen(OPTS));
+      assert(NB > 0);
+      WORK_QUERY = (DOUBLE) (NB*M);
+      break;
+    }
+
+    case eORGQR:
+      dorgqr_(&M, &N, &K, DUMMY, &LD, DUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    default:
+      assert(false);
+  }
+  assert(INFO == 0);
+
+  // LAPACK requires a workspace of size at least one
+  LWORK = std::max((INTEGER) 1, (INTEGER) WORK_QUERY);
+}
+
 #include <Ravelin/ddefs.h>
 #include "LinAlg.cpp"
 #include <Ravelin/undefs.h>
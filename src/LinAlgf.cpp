@@ -12,8 +12,11 @@
 #include <limits>
 #include <cstdlib>
 #include <boost/algorithm/minmax.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
 #include <Ravelin/cblas.h>
 #include "clapack.h"
+#include "blocked_blas.h"
 #include <Ravelin/MissizeException.h>
 #include <Ravelin/NonsquareMatrixException.h>
 #include <Ravelin/NumericalException.h>
@@ -58,18 +61,15 @@ void LinAlgf::trtrs_(char* UPLO, char* TRANS, INTEGER* N, INTEGER* NRHS, SINGLE*
 void LinAlgf::ormqr_(char* SIDE, char* TRANS, INTEGER* M, INTEGER* N, INTEGER* K, SINGLE* A, INTEGER* LDA, SINGLE* TAU, SINGLE* C, INTEGER* LDC, INTEGER* INFO)
 {
   // determine workspace size
-  INTEGER LWORK = -1;
-  SINGLE WORK_QUERY;
-  sormqr_(SIDE, TRANS, M, N, K, A, LDA, TAU, C, LDC, &WORK_QUERY, &LWORK, INFO);
-  assert(INFO == 0);
+  INTEGER LWORK, LIWORK;
+  workspace(eORMQR, *SIDE, ' ', *M, *N, *K, LWORK, LIWORK);
 
   // declare memory
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // do the real call now
   sormqr_(SIDE, TRANS, M, N, K, A, LDA, TAU, C, LDC, workv().data(), &LWORK, INFO);
-  assert(INFO == 0);
+  assert(*INFO == 0);
 }
 
 /// Calls LAPACK function for doing LDL' factorization of a matrix
@@ -89,50 +89,29 @@ void LinAlgf::gelsd_(INTEGER* M, INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER*
 {
   // create array to hold singular values
   INTEGER min_mn = std::min(*M, *N);
-  workv().resize(min_mn);
+  workv2().resize(min_mn);
 
-   // necessary for computing WORK sizes
-  INTEGER ISPEC = (INTEGER) 9;
-  INTEGER TMP = (INTEGER) 0;
-  const char* NAME = "SGELSD";
-  const char* OPTS = " ";
-  INTEGER smlsiz = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, M, N, NRHS, &TMP, strlen(NAME), strlen(OPTS));
-  assert(smlsiz > (INTEGER) 0);
-  INTEGER NLVL = std::max((INTEGER) 0, (INTEGER) (log2((float) min_mn/(float) (smlsiz+1))+1));
-  INTEGER LIWORK = std::max((INTEGER) 1, 3*min_mn*NLVL + 11*min_mn);
-  iworkv().resize(LIWORK);
+  // determine workspace sizes
+  INTEGER LWORK, LIWORK;
+  workspace(eGELSD, ' ', ' ', *M, *N, *NRHS, LWORK, LIWORK);
   INTEGER RANK;
 
-  // first do WORK query
-  float WORK_QUERY;
-  INTEGER LWORK = -1;
-  sgelsd_(M, N, NRHS, A, M, B, LDB, workv().data(), RCOND, &RANK, &WORK_QUERY, &LWORK, &iworkv().front(), INFO);
-  assert(*INFO == 0);
-
-  // setup LWORK 
-  LWORK = (INTEGER) WORK_QUERY;
-
-  // setup second WORK array
-  workv2().resize(std::max((INTEGER) 1, LWORK));
+  // setup WORK arrays
+  workv().resize(LWORK);
+  resize_work(iworkv(), LIWORK);
 
   // compute
-  sgelsd_(M, N, NRHS, A, M, B, LDB, workv().data(), RCOND, &RANK, workv2().data(), &LWORK, &iworkv().front(), INFO);
+  sgelsd_(M, N, NRHS, A, M, B, LDB, workv2().data(), RCOND, &RANK, workv().data(), &LWORK, &iworkv().front(), INFO);
 }
 
 /// Calls appropriate LAPACK function for solving systems of linear equations Ax=b, where A is symmetric indefinite
 void LinAlgf::sysv_(char* UPLO, INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, SINGLE* B, INTEGER* LDB, INTEGER* INFO)
 { 
-  INTEGER LWORK = -1;
-  float WORK_QUERY;
-
-  // first, determine workspace size
-  ssysv_(UPLO, N, NRHS, A, LDA, IPIV, B, LDB, &WORK_QUERY, &LWORK, INFO);
-  assert(*INFO >= 0);
-  if (*INFO > 0)
-    return;
+  // determine workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eSYSV, ' ', ' ', *N, *NRHS, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // call LAPACK
@@ -142,61 +121,61 @@ void LinAlgf::sysv_(char* UPLO, INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER* L
 /// Calls LAPACK function for svd (divide and conquer)
 void LinAlgf::gesdd_(char* JOBZ, INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, SINGLE* S, SINGLE* U, INTEGER* LDU, SINGLE* V, INTEGER* LDVT, INTEGER* INFO)
 {
-  float WORK_QUERY;
-  INTEGER minmn = std::min(*M, *N);
-  INTEGER LWORK = -1;
-  iworkv().resize(8*minmn);
-
-  // call LAPACK to determine the optimal workspace size
-  sgesdd_(JOBZ, M, N, A, LDA, S, U, LDU, V, LDVT, &WORK_QUERY, &LWORK, &iworkv().front(), INFO);
+  // determine the optimal workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eGESDD, *JOBZ, ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK); 
+  resize_work(iworkv(), LIWORK);
 
-  // call LAPACK once again
+  // call LAPACK 
   sgesdd_(JOBZ, M, N, A, LDA, S, U, LDU, V, LDVT, workv().data(), &LWORK, &iworkv().front(), INFO);
 }
 
 /// Calls LAPACK function for svd 
 void LinAlgf::gesvd_(char* JOBU, char* JOBV, INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, SINGLE* S, SINGLE* U, INTEGER* LDU, SINGLE* V, INTEGER* LDVT, INTEGER* INFO)
 {
-  float WORK_QUERY;
-  INTEGER minmn = std::min(*M, *N);
-  INTEGER LWORK = -1;
-
-  // call LAPACK to determine the optimal workspace size
-  sgesvd_(JOBU, JOBV, M, N, A, LDA, S, U, LDU, V, LDVT, &WORK_QUERY, &LWORK, INFO);
+  // determine the optimal workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eGESVD, *JOBU, *JOBV, *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK); 
 
-  // call LAPACK once again
+  // call LAPACK 
   sgesvd_(JOBU, JOBV, M, N, A, LDA, S, U, LDU, V, LDVT, workv().data(), &LWORK, INFO);
 }
 
 /// Calls LAPACK function for computing eigenvalues and eigenvectors
 void LinAlgf::syevd_(char* JOBZ, char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, SINGLE* EVALS, INTEGER* INFO)
 {
-  // do work query first
-  float WORK_QUERY;
-  INTEGER LWORK = -1;
-  INTEGER IWORK_QUERY;
-  INTEGER LIWORK = -1;
-  ssyevd_(JOBZ, UPLO, N, A, LDA, EVALS, &WORK_QUERY, &LWORK, &IWORK_QUERY, &LIWORK, INFO);
+  // determine the optimal workspace sizes
+  INTEGER LWORK, LIWORK;
+  workspace(eSYEVD, *JOBZ, ' ', *N, 0, 0, LWORK, LIWORK);
 
   // set array sizes
-  LWORK = (INTEGER) WORK_QUERY;
-  LIWORK = IWORK_QUERY;
   workv().resize(LWORK);
-  iworkv().resize(LIWORK);
+  resize_work(iworkv(), LIWORK);
+
   ssyevd_(JOBZ, UPLO, N, A, LDA, EVALS, workv().data(), &LWORK, &iworkv().front(), &LIWORK, INFO);
 }
 
 /// Calls LAPACK function for solving system of linear equations using LU factorization
 void LinAlgf::gesv_(INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, SINGLE* X, INTEGER* LDX, INTEGER* INFO)
 {
+  // use the built-in blocked LU factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::getrf(*N, *N, A, *LDA, IPIV);
+    if (*INFO == 0)
+    {
+      char TRANS = 'N';
+      sgetrs_(&TRANS, N, NRHS, A, LDA, IPIV, X, LDX, INFO);
+    }
+    return;
+  }
+
   sgesv_(N, NRHS, A, LDA, IPIV, X, LDX, INFO);
 }
 
@@ -215,12 +194,28 @@ void LinAlgf::potri_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* I
 /// Calls LAPACK function for Cholesky factorization
 void LinAlgf::potrf_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* INFO)
 {
+  // use the built-in blocked Cholesky factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::potrf((*UPLO == 'U' || *UPLO == 'u') ? CblasUpper : CblasLower, *N, A, *LDA);
+    return;
+  }
+
   spotrf_(UPLO, N, A, LDA, INFO);
 }
 
 /// Calls LAPACK function for solving system of equations Ax=b, where A is PSD
 void LinAlgf::posv_(char* UPLO, INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER* LDA, SINGLE* B, INTEGER* LDB, INTEGER* INFO)
 {
+  // use the built-in blocked Cholesky factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::potrf((*UPLO == 'U' || *UPLO == 'u') ? CblasUpper : CblasLower, *N, A, *N);
+    if (*INFO == 0)
+      spotrs_(UPLO, N, NRHS, A, N, B, LDB, INFO);
+    return;
+  }
+
   sposv_(UPLO, N, NRHS, A, N, B, LDB, INFO);
 }
 
@@ -232,18 +227,13 @@ void LinAlgf::sytri_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* I
 }
 
 /// Calls LAPACK function for factorizing symmetric, indefinite matrix 
-void LinAlgf::sytrf_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO) 
+void LinAlgf::sytrf_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO)
 {
-  // perform workspace query for factorization
-  float WORK_QUERY;
-  INTEGER LWORK = -1;
-  ssytrf_(UPLO, N, A, LDA, IPIV, &WORK_QUERY, &LWORK, INFO);
-  assert(*INFO >= 0);
-  if (*INFO > 0)
-    return; 
+  // determine workspace size for factorization
+  INTEGER LWORK, LIWORK;
+  workspace(eSYTRF, ' ', ' ', *N, 0, 0, LWORK, LIWORK);
 
   // setup WORK array
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
   // perform the necessary factorization
@@ -254,12 +244,10 @@ void LinAlgf::sytrf_(char* UPLO, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* I
 void LinAlgf::geqp3_(INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* JPVT, SINGLE* TAU, INTEGER* INFO)
 {
   // determine workspace size
-  INTEGER LWORK = -1;
-  SINGLE work_query;
-  sgeqp3_(M, N, A, LDA, JPVT, TAU, &work_query, &LWORK, INFO);
+  INTEGER LWORK, LIWORK;
+  workspace(eGEQP3, ' ', ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup workspace
-  LWORK = (INTEGER) work_query;
   workv().resize(LWORK);
 
   // do QR factorization
@@ -270,15 +258,10 @@ void LinAlgf::geqp3_(INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* J
 void LinAlgf::geqrf_(INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, SINGLE* TAU, INTEGER* INFO)
 {
   // determine LWORK
-  const char* NAME = "SGEQRF";
-  const char* OPTS = " ";
-  INTEGER ISPEC = 1L;
-  INTEGER TMP = -1;
-  INTEGER NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, M, N, &TMP, &TMP, strlen(NAME), strlen(OPTS));
-  assert(NB >= 0);
+  INTEGER LWORK, LIWORK;
+  workspace(eGEQRF, ' ', ' ', *M, *N, 0, LWORK, LIWORK);
 
   // setup WORK vectors
-  INTEGER LWORK = NB*(*N);
   workv().resize(LWORK);
   sgeqrf_(M, N, A, LDA, TAU, workv().data(), &LWORK, INFO);
 }
@@ -286,23 +269,24 @@ void LinAlgf::geqrf_(INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, SINGLE* TA
 /// Calls LAPACK function for LU factorization 
 void LinAlgf::getrf_(INTEGER* M, INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO)
 {
+  // use the built-in blocked LU factorization, if selected
+  if (CBLAS::get_backend() == CBLAS::eBuiltin)
+  {
+    *INFO = BlockedBLAS::getrf(*M, *N, A, *LDA, IPIV);
+    return;
+  }
+
   sgetrf_(M, N, A, LDA, IPIV, INFO);
 }
 
 /// Calls LAPACK function for matrix inversion using LU factorization
 void LinAlgf::getri_(INTEGER* N, SINGLE* A, INTEGER* LDA, INTEGER* IPIV, INTEGER* INFO)
 { 
-  // compute block size
-  INTEGER TMP = -1;
-  INTEGER ISPEC = 1;
-  const char* NAME = "SGETRI";
-  const char* OPTS = " ";
-  INTEGER NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, N, &TMP, &TMP, &TMP, strlen(NAME), strlen(OPTS));
-
-  // setup LAPACK parameters
-  INTEGER LWORK = (*N)*NB;
+  // determine LWORK
+  INTEGER LWORK, LIWORK;
+  workspace(eGETRI, ' ', ' ', *N, 0, 0, LWORK, LIWORK);
 
-  // setup work vector
+  // setup work vector 
   workv().resize(LWORK);
   
   sgetri_(N, A, LDA, IPIV, workv().data(), &LWORK, INFO);
@@ -317,19 +301,125 @@ void LinAlgf::getrs_(char* TRANS, INTEGER* N, INTEGER* NRHS, SINGLE* A, INTEGER*
 /// Calls LAPACK function for forming Q from a QR factorization
 void LinAlgf::orgqr_(INTEGER* M, INTEGER* N, INTEGER* K, SINGLE* A, INTEGER* LDA, SINGLE* TAU, INTEGER* INFO)
 {
-  // do a workspace query
-  INTEGER LWORK = -1;
-  SINGLE WORK_QUERY;
-  sorgqr_(M, N, K, A, LDA, TAU, &WORK_QUERY, &LWORK, INFO);
+  // determine workspace size
+  INTEGER LWORK, LIWORK;
+  workspace(eORGQR, ' ', ' ', *M, *N, *K, LWORK, LIWORK);
 
   // initialize the work array
-  LWORK = (INTEGER) WORK_QUERY;
   workv().resize(LWORK);
 
-  // call the function for real
+  // call the function 
   sorgqr_(M, N, K, A, LDA, TAU, workv().data(), &LWORK, INFO);
 }
 
+/// Calls LAPACK function for computing eigenvalues and eigenvectors of a symmetric tridiagonal matrix
+void LinAlgf::stev_(char* JOBZ, INTEGER* N, SINGLE* D, SINGLE* E, SINGLE* Z, INTEGER* LDZ, INTEGER* INFO)
+{
+  // setup workspace
+  workv().resize(std::max((INTEGER) 1, 2*(*N)-2));
+
+  sstev_(JOBZ, N, D, E, Z, LDZ, workv().data(), INFO);
+}
+
+/// Performs a LAPACK workspace query for a routine and problem size
+/**
+ * LAPACK does not reference the matrix arguments during workspace queries,
+ * so dummy arrays are passed (with leading dimensions large enough to be
+ * valid for the problem size).
+ * \param M the number of rows (or the order, for square routines)
+ * \param N the number of columns (or right hand sides, for sysv)
+ * \param K the number of reflectors (ormqr/orgqr) or right hand sides (gelsd)
+ */
+void LinAlgf::query_lwork(LworkRoutine r, char opt1, char opt2, INTEGER M, INTEGER N, INTEGER K, INTEGER& LWORK, INTEGER& LIWORK)
+{
+  SINGLE DUMMY[1], WORK_QUERY = (SINGLE) 1.0, RCOND = (SINGLE) -1.0;
+  INTEGER IDUMMY[1], IWORK_QUERY = 1, INFO = 0, RANK;
+  INTEGER LD = std::max((INTEGER) 1, std::max(M, std::max(N, K)));
+  INTEGER minmn = std::min(M, N);
+  INTEGER TMP = -1, ISPEC = 1, NB;
+  char UPLO = 'U', TRANS = 'T';
+  const char* OPTS = " ";
+  LWORK = -1;
+  LIWORK = 1;
+
+  switch (r)
+  {
+    case eORMQR:
+      sormqr_(&opt1, &TRANS, &M, &N, &K, DUMMY, &LD, DUMMY, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGELSD:
+    {
+      // compute the integer workspace size 
+      const char* NAME = "SGELSD";
+      ISPEC = 9;
+      TMP = 0;
+      INTEGER smlsiz = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &N, &K, &TMP, strlen(NAME), strlen(OPTS));
+      assert(smlsiz > (INTEGER) 0);
+      INTEGER NLVL = std::max((INTEGER) 0, (INTEGER) (log2((SINGLE) minmn/(SINGLE) (smlsiz+1))+1));
+      LIWORK = std::max((INTEGER) 1, 3*minmn*NLVL + 11*minmn);
+      sgelsd_(&M, &N, &K, DUMMY, &LD, DUMMY, &LD, DUMMY, &RCOND, &RANK, &WORK_QUERY, &LWORK, IDUMMY, &INFO);
+      break;
+    }
+
+    case eSYSV:
+      ssysv_(&UPLO, &M, &N, DUMMY, &LD, IDUMMY, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGESDD:
+      LIWORK = std::max((INTEGER) 1, 8*minmn);
+      sgesdd_(&opt1, &M, &N, DUMMY, &LD, DUMMY, DUMMY, &LD, DUMMY, &LD, &WORK_QUERY, &LWORK, IDUMMY, &INFO);
+      break;
+
+    case eGESVD:
+      sgesvd_(&opt1, &opt2, &M, &N, DUMMY, &LD, DUMMY, DUMMY, &LD, DUMMY, &LD, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eSYEVD:
+      LIWORK = -1;
+      ssyevd_(&opt1, &UPLO, &M, DUMMY, &LD, DUMMY, &WORK_QUERY, &LWORK, &IWORK_QUERY, &LIWORK, &INFO);
+      LIWORK = std::max((INTEGER) 1, IWORK_QUERY);
+      break;
+
+    case eSYTRF:
+      ssytrf_(&UPLO, &M, DUMMY, &LD, IDUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGEQP3:
+      sgeqp3_(&M, &N, DUMMY, &LD, IDUMMY, DUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    case eGEQRF:
+    {
+      const char* NAME = "SGEQRF";
+      NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &N, &TMP, &TMP, strlen(NAME), strlen(OPTS));
+      assert(NB > 0);
+      WORK_QUERY = (SINGLE) (NB*N);
+      break;
+    }
+
+    case eGETRI:
+    {
+      const char* NAME = "SGETRI";
+      NB = ilaenv_(&ISPEC, (char*) NAME, (char*) OPTS, &M, &TMP, &TMP, &TMP, strlen(NAME), strlen(OPTS));
+      assert(NB > 0);
+      WORK_QUERY = (SINGLE) (NB*M);
+      break;
+    }
+
+    case eORGQR:
+      sorgqr_(&M, &N, &K, DUMMY, &LD, DUMMY, &WORK_QUERY, &LWORK, &INFO);
+      break;
+
+    default:
+      assert(false);
+  }
+  assert(INFO == 0);
+
+  // LAPACK requires a workspace of size at least one
+  LWORK = std::max((INTEGER) 1, (INTEGER) WORK_QUERY);
+}
+
 #include <Ravelin/fdefs.h>
 #include "LinAlg.cpp"
 #include <Ravelin/undefs.h>
@@ -1,17 +1,545 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
 #include <Ravelin/Log.h>
 
 using namespace Ravelin;
 
-std::ofstream OutputToFile::stream;
+LogFile OutputToFile::stream;
+
+/// The ring buffer of a thread; the thread writes tail and pending, and the flusher writes head
+struct LogRing
+{
+  char* data;
+  boost::uint64_t head;
+  boost::uint64_t tail;
+  boost::uint64_t pending;           // no greater than the sequence number of a record being published
+  int abandoned;                     // set when the thread exits
+};
+
+// the value of pending when the thread is not publishing a record
+static const boost::uint64_t NOT_PENDING = std::numeric_limits<boost::uint64_t>::max();
+
+/// Writes formatted text into the record that is being formatted
+class LogRecordBuffer : public std::streambuf
+{
+  public:
+    LogRecordBuffer() { record = NULL; }
+    LogRecord* record;
+
+  protected:
+    virtual int_type overflow(int_type c)
+    {
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+        char ch = traits_type::to_char_type(c);
+        record->append_text(&ch, 1);
+      }
+      return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+      record->append_text(s, n);
+      return n;
+    }
+};
+
+/// The stream with which a thread formats values that are not captured in binary form
+struct LogFormatter
+{
+  LogFormatter() : os(&buffer) { }
+  LogRecordBuffer buffer;
+  std::ostream os;
+};
+
+/// The buffers of the consumer (used with the consumer lock held)
+struct LogConsumer
+{
+  LogConsumer() { prefix_time = -1; }
+  std::ostringstream text;           // formatted messages not yet written
+  std::vector<char> record;          // the record being formatted
+  std::string prefix;                // the text of prefix_time
+  boost::int64_t prefix_time;
+};
+
+// the state of the backend; the consumer is never destroyed, so that
+// messages can be written at exit
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+static pthread_key_t formatter_key;
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t consumer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<LogRing*>* rings = NULL;
+static LogConsumer* consumer = NULL;
+static pthread_t flusher;
+static int initialized = 0;
+static int stopping = 0;
+static boost::int64_t cached_time = 0;
+static boost::uint64_t next_sequence = 0;
+
+// the interval at which the flusher writes messages and updates the time
+static const long FLUSH_INTERVAL_NS = 2000000;
+
+/// Marks the ring of an exiting thread, so that the flusher frees it once it is empty
+static void release_ring(void* ring)
+{
+  __atomic_store_n(&((LogRing*) ring)->abandoned, 1, __ATOMIC_RELEASE);
+}
+
+/// Frees the formatter of an exiting thread
+static void release_formatter(void* formatter)
+{
+  delete (LogFormatter*) formatter;
+}
 
-void OutputToFile::output(const std::string& msg)
+/// Writes messages and updates the cached time until the program exits
+static void* flusher_thread(void*)
 {
-  if (!stream.is_open())
+  timespec interval;
+  interval.tv_sec = 0;
+  interval.tv_nsec = FLUSH_INTERVAL_NS;
+  while (!__atomic_load_n(&stopping, __ATOMIC_ACQUIRE))
   {
-    std::ofstream stderr_stream("/dev/stderr", std::ofstream::app);
-    stderr_stream << msg << std::flush;
+    __atomic_store_n(&cached_time, (boost::int64_t) std::time(NULL), __ATOMIC_RELAXED);
+    OutputToFile::flush();
+    nanosleep(&interval, NULL);
   }
+  return NULL;
+}
+
+/// Stops the flusher and writes the remaining messages when the program exits
+static void shutdown()
+{
+  __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+  pthread_join(flusher, NULL);
+  OutputToFile::flush();
+}
+
+/// Initializes the backend and starts the flusher
+static void init()
+{
+  pthread_key_create(&ring_key, &release_ring);
+  pthread_key_create(&formatter_key, &release_formatter);
+  rings = new std::vector<LogRing*>;
+  consumer = new LogConsumer;
+  cached_time = std::time(NULL);
+  __atomic_store_n(&initialized, 1, __ATOMIC_RELEASE);
+  if (pthread_create(&flusher, NULL, &flusher_thread, NULL) == 0)
+    std::atexit(&shutdown);
   else
-    stream << msg << std::flush;
+    std::cerr << "Log - unable to start the flusher thread; messages are written when full or at flush()" << std::endl;
+}
+
+/// Gets the calling thread's ring buffer, creating it if necessary
+static LogRing* this_ring()
+{
+  LogRing* ring = (LogRing*) pthread_getspecific(ring_key);
+  if (!ring)
+  {
+    ring = new LogRing;
+    ring->data = new char[OutputToFile::RING_SIZE];
+    ring->head = ring->tail = 0;
+    ring->pending = NOT_PENDING;
+    ring->abandoned = 0;
+    pthread_mutex_lock(&registry_mutex);
+    rings->push_back(ring);
+    pthread_mutex_unlock(&registry_mutex);
+    pthread_setspecific(ring_key, ring);
+  }
+  return ring;
+}
+
+/// Copies data into a ring at the given position, wrapping around its end
+static void ring_write(LogRing* ring, boost::uint64_t pos, const char* data, size_t n)
+{
+  size_t offset = pos % OutputToFile::RING_SIZE;
+  size_t n1 = std::min(n, OutputToFile::RING_SIZE - offset);
+  std::memcpy(ring->data + offset, data, n1);
+  std::memcpy(ring->data, data + n1, n - n1);
+}
+
+/// Copies data out of a ring from the given position, wrapping around its end
+static void ring_read(const LogRing* ring, boost::uint64_t pos, char* data, size_t n)
+{
+  size_t offset = pos % OutputToFile::RING_SIZE;
+  size_t n1 = std::min(n, OutputToFile::RING_SIZE - offset);
+  std::memcpy(data, ring->data + offset, n1);
+  std::memcpy(data + n1, ring->data, n - n1);
+}
+
+/// Prints a value captured in a record
+template <class T>
+static const char* print(const char* p, std::ostream& out)
+{
+  T x;
+  std::memcpy(&x, p, sizeof(T));
+  out << x;
+  return p + sizeof(T);
+}
+
+/// Formats a record as "- h:m:s level: message"
+static void format_record(const char* record, std::ostream& out)
+{
+  LogRecord::Header header;
+  std::memcpy(&header, record, sizeof(header));
+
+  // the time changes at most once per second, so its text is cached
+  if (header.time != consumer->prefix_time)
+  {
+    time_t rawtime = (time_t) header.time;
+    tm t;
+    gmtime_r(&rawtime, &t);
+    std::ostringstream oss;
+    oss << "- " << t.tm_hour << ":" << t.tm_min << ":" << t.tm_sec;
+    consumer->prefix = oss.str();
+    consumer->prefix_time = header.time;
+  }
+  out << consumer->prefix << " " << header.level << ": ";
+
+  const char* p = record + sizeof(header);
+  const char* end = record + header.size;
+  while (p < end)
+  {
+    switch (*p++)
+    {
+      case LogRecord::eText:
+      {
+        boost::uint32_t len;
+        std::memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        out.write(p, len);
+        p += len;
+        break;
+      }
+      case LogRecord::eBool:       p = print<bool>(p, out); break;
+      case LogRecord::eChar:       p = print<char>(p, out); break;
+      case LogRecord::eInt:        p = print<int>(p, out); break;
+      case LogRecord::eUnsigned:   p = print<unsigned>(p, out); break;
+      case LogRecord::eLong:       p = print<long>(p, out); break;
+      case LogRecord::eULong:      p = print<unsigned long>(p, out); break;
+      case LogRecord::eLongLong:   p = print<long long>(p, out); break;
+      case LogRecord::eULongLong:  p = print<unsigned long long>(p, out); break;
+      case LogRecord::eDouble:     p = print<double>(p, out); break;
+      default:                     return;
+    }
+  }
+}
+
+/// Writes formatted messages to the log file, or to stderr if it is not open (the consumer lock must be held)
+static void write_text(std::ofstream& file)
+{
+  std::ostringstream& text = consumer->text;
+  const std::string& s = text.str();
+  if (s.empty())
+    return;
+  if (file.is_open())
+    file.write(s.data(), s.size()).flush();
+  else
+  {
+    std::fwrite(s.data(), 1, s.size(), stderr);
+    std::fflush(stderr);
+  }
+  text.str("");
+}
+
+/// Finds the ring holding the earliest published record that has not been formatted (the registry lock must be held)
+static LogRing* earliest_ring(LogRecord::Header& next_header)
+{
+  LogRing* next = NULL;
+  LogRecord::Header header;
+  for (unsigned i=0; i< rings->size(); i++)
+  {
+    LogRing* ring = (*rings)[i];
+    if (ring->head == __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST))
+      continue;
+    ring_read(ring, ring->head, (char*) &header, sizeof(header));
+    if (!next || header.sequence < next_header.sequence)
+    {
+      next = ring;
+      next_header = header;
+    }
+  }
+  return next;
+}
+
+/// Formats the pending records of every thread, in order (the consumer lock must be held)
+/**
+ * A record is held back while a record with an earlier sequence number has
+ * been numbered but not yet published; it is formatted by a later call. If
+ * ordered is false, every published record is formatted.
+ */
+static void drain(bool ordered = true)
+{
+  std::vector<char>& record = consumer->record;
+
+  pthread_mutex_lock(&registry_mutex);
+  while (true)
+  {
+    // find the earliest record at the head of a ring
+    LogRecord::Header next_header;
+    LogRing* next = earliest_ring(next_header);
+    if (!next)
+      break;
+
+    // stop at a record that a record still being published must precede;
+    // a record published while the bound was read may precede the one found,
+    // so the search is repeated in that case
+    if (ordered)
+    {
+      boost::uint64_t bound = NOT_PENDING;
+      for (unsigned i=0; i< rings->size(); i++)
+        bound = std::min(bound, __atomic_load_n(&(*rings)[i]->pending, __ATOMIC_SEQ_CST));
+      LogRecord::Header check_header;
+      if (earliest_ring(check_header) != next || check_header.sequence != next_header.sequence)
+        continue;
+      if (next_header.sequence >= bound)
+        break;
+    }
+
+    // copy it out, release its space, and format it
+    record.resize(next_header.size);
+    ring_read(next, next->head, &record[0], next_header.size);
+    __atomic_store_n(&next->head, next->head + next_header.size, __ATOMIC_RELEASE);
+    format_record(&record[0], consumer->text);
+  }
+
+  // free the rings of threads that have exited, once they are empty
+  for (unsigned i=0; i< rings->size(); )
+  {
+    LogRing* ring = (*rings)[i];
+    if (__atomic_load_n(&ring->abandoned, __ATOMIC_ACQUIRE) && ring->head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+    {
+      delete [] ring->data;
+      delete ring;
+      rings->erase(rings->begin() + i);
+    }
+    else
+      i++;
+  }
+  pthread_mutex_unlock(&registry_mutex);
+}
+
+/// Writes all pending messages
+void OutputToFile::flush()
+{
+  if (!__atomic_load_n(&initialized, __ATOMIC_ACQUIRE))
+    return;
+
+  pthread_mutex_lock(&consumer_mutex);
+  drain();
+  write_text(stream._stream);
+  pthread_mutex_unlock(&consumer_mutex);
+}
+
+/// Writes all published messages synchronously from a fatal path
+/**
+ * This is meant to be called before abort() and from handlers for fatal
+ * signals (e.g., SIGSEGV), when the messages still in the ring buffers would
+ * otherwise be lost. Unlike flush(), it waits at most FLUSH_INTERVAL_NS for
+ * the lock (writing nothing if the lock is not released, e.g., because the
+ * crash occurred while writing) and holds back no published record. It is
+ * not async-signal-safe, since records are formatted with iostreams.
+ */
+void OutputToFile::flush_fatal()
+{
+  if (!__atomic_load_n(&initialized, __ATOMIC_ACQUIRE))
+    return;
+
+  timespec interval;
+  interval.tv_sec = 0;
+  interval.tv_nsec = FLUSH_INTERVAL_NS/100;
+  unsigned attempts = 0;
+  while (pthread_mutex_trylock(&consumer_mutex) != 0)
+  {
+    if (++attempts > 100)
+      return;
+    nanosleep(&interval, NULL);
+  }
+  drain(false);
+  write_text(stream._stream);
+  pthread_mutex_unlock(&consumer_mutex);
+}
+
+/// Queues a message in the calling thread's ring buffer
+/**
+ * This takes no locks unless the buffer is full (in which case the calling
+ * thread writes the pending messages itself) or this is the first message
+ * of the thread. While the record is numbered and copied, the ring's pending
+ * field bounds its sequence number from below, so that drain() does not
+ * write records numbered after it first.
+ */
+void OutputToFile::output(LogRecord& record)
+{
+  pthread_once(&log_once, &init);
+  LogRing* ring = this_ring();
+  size_t n = record.size();
+
+  // a message larger than the ring is written directly, after the others
+  if (n > RING_SIZE)
+  {
+    const char* data = record.finish(__atomic_fetch_add(&next_sequence, 1, __ATOMIC_SEQ_CST));
+    pthread_mutex_lock(&consumer_mutex);
+    drain();
+    format_record(data, consumer->text);
+    write_text(stream._stream);
+    pthread_mutex_unlock(&consumer_mutex);
+    return;
+  }
+
+  // wait for space, then number and publish the record
+  while (RING_SIZE - (ring->tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) < n)
+    flush();
+  __atomic_store_n(&ring->pending, __atomic_load_n(&next_sequence, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+  const char* data = record.finish(__atomic_fetch_add(&next_sequence, 1, __ATOMIC_SEQ_CST));
+  ring_write(ring, ring->tail, data, n);
+  __atomic_store_n(&ring->tail, ring->tail + n, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&ring->pending, NOT_PENDING, __ATOMIC_SEQ_CST);
+}
+
+/// Starts a record at the given level, stamped with the cached time
+void LogRecord::start(unsigned level)
+{
+  pthread_once(&log_once, &init);
+
+  Header header;
+  header.size = 0;
+  header.level = level;
+  header.sequence = 0;
+  header.time = __atomic_load_n(&cached_time, __ATOMIC_RELAXED);
+  std::memcpy(_data, &header, sizeof(header));
+  _size = sizeof(header);
+  _text = 0;
+  _formatted = false;
+  _default_format = true;
+}
+
+/// Makes room for a record of n bytes
+void LogRecord::reserve(size_t n)
+{
+  if (n <= _capacity)
+    return;
+
+  size_t capacity = std::max(n, 2*_capacity);
+  char* data = new char[capacity];
+  std::memcpy(data, _data, _size);
+  if (_data != _inline)
+    delete [] _data;
+  _data = data;
+  _capacity = capacity;
+}
+
+/// Appends text to the record, extending the last item if it is text
+void LogRecord::append_text(const char* s, size_t n)
+{
+  boost::uint32_t len = n;
+  if (_text > 0)
+  {
+    reserve(_size + n);
+    boost::uint32_t old_len;
+    std::memcpy(&old_len, _data + _text, sizeof(old_len));
+    len += old_len;
+  }
+  else
+  {
+    reserve(_size + 1 + sizeof(len) + n);
+    _data[_size++] = (char) eText;
+    _text = _size;
+    _size += sizeof(len);
+  }
+  std::memcpy(_data + _text, &len, sizeof(len));
+  std::memcpy(_data + _size, s, n);
+  _size += n;
+}
+
+/// Gets the thread's stream, directed into this record
+std::ostream& LogRecord::begin_format()
+{
+  LogFormatter* formatter = (LogFormatter*) pthread_getspecific(formatter_key);
+  if (!formatter)
+  {
+    formatter = new LogFormatter;
+    pthread_setspecific(formatter_key, formatter);
+  }
+
+  // each message starts with the default format
+  if (!_formatted)
+  {
+    formatter->os.flags(std::ios_base::skipws | std::ios_base::dec);
+    formatter->os.precision(6);
+    formatter->os.width(0);
+    formatter->os.fill(' ');
+    _formatted = true;
+  }
+
+  _previous = formatter->buffer.record;
+  formatter->buffer.record = this;
+  return formatter->os;
+}
+
+/// Restores the thread's stream after formatting and notes whether its format is still the default
+void LogRecord::end_format(std::ostream& os)
+{
+  ((LogRecordBuffer*) os.rdbuf())->record = (LogRecord*) _previous;
+  _default_format = os.flags() == (std::ios_base::skipws | std::ios_base::dec) && os.precision() == 6 && os.width() == 0;
+}
+
+/// Applies a manipulator; the end of a line is captured as text, since the flusher flushes
+LogRecord& LogRecord::operator<<(std::ostream& (*manip)(std::ostream&))
+{
+  if (manip == static_cast<std::ostream& (*)(std::ostream&)>(std::endl))
+    append_text("\n", 1);
+  else if (manip != static_cast<std::ostream& (*)(std::ostream&)>(std::flush))
+  {
+    std::ostream& os = begin_format();
+    manip(os);
+    end_format(os);
+  }
+  return *this;
+}
+
+/// Applies a manipulator that changes the format (e.g., std::fixed)
+LogRecord& LogRecord::operator<<(std::ios_base& (*manip)(std::ios_base&))
+{
+  std::ostream& os = begin_format();
+  manip(os);
+  end_format(os);
+  return *this;
+}
+
+/// Opens the log file, after writing any pending messages to the previous destination
+void LogFile::open(const char* fname, std::ios_base::openmode mode)
+{
+  OutputToFile::flush();
+  pthread_mutex_lock(&consumer_mutex);
+  _stream.clear();
+  _stream.open(fname, mode);
+  pthread_mutex_unlock(&consumer_mutex);
+}
+
+/// Writes any pending messages and closes the log file
+void LogFile::close()
+{
+  OutputToFile::flush();
+  pthread_mutex_lock(&consumer_mutex);
+  _stream.close();
+  pthread_mutex_unlock(&consumer_mutex);
+}
+
+/// Determines whether the log file is open
+bool LogFile::is_open()
+{
+  pthread_mutex_lock(&consumer_mutex);
+  bool open = _stream.is_open();
+  pthread_mutex_unlock(&consumer_mutex);
+  return open;
 }
 
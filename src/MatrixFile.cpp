@@ -0,0 +1,416 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+using std::string;
+using boost::shared_ptr;
+using boost::shared_array;
+
+/// Unmaps the file
+MATRIX_FILE::MappedFile::~MappedFile()
+{
+  munmap(data, size);
+}
+
+/// Adds data to the checksum
+void MATRIX_FILE::Checksum::update(const void* data, size_t nbytes)
+{
+  const boost::uint64_t FNV_PRIME = 1099511628211ULL;
+  const char* bytes = (const char*) data;
+
+  // complete any partial word from the last update
+  while (_npartial > 0 && nbytes > 0)
+  {
+    _partial[_npartial++] = *bytes++;
+    nbytes--;
+    if (_npartial == sizeof(_partial))
+    {
+      boost::uint64_t word;
+      std::memcpy(&word, _partial, sizeof(word));
+      _value = (_value ^ word) * FNV_PRIME;
+      _npartial = 0;
+    }
+  }
+
+  // hash whole words, then save any remaining bytes
+  for (; nbytes >= sizeof(boost::uint64_t); bytes += sizeof(boost::uint64_t), nbytes -= sizeof(boost::uint64_t))
+  {
+    boost::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    _value = (_value ^ word) * FNV_PRIME;
+  }
+  std::memcpy(_partial + _npartial, bytes, nbytes);
+  _npartial += nbytes;
+}
+
+/// Sets up a header
+void MATRIX_FILE::init_header(Header& header, ObjectType object, unsigned rows, unsigned columns, unsigned nnz, bool checksum)
+{
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, "RAVELINM", sizeof(header.magic));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.object = object;
+  header.real_size = sizeof(REAL);
+  header.has_checksum = (checksum) ? 1 : 0;
+  header.rows = rows;
+  header.columns = columns;
+  header.leading_dim = rows;
+  header.nnz = nnz;
+}
+
+/// Writes data, adding it to the checksum (if any)
+void MATRIX_FILE::write_data(std::ostream& out, const void* data, size_t nbytes, Checksum* checksum)
+{
+  out.write((const char*) data, nbytes);
+  if (checksum)
+    checksum->update(data, nbytes);
+}
+
+/// Pads data of the given size to an 8-byte boundary
+void MATRIX_FILE::write_padding(std::ostream& out, size_t nbytes, Checksum* checksum)
+{
+  const char ZEROS[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  write_data(out, ZEROS, padded(nbytes) - nbytes, checksum);
+}
+
+/// Writes the checksum (if any) after the data
+bool MATRIX_FILE::finish(std::ostream& out, const Checksum* checksum)
+{
+  if (checksum)
+  {
+    boost::uint64_t value = checksum->value();
+    out.write((const char*) &value, sizeof(value));
+  }
+  out.flush();
+  return !out.fail();
+}
+
+/// Writes a vector to a binary stream
+/**
+ * \param checksum if <b>true</b>, a checksum of the data is written, which
+ *        read() verifies
+ * \return <b>true</b> if the vector was written successfully
+ */
+bool MATRIX_FILE::write(std::ostream& out, const CONST_SHAREDVECTORN& v, bool checksum)
+{
+  Header header;
+  init_header(header, eVector, v.size(), 1, 0, checksum);
+  out.write((const char*) &header, sizeof(Header));
+
+  // contiguous vectors are written at once; others one element at a time
+  Checksum sum;
+  Checksum* psum = (checksum) ? &sum : NULL;
+  if (v.inc() == 1 || v.size() == 0)
+    write_data(out, v.data(), sizeof(REAL)*v.size(), psum);
+  else
+    for (unsigned i=0; i< v.size(); i++)
+      write_data(out, v.data() + i*v.inc(), sizeof(REAL), psum);
+  write_padding(out, sizeof(REAL)*v.size(), psum);
+
+  return finish(out, psum);
+}
+
+/// Writes a dense matrix to a binary stream
+/**
+ * The matrix is written with its leading dimension equal to its number of
+ * rows, whatever its leading dimension in memory.
+ * \param checksum if <b>true</b>, a checksum of the data is written, which
+ *        read() verifies
+ * \return <b>true</b> if the matrix was written successfully
+ */
+bool MATRIX_FILE::write(std::ostream& out, const CONST_SHAREDMATRIXN& m, bool checksum)
+{
+  Header header;
+  init_header(header, eDenseMatrix, m.rows(), m.columns(), 0, checksum);
+  out.write((const char*) &header, sizeof(Header));
+
+  // packed matrices are written at once; others a column at a time
+  Checksum sum;
+  Checksum* psum = (checksum) ? &sum : NULL;
+  if (m.leading_dim() == m.rows() || m.columns() == 0)
+    write_data(out, m.data(), sizeof(REAL)*m.rows()*m.columns(), psum);
+  else
+    for (unsigned j=0; j< m.columns(); j++)
+      write_data(out, m.data() + j*m.leading_dim(), sizeof(REAL)*m.rows(), psum);
+  write_padding(out, sizeof(REAL)*m.rows()*m.columns(), psum);
+
+  return finish(out, psum);
+}
+
+/// Writes a sparse matrix to a binary stream
+/**
+ * \param checksum if <b>true</b>, a checksum of the data is written, which
+ *        read() verifies
+ * \return <b>true</b> if the matrix was written successfully
+ */
+bool MATRIX_FILE::write(std::ostream& out, const SPARSEMATRIXN& m, bool checksum)
+{
+  // get the number of row (column, if CSC) pointers
+  unsigned nptr = ((m.get_storage_type() == SPARSEMATRIXN::eCSR) ? m.rows() : m.columns()) + 1;
+
+  Header header;
+  init_header(header, eSparseMatrix, m.rows(), m.columns(), m.get_nnz(), checksum);
+  header.storage = m.get_storage_type();
+  out.write((const char*) &header, sizeof(Header));
+
+  // write the pointers, indices, and nonzeros; a matrix without storage has
+  // all zero pointers
+  Checksum sum;
+  Checksum* psum = (checksum) ? &sum : NULL;
+  if (m.get_ptr())
+    write_data(out, m.get_ptr(), sizeof(unsigned)*nptr, psum);
+  else
+  {
+    std::vector<unsigned> ptr(nptr, 0);
+    write_data(out, &ptr[0], sizeof(unsigned)*nptr, psum);
+  }
+  write_padding(out, sizeof(unsigned)*nptr, psum);
+  write_data(out, m.get_indices(), sizeof(unsigned)*m.get_nnz(), psum);
+  write_padding(out, sizeof(unsigned)*m.get_nnz(), psum);
+  write_data(out, m.get_data(), sizeof(REAL)*m.get_nnz(), psum);
+  write_padding(out, sizeof(REAL)*m.get_nnz(), psum);
+
+  return finish(out, psum);
+}
+
+/// Writes a vector to a binary file (see write(std::ostream&, const CONST_SHAREDVECTORN&, bool))
+bool MATRIX_FILE::write(const string& fname, const CONST_SHAREDVECTORN& v, bool checksum)
+{
+  std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+  if (!out)
+  {
+    std::cerr << "MatrixFile::write() - unable to open file " << fname << " for writing" << std::endl;
+    return false;
+  }
+
+  return write(out, v, checksum);
+}
+
+/// Writes a dense matrix to a binary file (see write(std::ostream&, const CONST_SHAREDMATRIXN&, bool))
+bool MATRIX_FILE::write(const string& fname, const CONST_SHAREDMATRIXN& m, bool checksum)
+{
+  std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+  if (!out)
+  {
+    std::cerr << "MatrixFile::write() - unable to open file " << fname << " for writing" << std::endl;
+    return false;
+  }
+
+  return write(out, m, checksum);
+}
+
+/// Writes a sparse matrix to a binary file (see write(std::ostream&, const SPARSEMATRIXN&, bool))
+bool MATRIX_FILE::write(const string& fname, const SPARSEMATRIXN& m, bool checksum)
+{
+  std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+  if (!out)
+  {
+    std::cerr << "MatrixFile::write() - unable to open file " << fname << " for writing" << std::endl;
+    return false;
+  }
+
+  return write(out, m, checksum);
+}
+
+/// Maps a file into memory and validates its header and (optionally) its checksum
+/**
+ * \return the mapped file, or a null pointer if the file could not be mapped
+ *         or is not valid
+ */
+shared_ptr<MATRIX_FILE::MappedFile> MATRIX_FILE::map(const string& fname, ObjectType object, bool verify_checksum, const Header*& header, const char*& payload)
+{
+  // open the file and get its size
+  int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "MatrixFile::read() - unable to open file " << fname << " for reading" << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header))
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " is not a matrix file" << std::endl;
+    close(fd);
+    return shared_ptr<MappedFile>();
+  }
+
+  // map the file
+  void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    std::cerr << "MatrixFile::read() - unable to map file " << fname << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+  shared_ptr<MappedFile> file(new MappedFile(data, st.st_size));
+
+  // verify the header
+  header = (const Header*) data;
+  payload = (const char*) data + sizeof(Header);
+  if (std::memcmp(header->magic, "RAVELINM", sizeof(header->magic)) != 0 || header->version != VERSION || header->byte_order != BYTE_ORDER_MARK)
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " is not a matrix file, or was written by an incompatible version or on an incompatible machine" << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+  if (header->real_size != sizeof(REAL))
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " was written with " << header->real_size << "-byte reals" << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+  if (header->object != (boost::uint32_t) object)
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " does not contain the requested type of object" << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+
+  // compute the size of the data (in 64 bits, so that no header can 
+  // overflow it)
+  boost::uint64_t nbytes64;
+  if (object == eSparseMatrix)
+  {
+    if (header->storage != SPARSEMATRIXN::eCSR && header->storage != SPARSEMATRIXN::eCSC)
+    {
+      std::cerr << "MatrixFile::read() - " << fname << " is corrupt" << std::endl;
+      return shared_ptr<MappedFile>();
+    }
+    boost::uint64_t nptr = (boost::uint64_t) ((header->storage == SPARSEMATRIXN::eCSR) ? header->rows : header->columns) + 1;
+    nbytes64 = padded(sizeof(unsigned)*nptr) + padded(sizeof(unsigned)*(boost::uint64_t) header->nnz) + padded(sizeof(REAL)*(boost::uint64_t) header->nnz);
+  }
+  else
+  {
+    // the size of the data must cover every element of the view (the last
+    // column of which need only hold rows elements); a vector is one
+    // contiguous column
+    boost::uint64_t nreals = (boost::uint64_t) header->leading_dim*header->columns;
+    boost::uint64_t extent = (header->rows == 0 || header->columns == 0) ? 0 : (boost::uint64_t) header->leading_dim*(header->columns-1) + header->rows;
+    bool bad_vector = (object == eVector && (header->columns != 1 || header->leading_dim != header->rows));
+    if (bad_vector || header->leading_dim < header->rows || extent > nreals || nreals > std::numeric_limits<unsigned>::max())
+    {
+      std::cerr << "MatrixFile::read() - " << fname << " is corrupt" << std::endl;
+      return shared_ptr<MappedFile>();
+    }
+    nbytes64 = padded(sizeof(REAL)*nreals);
+  }
+
+  // verify the size and checksum
+  boost::uint64_t nchecksum = (header->has_checksum) ? sizeof(boost::uint64_t) : 0;
+  if ((boost::uint64_t) st.st_size != sizeof(Header) + nbytes64 + nchecksum)
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " is truncated or corrupt" << std::endl;
+    return shared_ptr<MappedFile>();
+  }
+  size_t nbytes = (size_t) nbytes64;
+  if (verify_checksum && header->has_checksum)
+  {
+    boost::uint64_t value;
+    std::memcpy(&value, payload + nbytes, sizeof(value));
+    Checksum sum;
+    sum.update(payload, nbytes);
+    if (sum.value() != value)
+    {
+      std::cerr << "MatrixFile::read() - checksum mismatch in " << fname << std::endl;
+      return shared_ptr<MappedFile>();
+    }
+  }
+
+  return file;
+}
+
+/// Reads a vector from a binary file, without copying it
+/**
+ * \param v on return, a read-only view of the vector in the file, which is
+ *        mapped into memory as long as v (or any copy of it) exists
+ * \param verify_checksum if <b>true</b>, the checksum (if the file has one)
+ *        is verified, which requires reading the entire file
+ * \return <b>true</b> if the vector was read successfully
+ */
+bool MATRIX_FILE::read(const string& fname, CONST_SHAREDVECTORN& v, bool verify_checksum)
+{
+  const Header* header;
+  const char* payload;
+  shared_ptr<MappedFile> file = map(fname, eVector, verify_checksum, header, payload);
+  if (!file)
+    return false;
+
+  shared_array<REAL> data((REAL*) payload, MappedArrayDeleter<REAL>(file));
+  v = CONST_SHAREDVECTORN(header->rows, 1, 0, SharedResizable<REAL>(data, header->rows));
+  return true;
+}
+
+/// Reads a dense matrix from a binary file, without copying it
+/**
+ * \param m on return, a read-only view of the matrix in the file, which is
+ *        mapped into memory as long as m (or any copy of it) exists
+ * \param verify_checksum if <b>true</b>, the checksum (if the file has one)
+ *        is verified, which requires reading the entire file
+ * \return <b>true</b> if the matrix was read successfully
+ */
+bool MATRIX_FILE::read(const string& fname, CONST_SHAREDMATRIXN& m, bool verify_checksum)
+{
+  const Header* header;
+  const char* payload;
+  shared_ptr<MappedFile> file = map(fname, eDenseMatrix, verify_checksum, header, payload);
+  if (!file)
+    return false;
+
+  shared_array<REAL> data((REAL*) payload, MappedArrayDeleter<REAL>(file));
+  m = CONST_SHAREDMATRIXN(header->rows, header->columns, header->leading_dim, 0, SharedResizable<REAL>(data, (unsigned) ((size_t) header->leading_dim*header->columns)));
+  return true;
+}
+
+/// Reads a sparse matrix from a binary file, without copying it
+/**
+ * \param m on return, a read-only sparse matrix whose pointers, indices, and
+ *        nonzeros are those in the file, which is mapped into memory as long
+ *        as the matrix exists
+ * \param verify_checksum if <b>true</b>, the checksum (if the file has one)
+ *        is verified, which requires reading the entire file
+ * \return <b>true</b> if the matrix was read successfully
+ */
+bool MATRIX_FILE::read(const string& fname, shared_ptr<const SPARSEMATRIXN>& m, bool verify_checksum)
+{
+  const Header* header;
+  const char* payload;
+  shared_ptr<MappedFile> file = map(fname, eSparseMatrix, verify_checksum, header, payload);
+  if (!file)
+    return false;
+
+  // locate the arrays
+  SPARSEMATRIXN::StorageType stype = (SPARSEMATRIXN::StorageType) header->storage;
+  size_t nptr = (size_t) ((stype == SPARSEMATRIXN::eCSR) ? header->rows : header->columns) + 1;
+  const char* ptr_data = payload;
+  const char* indices_data = ptr_data + padded(sizeof(unsigned)*nptr);
+  const char* nz_data = indices_data + padded(sizeof(unsigned)*header->nnz);
+
+  // verify the pointers, so that the matrix cannot index outside of the file
+  const unsigned* ptr_array = (const unsigned*) ptr_data;
+  if (ptr_array[0] != 0 || ptr_array[nptr-1] != header->nnz)
+  {
+    std::cerr << "MatrixFile::read() - " << fname << " is corrupt" << std::endl;
+    return false;
+  }
+  for (size_t i=1; i< nptr; i++)
+    if (ptr_array[i] < ptr_array[i-1])
+    {
+      std::cerr << "MatrixFile::read() - " << fname << " is corrupt" << std::endl;
+      return false;
+    }
+  const unsigned* indices_array = (const unsigned*) indices_data;
+  unsigned nminor = (stype == SPARSEMATRIXN::eCSR) ? header->columns : header->rows;
+  for (size_t i=0; i< header->nnz; i++)
+    if (indices_array[i] >= nminor)
+    {
+      std::cerr << "MatrixFile::read() - " << fname << " is corrupt" << std::endl;
+      return false;
+    }
+
+  shared_array<unsigned> ptr((unsigned*) ptr_data, MappedArrayDeleter<unsigned>(file));
+  shared_array<unsigned> indices((unsigned*) indices_data, MappedArrayDeleter<unsigned>(file));
+  shared_array<REAL> data((REAL*) nz_data, MappedArrayDeleter<REAL>(file));
+  m = shared_ptr<const SPARSEMATRIXN>(new SPARSEMATRIXN(stype, header->rows, header->columns, ptr, indices, data));
+  return true;
+}
+
@@ -0,0 +1,22 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <limits>
+#include <fstream>
+#include <vector>
+#include <Ravelin/MatrixFiled.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/ddefs.h>
+#include "MatrixFile.cpp"
+#include <Ravelin/undefs.h>
+
@@ -311,7 +311,7 @@ MOVINGTRANSFORM3 MOVINGTRANSFORM3::calc_transform(boost::shared_ptr<const POSE3>
     r = target;
     while (true)
     {
-      if (POSE3::is_common(source, r, i))
+      if (POSE3::is_common(source.get(), r.get(), i))
         break;
       else
       {
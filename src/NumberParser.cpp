@@ -0,0 +1,247 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <locale.h>
+#include <stdlib.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+#include <cstring>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <Ravelin/NumberParser.h>
+
+using namespace Ravelin;
+
+// the largest number of significant digits that fits in the mantissa
+// accumulator
+static const int MAX_DIGITS = 19;
+
+// powers of ten that are exactly representable as doubles
+static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// powers of ten that are exactly representable as floats
+static const float POW10F[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+/// Gets the "C" locale, used by the slow path
+static locale_t c_locale()
+{
+  static locale_t loc = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
+  return loc;
+}
+
+/// Converts a mantissa and decimal exponent exactly, if possible
+/**
+ * Both the mantissa and the power of ten are exact, so a single
+ * multiplication or division yields the correctly rounded result.
+ */
+static bool convert_exact(boost::uint64_t m, int exp10, double& value)
+{
+  if (m > ((boost::uint64_t) 1 << 53) || exp10 < -22 || exp10 > 22)
+    return false;
+  value = (exp10 < 0) ? (double) m / POW10[-exp10] : (double) m * POW10[exp10];
+  return true;
+}
+
+/// Converts a mantissa and decimal exponent exactly, if possible
+static bool convert_exact(boost::uint64_t m, int exp10, float& value)
+{
+  if (m > ((boost::uint64_t) 1 << 24) || exp10 < -10 || exp10 > 10)
+    return false;
+  value = (exp10 < 0) ? (float) m / POW10F[-exp10] : (float) m * POW10F[exp10];
+  return true;
+}
+
+/// Converts a null-terminated token in the "C" locale
+static void convert_slow(const char* token, double& value)
+{
+  value = strtod_l(token, NULL, c_locale());
+}
+
+/// Converts a null-terminated token in the "C" locale
+static void convert_slow(const char* token, float& value)
+{
+  value = strtof_l(token, NULL, c_locale());
+}
+
+/// Converts the token [s, end) to a real number
+template <class Real>
+static void convert(const char* s, const char* end, Real& value)
+{
+  const char* p = s;
+
+  // read the sign
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-'))
+    negative = (*p++ == '-');
+
+  // read the digits of the integer and fractional parts into the mantissa
+  boost::uint64_t m = 0;
+  int ndigits = 0, exp10 = 0;
+  bool any = false, exact = true;
+  for (; p != end && *p >= '0' && *p <= '9'; p++)
+  {
+    any = true;
+    if (ndigits < MAX_DIGITS)
+    {
+      m = m*10 + (*p - '0');
+      if (m > 0)
+        ndigits++;
+    }
+    else
+    {
+      exp10++;
+      exact = exact && *p == '0';
+    }
+  }
+  if (p != end && *p == '.')
+    for (p++; p != end && *p >= '0' && *p <= '9'; p++)
+    {
+      any = true;
+      if (ndigits < MAX_DIGITS)
+      {
+        m = m*10 + (*p - '0');
+        if (m > 0)
+          ndigits++;
+        exp10--;
+      }
+      else
+        exact = exact && *p == '0';
+    }
+
+  // read the exponent
+  if (any && p != end && (*p == 'e' || *p == 'E'))
+  {
+    const char* q = p+1;
+    bool negative_exp = false;
+    if (q != end && (*q == '+' || *q == '-'))
+      negative_exp = (*q++ == '-');
+    if (q != end && *q >= '0' && *q <= '9')
+    {
+      int e = 0;
+      for (; q != end && *q >= '0' && *q <= '9'; q++)
+        if (e < 100000)
+          e = e*10 + (*q - '0');
+      exp10 += (negative_exp) ? -e : e;
+      p = q;
+    }
+  }
+
+  // the fast path handles plain decimal numbers whose conversion is exact
+  if (any && exact && p == end && (m == 0 || convert_exact(m, exp10, value)))
+  {
+    if (m == 0)
+      value = (Real) 0;
+    if (negative)
+      value = -value;
+    return;
+  }
+
+  // otherwise, copy the token so that it is null-terminated and convert it
+  // in the "C" locale; only very long tokens need to allocate
+  const unsigned BUFSIZE = 128;
+  size_t len = end - s;
+  if (len < BUFSIZE)
+  {
+    char buffer[BUFSIZE];
+    std::memcpy(buffer, s, len);
+    buffer[len] = '\0';
+    convert_slow(buffer, value);
+  }
+  else
+    convert_slow(std::string(s, end).c_str(), value);
+}
+
+/// Parses the next real number in [s, end), skipping any leading delimiters
+template <class Real>
+static const char* parse(const char* s, const char* end, Real& value)
+{
+  // skip leading delimiters
+  while (s != end && *s != '\0' && NumberParser::is_delimiter(*s))
+    s++;
+  if (s == end || *s == '\0')
+    return NULL;
+
+  // find the end of the token
+  const char* token_end = s;
+  while (token_end != end && *token_end != '\0' && !NumberParser::is_delimiter(*token_end))
+    token_end++;
+
+  convert(s, token_end, value);
+  return token_end;
+}
+
+/// Parses the next real number in [s, end), skipping any leading delimiters
+/**
+ * \return a pointer to the character after the number, or NULL if there are
+ *         no more numbers in the range (value is then left unchanged)
+ */
+const char* NumberParser::parse_real(const char* s, const char* end, double& value)
+{
+  return parse(s, end, value);
+}
+
+/// Parses the next real number in [s, end), skipping any leading delimiters
+/**
+ * \return a pointer to the character after the number, or NULL if there are
+ *         no more numbers in the range (value is then left unchanged)
+ */
+const char* NumberParser::parse_real(const char* s, const char* end, float& value)
+{
+  return parse(s, end, value);
+}
+
+/// Parses the real numbers in [s, end) into values
+/**
+ * \param n the capacity of values; numbers beyond the first n are counted
+ *        but not stored
+ * \return the number of numbers in the range
+ */
+unsigned NumberParser::parse_reals(const char* s, const char* end, double* values, unsigned n)
+{
+  unsigned count = 0;
+  double value;
+  for (; (s = parse(s, end, value)); count++)
+    if (count < n)
+      values[count] = value;
+  return count;
+}
+
+/// Parses the real numbers in [s, end) into values
+/**
+ * \param n the capacity of values; numbers beyond the first n are counted
+ *        but not stored
+ * \return the number of numbers in the range
+ */
+unsigned NumberParser::parse_reals(const char* s, const char* end, float* values, unsigned n)
+{
+  unsigned count = 0;
+  float value;
+  for (; (s = parse(s, end, value)); count++)
+    if (count < n)
+      values[count] = value;
+  return count;
+}
+
+/// Counts the real numbers in [s, end) without converting them
+unsigned NumberParser::count_reals(const char* s, const char* end)
+{
+  unsigned count = 0;
+  while (true)
+  {
+    // skip delimiters
+    while (s != end && *s != '\0' && is_delimiter(*s))
+      s++;
+    if (s == end || *s == '\0')
+      return count;
+
+    // skip the token
+    count++;
+    while (s != end && *s != '\0' && !is_delimiter(*s))
+      s++;
+  }
+}
+
@@ -0,0 +1,445 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+using std::vector;
+
+// offsets of the M, J, and H blocks within the packed data
+static const unsigned PACKED_M = 0, PACKED_J = 6, PACKED_H = 12;
+
+// index of entry (i,j) of a packed, symmetric 3x3 matrix
+static const unsigned PACKED_SYM[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+
+/// Default constructor -- constructs a zero inertia matrix
+PACKED_SPATIAL_AB_INERTIA::PACKED_SPATIAL_AB_INERTIA(FRAME_PTR pose)
+{
+  set_zero();
+  this->pose = pose;
+}
+
+/// Creates a zero matrix
+void PACKED_SPATIAL_AB_INERTIA::set_zero()
+{
+  std::fill_n(_data, PACKED_SIZE, (REAL) 0.0);
+}
+
+/// Copies a packed spatial AB inertia to this one
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator=(const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  pose = m.pose;
+  std::copy(m._data, m._data+PACKED_SIZE, _data);
+  return *this;
+}
+
+/// Packs a spatial AB inertia
+/**
+ * M and J are symmetrized (by averaging their off-diagonal entries).
+ */
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator=(const SPATIAL_AB_INERTIA& m)
+{
+  const unsigned THREE_D = 3;
+
+  pose = m.pose;
+  for (unsigned i=0; i< THREE_D; i++)
+    for (unsigned j=i; j< THREE_D; j++)
+    {
+      _data[PACKED_M+PACKED_SYM[i][j]] = (m.M(i,j) + m.M(j,i))*(REAL) 0.5;
+      _data[PACKED_J+PACKED_SYM[i][j]] = (m.J(i,j) + m.J(j,i))*(REAL) 0.5;
+    }
+  std::copy(m.H.data(), m.H.data()+THREE_D*THREE_D, _data+PACKED_H);
+  return *this;
+}
+
+/// Packs a spatial RB inertia
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator=(const SPATIAL_RB_INERTIA& m)
+{
+  const unsigned THREE_D = 3;
+
+  // precompute some things (as in SPATIAL_AB_INERTIA::operator=())
+  MATRIX3 hx = MATRIX3::skew_symmetric(m.h);
+  MATRIX3 mhx = MATRIX3::skew_symmetric(m.m * m.h);
+  MATRIX3 J = m.J - mhx*hx;
+
+  pose = m.pose;
+  for (unsigned i=0; i< THREE_D; i++)
+    for (unsigned j=i; j< THREE_D; j++)
+    {
+      _data[PACKED_M+PACKED_SYM[i][j]] = (i == j) ? m.m : (REAL) 0.0;
+      _data[PACKED_J+PACKED_SYM[i][j]] = J(i,j);
+    }
+  std::copy(mhx.data(), mhx.data()+THREE_D*THREE_D, _data+PACKED_H);
+  return *this;
+}
+
+/// Unpacks this inertia into a spatial AB inertia
+SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::to_ab_inertia(SPATIAL_AB_INERTIA& I) const
+{
+  const unsigned THREE_D = 3;
+
+  I.pose = pose;
+  for (unsigned i=0; i< THREE_D; i++)
+    for (unsigned j=0; j< THREE_D; j++)
+    {
+      I.M(i,j) = _data[PACKED_M+PACKED_SYM[i][j]];
+      I.J(i,j) = _data[PACKED_J+PACKED_SYM[i][j]];
+    }
+  std::copy(_data+PACKED_H, _data+PACKED_SIZE, I.H.data());
+  return I;
+}
+
+/// Adds m to this in place
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator+=(const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  #ifndef NEXCEPT
+  if (pose != m.pose)
+    throw FrameException();
+  #endif
+
+  for (unsigned i=0; i< PACKED_SIZE; i++)
+    _data[i] += m._data[i];
+  return *this;
+}
+
+/// Subtracts m from this in place
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator-=(const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  #ifndef NEXCEPT
+  if (pose != m.pose)
+    throw FrameException();
+  #endif
+
+  for (unsigned i=0; i< PACKED_SIZE; i++)
+    _data[i] -= m._data[i];
+  return *this;
+}
+
+/// Multiplies this matrix by a scalar in place
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::operator*=(REAL scalar)
+{
+  for (unsigned i=0; i< PACKED_SIZE; i++)
+    _data[i] *= scalar;
+  return *this;
+}
+
+/// Adds m, transformed to the frame of this inertia, to this inertia in place
+/**
+ * This is the accumulation of a child's articulated body inertia into its
+ * parent's; no intermediate inertia is formed.
+ */
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::add_transformed(const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  // quick check
+  if (m.pose == pose)
+    return operator+=(m);
+
+  transform_packed(POSE3::calc_relative_pose(m.pose, pose), m._data, _data, true);
+  return *this;
+}
+
+/// Performs the rank-1 update I - u*dinv*u' in place
+/**
+ * \param u a momentum (e.g., I*s for the spatial axis s of a single degree
+ *        of freedom joint)
+ * \param dinv the inverse of the scalar s'*I*s
+ */
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::rank_update(const SMOMENTUM& u, REAL dinv)
+{
+  const unsigned THREE_D = 3;
+
+  #ifndef NEXCEPT
+  if (pose != u.pose)
+    throw FrameException();
+  #endif
+
+  // get the upper and lower parts of u
+  const REAL* uu = u.data();
+  const REAL* ul = uu + THREE_D;
+
+  // update the upper triangles of M and J and all of H
+  for (unsigned i=0; i< THREE_D; i++)
+  {
+    const REAL dul = dinv*ul[i];
+    for (unsigned j=i; j< THREE_D; j++)
+    {
+      _data[PACKED_M+PACKED_SYM[i][j]] -= dinv*uu[i]*uu[j];
+      _data[PACKED_J+PACKED_SYM[i][j]] -= dul*ul[j];
+    }
+    for (unsigned j=0; j< THREE_D; j++)
+      _data[PACKED_H+i+j*THREE_D] -= dul*uu[j];
+  }
+
+  return *this;
+}
+
+/// Performs the rank-k update I - U*inv(D)*U' in place
+/**
+ * \param U k momenta (e.g., I*s for the spatial axes s of a joint)
+ * \param W the k x 6 matrix inv(D)*U', where each row is in the
+ *        [upper; lower] layout of SMOMENTUM (e.g., the solution of
+ *        (s'*I*s)*W = U')
+ * Since U*W is symmetric, only the 21 unique entries of the update are
+ * computed, and they are subtracted without forming U*W.
+ */
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::rank_update(const vector<SMOMENTUM>& U, const MATRIXN& W)
+{
+  const unsigned THREE_D = 3, SPATIAL_DIM = 6;
+
+  #ifndef NEXCEPT
+  if (W.rows() != U.size() || W.columns() != SPATIAL_DIM)
+    throw MissizeException();
+  #endif
+
+  // get the leading dimension of W
+  const unsigned LDW = W.leading_dim();
+
+  for (unsigned k=0; k< U.size(); k++)
+  {
+    #ifndef NEXCEPT
+    if (pose != U[k].pose)
+      throw FrameException();
+    #endif
+
+    // get the upper and lower parts of the k'th momentum and row of W
+    const REAL* uu = U[k].data();
+    const REAL* ul = uu + THREE_D;
+    const REAL* w = W.data() + k;
+    const REAL wu[3] = { w[0], w[LDW], w[LDW*2] };
+    const REAL wl[3] = { w[LDW*3], w[LDW*4], w[LDW*5] };
+
+    // update the upper triangles of M and J and all of H
+    for (unsigned i=0; i< THREE_D; i++)
+    {
+      for (unsigned j=i; j< THREE_D; j++)
+      {
+        _data[PACKED_M+PACKED_SYM[i][j]] -= uu[i]*wu[j];
+        _data[PACKED_J+PACKED_SYM[i][j]] -= ul[i]*wl[j];
+      }
+      for (unsigned j=0; j< THREE_D; j++)
+        _data[PACKED_H+i+j*THREE_D] -= ul[i]*wu[j];
+    }
+  }
+
+  return *this;
+}
+
+/// Transforms this inertia using the given transformation
+/**
+ * \param result the transformed inertia on return (may be this)
+ */
+PACKED_SPATIAL_AB_INERTIA& PACKED_SPATIAL_AB_INERTIA::transform(const TRANSFORM3& T, PACKED_SPATIAL_AB_INERTIA& result) const
+{
+  #ifndef NEXCEPT
+  if (pose != T.source)
+    throw FrameException();
+  #endif
+
+  // copy the source, if necessary
+  if (&result == this)
+  {
+    REAL src[PACKED_SIZE];
+    std::copy(_data, _data+PACKED_SIZE, src);
+    transform_packed(T, src, result._data, false);
+  }
+  else
+    transform_packed(T, _data, result._data, false);
+
+  result.pose = T.target;
+  return result;
+}
+
+/// Transforms a packed spatial AB inertia to the given pose
+PACKED_SPATIAL_AB_INERTIA PACKED_SPATIAL_AB_INERTIA::transform(FRAME_PTR target, const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  // quick check
+  if (m.pose == target)
+    return m;
+
+  PACKED_SPATIAL_AB_INERTIA result;
+  m.transform(POSE3::calc_relative_pose(m.pose, target), result);
+  return result;
+}
+
+/// Computes the congruence transformation of packed inertia data
+/**
+ * Computes (as in TRANSFORM3::transform())
+ *   M' = E*M*E'
+ *   H' = E*Y*E'            where Y = H - rx*M
+ *   J' = E*(J - rx*H' + Y*rx)*E'
+ * computing only the upper triangles of the symmetric M' and J'.
+ * \param src the packed source data
+ * \param dest the packed target data; must not alias src
+ * \param accumulate if true, the transformed inertia is added to dest
+ */
+void PACKED_SPATIAL_AB_INERTIA::transform_packed(const TRANSFORM3& T, const REAL* src, REAL* dest, bool accumulate)
+{
+  const unsigned X = 0, Y = 1, Z = 2, THREE_D = 3;
+  REAL m[3][3], j[3][3], h[3][3], y[3][3], z[3][3], t[3][3], e[3][3];
+
+  // setup r and E
+  MATRIX3 E = T.q;
+  ORIGIN3 r = E.transpose_mult(-T.x);
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=0; b< THREE_D; b++)
+      e[a][b] = E(a,b);
+
+  // unpack M, J, and H
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=0; b< THREE_D; b++)
+    {
+      m[a][b] = src[PACKED_M+PACKED_SYM[a][b]];
+      j[a][b] = src[PACKED_J+PACKED_SYM[a][b]];
+      h[a][b] = src[PACKED_H+a+b*THREE_D];
+    }
+
+  // setup rx
+  const REAL rx[3][3] = { { (REAL) 0.0, -r[Z], r[Y] },
+                          { r[Z], (REAL) 0.0, -r[X] },
+                          { -r[Y], r[X], (REAL) 0.0 } };
+
+  // compute Y = H - rx*M
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=0; b< THREE_D; b++)
+      y[a][b] = h[a][b] - rx[a][0]*m[0][b] - rx[a][1]*m[1][b] - rx[a][2]*m[2][b];
+
+  // compute the upper triangle of the symmetric Z = J - rx*H' + Y*rx
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=a; b< THREE_D; b++)
+    {
+      REAL sum = j[a][b];
+      for (unsigned c=0; c< THREE_D; c++)
+        sum += y[a][c]*rx[c][b] - rx[a][c]*h[b][c];
+      z[a][b] = z[b][a] = sum;
+    }
+
+  // if we're not accumulating, zero the destination
+  if (!accumulate)
+    std::fill_n(dest, PACKED_SIZE, (REAL) 0.0);
+
+  // compute the upper triangle of E*M*E'
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned c=0; c< THREE_D; c++)
+      t[a][c] = e[a][0]*m[0][c] + e[a][1]*m[1][c] + e[a][2]*m[2][c];
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=a; b< THREE_D; b++)
+      dest[PACKED_M+PACKED_SYM[a][b]] += t[a][0]*e[b][0] + t[a][1]*e[b][1] + t[a][2]*e[b][2];
+
+  // compute the upper triangle of E*Z*E'
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned c=0; c< THREE_D; c++)
+      t[a][c] = e[a][0]*z[0][c] + e[a][1]*z[1][c] + e[a][2]*z[2][c];
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=a; b< THREE_D; b++)
+      dest[PACKED_J+PACKED_SYM[a][b]] += t[a][0]*e[b][0] + t[a][1]*e[b][1] + t[a][2]*e[b][2];
+
+  // compute E*Y*E'
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned c=0; c< THREE_D; c++)
+      t[a][c] = e[a][0]*y[0][c] + e[a][1]*y[1][c] + e[a][2]*y[2][c];
+  for (unsigned a=0; a< THREE_D; a++)
+    for (unsigned b=0; b< THREE_D; b++)
+      dest[PACKED_H+a+b*THREE_D] += t[a][0]*e[b][0] + t[a][1]*e[b][1] + t[a][2]*e[b][2];
+}
+
+/// Does spatial arithmetic
+void PACKED_SPATIAL_AB_INERTIA::mult_spatial(const SVECTOR6& v, SVECTOR6& result) const
+{
+  const unsigned THREE_D = 3;
+
+  // get the upper and lower parts of v
+  const REAL* top = v.data();
+  const REAL* bot = top + THREE_D;
+
+  // compute H'*top + M*bot and J*top + H*bot
+  REAL* rtop = result.data();
+  REAL* rbot = rtop + THREE_D;
+  for (unsigned i=0; i< THREE_D; i++)
+  {
+    const REAL* Hcol = _data + PACKED_H + i*THREE_D;
+    REAL upper = Hcol[0]*top[0] + Hcol[1]*top[1] + Hcol[2]*top[2];
+    REAL lower = (REAL) 0.0;
+    for (unsigned j=0; j< THREE_D; j++)
+    {
+      upper += _data[PACKED_M+PACKED_SYM[i][j]]*bot[j];
+      lower += _data[PACKED_J+PACKED_SYM[i][j]]*top[j] + _data[PACKED_H+i+j*THREE_D]*bot[j];
+    }
+    rtop[i] = upper;
+    rbot[i] = lower;
+  }
+  result.pose = pose;
+}
+
+/// Multiplies this matrix by an acceleration and returns the result in a force
+SFORCE PACKED_SPATIAL_AB_INERTIA::mult(const SACCEL& t) const
+{
+  #ifndef NEXCEPT
+  if (pose != t.pose)
+    throw FrameException();
+  #endif
+
+  SFORCE result;
+  mult_spatial(t, result);
+  return result;
+}
+
+/// Multiplies this matrix by a velocity and returns the result in a momentum
+SMOMENTUM PACKED_SPATIAL_AB_INERTIA::mult(const SVELOCITY& t) const
+{
+  #ifndef NEXCEPT
+  if (pose != t.pose)
+    throw FrameException();
+  #endif
+
+  SMOMENTUM result;
+  mult_spatial(t, result);
+  return result;
+}
+
+/// Multiplies this matrix by a vector of accelerations and returns the result in a vector of forces
+vector<SFORCE>& PACKED_SPATIAL_AB_INERTIA::mult(const vector<SACCEL>& t, vector<SFORCE>& result) const
+{
+  result.resize(t.size());
+  for (unsigned i=0; i< t.size(); i++)
+  {
+    #ifndef NEXCEPT
+    if (pose != t[i].pose)
+      throw FrameException();
+    #endif
+
+    mult_spatial(t[i], result[i]);
+  }
+
+  return result;
+}
+
+/// Multiplies this inertia by a vector of velocities and returns the result in a vector of momenta
+vector<SMOMENTUM>& PACKED_SPATIAL_AB_INERTIA::mult(const vector<SVELOCITY>& t, vector<SMOMENTUM>& result) const
+{
+  result.resize(t.size());
+  for (unsigned i=0; i< t.size(); i++)
+  {
+    #ifndef NEXCEPT
+    if (pose != t[i].pose)
+      throw FrameException();
+    #endif
+
+    mult_spatial(t[i], result[i]);
+  }
+
+  return result;
+}
+
+/// Outputs this matrix to the stream
+std::ostream& Ravelin::operator<<(std::ostream& out, const PACKED_SPATIAL_AB_INERTIA& m)
+{
+  SPATIAL_AB_INERTIA I;
+  m.to_ab_inertia(I);
+  out << "packed spatial AB H:" << std::endl << I.H;
+  out << "packed spatial AB M:" << std::endl << I.M;
+  out << "packed spatial AB J:" << std::endl << I.J;
+  out << "pose: " << m.pose << std::endl;
+
+  return out;
+}
+
@@ -0,0 +1,18 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <algorithm>
+#include <Ravelin/Constants.h>
+#include <Ravelin/FrameException.h>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/PackedSpatialABInertiaf.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/fdefs.h>
+#include "PackedSpatialABInertia.cpp"
+#include <Ravelin/undefs.h>
+
@@ -201,3 +201,22 @@ void PLANARJOINT::calc_constraint_jacobian_dot(bool inboard, MATRIXN& Cq)
   throw std::runtime_error("Implementation required");
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* PLANARJOINT::copy(PoseMap& poses) const
+{
+  PLANARJOINT* joint = new PLANARJOINT(*this);
+  joint->copy_frames(poses);
+  return joint;
+}
+
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void PLANARJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_vi, poses);
+  remap_frame(_vj, poses);
+  remap_frame(_normal, poses);
+  remap_frame(_tan1, poses);
+  remap_frame(_tan2, poses);
+  remap_frame(_s_dot, poses);
+}
@@ -344,7 +344,7 @@ SFORCE POSE3::inverse_transform(const SFORCE& w) const
 }
 
 /// Transforms a vector of forcees 
-std::vector<SFORCE>& POSE3::transform(boost::shared_ptr<const POSE3> target, const std::vector<SFORCE>& w, std::vector<SFORCE>& result)
+std::vector<SFORCE>& POSE3::transform(FRAME_PTR target, const std::vector<SFORCE>& w, std::vector<SFORCE>& result)
 {
   // look for empty vector (easy case)
   if (w.empty())
@@ -354,7 +354,7 @@ std::vector<SFORCE>& POSE3::transform(boost::shared_ptr<const POSE3> target, con
   }
 
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = w[0].pose; 
+  FRAME_PTR source = w[0].pose; 
 
   #ifndef NEXCEPT
   for (unsigned i=1; i< w.size(); i++)
@@ -385,7 +385,7 @@ std::vector<SFORCE>& POSE3::transform(boost::shared_ptr<const POSE3> target, con
 }
 
 /// transforms a spatial vector using precomputation
-void POSE3::transform_spatial(boost::shared_ptr<const POSE3> target, const SVECTOR6& w, const VECTOR3& r, const MATRIX3& E, SVECTOR6& result)
+void POSE3::transform_spatial(FRAME_PTR target, const SVECTOR6& w, const VECTOR3& r, const MATRIX3& E, SVECTOR6& result)
 {
   // get the components of w[i] 
   VECTOR3 top = w.get_upper();
@@ -400,7 +400,7 @@ void POSE3::transform_spatial(boost::shared_ptr<const POSE3> target, const SVECT
 } 
 
 /// Transforms the force 
-SFORCE POSE3::transform(boost::shared_ptr<const POSE3> target, const SFORCE& v)
+SFORCE POSE3::transform(FRAME_PTR target, const SFORCE& v)
 {
   // setup the force
   SFORCE f;
@@ -412,10 +412,10 @@ SFORCE POSE3::transform(boost::shared_ptr<const POSE3> target, const SFORCE& v)
 }
 
 /// Transforms a spatial vector
-void POSE3::transform_spatial(boost::shared_ptr<const POSE3> target, const SVECTOR6& v, SVECTOR6& s)
+void POSE3::transform_spatial(FRAME_PTR target, const SVECTOR6& v, SVECTOR6& s)
 {
   // setup the source pose 
-  boost::shared_ptr<const POSE3> source = v.pose;
+  FRAME_PTR source = v.pose;
 
   // quick check
   if (source == target)
@@ -467,10 +467,10 @@ SACCEL POSE3::inverse_transform(const SACCEL& t) const
 }
 
 /// Transforms the acceleration 
-SACCEL POSE3::transform(boost::shared_ptr<const POSE3> target, const SACCEL& t)
+SACCEL POSE3::transform(FRAME_PTR target, const SACCEL& t)
 {
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = t.pose; 
+  FRAME_PTR source = t.pose; 
 
   // quick check
   if (source == target)
@@ -506,7 +506,7 @@ SACCEL POSE3::transform(boost::shared_ptr<const POSE3> target, const SACCEL& t)
 }
 
 /// Transforms a vector of accelerations 
-std::vector<SACCEL>& POSE3::transform(boost::shared_ptr<const POSE3> target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result)
+std::vector<SACCEL>& POSE3::transform(FRAME_PTR target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result)
 {
   // look for empty vector (easy case)
   if (t.empty())
@@ -516,7 +516,7 @@ std::vector<SACCEL>& POSE3::transform(boost::shared_ptr<const POSE3> target, con
   }
 
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = t[0].pose; 
+  FRAME_PTR source = t[0].pose; 
 
   #ifndef NEXCEPT
   for (unsigned i=1; i< t.size(); i++)
@@ -584,7 +584,7 @@ SVELOCITY POSE3::inverse_transform(const SVELOCITY& t) const
 }
 
 /// Transforms the velocity  
-SVELOCITY POSE3::transform(boost::shared_ptr<const POSE3> target, const SVELOCITY& t)
+SVELOCITY POSE3::transform(FRAME_PTR target, const SVELOCITY& t)
 {
   SVELOCITY v;
   transform_spatial(target, t, v);
@@ -592,7 +592,7 @@ SVELOCITY POSE3::transform(boost::shared_ptr<const POSE3> target, const SVELOCIT
 }
 
 /// Transforms a vector of velocities 
-std::vector<SVELOCITY>& POSE3::transform(boost::shared_ptr<const POSE3> target, const std::vector<SVELOCITY>& t, std::vector<SVELOCITY>& result)
+std::vector<SVELOCITY>& POSE3::transform(FRAME_PTR target, const std::vector<SVELOCITY>& t, std::vector<SVELOCITY>& result)
 {
   // look for empty vector (easy case)
   if (t.empty())
@@ -602,7 +602,7 @@ std::vector<SVELOCITY>& POSE3::transform(boost::shared_ptr<const POSE3> target,
   }
 
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = t[0].pose; 
+  FRAME_PTR source = t[0].pose; 
 
   #ifndef NEXCEPT
   for (unsigned i=1; i< t.size(); i++)
@@ -655,7 +655,7 @@ SMOMENTUM POSE3::inverse_transform(const SMOMENTUM& t) const
 }
 
 /// Transforms the momentum 
-SMOMENTUM POSE3::transform(boost::shared_ptr<const POSE3> target, const SMOMENTUM& t)
+SMOMENTUM POSE3::transform(FRAME_PTR target, const SMOMENTUM& t)
 {
   SMOMENTUM result;
   transform_spatial(target, t, result);
@@ -663,7 +663,7 @@ SMOMENTUM POSE3::transform(boost::shared_ptr<const POSE3> target, const SMOMENTU
 }
 
 /// Transforms a vector of momenta 
-std::vector<SMOMENTUM>& POSE3::transform(boost::shared_ptr<const POSE3> target, const std::vector<SMOMENTUM>& t, std::vector<SMOMENTUM>& result)
+std::vector<SMOMENTUM>& POSE3::transform(FRAME_PTR target, const std::vector<SMOMENTUM>& t, std::vector<SMOMENTUM>& result)
 {
   // look for empty vector (easy case)
   if (t.empty())
@@ -673,7 +673,7 @@ std::vector<SMOMENTUM>& POSE3::transform(boost::shared_ptr<const POSE3> target,
   }
 
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = t[0].pose; 
+  FRAME_PTR source = t[0].pose; 
 
   // quick check
   if (source == target)
@@ -787,10 +787,10 @@ void POSE3::get_r_E(VECTOR3& r, MATRIX3& E, bool inverse) const
 }
 
 /// Applies this pose to a vector 
-VECTOR3 POSE3::transform_vector(boost::shared_ptr<const POSE3> target, const VECTOR3& v) 
+VECTOR3 POSE3::transform_vector(FRAME_PTR target, const VECTOR3& v) 
 {
   // setup source pose 
-  boost::shared_ptr<const POSE3> source = v.pose;
+  FRAME_PTR source = v.pose;
 
   // quick check
   if (source == target)
@@ -801,10 +801,10 @@ VECTOR3 POSE3::transform_vector(boost::shared_ptr<const POSE3> target, const VEC
 }
 
 /// Transforms a point from one pose to another 
-VECTOR3 POSE3::transform_point(boost::shared_ptr<const POSE3> target, const VECTOR3& point)
+VECTOR3 POSE3::transform_point(FRAME_PTR target, const VECTOR3& point)
 {
   // setup source pose 
-  boost::shared_ptr<const POSE3> source = point.pose;
+  FRAME_PTR source = point.pose;
 
   #ifndef NEXCEPT
   if (source != point.pose)
@@ -825,10 +825,10 @@ SVELOCITY POSE3::transform(const SVELOCITY& t) const { return transform(rpose, t
 SACCEL POSE3::transform(const SACCEL& t) const { return transform(rpose, t); } 
 
 /// Transforms a spatial articulated body inertia 
-SPATIAL_AB_INERTIA POSE3::transform(boost::shared_ptr<const POSE3> target, const SPATIAL_AB_INERTIA& m)
+SPATIAL_AB_INERTIA POSE3::transform(FRAME_PTR target, const SPATIAL_AB_INERTIA& m)
 {
   // setup source pose 
-  boost::shared_ptr<const POSE3> source = m.pose;
+  FRAME_PTR source = m.pose;
 
   // quick check
   if (source == target)
@@ -839,10 +839,10 @@ SPATIAL_AB_INERTIA POSE3::transform(boost::shared_ptr<const POSE3> target, const
 }
 
 /// Transforms a spatial RB inertia to the given pose
-SPATIAL_RB_INERTIA POSE3::transform(boost::shared_ptr<const POSE3> target, const SPATIAL_RB_INERTIA& J)
+SPATIAL_RB_INERTIA POSE3::transform(FRAME_PTR target, const SPATIAL_RB_INERTIA& J)
 {
   // setup source pose 
-  boost::shared_ptr<const POSE3> source = J.pose;
+  FRAME_PTR source = J.pose;
 
   // quick check
   if (source == target)
@@ -853,7 +853,7 @@ SPATIAL_RB_INERTIA POSE3::transform(boost::shared_ptr<const POSE3> target, const
 }
 
 /// Determines whether pose p exists in the chain of relative poses (and, if so, how far down the chain)
-bool POSE3::is_common(boost::shared_ptr<const POSE3> x, boost::shared_ptr<const POSE3> p, unsigned& i)
+bool POSE3::is_common(const POSE3* x, const POSE3* p, unsigned& i)
 {
   // reset i
   i = 0;
@@ -864,20 +864,26 @@ bool POSE3::is_common(boost::shared_ptr<const POSE3> x, boost::shared_ptr<const
       return true;
     if (!x)
       return false;
-    x = x->rpose;
+    x = x->rpose.get();
     i++;
   }
 }
 
 /// Computes the relative transformation from this pose to another
-TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::shared_ptr<const POSE3> target)
+/**
+ * The chains of relative poses are traversed without touching the 
+ * reference counts of the poses.
+ */
+TRANSFORM3 POSE3::calc_transform(FRAME_PTR source_ptr, FRAME_PTR target_ptr)
 {
-  boost::shared_ptr<const POSE3> r, s; 
+  const POSE3* source = source_ptr.get();
+  const POSE3* target = target_ptr.get();
+  const POSE3* r, * s; 
   TRANSFORM3 result;
 
   // setup the source and targets
-  result.source = source;
-  result.target = target;
+  result.source = source_ptr;
+  result.target = target_ptr;
 
   // check for special case: no transformation 
   if (source == target)
@@ -896,7 +902,7 @@ TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::s
     s = source;
     while (s)
     {
-      s = s->rpose;
+      s = s->rpose.get();
       if (!s)
         break;
       result.x = s->x + s->q * result.x;
@@ -916,7 +922,7 @@ TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::s
     r = target;
     while (r)
     {
-      r = r->rpose;
+      r = r->rpose.get();
       if (!r)
         break;
       result.x = r->x + r->q * result.x; 
@@ -951,7 +957,7 @@ TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::s
       else
       {
         assert(r);
-        r = r->rpose;
+        r = r->rpose.get();
       } 
     } 
     
@@ -962,7 +968,7 @@ TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::s
     s = source;
     for (unsigned j=0; j < i; j++)
     {
-      s = s->rpose;
+      s = s->rpose.get();
       if (!s)
         break;
       left_x = s->x + s->q * left_x;
@@ -974,7 +980,7 @@ TRANSFORM3 POSE3::calc_transform(boost::shared_ptr<const POSE3> source, boost::s
     ORIGIN3 right_x = target->x;
     while (target != r)
     {
-      target = target->rpose;
+      target = target->rpose.get();
       if (!target)
         break;
       right_x = target->x + target->q * right_x; 
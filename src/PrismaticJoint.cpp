@@ -318,4 +318,23 @@ void PRISMATICJOINT::calc_constraint_jacobian_dot(bool inboard, MATRIXN& Cq)
   throw std::runtime_error("Implementation required");
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* PRISMATICJOINT::copy(PoseMap& poses) const
+{
+  PRISMATICJOINT* joint = new PRISMATICJOINT(*this);
+  joint->copy_frames(poses);
+  return joint;
+}
 
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void PRISMATICJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_u, poses);
+  remap_frame(_ui, poses);
+  remap_frame(_uj, poses);
+  remap_frame(_v1i, poses);
+  remap_frame(_v1j, poses);
+  remap_frame(_v2, poses);
+  remap_frame(_s_dot, poses);
+}
@@ -497,7 +497,7 @@ bool QUAT::unit() const
 /// Subtracts a quaternion from <b>this</b>
 QUAT QUAT::operator-(const QUAT& q) const
 {
-  return QUAT(x+q.x, y+q.y, z+q.z, w+q.w);
+  return QUAT(x-q.x, y-q.y, z-q.z, w-q.w);
 }
 
 /// Subtracts one quaternion from another
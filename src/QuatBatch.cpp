@@ -0,0 +1,238 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+/// Verifies that a leading dimension is valid for n quaternions, points, or matrices
+void QUAT_BATCH::check_ld(unsigned n, unsigned ld)
+{
+  #ifndef NEXCEPT
+  if (ld < n)
+    throw MissizeException();
+  #endif
+}
+
+/// Copies a vector of quaternions into an n x 4 matrix (one quaternion per row)
+void QUAT_BATCH::pack(const std::vector<QUAT>& q, MATRIXN& Q)
+{
+  const unsigned N = q.size();
+  Q.resize(N, 4);
+  REAL* data = Q.data();
+  for (unsigned i=0; i< N; i++)
+  {
+    data[i] = q[i].x;
+    data[N+i] = q[i].y;
+    data[2*N+i] = q[i].z;
+    data[3*N+i] = q[i].w;
+  }
+}
+
+/// Copies the rows of an n x 4 matrix into a vector of quaternions
+void QUAT_BATCH::unpack(const MATRIXN& Q, std::vector<QUAT>& q)
+{
+  #ifndef NEXCEPT
+  if (Q.columns() != 4)
+    throw MissizeException();
+  #endif
+
+  const unsigned N = Q.rows(), LD = Q.leading_dim();
+  const REAL* data = Q.data();
+  q.resize(N);
+  for (unsigned i=0; i< N; i++)
+  {
+    q[i].x = data[i];
+    q[i].y = data[LD+i];
+    q[i].z = data[2*LD+i];
+    q[i].w = data[3*LD+i];
+  }
+}
+
+/// Composes n pairs of orientations, r[i] = a[i]*b[i]
+void QUAT_BATCH::mult(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL* r, unsigned ldr)
+{
+  check_ld(n, lda);
+  check_ld(n, ldb);
+  check_ld(n, ldr);
+  RotationKernels::mult(n, a, lda, b, ldb, r, ldr);
+}
+
+/// Composes a single orientation with n orientations, r[i] = a*b[i]
+void QUAT_BATCH::mult(const QUAT& a, unsigned n, const REAL* b, unsigned ldb, REAL* r, unsigned ldr)
+{
+  check_ld(n, ldb);
+  check_ld(n, ldr);
+  const REAL A[4] = { a.x, a.y, a.z, a.w };
+  RotationKernels::mult(A, n, b, ldb, r, ldr);
+}
+
+/// Rotates each of n points by the corresponding unit quaternion
+/**
+ * \param p the points (n x 3)
+ * \param r the rotated points (n x 3) on return
+ */
+void QUAT_BATCH::rotate(unsigned n, const REAL* q, unsigned ldq, const REAL* p, unsigned ldp, REAL* r, unsigned ldr)
+{
+  check_ld(n, ldq);
+  check_ld(n, ldp);
+  check_ld(n, ldr);
+  RotationKernels::rotate(n, q, ldq, p, ldp, r, ldr);
+}
+
+/// Rotates n points by a single unit quaternion
+/**
+ * The rotation matrix is computed once, so this costs nine multiplications
+ * per point.
+ * \param p the points (n x 3)
+ * \param r the rotated points (n x 3) on return
+ */
+void QUAT_BATCH::rotate(const QUAT& q, unsigned n, const REAL* p, unsigned ldp, REAL* r, unsigned ldr)
+{
+  check_ld(n, ldp);
+  check_ld(n, ldr);
+  const REAL Q[4] = { q.x, q.y, q.z, q.w };
+  REAL R[9];
+  RotationKernels::to_matrix(1, Q, 1, R, 1);
+  RotationKernels::rotate(R, n, p, ldp, r, ldr);
+}
+
+/// Normalizes n quaternions in place (zero quaternions become the identity, as in QUAT::normalize())
+void QUAT_BATCH::normalize(unsigned n, REAL* q, unsigned ldq)
+{
+  check_ld(n, ldq);
+  RotationKernels::normalize(n, q, ldq);
+}
+
+/// Interpolates between n pairs of unit quaternions by normalized linear interpolation
+/**
+ * Like QUAT::lerp(), the shorter arc between a[i] and b[i] is used. The
+ * result approximates slerp(): the rotations differ by no more than
+ * nlerp_error(theta) radians, where theta is the angle of the rotation
+ * between a[i] and b[i] (e.g., 5e-6 radians for theta = 0.1). The error
+ * vanishes for alpha = 0, 1/2, and 1.
+ * \param alpha interpolation value (0 <= alpha <= 1)
+ */
+void QUAT_BATCH::nlerp(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL alpha, REAL* r, unsigned ldr)
+{
+  #ifndef NEXCEPT
+  if (alpha < (REAL) 0.0 || alpha > (REAL) 1.0)
+    throw std::runtime_error("Attempting to interpolate using QUAT_BATCH::nlerp() with t not in interval [0,1]");
+  #endif
+  check_ld(n, lda);
+  check_ld(n, ldb);
+  check_ld(n, ldr);
+  RotationKernels::nlerp(n, a, lda, b, ldb, alpha, r, ldr);
+}
+
+/// Interpolates between n pairs of unit quaternions by spherical linear interpolation
+/**
+ * The shorter arc between a[i] and b[i] is used. Pairs that are nearly
+ * identical are interpolated linearly (and normalized).
+ * \param alpha interpolation value (0 <= alpha <= 1)
+ */
+void QUAT_BATCH::slerp(unsigned n, const REAL* a, unsigned lda, const REAL* b, unsigned ldb, REAL alpha, REAL* r, unsigned ldr)
+{
+  #ifndef NEXCEPT
+  if (alpha < (REAL) 0.0 || alpha > (REAL) 1.0)
+    throw std::runtime_error("Attempting to interpolate using QUAT_BATCH::slerp() with t not in interval [0,1]");
+  #endif
+  check_ld(n, lda);
+  check_ld(n, ldb);
+  check_ld(n, ldr);
+
+  // above this cosine, the arc is too short for sin(theta) to be accurate
+  const REAL DOT_MAX = (REAL) 1.0 - std::sqrt(EPS);
+
+  for (unsigned i=0; i< n; i++)
+  {
+    REAL dot = a[i]*b[i] + a[lda+i]*b[ldb+i] + a[2*lda+i]*b[2*ldb+i] + a[3*lda+i]*b[3*ldb+i];
+
+    // use the shorter arc
+    REAL sb = (REAL) 1.0;
+    if (dot < (REAL) 0.0)
+    {
+      dot = -dot;
+      sb = (REAL) -1.0;
+    }
+
+    // compute the weights
+    REAL ka, kb;
+    if (dot < DOT_MAX)
+    {
+      const REAL theta = std::acos(dot);
+      const REAL sint_i = (REAL) 1.0/std::sin(theta);
+      ka = std::sin(((REAL) 1.0 - alpha)*theta)*sint_i;
+      kb = std::sin(alpha*theta)*sint_i*sb;
+    }
+    else
+    {
+      ka = (REAL) 1.0 - alpha;
+      kb = alpha*sb;
+    }
+
+    REAL x = a[i]*ka + b[i]*kb;
+    REAL y = a[lda+i]*ka + b[ldb+i]*kb;
+    REAL z = a[2*lda+i]*ka + b[2*ldb+i]*kb;
+    REAL w = a[3*lda+i]*ka + b[3*ldb+i]*kb;
+    if (dot >= DOT_MAX)
+    {
+      const REAL magi = (REAL) 1.0/std::sqrt(x*x + y*y + z*z + w*w);
+      x *= magi;
+      y *= magi;
+      z *= magi;
+      w *= magi;
+    }
+    r[i] = x;
+    r[ldr+i] = y;
+    r[2*ldr+i] = z;
+    r[3*ldr+i] = w;
+  }
+}
+
+/// Computes the time derivatives of n quaternions (see QUAT::deriv())
+/**
+ * \param w the angular velocities (n x 3)
+ * \param qd the quaternion time derivatives (n x 4) on return
+ */
+void QUAT_BATCH::deriv(unsigned n, const REAL* q, unsigned ldq, const REAL* w, unsigned ldw, REAL* qd, unsigned ldqd)
+{
+  check_ld(n, ldq);
+  check_ld(n, ldw);
+  check_ld(n, ldqd);
+  RotationKernels::deriv(n, q, ldq, w, ldw, qd, ldqd);
+}
+
+/// Computes the rotation matrices of n unit quaternions
+/**
+ * \param R the matrices (n x 9) on return; row i holds the entries of the
+ *        i-th matrix in the order of MATRIX3::data()
+ */
+void QUAT_BATCH::to_matrix(unsigned n, const REAL* q, unsigned ldq, REAL* R, unsigned ldr)
+{
+  check_ld(n, ldq);
+  check_ld(n, ldr);
+  RotationKernels::to_matrix(n, q, ldq, R, ldr);
+}
+
+/// Computes the unit quaternions of n axis-angle rotations (see QUAT::operator=(const AANGLE&))
+/**
+ * \param axis the unit rotation axes (n x 3)
+ * \param angle the n rotation angles
+ * \param q the quaternions (n x 4) on return
+ */
+void QUAT_BATCH::from_axis_angle(unsigned n, const REAL* axis, unsigned lda, const REAL* angle, REAL* q, unsigned ldq)
+{
+  check_ld(n, lda);
+  check_ld(n, ldq);
+  for (unsigned i=0; i< n; i++)
+  {
+    const REAL half = angle[i]*(REAL) 0.5;
+    const REAL sina = std::sin(half);
+    const REAL cosa = std::cos(half);
+    q[i] = axis[i]*sina;
+    q[ldq+i] = axis[lda+i]*sina;
+    q[2*ldq+i] = axis[2*lda+i]*sina;
+    q[3*ldq+i] = cosa;
+  }
+}
+
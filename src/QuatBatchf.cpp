@@ -0,0 +1,18 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <cmath>
+#include <stdexcept>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/QuatBatchf.h>
+#include "rotation_kernels.h"
+
+using namespace Ravelin;
+
+#include <Ravelin/fdefs.h>
+#include "QuatBatch.cpp"
+#include <Ravelin/undefs.h>
+
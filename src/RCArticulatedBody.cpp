@@ -425,20 +425,7 @@ void RC_ARTICULATED_BODY::set_links_and_joints(const vector<shared_ptr<RIGIDBODY
   _processed.resize(links.size());
 
   // setup pointers
-  for (unsigned i=0; i< joints.size(); i++)
-  {
-    // set pointers for inner and outer joints
-    shared_ptr<RIGIDBODY> inboard = joints[i]->get_inboard_link();
-    shared_ptr<RIGIDBODY> outboard = joints[i]->get_outboard_link();
-    outboard->_inner_joints.insert(joints[i]);
-    inboard->_outer_joints.insert(joints[i]);
-
-    // set frames for outboard
-    outboard->_xdj.pose = joints[i]->get_pose();
-    outboard->_xddj.pose = joints[i]->get_pose();
-    outboard->_Jj.pose = joints[i]->get_pose();
-    outboard->_forcej.pose = joints[i]->get_pose();
-  }
+  attach_joints(joints);
 
   // clear the vectors of joints
   _ejoints.clear();
@@ -571,6 +558,25 @@ void RC_ARTICULATED_BODY::set_links_and_joints(const vector<shared_ptr<RIGIDBODY
   compile();
 }
 
+/// Sets the inner and outer joint pointers of the links of the given joints
+void RC_ARTICULATED_BODY::attach_joints(const vector<shared_ptr<JOINT> >& joints)
+{
+  for (unsigned i=0; i< joints.size(); i++)
+  {
+    // set pointers for inner and outer joints
+    shared_ptr<RIGIDBODY> inboard = joints[i]->get_inboard_link();
+    shared_ptr<RIGIDBODY> outboard = joints[i]->get_outboard_link();
+    outboard->_inner_joints.insert(joints[i]);
+    inboard->_outer_joints.insert(joints[i]);
+
+    // set frames for outboard
+    outboard->_xdj.pose = joints[i]->get_pose();
+    outboard->_xddj.pose = joints[i]->get_pose();
+    outboard->_Jj.pose = joints[i]->get_pose();
+    outboard->_forcej.pose = joints[i]->get_pose();
+  }
+}
+
 /// Gets the derivative of the velocity state vector for this articulated body
 /**
  * The state vector consists of the joint-space velocities of the robot as
@@ -866,7 +872,7 @@ MATRIXN& RC_ARTICULATED_BODY::calc_jacobian_column(boost::shared_ptr<JOINT> join
   Jc.resize(SPATIAL_DIM, s.size());
 
   // compute a spatial transformation using the point as the target frame
-  target->rpose = point.pose;
+  target->rpose = lock_frame(point.pose);
   target->x = ORIGIN3(point);
   target->q.set_identity();
   POSE3::transform(target, s, sprime);
@@ -1348,3 +1354,539 @@ bool RC_ARTICULATED_BODY::supports(boost::shared_ptr<JOINT> joint, shared_ptr<RI
 
 
 
+
+/// Computes a 64-bit (FNV-1a) hash of the contents of a file
+/**
+ * This hash can be passed to save_compiled() and load_compiled() to detect
+ * compiled models that are stale with respect to their source (e.g., URDF)
+ * file.
+ * \return the hash, or zero if the file could not be read
+ */
+boost::uint64_t RC_ARTICULATED_BODY::calc_file_hash(const string& fname)
+{
+  const boost::uint64_t FNV_OFFSET = 14695981039346656037ULL, FNV_PRIME = 1099511628211ULL;
+  const size_t BUFSIZE = 65536;
+
+  std::ifstream in(fname.c_str(), std::ios::in | std::ios::binary);
+  if (!in)
+    return 0;
+
+  boost::uint64_t hash = FNV_OFFSET;
+  vector<char> buffer(BUFSIZE);
+  while (in)
+  {
+    in.read(&buffer[0], BUFSIZE);
+    for (std::streamsize i=0; i< in.gcount(); i++)
+    {
+      hash ^= (unsigned char) buffer[i];
+      hash *= FNV_PRIME;
+    }
+  }
+
+  return hash;
+}
+
+/// Writes this (compiled) body to a binary file, from which it can be reconstructed using load_compiled()
+/**
+ * The file stores the link inertias and poses, the base velocity, the joint
+ * types, axes, poses, tare values, positions and velocities, the topology, and the joint ordering (and hence the 
+ * generalized coordinate indices) of the compiled body, so that it can be
+ * reconstructed without reading or processing the model description again.
+ * Only fixed, revolute and prismatic joints are supported. The file records
+ * the size of REAL, so files written using the double version of the 
+ * library can only be read by the double version (and vice versa).
+ * \param fname the name of the file to write
+ * \param source_hash a hash of the source of the model (see calc_file_hash());
+ *        load_compiled() can check this hash to detect stale files
+ * \return <b>true</b> if the file was written successfully
+ */
+bool RC_ARTICULATED_BODY::save_compiled(const string& fname, boost::uint64_t source_hash) const
+{
+  // serialize the body
+  string data;
+  if (!write_compiled(data, source_hash))
+    return false;
+
+  // write the file 
+  std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::cerr << "RCArticulatedBody::save_compiled() - unable to open file " << fname << " for writing" << std::endl;
+    return false;
+  }
+  out.write(data.c_str(), data.size());
+
+  return (bool) out;
+}
+
+/// Serializes this (compiled) body in the format of save_compiled() 
+bool RC_ARTICULATED_BODY::write_compiled(string& data, boost::uint64_t source_hash) const
+{
+  const shared_ptr<const POSE3> GLOBAL;
+  const unsigned X = 0, Y = 1, Z = 2;
+
+  // setup the header
+  CompiledHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "RAVELINC", sizeof(header.magic));
+  header.version = COMPILED_VERSION;
+  header.real_size = sizeof(REAL);
+  header.nlinks = _links.size();
+  header.njoints = _joints.size();
+  header.algorithm = (boost::uint32_t) algorithm_type;
+  header.rftype = (boost::uint32_t) _rftype;
+  header.body_id_size = body_id.size();
+  header.source_hash = source_hash;
+
+  // the string table starts with the body ID 
+  string strings = body_id;
+
+  // setup the link records
+  vector<CompiledLink> links(_links.size());
+  for (unsigned i=0; i< _links.size(); i++)
+  {
+    CompiledLink& link = links[i];
+    std::memset(&link, 0, sizeof(link));
+    link.id_offset = strings.size();
+    link.id_size = _links[i]->body_id.size();
+    strings += _links[i]->body_id;
+    link.enabled = (_links[i]->is_enabled()) ? 1 : 0;
+
+    // get the pose relative to the inner joint (the pose is defined relative
+    // to the pose induced by that joint) or to the global frame (for the base)
+    POSE3 P = *_links[i]->get_pose();
+    shared_ptr<JOINT> inner = (i > 0) ? _links[i]->get_inner_joint_explicit() : shared_ptr<JOINT>();
+    if (inner)
+      link.inner_joint = inner->get_index();
+    else
+    {
+      link.inner_joint = std::numeric_limits<boost::uint32_t>::max();
+      P.update_relative_pose(GLOBAL);
+    }
+    link.x[X] = P.x[X];  link.x[Y] = P.x[Y];  link.x[Z] = P.x[Z];
+    link.q[0] = P.q.x;  link.q[1] = P.q.y;  link.q[2] = P.q.z;  link.q[3] = P.q.w;
+
+    // get the velocity of the base (the velocities of the other links are
+    // determined by the joint velocities)
+    if (!inner)
+    {
+      SVELOCITY xd = POSE3::transform(_links[i]->get_pose(), _links[i]->get_velocity());
+      std::copy(xd.data(), xd.data()+6, link.xd);
+    }
+
+    // get the inertia in the link pose
+    const SPATIAL_RB_INERTIA& J = _links[i]->_Ji;
+    link.m = J.m;
+    link.h[X] = J.h[X];  link.h[Y] = J.h[Y];  link.h[Z] = J.h[Z];
+    std::copy(J.J.data(), J.J.data()+9, link.J);
+  }
+
+  // setup the joint records
+  vector<CompiledJoint> joints(_joints.size());
+  for (unsigned i=0; i< _joints.size(); i++)
+  {
+    shared_ptr<JOINT> joint = _joints[i];
+    CompiledJoint& cj = joints[i];
+    std::memset(&cj, 0, sizeof(cj));
+    cj.id_offset = strings.size();
+    cj.id_size = joint->joint_id.size();
+    strings += joint->joint_id;
+    cj.inboard = joint->get_inboard_link()->get_index();
+    cj.outboard = joint->get_outboard_link()->get_index();
+    cj.ndof = joint->num_dof();
+
+    // get the position of the joint in the vector of explicit or implicit 
+    // joints; this determines the generalized coordinate indices
+    const vector<shared_ptr<JOINT> >& order = (joint->get_constraint_type() == JOINT::eImplicit) ? _ijoints : _ejoints;
+    cj.implicit = (joint->get_constraint_type() == JOINT::eImplicit) ? 1 : 0;
+    cj.order = std::find(order.begin(), order.end(), joint) - order.begin();
+
+    // get the joint type and axis
+    shared_ptr<REVOLUTEJOINT> rj = dynamic_pointer_cast<REVOLUTEJOINT>(joint);
+    shared_ptr<PRISMATICJOINT> pj = dynamic_pointer_cast<PRISMATICJOINT>(joint);
+    VECTOR3 axis((REAL) 0.0, (REAL) 0.0, (REAL) 0.0);
+    if (rj)
+    {
+      cj.type = eCompiledRevolute;
+      axis = rj->get_axis();
+    }
+    else if (pj)
+    {
+      cj.type = eCompiledPrismatic;
+      axis = pj->get_axis();
+    }
+    else if (dynamic_pointer_cast<FIXEDJOINT>(joint))
+      cj.type = eCompiledFixed;
+    else
+    {
+      std::cerr << "RCArticulatedBody::write_compiled() - joint " << joint->joint_id << " is of an unsupported type" << std::endl;
+      return false;
+    }
+    cj.axis[X] = axis[X];  cj.axis[Y] = axis[Y];  cj.axis[Z] = axis[Z];
+
+    // get the joint poses
+    const POSE3* poses[2] = { joint->_F.get(), joint->_Fb.get() };
+    REAL* dest[2] = { cj.F, cj.Fb };
+    for (unsigned j=0; j< 2; j++)
+    {
+      dest[j][0] = poses[j]->x[X];  dest[j][1] = poses[j]->x[Y];  dest[j][2] = poses[j]->x[Z];
+      dest[j][3] = poses[j]->q.x;  dest[j][4] = poses[j]->q.y;  dest[j][5] = poses[j]->q.z;  dest[j][6] = poses[j]->q.w;
+    }
+
+    // get the joint values
+    for (unsigned j=0; j< cj.ndof; j++)
+    {
+      cj.q_tare[j] = joint->get_q_tare()[j];
+      cj.q[j] = joint->q[j];
+      cj.qd[j] = joint->qd[j];
+    }
+  }
+  header.strings_size = strings.size();
+
+  // concatenate the header, the records and the strings 
+  data.clear();
+  data.reserve(sizeof(header) + sizeof(CompiledLink)*links.size() + sizeof(CompiledJoint)*joints.size() + strings.size());
+  data.append((const char*) &header, sizeof(header));
+  if (!links.empty())
+    data.append((const char*) &links[0], sizeof(CompiledLink)*links.size());
+  if (!joints.empty())
+    data.append((const char*) &joints[0], sizeof(CompiledJoint)*joints.size());
+  data += strings;
+
+  return true;
+}
+
+/// Creates an independent copy of this (compiled) body
+/**
+ * The copy has its own links, joints and frames, which are copied directly
+ * from those of this body (the frames of the copied links, joints, vectors 
+ * and inertias are made to refer to one another), and its own algorithm 
+ * workspaces. The state of this body (joint positions, velocities and 
+ * forces, the base pose and velocity, and the link poses and velocities
+ * computed from them) is copied, so the copy need not be recompiled and can 
+ * be simulated independently (e.g., for parallel rollouts). 
+ * 
+ * \return the copy, or a null pointer if the body contains a joint type 
+ *         that does not support copying (see JOINT::copy())
+ */
+shared_ptr<RC_ARTICULATED_BODY> RC_ARTICULATED_BODY::clone() const
+{
+  shared_ptr<RC_ARTICULATED_BODY> body(new RC_ARTICULATED_BODY);
+
+  // copy the links and joints, and their frames
+  JOINT::PoseMap poses;
+  poses.rehash((_links.size()*2 + _joints.size()*4)*2);
+  vector<shared_ptr<RIGIDBODY> > links(_links.size());
+  for (unsigned i=0; i< _links.size(); i++)
+  {
+    links[i] = shared_ptr<RIGIDBODY>(new RIGIDBODY(*_links[i]));
+    JOINT::copy_frame(links[i]->_F, poses);
+    JOINT::copy_frame(links[i]->_F2, poses);
+  }
+  vector<shared_ptr<JOINT> > joints(_joints.size());
+  for (unsigned i=0; i< _joints.size(); i++)
+  {
+    JOINT* joint = _joints[i]->copy(poses);
+    if (!joint)
+      return shared_ptr<RC_ARTICULATED_BODY>();
+    joints[i] = shared_ptr<JOINT>(joint);
+  }
+
+  // make the copied frames refer to one another 
+  for (JOINT::PoseMap::iterator i = poses.begin(); i != poses.end(); i++)
+  {
+    JOINT::PoseMap::const_iterator j = poses.find(i->second->rpose.get());
+    if (j != poses.end())
+      i->second->rpose = j->second;
+  }
+
+  // make the link quantities refer to the copied frames and reattach the 
+  // links to the copied joints
+  for (unsigned i=0; i< links.size(); i++)
+  {
+    RIGIDBODY& link = *links[i];
+    JOINT::remap_frame(link._J0, poses);
+    JOINT::remap_frame(link._xd0, poses);
+    JOINT::remap_frame(link._xdd0, poses);
+    JOINT::remap_frame(link._force0, poses);
+    JOINT::remap_frame(link._Ji, poses);
+    JOINT::remap_frame(link._xdi, poses);
+    JOINT::remap_frame(link._xddi, poses);
+    JOINT::remap_frame(link._forcei, poses);
+    JOINT::remap_frame(link._Jcom, poses);
+    JOINT::remap_frame(link._xdcom, poses);
+    JOINT::remap_frame(link._xddcom, poses);
+    JOINT::remap_frame(link._forcecom, poses);
+    JOINT::remap_frame(link._Jj, poses);
+    JOINT::remap_frame(link._xdj, poses);
+    JOINT::remap_frame(link._forcej, poses);
+    JOINT::remap_frame(link._xddj, poses);
+    link._inner_joints.clear();
+    link._outer_joints.clear();
+    link._abody = body;
+  }
+  for (unsigned i=0; i< joints.size(); i++)
+  {
+    joints[i]->remap_frames(poses);
+    shared_ptr<RIGIDBODY> inboard = links[_joints[i]->get_inboard_link()->get_index()];
+    shared_ptr<RIGIDBODY> outboard = links[_joints[i]->get_outboard_link()->get_index()];
+    joints[i]->_inboard_link = inboard;
+    joints[i]->_outboard_link = outboard;
+    inboard->_outer_joints.insert(joints[i]);
+    outboard->_inner_joints.insert(joints[i]);
+  }
+
+  // setup the body; the joint order, coordinate indices and link poses and
+  // velocities are copied, so the body need not be compiled 
+  body->body_id = body_id;
+  body->algorithm_type = algorithm_type;
+  body->_rftype = _rftype;
+  body->_floating_base = _floating_base;
+  body->_n_joint_DOF_explicit = _n_joint_DOF_explicit;
+  body->_position_invalidated = _position_invalidated;
+  body->_links = links;
+  body->_joints = joints;
+  body->_processed.resize(links.size());
+  body->_ejoints.resize(_ejoints.size());
+  for (unsigned i=0; i< _ejoints.size(); i++)
+    body->_ejoints[i] = joints[_ejoints[i]->get_index()];
+  body->_ijoints.resize(_ijoints.size());
+  for (unsigned i=0; i< _ijoints.size(); i++)
+    body->_ijoints[i] = joints[_ijoints[i]->get_index()];
+  body->_crb.set_body(body);
+  body->_fsab.set_body(body);
+
+  return body;
+}
+
+/// Reconstructs a body written by save_compiled()
+/**
+ * The file is mapped into memory read-only and the link and joint records
+ * are read in place (no parsing is necessary). 
+ * \param fname the name of the file to read
+ * \param source_hash if nonzero, the file is rejected unless it was written
+ *        with the same source hash (see calc_file_hash()) 
+ * \return the body, or a null pointer if the file could not be read, was 
+ *         written by an incompatible version or with a different REAL type,
+ *         or is stale
+ */
+shared_ptr<RC_ARTICULATED_BODY> RC_ARTICULATED_BODY::load_compiled(const string& fname, boost::uint64_t source_hash)
+{
+  // open the file and get its size
+  int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "RCArticulatedBody::load_compiled() - unable to open file " << fname << " for reading" << std::endl;
+    return shared_ptr<RC_ARTICULATED_BODY>();
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(CompiledHeader))
+  {
+    std::cerr << "RCArticulatedBody::load_compiled() - " << fname << " is not a compiled model" << std::endl;
+    close(fd);
+    return shared_ptr<RC_ARTICULATED_BODY>();
+  }
+
+  // map the file
+  void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    std::cerr << "RCArticulatedBody::load_compiled() - unable to map file " << fname << std::endl;
+    return shared_ptr<RC_ARTICULATED_BODY>();
+  }
+
+  // construct the body
+  shared_ptr<RC_ARTICULATED_BODY> body(new RC_ARTICULATED_BODY);
+  bool success = read_compiled((const char*) data, st.st_size, source_hash, body);
+  munmap(data, st.st_size);
+  if (!success)
+  {
+    std::cerr << "RCArticulatedBody::load_compiled() - unable to read compiled model from " << fname << std::endl;
+    return shared_ptr<RC_ARTICULATED_BODY>();
+  }
+
+  return body;
+}
+
+/// Reconstructs a body from the contents of a compiled model file
+bool RC_ARTICULATED_BODY::read_compiled(const char* data, size_t size, boost::uint64_t source_hash, shared_ptr<RC_ARTICULATED_BODY> body)
+{
+  const unsigned X = 0, Y = 1, Z = 2;
+  const boost::uint32_t NONE = std::numeric_limits<boost::uint32_t>::max();
+
+  // verify the header
+  if (size < sizeof(CompiledHeader))
+    return false;
+  const CompiledHeader& header = *((const CompiledHeader*) data);
+  if (std::memcmp(header.magic, "RAVELINC", sizeof(header.magic)) != 0 || header.version != COMPILED_VERSION)
+    return false;
+  if (header.algorithm > eCRB || header.rftype > eJoint)
+    return false;
+  if (header.real_size != sizeof(REAL))
+  {
+    std::cerr << "RCArticulatedBody::read_compiled() - model was compiled with a different floating point type" << std::endl;
+    return false;
+  }
+  if (source_hash != 0 && header.source_hash != source_hash)
+  {
+    std::cerr << "RCArticulatedBody::read_compiled() - compiled model is stale" << std::endl;
+    return false;
+  }
+  const size_t LINKS_OFFSET = sizeof(CompiledHeader);
+  const size_t JOINTS_OFFSET = LINKS_OFFSET + sizeof(CompiledLink)*header.nlinks; 
+  const size_t STRINGS_OFFSET = JOINTS_OFFSET + sizeof(CompiledJoint)*header.njoints; 
+  if (STRINGS_OFFSET + header.strings_size != size || header.body_id_size > header.strings_size)
+    return false;
+  const CompiledLink* clinks = (const CompiledLink*) (data + LINKS_OFFSET);
+  const CompiledJoint* cjoints = (const CompiledJoint*) (data + JOINTS_OFFSET);
+  const char* strings = data + STRINGS_OFFSET;
+
+  // verify the records; no two explicit (or two implicit) joints may have
+  // the same order
+  for (unsigned i=0; i< header.nlinks; i++)
+    if ((boost::uint64_t) clinks[i].id_offset + clinks[i].id_size > header.strings_size || (clinks[i].inner_joint != NONE && clinks[i].inner_joint >= header.njoints))
+      return false;
+  vector<bool> ordered[2] = { vector<bool>(header.njoints, false), vector<bool>(header.njoints, false) };
+  for (unsigned i=0; i< header.njoints; i++)
+  {
+    if ((boost::uint64_t) cjoints[i].id_offset + cjoints[i].id_size > header.strings_size || cjoints[i].inboard >= header.nlinks || cjoints[i].outboard >= header.nlinks || cjoints[i].order >= header.njoints || cjoints[i].type > eCompiledPrismatic)
+      return false;
+    vector<bool>& seen = ordered[(cjoints[i].implicit) ? 1 : 0];
+    if (seen[cjoints[i].order])
+      return false;
+    seen[cjoints[i].order] = true;
+  }
+
+  // construct the links; the inertia is defined in the link pose
+  vector<shared_ptr<RIGIDBODY> > links(header.nlinks);
+  for (unsigned i=0; i< header.nlinks; i++)
+  {
+    const CompiledLink& cl = clinks[i];
+    links[i] = shared_ptr<RIGIDBODY>(new RIGIDBODY);
+    links[i]->body_id = string(strings + cl.id_offset, cl.id_size);
+    links[i]->set_enabled(cl.enabled != 0);
+    SPATIAL_RB_INERTIA J(links[i]->get_pose());
+    J.m = cl.m;
+    J.h = VECTOR3(cl.h[X], cl.h[Y], cl.h[Z], links[i]->get_pose());
+    std::copy(cl.J, cl.J+9, J.J.data());
+    links[i]->set_inertia(J);
+  }
+
+  // construct the joints and attach them to their links
+  vector<shared_ptr<JOINT> > joints(header.njoints);
+  for (unsigned i=0; i< header.njoints; i++)
+  {
+    const CompiledJoint& cj = cjoints[i];
+    if (cj.type == eCompiledRevolute)
+      joints[i] = shared_ptr<JOINT>(new REVOLUTEJOINT);
+    else if (cj.type == eCompiledPrismatic)
+      joints[i] = shared_ptr<JOINT>(new PRISMATICJOINT);
+    else
+      joints[i] = shared_ptr<JOINT>(new FIXEDJOINT);
+    if (joints[i]->num_dof() != cj.ndof)
+      return false;
+    joints[i]->joint_id = string(strings + cj.id_offset, cj.id_size);
+    joints[i]->set_inboard_link(links[cj.inboard], false);
+    joints[i]->set_outboard_link(links[cj.outboard], false);
+
+    // set the joint poses relative to the inboard and outboard link poses 
+    POSE3* poses[2] = { joints[i]->_F.get(), joints[i]->_Fb.get() };
+    const REAL* src[2] = { cj.F, cj.Fb };
+    for (unsigned j=0; j< 2; j++)
+    {
+      poses[j]->x = ORIGIN3(src[j][0], src[j][1], src[j][2]);
+      poses[j]->q = QUAT(src[j][3], src[j][4], src[j][5], src[j][6]);
+    }
+
+    // set the joint values
+    VECTORN q_tare(cj.ndof);
+    for (unsigned j=0; j< cj.ndof; j++)
+    {
+      q_tare[j] = cj.q_tare[j];
+      joints[i]->q[j] = cj.q[j];
+      joints[i]->qd[j] = cj.qd[j];
+    }
+    joints[i]->set_q_tare(q_tare);
+    if (cj.implicit)
+      joints[i]->set_constraint_type(JOINT::eImplicit);
+  }
+
+  // set the link poses; the pose of each non-base link is defined relative 
+  // to the pose of its inner joint, which is identical to the pose induced 
+  // by the joint at the zero configuration that compile() uses 
+  for (unsigned i=0; i< header.nlinks; i++)
+  {
+    const CompiledLink& cl = clinks[i];
+    shared_ptr<POSE3> P = links[i]->_F;
+    P->x = ORIGIN3(cl.x[X], cl.x[Y], cl.x[Z]);
+    P->q = QUAT(cl.q[0], cl.q[1], cl.q[2], cl.q[3]);
+    if (cl.inner_joint != NONE)
+      P->rpose = joints[cl.inner_joint]->get_pose();
+    links[i]->update_mixed_pose();
+    if (cl.inner_joint == NONE)
+      links[i]->set_velocity(SVELOCITY(cl.xd, links[i]->get_pose()));
+  }
+
+  // set the joint axes (these depend upon the link poses)
+  for (unsigned i=0; i< header.njoints; i++)
+  {
+    const CompiledJoint& cj = cjoints[i];
+    VECTOR3 axis(cj.axis[X], cj.axis[Y], cj.axis[Z], joints[i]->get_pose());
+    if (cj.type == eCompiledRevolute)
+      dynamic_pointer_cast<REVOLUTEJOINT>(joints[i])->set_axis(axis);
+    else if (cj.type == eCompiledPrismatic)
+      dynamic_pointer_cast<PRISMATICJOINT>(joints[i])->set_axis(axis);
+  }
+
+  // setup the body directly from the compiled topology and joint order; 
+  // this is equivalent to (but faster than) set_links_and_joints(), which
+  // also determines the order of the explicit and implicit joints (and 
+  // hence the generalized coordinate indices) 
+  body->body_id = string(strings, header.body_id_size);
+  body->algorithm_type = (ForwardDynamicsAlgorithmType) header.algorithm;
+  body->_rftype = (ReferenceFrameType) header.rftype;
+  body->attach_joints(joints);
+  body->_ejoints.clear();
+  body->_ijoints.clear();
+  for (unsigned i=0; i< header.njoints; i++)
+  {
+    vector<shared_ptr<JOINT> >& order = (cjoints[i].implicit) ? body->_ijoints : body->_ejoints;
+    if (order.size() <= cjoints[i].order)
+      order.resize(cjoints[i].order+1);
+    order[cjoints[i].order] = joints[i];
+  }
+  body->_n_joint_DOF_explicit = 0;
+  for (unsigned i=0; i< body->_ejoints.size(); i++)
+  {
+    if (!body->_ejoints[i])
+      return false;
+    body->_ejoints[i]->set_constraint_type(JOINT::eExplicit);
+    body->_n_joint_DOF_explicit += body->_ejoints[i]->num_dof();
+  }
+  for (unsigned i=0; i< body->_ijoints.size(); i++)
+  {
+    if (!body->_ijoints[i])
+      return false;
+    body->_ijoints[i]->set_constraint_type(JOINT::eImplicit);
+  }
+
+  // setup the links and joints
+  body->_floating_base = (header.nlinks > 0 && links.front()->is_enabled());
+  body->_links = links;
+  for (unsigned i=0; i< links.size(); i++)
+  {
+    links[i]->set_computation_frame_type(body->_rftype);
+    links[i]->set_index(i);
+    links[i]->set_articulated_body(body);
+  }
+  body->_joints = joints;
+  for (unsigned i=0; i< joints.size(); i++)
+    joints[i]->set_index(i);
+  body->_processed.resize(links.size());
+
+  // compile the body
+  body->compile();
+
+  return true;
+}
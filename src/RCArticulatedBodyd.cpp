@@ -4,11 +4,22 @@
  * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
  ****************************************************************************/
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <stack>
 #include <queue>
 #include <Ravelin/Jointd.h>
 #include <Ravelin/RigidBodyd.h>
 #include <Ravelin/RCArticulatedBodyd.h>
+#include <Ravelin/FixedJointd.h>
+#include <Ravelin/PrismaticJointd.h>
+#include <Ravelin/RevoluteJointd.h>
 #include <Ravelin/CRBAlgorithmd.h>
 #include <Ravelin/FSABAlgorithmd.h>
 #include <Ravelin/SpatialArithmeticd.h>
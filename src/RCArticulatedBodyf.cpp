@@ -4,11 +4,22 @@
  * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
  ****************************************************************************/
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <stack>
 #include <queue>
 #include <Ravelin/Jointf.h>
 #include <Ravelin/RigidBodyf.h>
 #include <Ravelin/RCArticulatedBodyf.h>
+#include <Ravelin/FixedJointf.h>
+#include <Ravelin/PrismaticJointf.h>
+#include <Ravelin/RevoluteJointf.h>
 #include <Ravelin/CRBAlgorithmf.h>
 #include <Ravelin/FSABAlgorithmf.h>
 #include <Ravelin/SpatialArithmeticf.h>
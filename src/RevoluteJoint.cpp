@@ -252,4 +252,21 @@ void REVOLUTEJOINT::calc_constraint_jacobian_dot(bool inboard, MATRIXN& Cq)
   throw std::runtime_error("Implementation required");
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* REVOLUTEJOINT::copy(PoseMap& poses) const
+{
+  REVOLUTEJOINT* joint = new REVOLUTEJOINT(*this);
+  joint->copy_frames(poses);
+  return joint;
+}
 
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void REVOLUTEJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_u, poses);
+  remap_frame(_ui, poses);
+  remap_frame(_uj, poses);
+  remap_frame(_v2, poses);
+  remap_frame(_s_dot, poses);
+}
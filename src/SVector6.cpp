@@ -12,7 +12,7 @@ SVECTOR6::SVECTOR6()
 }
 
 /// Constructs a zero vector relative to the given pose
-SVECTOR6::SVECTOR6(boost::shared_ptr<const POSE3> pose) 
+SVECTOR6::SVECTOR6(FRAME_PTR pose) 
 { 
   _data[0] = _data[1] = _data[2] = 0.0;
   _data[3] = _data[4] = _data[5] = 0.0;
@@ -39,7 +39,7 @@ SVECTOR6::SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c)
 }
 
 /// Constructs this vector with the given values
-SVECTOR6::SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c, boost::shared_ptr<const POSE3> pose)
+SVECTOR6::SVECTOR6(REAL x, REAL y, REAL z, REAL a, REAL b, REAL c, FRAME_PTR pose)
 {
   _data[0] = x;
   _data[1] = y;
@@ -76,7 +76,7 @@ SVECTOR6::SVECTOR6(const REAL* array)
 /**
  * \param array a 6-dimensional (or larger) array
  */
-SVECTOR6::SVECTOR6(const REAL* array, boost::shared_ptr<const POSE3> pose)
+SVECTOR6::SVECTOR6(const REAL* array, FRAME_PTR pose)
 {
   for (unsigned i=0; i< 6; i++)
     _data[i] = array[i];
@@ -102,7 +102,7 @@ SVECTOR6::SVECTOR6(const VECTOR3& upper, const VECTOR3& lower)
 }
 
 /// Constructs the given spatial vector with given upper and lower components
-SVECTOR6::SVECTOR6(const VECTOR3& upper, const VECTOR3& lower, boost::shared_ptr<const POSE3> pose)
+SVECTOR6::SVECTOR6(const VECTOR3& upper, const VECTOR3& lower, FRAME_PTR pose)
 {
   set_upper(upper);
   set_lower(lower);
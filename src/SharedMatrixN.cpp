@@ -13,6 +13,32 @@ SHAREDMATRIXN::SHAREDMATRIXN(unsigned rows, unsigned cols, unsigned leading_dim,
   _data = data;
 }
 
+/// Constructs a view of a column-major matrix in memory owned elsewhere (e.g., by Eigen, numpy, or a shared memory segment)
+/**
+ * No data is copied and the memory is not freed by the view, so it must
+ * outlive the view and all views and copies made from it. Constructing the
+ * view does not allocate.
+ * \param leading_dim the distance between the starts of consecutive columns,
+ *        or 0 if the columns are contiguous (the leading dimension is rows)
+ */
+SHAREDMATRIXN::SHAREDMATRIXN(REAL* data, unsigned rows, unsigned cols, unsigned leading_dim)
+{
+  if (leading_dim == 0)
+    leading_dim = rows;
+  #ifndef NEXCEPT
+  if (leading_dim < rows)
+    throw MissizeException();
+  if (!data && rows > 0 && cols > 0)
+    throw NullPointerException("Null data given for a non-empty matrix");
+  #endif
+  _rows = rows;
+  _columns = cols;
+  _ld = leading_dim;
+  _start = 0;
+  unsigned span = (rows > 0 && cols > 0) ? leading_dim*(cols-1) + rows : 0;
+  _data = SharedResizable<REAL>::external(const_cast<REAL*>(data), span);
+}
+
 /// Copy constructor
 SHAREDMATRIXN::SHAREDMATRIXN(const SHAREDMATRIXN& source)
 {
@@ -24,7 +50,7 @@ void SHAREDMATRIXN::reset_from(const SHAREDMATRIXN& source)
 {
   _rows = source.rows();
   _columns = source.columns();
-  _ld = source.rows();
+  _ld = source.leading_dim();
   _start = source._start;
   _data = source._data;
 }
@@ -253,6 +279,32 @@ CONST_SHAREDMATRIXN::CONST_SHAREDMATRIXN(unsigned rows, unsigned cols, unsigned
   _data = data;
 }
 
+/// Constructs a view of a column-major matrix in memory owned elsewhere (e.g., by Eigen, numpy, or a shared memory segment)
+/**
+ * No data is copied and the memory is not freed by the view, so it must
+ * outlive the view and all views and copies made from it. Constructing the
+ * view does not allocate.
+ * \param leading_dim the distance between the starts of consecutive columns,
+ *        or 0 if the columns are contiguous (the leading dimension is rows)
+ */
+CONST_SHAREDMATRIXN::CONST_SHAREDMATRIXN(const REAL* data, unsigned rows, unsigned cols, unsigned leading_dim)
+{
+  if (leading_dim == 0)
+    leading_dim = rows;
+  #ifndef NEXCEPT
+  if (leading_dim < rows)
+    throw MissizeException();
+  if (!data && rows > 0 && cols > 0)
+    throw NullPointerException("Null data given for a non-empty matrix");
+  #endif
+  _rows = rows;
+  _columns = cols;
+  _ld = leading_dim;
+  _start = 0;
+  unsigned span = (rows > 0 && cols > 0) ? leading_dim*(cols-1) + rows : 0;
+  _data = SharedResizable<REAL>::external(const_cast<REAL*>(data), span);
+}
+
 /// Copy constructor
 CONST_SHAREDMATRIXN::CONST_SHAREDMATRIXN(const SHAREDMATRIXN& source)
 {
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <Ravelin/cblas.h>
 #include <Ravelin/Constants.h>
+#include <Ravelin/NullPointerException.h>
 #include <Ravelin/VectorNf.h>
 #include <Ravelin/MatrixNf.h>
 #include <Ravelin/SharedVectorNf.h>
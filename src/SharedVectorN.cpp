@@ -23,6 +23,29 @@ SHAREDVECTORN::SHAREDVECTORN(unsigned len, unsigned inc, unsigned start, SharedR
   _data = data;
 }
 
+/// Constructs a view of a vector in memory owned elsewhere (e.g., by Eigen, numpy, or a shared memory segment)
+/**
+ * No data is copied and the memory is not freed by the view, so it must
+ * outlive the view and all views and copies made from it. Constructing the
+ * view does not allocate.
+ * \param inc the distance between consecutive elements; the LINALG solvers
+ *        solve a strided vector through a contiguous copy
+ */
+SHAREDVECTORN::SHAREDVECTORN(REAL* data, unsigned len, unsigned inc)
+{
+  #ifndef NEXCEPT
+  if (inc == 0)
+    throw InvalidIndexException();
+  if (!data && len > 0)
+    throw NullPointerException("Null data given for a non-empty vector");
+  #endif
+  _len = len;
+  _inc = inc;
+  _start = 0;
+  unsigned span = (len > 0) ? inc*(len-1) + 1 : 0;
+  _data = SharedResizable<REAL>::external(const_cast<REAL*>(data), span);
+}
+
 /// Constructs a shared vector from another shared vector 
 void SHAREDVECTORN::reset_from(const SHAREDVECTORN& v)
 {
@@ -194,6 +217,29 @@ CONST_SHAREDVECTORN::CONST_SHAREDVECTORN(unsigned len, unsigned inc, unsigned st
   _data = data;
 }
 
+/// Constructs a view of a vector in memory owned elsewhere (e.g., by Eigen, numpy, or a shared memory segment)
+/**
+ * No data is copied and the memory is not freed by the view, so it must
+ * outlive the view and all views and copies made from it. Constructing the
+ * view does not allocate.
+ * \param inc the distance between consecutive elements; the LINALG solvers
+ *        solve a strided vector through a contiguous copy
+ */
+CONST_SHAREDVECTORN::CONST_SHAREDVECTORN(const REAL* data, unsigned len, unsigned inc)
+{
+  #ifndef NEXCEPT
+  if (inc == 0)
+    throw InvalidIndexException();
+  if (!data && len > 0)
+    throw NullPointerException("Null data given for a non-empty vector");
+  #endif
+  _len = len;
+  _inc = inc;
+  _start = 0;
+  unsigned span = (len > 0) ? inc*(len-1) + 1 : 0;
+  _data = SharedResizable<REAL>::external(const_cast<REAL*>(data), span);
+}
+
 /// Gets this object as a standard shared vector
 /**
  * \note const-ness is not enforced by my compiler! 
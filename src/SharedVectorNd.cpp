@@ -11,6 +11,7 @@
 #include <iostream>
 #include <Ravelin/cblas.h>
 #include <Ravelin/Constants.h>
+#include <Ravelin/NullPointerException.h>
 #include <Ravelin/VectorNd.h>
 #include <Ravelin/SharedVectorNd.h>
 
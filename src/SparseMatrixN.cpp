@@ -39,17 +39,28 @@ SPARSEMATRIXN::SPARSEMATRIXN(StorageType stype, unsigned m, unsigned n, const ma
   set(m, n, values);
 }
 
+/// Creates a sparse matrix from (row, column, value) triplets, summing duplicates
+SPARSEMATRIXN::SPARSEMATRIXN(StorageType stype, unsigned m, unsigned n, const Triplets& triplets)
+{
+  _rows = _columns = 0;
+  _nnz = 0;
+  _nnz_capacity = 0;
+  _ptr_capacity = 0;
+  _stype = stype;
+  set_from_triplets(m, n, triplets);
+}
+
 SPARSEMATRIXN::SPARSEMATRIXN(StorageType stype, unsigned m, unsigned n, shared_array<unsigned> ptr, shared_array<unsigned> indices, shared_array<REAL> data) 
 {
   _rows = m;
   _columns = n;
   _stype = stype;
-  _nnz = _ptr[_rows];
-  _nnz_capacity = _nnz;
-  _ptr_capacity = _rows+1;
   _data = data; 
   _ptr = ptr; 
   _indices = indices; 
+  _ptr_capacity = ((stype == eCSR) ? _rows : _columns)+1;
+  _nnz = _ptr[_ptr_capacity-1];
+  _nnz_capacity = _nnz;
 }
 
 /// Creates a sparse matrix from a dense matrix
@@ -79,7 +90,7 @@ SPARSEMATRIXN::SPARSEMATRIXN(const MATRIXN& m, REAL tol)
   unsigned j = 0;
   unsigned k=0;
   _ptr[0] = j;
-  CONST_COLUMN_ITERATOR i = m.column_iterator_begin();
+  CONST_ROW_ITERATOR i = m.row_iterator_begin();
   for (unsigned r=0; r< m.rows(); r++)
   {
     for (unsigned s=0; s< m.columns(); s++, i++)
@@ -126,7 +137,7 @@ SPARSEMATRIXN::SPARSEMATRIXN(StorageType stype, const MATRIXN& m, REAL tol)
     unsigned j=0;
     unsigned k=0;
     _ptr[0] = j;
-    CONST_COLUMN_ITERATOR i = m.column_iterator_begin();
+    CONST_ROW_ITERATOR i = m.row_iterator_begin();
     for (unsigned r=0; r< m.rows(); r++)
     {
       for (unsigned s=0; s< m.columns(); s++, i++)
@@ -158,7 +169,7 @@ SPARSEMATRIXN::SPARSEMATRIXN(StorageType stype, const MATRIXN& m, REAL tol)
     unsigned j = 0;
     unsigned k=0;
     _ptr[0] = j;
-    CONST_ROW_ITERATOR i = m.row_iterator_begin();
+    CONST_COLUMN_ITERATOR i = m.column_iterator_begin();
     for (unsigned col=0; col< m.columns(); col++)
     {
       for (unsigned row=0; row< m.rows(); row++, i++)
@@ -285,23 +296,7 @@ void SPARSEMATRIXN::get_values(map<pair<unsigned, unsigned>, REAL>& values) cons
 void SPARSEMATRIXN::set_column(unsigned col, const VECTORN& v)
 {
   if (_stype == eCSR)
-  {
-    // get the values
-    map<pair<unsigned, unsigned>, REAL> values; 
-    get_values(values);
-
-    // remove all values from column
-    for (unsigned i=0; i< _rows; i++)
-      values.erase(make_pair(i, col));
-
-    // update the map
-    for (unsigned i=0; i< v.size(); i++)
-      if (v[i] > EPS || v[i] < -EPS)
-        values[make_pair(i,col)] = v[i];
-
-    // update the matrix
-    set(_rows, _columns, values); 
-  }
+    set_minor(col, v);
   else
   {
     assert(_stype == eCSC);
@@ -330,7 +325,7 @@ void SPARSEMATRIXN::set_column(unsigned col, const VECTORN& v)
     
       // update ptr
       unsigned* ptr = _ptr.get();
-      std::transform(ptr+col+1, ptr+_nnz+1, ptr+col+1, _1 + nextra);
+      std::transform(ptr+col+1, ptr+_columns+1, ptr+col+1, _1 + nextra);
 
       // update the number of nonzero entries
       _nnz += nextra;
@@ -348,7 +343,7 @@ void SPARSEMATRIXN::set_column(unsigned col, const VECTORN& v)
     
       // update ptr
       unsigned* ptr = _ptr.get();
-      std::transform(ptr+col+1, ptr+_nnz+1, ptr+col+1, _1 - nfewer);
+      std::transform(ptr+col+1, ptr+_columns+1, ptr+col+1, _1 - nfewer);
 
       // update the number of nonzero entries
       _nnz -= nfewer;
@@ -399,7 +394,7 @@ void SPARSEMATRIXN::set_row(unsigned row, const VECTORN& v)
     
       // update ptr
       unsigned* ptr = _ptr.get();
-      std::transform(ptr+row+1, ptr+_nnz+1, ptr+row+1, _1 + nextra);
+      std::transform(ptr+row+1, ptr+_rows+1, ptr+row+1, _1 + nextra);
 
       // update the number of nonzero entries
       _nnz += nextra;
@@ -417,7 +412,7 @@ void SPARSEMATRIXN::set_row(unsigned row, const VECTORN& v)
     
       // update ptr
       unsigned* ptr = _ptr.get();
-      std::transform(ptr+row+1, ptr+_nnz+1, ptr+row+1, _1 - nfewer);
+      std::transform(ptr+row+1, ptr+_rows+1, ptr+row+1, _1 - nfewer);
 
       // update the number of nonzero entries
       _nnz -= nfewer;
@@ -435,107 +430,184 @@ void SPARSEMATRIXN::set_row(unsigned row, const VECTORN& v)
   else
   {
     assert(_stype == eCSC);
-
-    // get the values
-    map<pair<unsigned, unsigned>, REAL> values; 
-    get_values(values);
-
-    // remove all values from row 
-    for (unsigned i=0; i< _columns; i++)
-      values.erase(make_pair(row, i));
-
-    // update the map
-    for (unsigned i=0; i< v.size(); i++)
-      if (v[i] > EPS || v[i] < -EPS)
-        values[make_pair(row, i)] = v[i];
-
-    // update the matrix
-    set(_rows, _columns, values); 
+    set_minor(row, v);
   }
 }
 
 /// Sets up a sparse matrix from a map 
 void SPARSEMATRIXN::set(unsigned m, unsigned n, const map<pair<unsigned, unsigned>, REAL>& values)
 {
-  const unsigned nv = values.size();
+  Triplets triplets;
+  triplets.reserve(values.size());
+  for (map<pair<unsigned, unsigned>, REAL>::const_iterator i = values.begin(); i != values.end(); i++)
+    triplets.add(i->first.first, i->first.second, i->second);
+  set_from_triplets(m, n, triplets);
+}
+
+/// Sets up a sparse matrix from (row, column, value) triplets, summing duplicates
+/**
+ * The triplets are sorted into compressed (CSR or CSC, depending on the
+ * storage type of this) form using two stable counting sorts- first by
+ * minor index, then by major index- so that indices within each row
+ * (column) are sorted; duplicates are then summed in a single pass. This
+ * takes O(nnz + m + n) time. Existing storage is reused if its capacity is
+ * sufficient.
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::set_from_triplets(unsigned m, unsigned n, const Triplets& triplets)
+{
+  #ifdef REENTRANT
+  FastThreadable<vector<unsigned> > perm, count;
+  #else
+  static FastThreadable<vector<unsigned> > perm, count;
+  #endif
+
+  const unsigned NT = triplets.size();
+  const bool CSR = (_stype == eCSR);
+  const unsigned NMAJOR = (CSR) ? m : n, NMINOR = (CSR) ? n : m;
+  const vector<unsigned>& major = (CSR) ? triplets.rows : triplets.columns;
+  const vector<unsigned>& minor = (CSR) ? triplets.columns : triplets.rows;
 
-  // setup rows and columns
+  #ifndef NEXCEPT
+  if (triplets.columns.size() != NT || triplets.values.size() != NT)
+    throw MissizeException();
+  for (unsigned k=0; k< NT; k++)
+    if (triplets.rows[k] >= m || triplets.columns[k] >= n)
+      throw InvalidIndexException();
+  #endif
+
+  // setup rows and columns and make sure there is enough storage
   _rows = m;
   _columns = n;
-
-  if (_stype == eCSR)
+  _nnz = 0;
+  if (_nnz_capacity < NT || _ptr_capacity < NMAJOR+1)
+    set_capacities(std::max(NT, _nnz_capacity), std::max(NMAJOR, (_ptr_capacity > 0) ? _ptr_capacity-1 : 0), false);
+  unsigned* ptr = _ptr.get();
+  unsigned* indices = _indices.get();
+  REAL* data = _data.get();
+
+  // counting sort the triplets by minor index
+  vector<unsigned>& cnt = count();
+  vector<unsigned>& p = perm();
+  cnt.assign(std::max(NMAJOR, NMINOR)+1, 0);
+  p.resize(NT);
+  for (unsigned k=0; k< NT; k++)
+    cnt[minor[k]+1]++;
+  std::partial_sum(cnt.begin(), cnt.begin()+NMINOR+1, cnt.begin());
+  for (unsigned k=0; k< NT; k++)
+    p[cnt[minor[k]]++] = k;
+
+  // stable counting sort by major index, scattering into the arrays 
+  std::fill(ptr, ptr+NMAJOR+1, 0);
+  for (unsigned k=0; k< NT; k++)
+    ptr[major[k]+1]++;
+  std::partial_sum(ptr, ptr+NMAJOR+1, ptr);
+  std::copy(ptr, ptr+NMAJOR, cnt.begin());
+  for (unsigned t=0; t< NT; t++)
   {
-    // setup arrays
-    _nnz_capacity = nv;
-    _ptr_capacity = m+1;
-    _data = shared_array<REAL>(new REAL[nv]);
-    _ptr = shared_array<unsigned>(new unsigned[m+1]);
-    _indices = shared_array<unsigned>(new unsigned[nv]);
-
-    // populate the matrix data
-    map<pair<unsigned, unsigned>, REAL>::const_iterator i = values.begin();
-    unsigned j;
-    for (j=0; j< nv; j++, i++)
-      _data[j] = i->second;
+    const unsigned k = p[t];
+    const unsigned slot = cnt[major[k]]++;
+    indices[slot] = minor[k];
+    data[slot] = triplets.values[k];
+  }
 
-    // setup ptr
-    j = 0;
-    unsigned k=0;
-    _ptr[0] = j;
-    for (unsigned r=0; r< m; r++)
+  // sum duplicates (now adjacent) in place
+  unsigned nz = 0;
+  for (unsigned i=0, start=0; i< NMAJOR; i++)
+  {
+    const unsigned end = ptr[i+1];
+    const unsigned row_start = nz;
+    for (unsigned k=start; k< end; k++)
     {
-      for (unsigned s=0; s< n; s++)
-        if (values.find(make_pair(r, s)) != values.end())
-        {
-          j++;
-          _indices[k++] = s;
-        }
-      _ptr[r+1] = j;
+      if (nz > row_start && indices[nz-1] == indices[k])
+        data[nz-1] += data[k];
+      else
+      {
+        indices[nz] = indices[k];
+        data[nz] = data[k];
+        nz++;
+      }
     }
-
-    // set nnz
-    _nnz = nv;
+    ptr[i+1] = nz;
+    start = end;
   }
-  else
-  {
-    assert(_stype == eCSC);
+  _nnz = nz;
 
-    // setup a new values map
-    map<pair<unsigned, unsigned>, REAL> values2;
-    for (map<pair<unsigned, unsigned>, REAL>::const_iterator i = values.begin(); i != values.end(); i++)
-      values2[make_pair(i->first.second, i->first.first)] = i->second;
+  return *this;
+}
 
-    // setup arrays
-    _nnz_capacity = nv;
-    _ptr_capacity = n+1;
-    _data = shared_array<REAL>(new REAL[nv]);
-    _ptr = shared_array<unsigned>(new unsigned[n+1]);
-    _indices = shared_array<unsigned>(new unsigned[nv]);
+/// Gets the (row, column, value) triplets of the nonzeros of this matrix
+void SPARSEMATRIXN::get_triplets(Triplets& triplets) const
+{
+  triplets.rows.resize(_nnz);
+  triplets.columns.resize(_nnz);
+  triplets.values.assign(_data.get(), _data.get()+_nnz);
+  vector<unsigned>& major = (_stype == eCSR) ? triplets.rows : triplets.columns;
+  vector<unsigned>& minor = (_stype == eCSR) ? triplets.columns : triplets.rows;
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
+  for (unsigned i=0; i< NMAJOR; i++)
+    std::fill(major.begin()+_ptr[i], major.begin()+_ptr[i+1], i);
+  std::copy(_indices.get(), _indices.get()+_nnz, minor.begin());
+}
 
-    // populate the matrix data
-    map<pair<unsigned, unsigned>, REAL>::const_iterator i = values2.begin();
-    unsigned j;
-    for (j=0; j< nv; j++, i++)
-      _data[j] = i->second;
+/// Sets a column (if CSR) or row (if CSC) of the matrix in a single pass over the nonzeros
+void SPARSEMATRIXN::set_minor(unsigned idx, const VECTORN& v)
+{
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
 
-    // setup ptr
-    j = 0;
-    unsigned k=0;
-    _ptr[0] = j;
-    for (unsigned col=0; col< n; col++)
+  #ifndef NEXCEPT
+  if (idx >= ((_stype == eCSR) ? _columns : _rows))
+    throw InvalidIndexException();
+  if (v.size() != NMAJOR)
+    throw MissizeException();
+  #endif
+
+  // determine the new number of nonzeros
+  unsigned nnz = _nnz;
+  for (unsigned i=0; i< NMAJOR; i++)
+  {
+    const unsigned* begin = _indices.get() + _ptr[i];
+    const unsigned* end = _indices.get() + _ptr[i+1];
+    if (std::binary_search(begin, end, idx))
+      nnz--;
+    if (v[i] > EPS || v[i] < -EPS)
+      nnz++;
+  }
+
+  // setup new arrays
+  shared_array<REAL> data(new REAL[nnz]);
+  shared_array<unsigned> ptr(new unsigned[NMAJOR+1]);
+  shared_array<unsigned> indices(new unsigned[nnz]);
+
+  // copy each row (column), replacing the entry at idx
+  ptr[0] = 0;
+  for (unsigned i=0, nz=0; i< NMAJOR; i++)
+  {
+    for (unsigned k=_ptr[i]; k< _ptr[i+1] && _indices[k] < idx; k++, nz++)
     {
-      for (unsigned row=0; row< m; row++)
-        if (values.find(make_pair(row, col)) != values.end())
-        {
-          j++;
-          _indices[k++] = row;
-        }
-      _ptr[col+1] = j;
+      indices[nz] = _indices[k];
+      data[nz] = _data[k];
     }
-
-    // set nnz
-    _nnz = nv;
+    if (v[i] > EPS || v[i] < -EPS)
+    {
+      indices[nz] = idx;
+      data[nz++] = v[i];
+    }
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+      if (_indices[k] > idx)
+      {
+        indices[nz] = _indices[k];
+        data[nz++] = _data[k];
+      }
+    ptr[i+1] = nz;
   }
+
+  // store the new arrays
+  _data = data;
+  _ptr = ptr;
+  _indices = indices;
+  _nnz = nnz;
+  _nnz_capacity = nnz;
+  _ptr_capacity = NMAJOR+1;
 }
 
 /// Gets a column of the sparse matrix as a sparse vector
@@ -961,13 +1033,9 @@ VECTORN& SPARSEMATRIXN::mult(const VECTORN& x, VECTORN& result) const
   {
     for (unsigned row=0; row < _rows; row++)
     {
-      REAL dot = (REAL) 0.0;
       unsigned row_start = _ptr[row];
       unsigned row_end = _ptr[row+1];
-      for (unsigned jj= row_start; jj< row_end; jj++)
-        dot += _data[jj] * xdata[_indices[jj]];
-
-      rdata[row] += dot;
+      rdata[row] += SparseKernels::doti(row_end - row_start, _data.get()+row_start, _indices.get()+row_start, xdata);
     }
   }
   else
@@ -982,6 +1050,47 @@ VECTORN& SPARSEMATRIXN::mult(const VECTORN& x, VECTORN& result) const
   return result;
 }
 
+/// Computes the dot products of a dense vector with several rows of this matrix
+/**
+ * \param rows the indices of the rows
+ * \param x the dense vector
+ * \param result on return, result[k] is the dot product of row rows[k]
+ *        and x
+ * \note this is efficient for CSR matrices only; for CSC matrices, the
+ *       full product is formed
+ */
+VECTORN& SPARSEMATRIXN::dot_rows(const vector<unsigned>& rows, const VECTORN& x, VECTORN& result) const
+{
+  #ifndef NEXCEPT
+  if (_columns != x.size())
+    throw MissizeException();
+  for (unsigned k=0; k< rows.size(); k++)
+    if (rows[k] >= _rows)
+      throw InvalidIndexException();
+  #endif
+
+  result.resize(rows.size());
+  REAL* rdata = result.data();
+  if (_stype == eCSR)
+  {
+    const REAL* xdata = x.data();
+    for (unsigned k=0; k< rows.size(); k++)
+    {
+      const unsigned start = _ptr[rows[k]];
+      rdata[k] = SparseKernels::doti(_ptr[rows[k]+1] - start, _data.get()+start, _indices.get()+start, xdata);
+    }
+  }
+  else
+  {
+    VECTORN y;
+    mult(x, y);
+    for (unsigned k=0; k< rows.size(); k++)
+      rdata[k] = y[rows[k]];
+  }
+
+  return result;
+}
+
 /// Multiplies the transpose of this sparse matrix by a dense vector
 VECTORN& SPARSEMATRIXN::transpose_mult(const VECTORN& x, VECTORN& result) const
 {
@@ -1148,46 +1257,661 @@ MATRIXN& SPARSEMATRIXN::to_dense(MATRIXN& m) const
   return m;
 }
 
-/// Subtracts a sparse matrix from this one -- attempts to do it in place
-SPARSEMATRIXN& SPARSEMATRIXN::operator-=(const SPARSEMATRIXN& m)
+/// Computes the storage arrays of the transpose of this matrix (with the same storage type) using a counting sort
+/**
+ * Equivalently, computes the arrays of this matrix in the other storage
+ * format; minor indices in the result are sorted.
+ */
+void SPARSEMATRIXN::transpose_storage(SPARSEMATRIXN& result) const
+{
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
+  const unsigned NMINOR = (_stype == eCSR) ? _columns : _rows;
+
+  // make sure there is enough storage
+  if (result._nnz_capacity < _nnz || result._ptr_capacity < NMINOR+1)
+    result.set_capacities(std::max(_nnz, result._nnz_capacity), NMINOR, false);
+  unsigned* ptr = result._ptr.get();
+  unsigned* indices = result._indices.get();
+  REAL* data = result._data.get();
+
+  // count the entries in each minor index
+  std::fill(ptr, ptr+NMINOR+1, 0);
+  for (unsigned k=0; k< _nnz; k++)
+    ptr[_indices[k]+1]++;
+  std::partial_sum(ptr, ptr+NMINOR+1, ptr);
+
+  // scatter (use ptr as the insertion point, then shift it back)
+  for (unsigned i=0; i< NMAJOR; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const unsigned slot = ptr[_indices[k]]++;
+      indices[slot] = i;
+      data[slot] = _data[k];
+    }
+  for (unsigned j=NMINOR; j> 0; j--)
+    ptr[j] = ptr[j-1];
+  ptr[0] = 0;
+
+  result._nnz = _nnz;
+}
+
+/// Computes the transpose of this matrix (using the same storage type)
+SPARSEMATRIXN& SPARSEMATRIXN::transpose(SPARSEMATRIXN& result) const
+{
+  if (&result == this)
+  {
+    SPARSEMATRIXN tmp;
+    transpose(tmp);
+    return result = tmp;
+  }
+
+  transpose_storage(result);
+  result._stype = _stype;
+  result._rows = _columns;
+  result._columns = _rows;
+  return result;
+}
+
+/// Converts this matrix to the given storage type (CSR <-> CSC)
+SPARSEMATRIXN& SPARSEMATRIXN::convert(StorageType stype, SPARSEMATRIXN& result) const
+{
+  if (stype == _stype)
+    return (&result == this) ? result : (result = *this);
+  if (&result == this)
+  {
+    SPARSEMATRIXN tmp;
+    convert(stype, tmp);
+    return result = tmp;
+  }
+
+  transpose_storage(result);
+  result._stype = stype;
+  result._rows = _rows;
+  result._columns = _columns;
+  return result;
+}
+
+/// Gets this matrix in the given storage type, converting it into work if necessary
+const SPARSEMATRIXN& SPARSEMATRIXN::get_storage(StorageType stype, SPARSEMATRIXN& work) const
+{
+  if (stype == _stype)
+    return *this;
+  return convert(stype, work);
+}
+
+/// Computes the nonzero pattern of the CSR matrix C = L*R
+/**
+ * \param L a matrix whose arrays are the CSR arrays of the m-row left operand
+ * \param R a matrix whose arrays are the CSR arrays of the n-column right
+ *        operand
+ */
+void SPARSEMATRIXN::product_symbolic(const SPARSEMATRIXN& L, const SPARSEMATRIXN& R, unsigned m, unsigned n, SPARSEMATRIXN& C)
+{
+  // compute the row pointers
+  C._stype = eCSR;
+  C._rows = m;
+  C._columns = n;
+  if (C._ptr_capacity < m+1)
+    C.set_capacities(C._nnz_capacity, m, false);
+  if (m == 0)
+  {
+    C._ptr[0] = 0;
+    C._nnz = 0;
+    return;
+  }
+  SparseKernels::gemm_symbolic_count(m, n, L._ptr.get(), L._indices.get(), R._ptr.get(), R._indices.get(), C._ptr.get());
+
+  // compute the column indices
+  const unsigned NNZ = C._ptr[m];
+  if (C._nnz_capacity < NNZ)
+  {
+    C._nnz_capacity = NNZ;
+    C._data = shared_array<REAL>(new REAL[NNZ]);
+    C._indices = shared_array<unsigned>(new unsigned[NNZ]);
+  }
+  SparseKernels::gemm_symbolic_fill(m, n, L._ptr.get(), L._indices.get(), R._ptr.get(), R._indices.get(), C._ptr.get(), C._indices.get());
+  C._nnz = NNZ;
+  std::fill(C._data.get(), C._data.get()+NNZ, (REAL) 0.0);
+
+  // allocate the scratch for the numeric phase
+  C._product_pos.resize(SparseKernels::gemm_numeric_workspace(n));
+}
+
+/// Computes the values of the CSR matrix C = L diag(d) R for the pattern computed by product_symbolic()
+void SPARSEMATRIXN::product_numeric(const SPARSEMATRIXN& L, const REAL* d, const SPARSEMATRIXN& R, unsigned m, unsigned n, SPARSEMATRIXN& C)
 {
-  // check rows/columns match up
   #ifndef NEXCEPT
-  if (_rows != m._rows || _columns != m._columns)
+  if (C._stype != eCSR || C._rows != m || C._columns != n)
     throw MissizeException();
   #endif
 
-  typedef std::map<std::pair<unsigned, unsigned>, REAL> ValueMap; 
-  ValueMap v1, v2;
-  get_values(v1);
-  m.get_values(v2);
-  for (ValueMap::iterator i = v1.begin(); i != v1.end(); i++)
+  if (m == 0 || n == 0)
+    return;
+
+  // the scratch is allocated by product_symbolic(), but not by assignment
+  if (C._product_pos.size() < n)
+    C._product_pos.resize(SparseKernels::gemm_numeric_workspace(n));
+  SparseKernels::gemm_numeric(m, n, L._ptr.get(), L._indices.get(), L._data.get(), d, R._ptr.get(), R._indices.get(), R._data.get(), C._ptr.get(), C._indices.get(), &C._product_pos.front(), C._product_pos.size(), C._data.get());
+}
+
+/// Computes the sparse product C = A*B (C is stored in CSR format)
+/**
+ * This performs mult_symbolic() followed by mult_numeric(). When the
+ * product is needed repeatedly for matrices with unchanging nonzero
+ * patterns, call mult_symbolic() once and mult_numeric() thereafter.
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::mult(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C)
+{
+  if (&C == &A || &C == &B)
   {
-    ValueMap::iterator j = v2.find(i->first);
-    if (j == v2.end())
-      continue;
-    else
-      i->second -= j->second;
+    SPARSEMATRIXN tmp;
+    mult(A, B, tmp);
+    return C = tmp;
   }
 
-  // still must iterate through v2 in case keys in v2 aren't in v1 
-  for (ValueMap::iterator i = v2.begin(); i != v2.end(); i++)
+  mult_symbolic(A, B, C);
+  return mult_numeric(A, B, C);
+}
+
+/// Computes the nonzero pattern of C = A*B (C is stored in CSR format and its values are zeroed)
+SPARSEMATRIXN& SPARSEMATRIXN::mult_symbolic(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> workA, workB;
+  #else
+  static FastThreadable<SPARSEMATRIXN> workA, workB;
+  #endif
+
+  #ifndef NEXCEPT
+  if (A._columns != B._rows)
+    throw MissizeException();
+  #endif
+
+  const SPARSEMATRIXN& L = A.get_storage(eCSR, workA());
+  const SPARSEMATRIXN& R = B.get_storage(eCSR, workB());
+  product_symbolic(L, R, A._rows, B._columns, C);
+  return C;
+}
+
+/// Computes the values of C = A*B, where the pattern of C was determined by mult_symbolic()
+SPARSEMATRIXN& SPARSEMATRIXN::mult_numeric(const SPARSEMATRIXN& A, const SPARSEMATRIXN& B, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> workA, workB;
+  #else
+  static FastThreadable<SPARSEMATRIXN> workA, workB;
+  #endif
+
+  #ifndef NEXCEPT
+  if (A._columns != B._rows)
+    throw MissizeException();
+  #endif
+
+  const SPARSEMATRIXN& L = A.get_storage(eCSR, workA());
+  const SPARSEMATRIXN& R = B.get_storage(eCSR, workB());
+  product_numeric(L, NULL, R, A._rows, B._columns, C);
+  return C;
+}
+
+/// Computes the sparse product C = A'*A (C is stored in CSR format)
+SPARSEMATRIXN& SPARSEMATRIXN::transpose_mult_self(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  if (&C == &A)
   {
-    ValueMap::iterator j = v1.find(i->first);
-    if (j != v1.end())
-      continue;
-    else
-      v1[i->first] = -i->second;
+    SPARSEMATRIXN tmp;
+    transpose_mult_self(A, tmp);
+    return C = tmp;
   }
 
-  // reset the values
-  set(_rows, _columns, v1);
+  transpose_mult_self_symbolic(A, C);
+  return transpose_mult_self_numeric(A, C);
+}
 
-  return *this;
+/// Computes the nonzero pattern of C = A'*A (C is stored in CSR format and its values are zeroed)
+SPARSEMATRIXN& SPARSEMATRIXN::transpose_mult_self_symbolic(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> work;
+  #else
+  static FastThreadable<SPARSEMATRIXN> work;
+  #endif
+
+  // the CSC arrays of A are the CSR arrays of A'
+  const SPARSEMATRIXN& L = A.get_storage(eCSC, work());
+  const SPARSEMATRIXN& R = (A._stype == eCSR) ? A : A.get_storage(eCSR, work());
+  product_symbolic(L, R, A._columns, A._columns, C);
+  return C;
+}
+
+/// Computes the values of C = A'*A, where the pattern of C was determined by transpose_mult_self_symbolic()
+SPARSEMATRIXN& SPARSEMATRIXN::transpose_mult_self_numeric(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> work;
+  #else
+  static FastThreadable<SPARSEMATRIXN> work;
+  #endif
+
+  const SPARSEMATRIXN& L = A.get_storage(eCSC, work());
+  const SPARSEMATRIXN& R = (A._stype == eCSR) ? A : A.get_storage(eCSR, work());
+  product_numeric(L, NULL, R, A._columns, A._columns, C);
+  return C;
+}
+
+/// Computes the sparse product C = A*A' (C is stored in CSR format)
+SPARSEMATRIXN& SPARSEMATRIXN::mult_transpose_self(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  if (&C == &A)
+  {
+    SPARSEMATRIXN tmp;
+    mult_transpose_self(A, tmp);
+    return C = tmp;
+  }
+
+  mult_transpose_self_symbolic(A, C);
+  return mult_transpose_self_numeric(A, C);
+}
+
+/// Computes the nonzero pattern of C = A*A' (or of C = A*diag(d)*A'); C is stored in CSR format and its values are zeroed
+SPARSEMATRIXN& SPARSEMATRIXN::mult_transpose_self_symbolic(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> work;
+  #else
+  static FastThreadable<SPARSEMATRIXN> work;
+  #endif
+
+  // the CSC arrays of A are the CSR arrays of A'
+  const SPARSEMATRIXN& L = (A._stype == eCSR) ? A : A.get_storage(eCSR, work());
+  const SPARSEMATRIXN& R = (A._stype == eCSC) ? A : A.get_storage(eCSC, work());
+  product_symbolic(L, R, A._rows, A._rows, C);
+  return C;
+}
+
+/// Computes the values of C = A*A', where the pattern of C was determined by mult_transpose_self_symbolic()
+SPARSEMATRIXN& SPARSEMATRIXN::mult_transpose_self_numeric(const SPARSEMATRIXN& A, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> work;
+  #else
+  static FastThreadable<SPARSEMATRIXN> work;
+  #endif
+
+  const SPARSEMATRIXN& L = (A._stype == eCSR) ? A : A.get_storage(eCSR, work());
+  const SPARSEMATRIXN& R = (A._stype == eCSC) ? A : A.get_storage(eCSC, work());
+  product_numeric(L, NULL, R, A._rows, A._rows, C);
+  return C;
+}
+
+/// Computes the sparse product C = A*diag(d)*A' (C is stored in CSR format)
+/**
+ * The pattern of C is determined by mult_transpose_self_symbolic(); the
+ * values may then be recomputed with mult_diag_transpose_numeric().
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::mult_diag_transpose(const SPARSEMATRIXN& A, const VECTORN& d, SPARSEMATRIXN& C)
+{
+  if (&C == &A)
+  {
+    SPARSEMATRIXN tmp;
+    mult_diag_transpose(A, d, tmp);
+    return C = tmp;
+  }
+
+  mult_transpose_self_symbolic(A, C);
+  return mult_diag_transpose_numeric(A, d, C);
+}
+
+/// Computes the values of C = A*diag(d)*A', where the pattern of C was determined by mult_transpose_self_symbolic()
+SPARSEMATRIXN& SPARSEMATRIXN::mult_diag_transpose_numeric(const SPARSEMATRIXN& A, const VECTORN& d, SPARSEMATRIXN& C)
+{
+  #ifdef REENTRANT
+  FastThreadable<SPARSEMATRIXN> work;
+  #else
+  static FastThreadable<SPARSEMATRIXN> work;
+  #endif
+
+  #ifndef NEXCEPT
+  if (d.size() != A._columns)
+    throw MissizeException();
+  #endif
+
+  const SPARSEMATRIXN& L = (A._stype == eCSR) ? A : A.get_storage(eCSR, work());
+  const SPARSEMATRIXN& R = (A._stype == eCSC) ? A : A.get_storage(eCSC, work());
+  product_numeric(L, d.data(), R, A._rows, A._rows, C);
+  return C;
+}
+
+/// Gets the adjacency structure of the graph of this + this' (without self-loops)
+void SPARSEMATRIXN::get_symmetric_graph(vector<unsigned>& xadj, vector<unsigned>& adj) const
+{
+  #ifndef NEXCEPT
+  if (_rows != _columns)
+    throw NonsquareMatrixException();
+  #endif
+
+  if (_rows == 0)
+  {
+    xadj.assign(1, 0);
+    adj.clear();
+    return;
+  }
+  SparseOrdering::symmetric_graph(_rows, _ptr.get(), _indices.get(), xadj, adj);
+}
+
+/// Computes an approximate minimum degree (fill-reducing) ordering of this (square) matrix
+/**
+ * The ordering is computed from the pattern of this + this'.
+ * \param perm on return, perm[i] is the row (and column) of this that 
+ *        becomes row (and column) i of the permuted matrix (see
+ *        permute_symmetric())
+ */
+void SPARSEMATRIXN::calc_amd_ordering(vector<unsigned>& perm) const
+{
+  vector<unsigned> xadj, adj;
+  get_symmetric_graph(xadj, adj);
+  SparseOrdering::amd(_rows, xadj, adj, perm);
+}
+
+/// Computes a reverse Cuthill-McKee (bandwidth-reducing) ordering of this (square) matrix
+/**
+ * The ordering is computed from the pattern of this + this'.
+ * \param perm on return, perm[i] is the row (and column) of this that 
+ *        becomes row (and column) i of the permuted matrix (see
+ *        permute_symmetric())
+ */
+void SPARSEMATRIXN::calc_rcm_ordering(vector<unsigned>& perm) const
+{
+  vector<unsigned> xadj, adj;
+  get_symmetric_graph(xadj, adj);
+  SparseOrdering::rcm(_rows, xadj, adj, perm);
+}
+
+/// Computes a nested dissection (fill-reducing) ordering of this (square) matrix
+/**
+ * The ordering is computed from the pattern of this + this'.
+ * \param perm on return, perm[i] is the row (and column) of this that 
+ *        becomes row (and column) i of the permuted matrix (see
+ *        permute_symmetric())
+ */
+void SPARSEMATRIXN::calc_nested_dissection_ordering(vector<unsigned>& perm) const
+{
+  vector<unsigned> xadj, adj;
+  get_symmetric_graph(xadj, adj);
+  SparseOrdering::nested_dissection(_rows, xadj, adj, perm);
+}
+
+/// Computes the inverse of a permutation
+std::vector<unsigned>& SPARSEMATRIXN::invert_permutation(const vector<unsigned>& perm, vector<unsigned>& iperm)
+{
+  iperm.resize(perm.size());
+  for (unsigned i=0; i< perm.size(); i++)
+    iperm[perm[i]] = i;
+  return iperm;
+}
+
+/// Permutes the rows and columns of this matrix 
+/**
+ * The result (which has the storage type of this) is 
+ * result(i,j) = this(row_perm[i], col_perm[j]). Permutations returned by
+ * calc_amd_ordering(), etc. can be reused as long as the nonzero pattern
+ * of this does not change.
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::permute(const vector<unsigned>& row_perm, const vector<unsigned>& col_perm, SPARSEMATRIXN& result) const
+{
+  #ifndef NEXCEPT
+  if (row_perm.size() != _rows || col_perm.size() != _columns)
+    throw MissizeException();
+  #endif
+
+  // permuting in place is not possible
+  if (&result == this)
+  {
+    SPARSEMATRIXN tmp(_stype);
+    permute(row_perm, col_perm, tmp);
+    return result = tmp;
+  }
+
+  const bool CSR = (_stype == eCSR);
+  const unsigned NMAJOR = (CSR) ? _rows : _columns;
+  const vector<unsigned>& major_perm = (CSR) ? row_perm : col_perm;
+  vector<unsigned> iminor;
+  invert_permutation((CSR) ? col_perm : row_perm, iminor);
+
+  // setup the result
+  result._stype = _stype;
+  result._rows = _rows;
+  result._columns = _columns;
+  if (result._nnz_capacity < _nnz || result._ptr_capacity < NMAJOR+1)
+    result.set_capacities(_nnz, NMAJOR, false);
+  unsigned* ptr = result._ptr.get();
+  unsigned* indices = result._indices.get();
+  REAL* data = result._data.get();
+
+  // copy the rows (columns), remapping and sorting the indices
+  vector<pair<unsigned, REAL> > entries;
+  ptr[0] = 0;
+  for (unsigned i=0; i< NMAJOR; i++)
+  {
+    const unsigned old = major_perm[i];
+    entries.clear();
+    for (unsigned k=_ptr[old]; k< _ptr[old+1]; k++)
+      entries.push_back(make_pair(iminor[_indices[k]], _data[k]));
+    std::sort(entries.begin(), entries.end());
+    for (unsigned k=0; k< entries.size(); k++)
+    {
+      indices[ptr[i]+k] = entries[k].first;
+      data[ptr[i]+k] = entries[k].second;
+    }
+    ptr[i+1] = ptr[i] + entries.size();
+  }
+  result._nnz = _nnz;
+
+  return result;
+}
+
+/// Symmetrically permutes this (square) matrix, i.e., result(i,j) = this(perm[i], perm[j])
+SPARSEMATRIXN& SPARSEMATRIXN::permute_symmetric(const vector<unsigned>& perm, SPARSEMATRIXN& result) const
+{
+  #ifndef NEXCEPT
+  if (_rows != _columns)
+    throw NonsquareMatrixException();
+  #endif
+
+  return permute(perm, perm, result);
+}
+
+/// Subtracts a sparse matrix from this one -- attempts to do it in place
+SPARSEMATRIXN& SPARSEMATRIXN::operator-=(const SPARSEMATRIXN& m)
+{
+  return axpy((REAL) -1.0, m);
 }
 
 /// Adds a sparse matrix to this one -- attempts to do it in place
 SPARSEMATRIXN& SPARSEMATRIXN::operator+=(const SPARSEMATRIXN& m)
+{
+  return axpy((REAL) 1.0, m);
+}
+
+/// Determines whether this matrix has the same size, storage type, and nonzero pattern as another
+bool SPARSEMATRIXN::same_pattern(const SPARSEMATRIXN& m) const
+{
+  if (_rows != m._rows || _columns != m._columns || _stype != m._stype || _nnz != m._nnz)
+    return false;
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
+  if (_nnz == 0 && NMAJOR == 0)
+    return true;
+  if (_ptr.get() == m._ptr.get() && _indices.get() == m._indices.get())
+    return true;
+  return std::equal(_ptr.get(), _ptr.get()+NMAJOR+1, m._ptr.get()) &&
+         std::equal(_indices.get(), _indices.get()+_nnz, m._indices.get());
+}
+
+/// Builds the position map, which maps (row, column) pairs to locations in the nonzero data
+/**
+ * The position map is an open-addressing hash table with (at least) twice
+ * as many entries as nonzeros. It is used by the pattern-preserving update
+ * functions (find_slot(), add_to(), set_values(), get_slots(), and refill())
+ * and is built automatically when first needed. Lookups are always checked
+ * against the current nonzero pattern, so the map is rebuilt transparently
+ * if the pattern changes; calling this function explicitly only moves the
+ * construction cost out of the first update.
+ */
+void SPARSEMATRIXN::build_position_map()
+{
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
+  const boost::uint64_t NMINOR = (_stype == eCSR) ? _columns : _rows;
+
+  // size the table as a power of two
+  unsigned bits = 1;
+  while ((1u << bits) < 2*_nnz)
+    bits++;
+  const unsigned SZ = 1u << bits, MASK = SZ-1;
+  _pos_shift = 64 - bits;
+  _pos_keys.resize(SZ);
+  _pos_slots.assign(SZ, std::numeric_limits<unsigned>::max());
+
+  // insert the nonzeros using linear probing
+  for (unsigned i=0; i< NMAJOR; i++)
+    for (unsigned k=_ptr[i]; k< _ptr[i+1]; k++)
+    {
+      const boost::uint64_t key = i*NMINOR + _indices[k];
+      unsigned h = (unsigned) ((key*0x9E3779B97F4A7C15ULL) >> _pos_shift);
+      while (_pos_slots[h] != std::numeric_limits<unsigned>::max())
+        h = (h+1) & MASK;
+      _pos_keys[h] = key;
+      _pos_slots[h] = k;
+    }
+}
+
+/// Looks up a nonzero in the position map, returning the maximum unsigned value if it is not found
+unsigned SPARSEMATRIXN::lookup_position(unsigned major, unsigned minor) const
+{
+  if (_pos_slots.empty())
+    return std::numeric_limits<unsigned>::max();
+
+  const boost::uint64_t NMINOR = (_stype == eCSR) ? _columns : _rows;
+  const boost::uint64_t key = major*NMINOR + minor;
+  const unsigned MASK = _pos_slots.size()-1;
+  unsigned h = (unsigned) ((key*0x9E3779B97F4A7C15ULL) >> _pos_shift);
+  while (_pos_slots[h] != std::numeric_limits<unsigned>::max())
+  {
+    if (_pos_keys[h] == key)
+      return _pos_slots[h];
+    h = (h+1) & MASK;
+  }
+
+  return std::numeric_limits<unsigned>::max();
+}
+
+/// Gets the location of element (i,j) in the nonzero data (i.e., get_data())
+/**
+ * \note throws InvalidIndexException if (i,j) is not in the nonzero pattern
+ */
+unsigned SPARSEMATRIXN::find_slot(unsigned i, unsigned j)
+{
+  #ifndef NEXCEPT
+  if (i >= _rows || j >= _columns)
+    throw InvalidIndexException();
+  #endif
+
+  const unsigned major = (_stype == eCSR) ? i : j;
+  const unsigned minor = (_stype == eCSR) ? j : i;
+
+  // build the map if necessary and check the slot against the pattern 
+  if (_pos_slots.empty())
+    build_position_map();
+  const unsigned slot = lookup_position(major, minor);
+  if (slot >= _ptr[major] && slot < _ptr[major+1] && _indices[slot] == minor)
+    return slot;
+
+  // the element is either not in the pattern or the map is stale
+  const unsigned* begin = _indices.get() + _ptr[major];
+  const unsigned* end = _indices.get() + _ptr[major+1];
+  const unsigned* k = std::lower_bound(begin, end, minor);
+  if (k == end || *k != minor)
+    throw InvalidIndexException();
+  build_position_map();
+  return k - _indices.get();
+}
+
+/// Adds v to element (i,j), which must be in the nonzero pattern
+void SPARSEMATRIXN::add_to(unsigned i, unsigned j, REAL v)
+{
+  _data[find_slot(i, j)] += v;
+}
+
+/// Sets n elements of a row of the matrix without changing the nonzero pattern
+/**
+ * \param row the row to set
+ * \param n the number of elements to set
+ * \param col_indices the column indices of the elements (each must be in the
+ *        nonzero pattern)
+ * \param values the values of the elements
+ * \note elements of the row that are not listed are left unchanged
+ */
+void SPARSEMATRIXN::set_values(unsigned row, unsigned n, const unsigned* col_indices, const REAL* values)
+{
+  for (unsigned k=0; k< n; k++)
+    _data[find_slot(row, col_indices[k])] = values[k];
+}
+
+/// Computes the locations of the triplets in the nonzero data, for use with refill()
+/**
+ * Every triplet must be in the nonzero pattern (as it is if this matrix was
+ * built from triplets with the same rows and columns).
+ */
+void SPARSEMATRIXN::get_slots(const Triplets& triplets, vector<unsigned>& slots)
+{
+  const unsigned NT = triplets.size();
+  slots.resize(NT);
+  for (unsigned k=0; k< NT; k++)
+    slots[k] = find_slot(triplets.rows[k], triplets.columns[k]);
+}
+
+/// Refills the nonzero values from triplets (summing duplicates) without changing the nonzero pattern
+/**
+ * Every triplet must be in the nonzero pattern; nonzeros not referenced by
+ * any triplet are set to zero.
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::refill(const Triplets& triplets)
+{
+  std::fill(_data.get(), _data.get()+_nnz, (REAL) 0.0);
+  for (unsigned k=0; k< triplets.size(); k++)
+    _data[find_slot(triplets.rows[k], triplets.columns[k])] += triplets.values[k];
+
+  return *this;
+}
+
+/// Refills the nonzero values (summing duplicates) using slots precomputed by get_slots()
+/**
+ * This performs no lookups at all: values[k] is added to the nonzero at
+ * slots[k] after all nonzeros are set to zero. 
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::refill(const vector<unsigned>& slots, const vector<REAL>& values)
+{
+  #ifndef NEXCEPT
+  if (slots.size() != values.size())
+    throw MissizeException();
+  for (unsigned k=0; k< slots.size(); k++)
+    if (slots[k] >= _nnz)
+      throw InvalidIndexException();
+  #endif
+
+  REAL* data = _data.get();
+  std::fill(data, data+_nnz, (REAL) 0.0);
+  for (unsigned k=0; k< slots.size(); k++)
+    data[slots[k]] += values[k];
+
+  return *this;
+}
+
+/// Computes this += alpha*m using a linear merge of the nonzero patterns
+/**
+ * If the patterns match, the nonzero values are updated in place. Otherwise,
+ * the rows (columns) are merged back to front, which also works in place
+ * when the nonzero capacity of this matrix suffices.
+ */
+SPARSEMATRIXN& SPARSEMATRIXN::axpy(REAL alpha, const SPARSEMATRIXN& m)
 {
   // check rows/columns match up
   #ifndef NEXCEPT
@@ -1195,31 +1919,104 @@ SPARSEMATRIXN& SPARSEMATRIXN::operator+=(const SPARSEMATRIXN& m)
     throw MissizeException();
   #endif
 
-  typedef std::map<std::pair<unsigned, unsigned>, REAL> ValueMap; 
-  ValueMap v1, v2;
-  get_values(v1);
-  m.get_values(v2);
-  for (ValueMap::iterator i = v1.begin(); i != v1.end(); i++)
+  // fast exit: patterns match 
+  if (same_pattern(m))
   {
-    ValueMap::iterator j = v2.find(i->first);
-    if (j == v2.end())
-      continue;
-    else
-      i->second += j->second;
+    CBLAS::axpy(_nnz, alpha, m._data.get(), 1, _data.get(), 1);
+    return *this;
   }
 
-  // still must iterate through v2 in case keys in v2 aren't in v1 
-  for (ValueMap::iterator i = v2.begin(); i != v2.end(); i++)
+  // if the storage types differ, convert m 
+  if (m._stype != _stype)
   {
-    ValueMap::iterator j = v1.find(i->first);
-    if (j != v1.end())
-      continue;
-    else
-      v1[i->first] = i->second;
+    Triplets triplets;
+    m.get_triplets(triplets);
+    SPARSEMATRIXN mconv(_stype, _rows, _columns, triplets);
+    return axpy(alpha, mconv);
+  }
+
+  // setup empty storage if necessary
+  const unsigned NMAJOR = (_stype == eCSR) ? _rows : _columns;
+  if (_ptr_capacity < NMAJOR+1)
+  {
+    set_capacities(0, NMAJOR, false);
+    std::fill(_ptr.get(), _ptr.get()+NMAJOR+1, 0);
   }
 
-  // reset the values
-  set(_rows, _columns, v1);
+  // count the nonzeros in the union of the patterns 
+  const unsigned* aptr = _ptr.get();
+  const unsigned* aidx = _indices.get();
+  const unsigned* bptr = m._ptr.get();
+  const unsigned* bidx = m._indices.get();
+  const REAL* bdata = m._data.get();
+  unsigned nnz = 0;
+  for (unsigned i=0; i< NMAJOR; i++)
+  {
+    unsigned ka = aptr[i], kb = bptr[i];
+    while (ka < aptr[i+1] && kb < bptr[i+1])
+    {
+      if (aidx[ka] < bidx[kb])
+        ka++;
+      else if (bidx[kb] < aidx[ka])
+        kb++;
+      else
+      {
+        ka++;
+        kb++;
+      }
+      nnz++;
+    }
+    nnz += (aptr[i+1] - ka) + (bptr[i+1] - kb);
+  }
+
+  // get the destination arrays; merging back to front allows the merge to
+  // be done in place (each row only ever moves toward the end)
+  shared_array<REAL> data = _data;
+  shared_array<unsigned> ptr = _ptr;
+  shared_array<unsigned> indices = _indices;
+  if (_nnz_capacity < nnz)
+  {
+    data = shared_array<REAL>(new REAL[nnz]);
+    ptr = shared_array<unsigned>(new unsigned[NMAJOR+1]);
+    indices = shared_array<unsigned>(new unsigned[nnz]);
+    _nnz_capacity = nnz;
+    _ptr_capacity = NMAJOR+1;
+  }
+
+  // do the merge 
+  unsigned w = nnz;
+  for (unsigned i=NMAJOR; i> 0; i--)
+  {
+    int ka = (int) aptr[i]-1, kb = (int) bptr[i]-1;
+    const int ka_end = (int) aptr[i-1], kb_end = (int) bptr[i-1];
+    ptr[i] = w;
+    while (ka >= ka_end || kb >= kb_end)
+    {
+      w--;
+      if (kb < kb_end || (ka >= ka_end && aidx[ka] > bidx[kb]))
+      {
+        indices[w] = aidx[ka];
+        data[w] = _data[ka--];
+      }
+      else if (ka < ka_end || bidx[kb] > aidx[ka])
+      {
+        indices[w] = bidx[kb];
+        data[w] = alpha*bdata[kb--];
+      }
+      else
+      {
+        indices[w] = aidx[ka];
+        data[w] = _data[ka--] + alpha*bdata[kb--];
+      }
+    }
+  }
+  ptr[0] = 0;
+
+  // store the arrays
+  _data = data;
+  _ptr = ptr;
+  _indices = indices;
+  _nnz = nnz;
 
   return *this;
 }
@@ -5,11 +5,15 @@
  ****************************************************************************/
 
 #include <numeric>
+#include <limits>
 #include <boost/lambda/lambda.hpp>
 #include <Ravelin/FastThreadable.h>
 #include <Ravelin/Constants.h>
 #include <Ravelin/MissizeException.h>
 #include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/NonsquareMatrixException.h>
+#include "sparse_kernels.h"
+#include "sparse_ordering.h"
 #include <Ravelin/SparseMatrixNd.h>
 #include <Ravelin/MatrixNd.h>
 
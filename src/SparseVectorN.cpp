@@ -14,7 +14,7 @@ SPARSEVECTORN::SPARSEVECTORN(const VECTORN& x)
   _nelm = 0;
   shared_array<bool> nz_elms(new bool[x.size()]);
   for (unsigned i=0; i< x.size(); i++)
-    if (std::fabs(x[i]) < EPS)
+    if (std::fabs(x[i]) >= EPS)
     {
       _nelm++;
       nz_elms[i] = true;
@@ -75,19 +75,142 @@ REAL SPARSEVECTORN::square() const
 /// Computes the dot product between a sparse vector and a dense vector
 REAL SPARSEVECTORN::dot(const VECTORN& x) const
 {
-  REAL result = 0;
+  #ifndef NEXCEPT
+  if (x.size() != _size)
+    throw MissizeException();
+  #endif
+
+  return SparseKernels::doti(_nelm, _data.get(), _indices.get(), x.data());
+}
 
+/// Computes the dot product between two sparse vectors
+/**
+ * The sorted index lists are merged in linear time; if one vector has far
+ * fewer nonzeros than the other, its indices are instead searched for in the
+ * other vector.
+ */
+REAL SPARSEVECTORN::dot(const SPARSEVECTORN& x) const
+{
   #ifndef NEXCEPT
   if (x.size() != _size)
     throw MissizeException();
   #endif
 
-  for (unsigned i=0; i< _nelm; i++)
-    result += x[_indices[i]] * _data[i];
+  // make a the vector with fewer nonzeros
+  const SPARSEVECTORN& a = (_nelm <= x._nelm) ? *this : x;
+  const SPARSEVECTORN& b = (_nelm <= x._nelm) ? x : *this;
+  const unsigned* aidx = a._indices.get();
+  const unsigned* bidx = b._indices.get();
+  const REAL* adata = a._data.get();
+  const REAL* bdata = b._data.get();
+  REAL result = (REAL) 0.0;
+
+  // search if a is much sparser than b
+  const unsigned SEARCH_RATIO = 16;
+  if (a._nelm*SEARCH_RATIO < b._nelm)
+  {
+    const unsigned* bstart = bidx;
+    const unsigned* bend = bidx + b._nelm;
+    for (unsigned i=0; i< a._nelm && bstart != bend; i++)
+    {
+      bstart = std::lower_bound(bstart, bend, aidx[i]);
+      if (bstart != bend && *bstart == aidx[i])
+        result += adata[i] * bdata[bstart - bidx];
+    }
+    return result;
+  }
+
+  // merge the two index lists
+  for (unsigned i=0, j=0; i< a._nelm && j< b._nelm; )
+  {
+    if (aidx[i] < bidx[j])
+      i++;
+    else if (bidx[j] < aidx[i])
+      j++;
+    else
+      result += adata[i++] * bdata[j++];
+  }
+
+  return result;
+}
+
+/// Adds a scaled copy of this sparse vector to a dense vector (y += alpha*this)
+VECTORN& SPARSEVECTORN::add_to(REAL alpha, VECTORN& y) const
+{
+  #ifndef NEXCEPT
+  if (y.size() != _size)
+    throw MissizeException();
+  #endif
+
+  SparseKernels::axpyi(_nelm, alpha, _data.get(), _indices.get(), y.data());
+  return y;
+}
+
+/// Computes result = alpha*x + y, where the nonzero pattern of the result is the union of the patterns of x and y
+/**
+ * result may be x or y.
+ */
+SPARSEVECTORN& SPARSEVECTORN::axpy(REAL alpha, const SPARSEVECTORN& x, const SPARSEVECTORN& y, SPARSEVECTORN& result)
+{
+  #ifndef NEXCEPT
+  if (x.size() != y.size())
+    throw MissizeException();
+  #endif
+
+  // determine the number of nonzeros in the union
+  const unsigned* xidx = x._indices.get();
+  const unsigned* yidx = y._indices.get();
+  const REAL* xdata = x._data.get();
+  const REAL* ydata = y._data.get();
+  unsigned nelm = 0;
+  for (unsigned i=0, j=0; i< x._nelm || j< y._nelm; nelm++)
+  {
+    if (j == y._nelm || (i < x._nelm && xidx[i] < yidx[j]))
+      i++;
+    else if (i == x._nelm || yidx[j] < xidx[i])
+      j++;
+    else
+    {
+      i++;
+      j++;
+    }
+  }
 
+  // merge into new arrays (so that result may alias x or y)
+  shared_array<unsigned> indices(new unsigned[nelm]);
+  shared_array<REAL> data(new REAL[nelm]);
+  for (unsigned i=0, j=0, k=0; k< nelm; k++)
+  {
+    if (j == y._nelm || (i < x._nelm && xidx[i] < yidx[j]))
+    {
+      indices[k] = xidx[i];
+      data[k] = alpha*xdata[i++];
+    }
+    else if (i == x._nelm || yidx[j] < xidx[i])
+    {
+      indices[k] = yidx[j];
+      data[k] = ydata[j++];
+    }
+    else
+    {
+      indices[k] = xidx[i];
+      data[k] = alpha*xdata[i++] + ydata[j++];
+    }
+  }
+
+  result._size = x._size;
+  result._nelm = nelm;
+  result._indices = indices;
+  result._data = data;
   return result;
 }
 
+/// Computes this += alpha*x, where the nonzero pattern of this becomes the union of the patterns of this and x
+SPARSEVECTORN& SPARSEVECTORN::axpy(REAL alpha, const SPARSEVECTORN& x)
+{
+  return axpy(alpha, x, *this, *this);
+}
+
 /// Gets the dense version of the vector 
 VECTORN& SPARSEVECTORN::to_dense(VECTORN& result) const
 {
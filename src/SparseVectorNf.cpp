@@ -4,8 +4,10 @@
  * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
  ****************************************************************************/
 
+#include <algorithm>
 #include <Ravelin/MissizeException.h>
 #include <Ravelin/Constants.h>
+#include "sparse_kernels.h"
 #include <Ravelin/SparseVectorNf.h>
 
 using std::map;
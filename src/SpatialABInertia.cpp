@@ -8,7 +8,7 @@ using std::vector;
 using boost::shared_ptr;
 
 /// Default constructor -- constructs a zero inertia matrix
-SPATIAL_AB_INERTIA::SPATIAL_AB_INERTIA(shared_ptr<const POSE3> pose)
+SPATIAL_AB_INERTIA::SPATIAL_AB_INERTIA(FRAME_PTR pose)
 {
   M.set_zero();
   H.set_zero();
@@ -26,7 +26,7 @@ SPATIAL_AB_INERTIA::SPATIAL_AB_INERTIA(shared_ptr<POSE3> pose)
 }
 
 /// Constructs the spatial AB inertia from the given values 
-SPATIAL_AB_INERTIA::SPATIAL_AB_INERTIA(const MATRIX3& M, const MATRIX3& H, const MATRIX3& J, shared_ptr<const POSE3> pose)
+SPATIAL_AB_INERTIA::SPATIAL_AB_INERTIA(const MATRIX3& M, const MATRIX3& H, const MATRIX3& J, FRAME_PTR pose)
 {
   this->M = M;
   this->H = H;
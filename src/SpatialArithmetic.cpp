@@ -27,7 +27,7 @@ static void get_r_E(const TRANSFORM3& T, VECTOR3& r, MATRIX3& E)
 }
 
 /// transforms a spatial acceleration using precomputation *without accounting for moving frames*
-void SPARITH::transform_accel(boost::shared_ptr<const POSE3> target, const SACCEL& w, const VECTOR3& r, const MATRIX3& E, SACCEL& result)
+void SPARITH::transform_accel(FRAME_PTR target, const SACCEL& w, const VECTOR3& r, const MATRIX3& E, SACCEL& result)
 {
   // get the components of w[i] 
   VECTOR3 top = w.get_upper();
@@ -42,14 +42,14 @@ void SPARITH::transform_accel(boost::shared_ptr<const POSE3> target, const SACCE
 } 
 
 /// Special transformation of acceleration when moving aspect of pose accounted for elsewhere
-SACCEL SPARITH::transform_accel(boost::shared_ptr<const POSE3> target, const SACCEL& a)
+SACCEL SPARITH::transform_accel(FRAME_PTR target, const SACCEL& a)
 {
   SACCEL s;
 
   // NOTE: this is a duplication of the transform_spatial(.) function in
   // Ravelin::Pose3x
   // setup the source pose 
-  boost::shared_ptr<const POSE3> source = a.pose;
+  FRAME_PTR source = a.pose;
 
   // quick check
   if (source == target)
@@ -80,7 +80,7 @@ SACCEL SPARITH::transform_accel(boost::shared_ptr<const POSE3> target, const SAC
 }
 
 /// Special transformation of acceleration when moving aspect of pose accounted for elsewhere
-std::vector<SACCEL>& SPARITH::transform_accel(boost::shared_ptr<const POSE3> target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result)
+std::vector<SACCEL>& SPARITH::transform_accel(FRAME_PTR target, const std::vector<SACCEL>& t, std::vector<SACCEL>& result)
 {
   // NOTE: this is a duplication of the transform_spatial(.) function in
   // Ravelin::Pose3x
@@ -93,7 +93,7 @@ std::vector<SACCEL>& SPARITH::transform_accel(boost::shared_ptr<const POSE3> tar
   }
 
   // setup the source pose
-  boost::shared_ptr<const POSE3> source = t[0].pose; 
+  FRAME_PTR source = t[0].pose; 
 
   #ifndef NEXCEPT
   for (unsigned i=1; i< t.size(); i++)
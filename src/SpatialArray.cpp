@@ -0,0 +1,103 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+/// Constructs an array of n (uninitialized) spatial vectors in the given frame
+SPATIAL_ARRAY::SPATIAL_ARRAY(unsigned n, FRAME_PTR pose)
+{
+  _m.resize(SPATIAL_DIM, n);
+  this->pose = pose;
+}
+
+/// Resizes the array, preserving existing spatial vectors
+SPATIAL_ARRAY& SPATIAL_ARRAY::resize(unsigned n)
+{
+  _m.resize(SPATIAL_DIM, n, true);
+  return *this;
+}
+
+/// Sets the i-th spatial vector, which must be defined in the frame of this array
+void SPATIAL_ARRAY::set(unsigned i, const SVECTOR6& v)
+{
+  #ifndef NEXCEPT
+  if (i >= size())
+    throw InvalidIndexException();
+  if (v.pose != pose)
+    throw FrameException();
+  #endif
+
+  std::copy(v.data(), v.data()+SPATIAL_DIM, column_data(i));
+}
+
+/// Transforms all spatial vectors in this array to the target frame
+/**
+ * The relative transform (r and E) is computed once. Each spatial vector
+ * [u; l] (angular/linear for velocities and accelerations, force/torque for
+ * forces and momenta) is transformed to [E*u; E*l - E*rx*u], which is 
+ * applied to the entire array as three 3 x n matrix products with BLAS.
+ * \param result the transformed array on return (may be this)
+ */
+SPATIAL_ARRAY& SPATIAL_ARRAY::transform(boost::shared_ptr<const POSE3> target, SPATIAL_ARRAY& result) const
+{
+  const unsigned N = size();
+  const unsigned THREE_D = 3;
+
+  #ifdef REENTRANT
+  FastThreadable<MATRIXN> work;
+  #else
+  static FastThreadable<MATRIXN> work;
+  #endif
+
+  // quick check
+  if (pose == target)
+  {
+    if (&result != this)
+      result = *this;
+    return result;
+  }
+
+  // compute r and E (as in POSE3::get_r_E())
+  TRANSFORM3 T = POSE3::calc_relative_pose(pose, target);
+  MATRIX3 E = T.q;
+  ORIGIN3 r = E.transpose_mult(-T.x);
+  MATRIX3 Erx = E * MATRIX3::skew_symmetric(r);
+
+  // copy the source, if necessary
+  const REAL* src = data();
+  if (&result == this)
+  {
+    work() = _m;
+    src = work().data();
+  }
+  else
+    result._m.resize(SPATIAL_DIM, N);
+  result.pose = target;
+  if (N == 0)
+    return result;
+
+  // upper = E*u, lower = E*l - E*rx*u
+  REAL* dest = result.data();
+  CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, THREE_D, N, THREE_D, (REAL) 1.0, E.data(), THREE_D, src, SPATIAL_DIM, (REAL) 0.0, dest, SPATIAL_DIM);
+  CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, THREE_D, N, THREE_D, (REAL) 1.0, E.data(), THREE_D, src+THREE_D, SPATIAL_DIM, (REAL) 0.0, dest+THREE_D, SPATIAL_DIM);
+  CBLAS::gemm(CblasColMajor, CblasNoTrans, CblasNoTrans, THREE_D, N, THREE_D, (REAL) -1.0, Erx.data(), THREE_D, src, SPATIAL_DIM, (REAL) 1.0, dest+THREE_D, SPATIAL_DIM);
+
+  return result;
+}
+
+/// Computes the linear combination of the spatial vectors in this array (e.g., s*qd for joint spatial axes s)
+/**
+ * \param x the coefficients (one per spatial vector)
+ * \param result the six-dimensional result on return
+ */
+VECTORN& SPATIAL_ARRAY::mult(const VECTORN& x, VECTORN& result) const
+{
+  #ifndef NEXCEPT
+  if (x.size() != size())
+    throw MissizeException();
+  #endif
+
+  return _m.mult(x, result);
+}
+
@@ -0,0 +1,21 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <algorithm>
+#include <Ravelin/cblas.h>
+#include <Ravelin/FastThreadable.h>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/FrameException.h>
+#include <Ravelin/Transform3d.h>
+#include <Ravelin/SpatialArrayd.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/ddefs.h>
+#include "SpatialArray.cpp"
+#include <Ravelin/undefs.h>
+
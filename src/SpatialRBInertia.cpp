@@ -7,7 +7,7 @@
 using boost::shared_ptr;
 
 /// Default constructor -- constructs a zero inertia matrix
-SPATIAL_RB_INERTIA::SPATIAL_RB_INERTIA(shared_ptr<const POSE3> pose)
+SPATIAL_RB_INERTIA::SPATIAL_RB_INERTIA(FRAME_PTR pose)
 {
   m = (REAL) 0.0;
   h.set_zero();
@@ -25,7 +25,7 @@ SPATIAL_RB_INERTIA::SPATIAL_RB_INERTIA(shared_ptr<POSE3> pose)
 }
 
 /// Constructs the 6x6 spatial matrix from the given values 
-SPATIAL_RB_INERTIA::SPATIAL_RB_INERTIA(REAL m, const VECTOR3& h, const MATRIX3& J, shared_ptr<const POSE3> pose)
+SPATIAL_RB_INERTIA::SPATIAL_RB_INERTIA(REAL m, const VECTOR3& h, const MATRIX3& J, FRAME_PTR pose)
 {
   this->m = m;
   this->h = h;
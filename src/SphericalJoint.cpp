@@ -415,3 +415,20 @@ void SPHERICALJOINT::calc_constraint_jacobian_dot(bool inboard, MATRIXN& Cq)
   throw std::runtime_error("Implementation required");
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* SPHERICALJOINT::copy(PoseMap& poses) const
+{
+  SPHERICALJOINT* joint = new SPHERICALJOINT(*this);
+  joint->copy_frames(poses);
+  return joint;
+}
+
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void SPHERICALJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_u[0], poses);
+  remap_frame(_u[1], poses);
+  remap_frame(_u[2], poses);
+  remap_frame(_s_dot, poses);
+}
@@ -0,0 +1,770 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+using boost::shared_array;
+
+/// The unsigned integer with the size of a real, used by the codec
+template <unsigned N>
+struct RealBits;
+
+template <>
+struct RealBits<4> { typedef boost::uint32_t Word; };
+
+template <>
+struct RealBits<8> { typedef boost::uint64_t Word; };
+
+/// Encodes a column of frames with the XOR-delta codec
+/**
+ * Each value is XOR'ed with the same element of the previous frame; the
+ * result, which for slowly changing signals has few significant bytes, is
+ * stored as a 4-bit count of its significant bytes followed by those bytes
+ * (the counts of two values share a byte).
+ * \return the number of bytes written to out
+ */
+static size_t encode_xor_delta(const REAL* values, unsigned nframes, unsigned width, unsigned char* out)
+{
+  typedef RealBits<sizeof(REAL)>::Word Word;
+  unsigned char* p = out;
+  unsigned char* counts = NULL;
+  for (unsigned i=0, n=nframes*width; i< n; i++)
+  {
+    Word x, prev = 0;
+    std::memcpy(&x, values+i, sizeof(Word));
+    if (i >= width)
+      std::memcpy(&prev, values+i-width, sizeof(Word));
+    x ^= prev;
+
+    // count the significant bytes
+    unsigned nbytes = sizeof(Word);
+    while (nbytes > 0 && (x >> (8*(nbytes-1))) == 0)
+      nbytes--;
+
+    if (i % 2 == 0)
+    {
+      counts = p++;
+      *counts = (unsigned char) nbytes;
+    }
+    else
+      *counts |= (unsigned char) (nbytes << 4);
+    for (unsigned j=0; j< nbytes; j++)
+      *p++ = (unsigned char) (x >> (8*j));
+  }
+
+  return p - out;
+}
+
+/// Decodes a column of frames encoded by encode_xor_delta()
+/**
+ * \return a pointer past the encoded column, or NULL if the data is corrupt
+ */
+static const unsigned char* decode_xor_delta(const unsigned char* p, const unsigned char* end, unsigned nframes, unsigned width, REAL* values)
+{
+  typedef RealBits<sizeof(REAL)>::Word Word;
+  unsigned char counts = 0;
+  for (unsigned i=0, n=nframes*width; i< n; i++)
+  {
+    if (i % 2 == 0)
+    {
+      if (p == end)
+        return NULL;
+      counts = *p++;
+    }
+    unsigned nbytes = (i % 2 == 0) ? (counts & 0x0f) : (counts >> 4);
+    if (nbytes > sizeof(Word) || (size_t) (end - p) < nbytes)
+      return NULL;
+
+    Word x = 0;
+    for (unsigned j=0; j< nbytes; j++)
+      x |= ((Word) *p++) << (8*j);
+    if (i >= width)
+    {
+      Word prev;
+      std::memcpy(&prev, values+i-width, sizeof(Word));
+      x ^= prev;
+    }
+    std::memcpy(values+i, &x, sizeof(Word));
+  }
+
+  return p;
+}
+
+/// Constructs a recorder with no bodies
+TRAJECTORY_RECORDER::TRAJECTORY_RECORDER()
+{
+  _frame_size = 1;
+  _chunk_frames = 0;
+  _codec = eNoCompression;
+  _write_error = false;
+  _nrecorded = _ndropped = 0;
+  _current = -1;
+  _queue_head = _queue_size = 0;
+  _stop = false;
+  _running = false;
+}
+
+/// Closes the log, if it is open
+TRAJECTORY_RECORDER::~TRAJECTORY_RECORDER()
+{
+  if (_running)
+    close();
+}
+
+/// Adds a body whose generalized coordinates, velocities, accelerations, and/or forces are recorded
+/**
+ * Bodies must be added before the log is opened. The channels are named
+ * using the body's id (or "body" and its index, if the id is empty),
+ * followed by "/q", "/qd", "/qdd", or "/tau".
+ * \param quantities a bitwise combination of Quantity values
+ */
+void TRAJECTORY_RECORDER::add_body(shared_ptr<DYNAMIC_BODY> body, unsigned quantities)
+{
+  if (_running)
+  {
+    std::cerr << "TrajectoryRecorder::add_body() - bodies cannot be added while recording" << std::endl;
+    return;
+  }
+
+  _bodies.push_back(body);
+  _body_quantities.push_back(quantities);
+}
+
+/// Adds a link whose pose is recorded
+/**
+ * Links must be added before the log is opened. The channel is named using
+ * the link's id followed by "/pose".
+ */
+void TRAJECTORY_RECORDER::add_link_pose(shared_ptr<RIGIDBODY> link)
+{
+  if (_running)
+  {
+    std::cerr << "TrajectoryRecorder::add_link_pose() - links cannot be added while recording" << std::endl;
+    return;
+  }
+
+  _links.push_back(link);
+}
+
+/// Opens a log and starts the writer thread
+/**
+ * All memory used for recording is allocated here.
+ * \param codec the compression applied to each chunk
+ * \param chunk_frames the number of frames in a chunk
+ * \param nchunks the number of chunks; more chunks let the writer fall
+ *        further behind (e.g., when the disk stalls) before frames are
+ *        dropped
+ * \return <b>true</b> if the log was opened successfully
+ */
+bool TRAJECTORY_RECORDER::open(const string& fname, Codec codec, unsigned chunk_frames, unsigned nchunks)
+{
+  if (_running)
+  {
+    std::cerr << "TrajectoryRecorder::open() - a log is already open" << std::endl;
+    return false;
+  }
+  if (chunk_frames == 0 || nchunks < 2)
+  {
+    std::cerr << "TrajectoryRecorder::open() - at least two chunks of at least one frame are required" << std::endl;
+    return false;
+  }
+
+  // setup the channels
+  const char* SUFFIXES[] = { "/q", "/qd", "/qdd", "/tau" };
+  _channels.clear();
+  _frame_size = 1;
+  for (unsigned i=0; i< _bodies.size(); i++)
+  {
+    string id = _bodies[i]->body_id;
+    if (id.empty())
+    {
+      std::ostringstream oss;
+      oss << "body" << i;
+      id = oss.str();
+    }
+    for (unsigned j=0; j< 4; j++)
+    {
+      if (!(_body_quantities[i] & (1 << j)))
+        continue;
+      Channel c;
+      c.type = (ChannelType) (eQChannel + j);
+      c.name = id + SUFFIXES[j];
+      c.width = _bodies[i]->num_generalized_coordinates((j == 0) ? DYNAMIC_BODY::eEuler : DYNAMIC_BODY::eSpatial);
+      c.offset = _frame_size - 1;
+      c.body = _bodies[i];
+      _channels.push_back(c);
+      _frame_size += c.width;
+    }
+  }
+  for (unsigned i=0; i< _links.size(); i++)
+  {
+    Channel c;
+    c.type = ePoseChannel;
+    c.name = _links[i]->body_id + "/pose";
+    c.width = 7;
+    c.offset = _frame_size - 1;
+    c.link = _links[i];
+    _channels.push_back(c);
+    _frame_size += c.width;
+  }
+
+  // open the file and write the header and the channel descriptions
+  _out.clear();
+  _out.open(fname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!_out)
+  {
+    std::cerr << "TrajectoryRecorder::open() - unable to open file " << fname << " for writing" << std::endl;
+    return false;
+  }
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, "RAVELINT", sizeof(header.magic));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.real_size = sizeof(REAL);
+  header.codec = codec;
+  header.nchannels = _channels.size();
+  header.chunk_frames = chunk_frames;
+  _out.write((const char*) &header, sizeof(Header));
+  const char ZEROS[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  for (unsigned i=0; i< _channels.size(); i++)
+  {
+    ChannelHeader ch;
+    ch.width = _channels[i].width;
+    ch.name_length = _channels[i].name.size();
+    _out.write((const char*) &ch, sizeof(ChannelHeader));
+    _out.write(_channels[i].name.data(), ch.name_length);
+    _out.write(ZEROS, padded(ch.name_length) - ch.name_length);
+  }
+  _out.flush();
+  if (_out.fail())
+  {
+    std::cerr << "TrajectoryRecorder::open() - unable to write the header to " << fname << std::endl;
+    _out.close();
+    return false;
+  }
+
+  // allocate the chunks and the buffer for compression (in the worst case,
+  // every value has a count and all of its bytes)
+  _codec = codec;
+  _chunk_frames = chunk_frames;
+  _buffer.assign((size_t) nchunks*chunk_frames*_frame_size, (REAL) 0.0);
+  _chunks.resize(nchunks);
+  _free.clear();
+  _free.reserve(nchunks);
+  for (unsigned i=0; i< nchunks; i++)
+  {
+    _chunks[i].data = &_buffer[(size_t) i*chunk_frames*_frame_size];
+    _chunks[i].nframes = 0;
+    _free.push_back(nchunks-i-1);
+  }
+  if (codec == eXorDelta)
+    _encoded.resize((size_t) chunk_frames*_frame_size*(sizeof(REAL)+1));
+  _queue.resize(nchunks);
+  _queue_head = _queue_size = 0;
+  _current = -1;
+  _stop = false;
+  _write_error = false;
+  _nrecorded = _ndropped = 0;
+
+  // start the writer
+  pthread_mutex_init(&_mutex, NULL);
+  pthread_cond_init(&_cond, NULL);
+  if (pthread_create(&_thread, NULL, &writer_thread, this) != 0)
+  {
+    std::cerr << "TrajectoryRecorder::open() - unable to start the writer thread" << std::endl;
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+    _out.close();
+    return false;
+  }
+  _running = true;
+
+  return true;
+}
+
+/// Records the current states of the bodies and poses of the links
+/**
+ * This does not allocate memory or perform I/O, and it takes a lock only
+ * when a chunk fills.
+ * \param t the time of the frame
+ * \return <b>true</b> if the frame was recorded, <b>false</b> if it was
+ *         dropped because no chunk was free (or the log is not open)
+ */
+bool TRAJECTORY_RECORDER::record(REAL t)
+{
+  if (!_running)
+    return false;
+
+  // get a free chunk, if necessary
+  if (_current < 0)
+  {
+    pthread_mutex_lock(&_mutex);
+    if (!_free.empty())
+    {
+      _current = _free.back();
+      _free.pop_back();
+    }
+    pthread_mutex_unlock(&_mutex);
+    if (_current < 0)
+    {
+      _ndropped++;
+      return false;
+    }
+  }
+
+  // sample each channel into its column
+  Chunk& chunk = _chunks[_current];
+  unsigned k = chunk.nframes;
+  chunk.data[k] = t;
+  for (unsigned i=0; i< _channels.size(); i++)
+  {
+    const Channel& c = _channels[i];
+    sample(c, chunk.data + (size_t) _chunk_frames*(c.offset+1) + (size_t) k*c.width);
+  }
+  _nrecorded++;
+
+  // hand off the chunk when it is full
+  if (++chunk.nframes == _chunk_frames)
+  {
+    submit(_current);
+    _current = -1;
+  }
+
+  return true;
+}
+
+/// Samples a channel into the given values
+void TRAJECTORY_RECORDER::sample(const Channel& c, REAL* values)
+{
+  // bodies write directly into the chunk through a view of it
+  SHAREDVECTORN v(values, c.width);
+
+  switch (c.type)
+  {
+    case eQChannel:
+      c.body->get_generalized_coordinates_euler(v);
+      break;
+
+    case eQdChannel:
+      c.body->get_generalized_velocity(DYNAMIC_BODY::eSpatial, v);
+      break;
+
+    case eQddChannel:
+      c.body->get_generalized_acceleration(v);
+      break;
+
+    case eTauChannel:
+      c.body->get_generalized_forces(v);
+      break;
+
+    case ePoseChannel:
+    {
+      TRANSFORM3 T = POSE3::calc_relative_pose(c.link->get_pose(), shared_ptr<const POSE3>());
+      values[0] = T.x[0];
+      values[1] = T.x[1];
+      values[2] = T.x[2];
+      values[3] = T.q.w;
+      values[4] = T.q.x;
+      values[5] = T.q.y;
+      values[6] = T.q.z;
+      break;
+    }
+  }
+}
+
+/// Queues a full chunk for the writer
+void TRAJECTORY_RECORDER::submit(unsigned chunk)
+{
+  pthread_mutex_lock(&_mutex);
+  _queue[(_queue_head + _queue_size) % _queue.size()] = chunk;
+  _queue_size++;
+  pthread_cond_signal(&_cond);
+  pthread_mutex_unlock(&_mutex);
+}
+
+/// Writes queued chunks until the log is closed
+void* TRAJECTORY_RECORDER::writer_thread(void* arg)
+{
+  TRAJECTORY_RECORDER* recorder = (TRAJECTORY_RECORDER*) arg;
+
+  while (true)
+  {
+    // wait for a chunk
+    pthread_mutex_lock(&recorder->_mutex);
+    while (recorder->_queue_size == 0 && !recorder->_stop)
+      pthread_cond_wait(&recorder->_cond, &recorder->_mutex);
+    if (recorder->_queue_size == 0)
+    {
+      pthread_mutex_unlock(&recorder->_mutex);
+      break;
+    }
+    unsigned idx = recorder->_queue[recorder->_queue_head];
+    recorder->_queue_head = (recorder->_queue_head + 1) % recorder->_queue.size();
+    recorder->_queue_size--;
+    pthread_mutex_unlock(&recorder->_mutex);
+
+    // write it without holding the lock, then return it to the free list
+    recorder->write_chunk(recorder->_chunks[idx]);
+    recorder->_chunks[idx].nframes = 0;
+    pthread_mutex_lock(&recorder->_mutex);
+    recorder->_free.push_back(idx);
+    pthread_mutex_unlock(&recorder->_mutex);
+  }
+
+  return NULL;
+}
+
+/// Writes a chunk to the log (called by the writer thread)
+void TRAJECTORY_RECORDER::write_chunk(const Chunk& chunk)
+{
+  const char ZEROS[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  unsigned n = chunk.nframes;
+
+  ChunkHeader header;
+  std::memcpy(header.magic, "RCHK", sizeof(header.magic));
+  header.nframes = n;
+  header.t0 = (double) chunk.data[0];
+  header.t1 = (double) chunk.data[n-1];
+
+  if (_codec == eXorDelta)
+  {
+    // encode the time column and each channel's column
+    size_t nbytes = encode_xor_delta(chunk.data, n, 1, &_encoded[0]);
+    for (unsigned i=0; i< _channels.size(); i++)
+    {
+      const Channel& c = _channels[i];
+      nbytes += encode_xor_delta(chunk.data + (size_t) _chunk_frames*(c.offset+1), n, c.width, &_encoded[nbytes]);
+    }
+    header.stored_bytes = nbytes;
+    _out.write((const char*) &header, sizeof(ChunkHeader));
+    _out.write((const char*) &_encoded[0], nbytes);
+  }
+  else
+  {
+    // write the used part of the time column and each channel's column
+    header.stored_bytes = sizeof(REAL)*n*_frame_size;
+    _out.write((const char*) &header, sizeof(ChunkHeader));
+    _out.write((const char*) chunk.data, sizeof(REAL)*n);
+    for (unsigned i=0; i< _channels.size(); i++)
+    {
+      const Channel& c = _channels[i];
+      _out.write((const char*) (chunk.data + (size_t) _chunk_frames*(c.offset+1)), sizeof(REAL)*n*c.width);
+    }
+  }
+  _out.write(ZEROS, padded(header.stored_bytes) - header.stored_bytes);
+
+  if (_out.fail() && !_write_error)
+  {
+    std::cerr << "TrajectoryRecorder - error writing the log; subsequent frames may be lost" << std::endl;
+    _write_error = true;
+  }
+}
+
+/// Writes any partially filled chunk, stops the writer thread, and closes the log
+/**
+ * \return <b>true</b> if every chunk was written successfully
+ */
+bool TRAJECTORY_RECORDER::close()
+{
+  if (!_running)
+    return false;
+
+  // queue the partial chunk and stop the writer once the queue is empty
+  if (_current >= 0 && _chunks[_current].nframes > 0)
+    submit(_current);
+  _current = -1;
+  pthread_mutex_lock(&_mutex);
+  _stop = true;
+  pthread_cond_signal(&_cond);
+  pthread_mutex_unlock(&_mutex);
+  pthread_join(_thread, NULL);
+  pthread_cond_destroy(&_cond);
+  pthread_mutex_destroy(&_mutex);
+  _running = false;
+
+  _out.close();
+  bool success = !_write_error && !_out.fail();
+
+  // release the chunks
+  vector<REAL>().swap(_buffer);
+  vector<unsigned char>().swap(_encoded);
+  _chunks.clear();
+
+  return success;
+}
+
+/// Unmaps the log
+void TRAJECTORY_LOG::Unmapper::operator()(char* data) const
+{
+  munmap(data, _size);
+}
+
+/// Constructs a reader with no log open
+TRAJECTORY_LOG::TRAJECTORY_LOG()
+{
+  _codec = TRAJECTORY_RECORDER::eNoCompression;
+  _frame_size = 1;
+  _nframes = 0;
+  _decoded_chunk = -1;
+}
+
+/// Closes the log (views of it remain valid)
+void TRAJECTORY_LOG::close()
+{
+  _file.reset();
+  _decoded.reset();
+  _decoded_chunk = -1;
+  _channels.clear();
+  _chunks.clear();
+  _frame_size = 1;
+  _nframes = 0;
+}
+
+/// Opens a log written by TRAJECTORY_RECORDER
+/**
+ * \return <b>true</b> if the log was opened successfully
+ */
+bool TRAJECTORY_LOG::open(const string& fname)
+{
+  typedef TRAJECTORY_RECORDER::Header Header;
+  typedef TRAJECTORY_RECORDER::ChannelHeader ChannelHeader;
+  typedef TRAJECTORY_RECORDER::ChunkHeader ChunkHeader;
+  close();
+
+  // open the file and get its size
+  int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "TrajectoryLog::open() - unable to open file " << fname << " for reading" << std::endl;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header))
+  {
+    std::cerr << "TrajectoryLog::open() - " << fname << " is not a trajectory log" << std::endl;
+    ::close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+
+  // map the file
+  void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    std::cerr << "TrajectoryLog::open() - unable to map file " << fname << std::endl;
+    return false;
+  }
+  shared_array<char> file((char*) data, Unmapper(size));
+  const char* end = file.get() + size;
+
+  // verify the header
+  const Header* header = (const Header*) data;
+  if (std::memcmp(header->magic, "RAVELINT", sizeof(header->magic)) != 0 || header->version != TRAJECTORY_RECORDER::VERSION || header->byte_order != TRAJECTORY_RECORDER::BYTE_ORDER_MARK)
+  {
+    std::cerr << "TrajectoryLog::open() - " << fname << " is not a trajectory log, or was written by an incompatible version or on an incompatible machine" << std::endl;
+    return false;
+  }
+  if (header->real_size != sizeof(REAL))
+  {
+    std::cerr << "TrajectoryLog::open() - " << fname << " was written with " << header->real_size << "-byte reals" << std::endl;
+    return false;
+  }
+  if (header->codec != TRAJECTORY_RECORDER::eNoCompression && header->codec != TRAJECTORY_RECORDER::eXorDelta)
+  {
+    std::cerr << "TrajectoryLog::open() - " << fname << " uses an unknown codec" << std::endl;
+    return false;
+  }
+
+  // read the channels
+  const char* p = file.get() + sizeof(Header);
+  vector<Channel> channels(header->nchannels);
+  unsigned frame_size = 1;
+  for (unsigned i=0; i< header->nchannels; i++)
+  {
+    if ((size_t) (end - p) < sizeof(ChannelHeader))
+    {
+      std::cerr << "TrajectoryLog::open() - " << fname << " is corrupt" << std::endl;
+      return false;
+    }
+    const ChannelHeader* ch = (const ChannelHeader*) p;
+    p += sizeof(ChannelHeader);
+    if ((size_t) (end - p) < TRAJECTORY_RECORDER::padded(ch->name_length))
+    {
+      std::cerr << "TrajectoryLog::open() - " << fname << " is corrupt" << std::endl;
+      return false;
+    }
+    channels[i].name = string(p, ch->name_length);
+    channels[i].width = ch->width;
+    channels[i].offset = frame_size - 1;
+    frame_size += ch->width;
+    p += TRAJECTORY_RECORDER::padded(ch->name_length);
+  }
+
+  // index the chunks, stopping at the first incomplete one
+  vector<ChunkInfo> chunks;
+  unsigned nframes = 0;
+  while ((size_t) (end - p) >= sizeof(ChunkHeader))
+  {
+    const ChunkHeader* h = (const ChunkHeader*) p;
+    const char* chunk_data = p + sizeof(ChunkHeader);
+    bool valid = std::memcmp(h->magic, "RCHK", sizeof(h->magic)) == 0 && h->nframes > 0 && h->nframes <= header->chunk_frames && h->stored_bytes <= (boost::uint64_t) (end - chunk_data);
+    if (valid && header->codec == TRAJECTORY_RECORDER::eNoCompression)
+      valid = (h->stored_bytes == (boost::uint64_t) sizeof(REAL)*h->nframes*frame_size);
+    if (!valid)
+    {
+      std::cerr << "TrajectoryLog::open() - " << fname << " ends with an incomplete or corrupt chunk, which is ignored" << std::endl;
+      break;
+    }
+
+    ChunkInfo info;
+    info.data = chunk_data;
+    info.stored_bytes = h->stored_bytes;
+    info.first_frame = nframes;
+    info.nframes = h->nframes;
+    info.t0 = h->t0;
+    chunks.push_back(info);
+    nframes += h->nframes;
+    p = chunk_data + std::min((size_t) TRAJECTORY_RECORDER::padded(h->stored_bytes), (size_t) (end - chunk_data));
+  }
+
+  _file = file;
+  _codec = (TRAJECTORY_RECORDER::Codec) header->codec;
+  _frame_size = frame_size;
+  _nframes = nframes;
+  _channels.swap(channels);
+  _chunks.swap(chunks);
+  return true;
+}
+
+/// Finds a channel by name
+/**
+ * \return the index of the channel, or -1 if there is no such channel
+ */
+int TRAJECTORY_LOG::find_channel(const string& name) const
+{
+  for (unsigned i=0; i< _channels.size(); i++)
+    if (_channels[i].name == name)
+      return (int) i;
+  return -1;
+}
+
+/// Finds the chunk containing a frame
+unsigned TRAJECTORY_LOG::find_chunk(unsigned frame) const
+{
+  #ifndef NEXCEPT
+  if (frame >= _nframes)
+    throw InvalidIndexException();
+  #endif
+
+  // find the last chunk that starts at or before the frame
+  unsigned lo = 0, hi = _chunks.size();
+  while (hi - lo > 1)
+  {
+    unsigned mid = (lo + hi)/2;
+    if (_chunks[mid].first_frame <= frame)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/// Gets the data of a chunk (the time column followed by the column of each channel), decoding it if necessary
+/**
+ * \param owner on return, the array that holds the data (views of the data
+ *        must share it)
+ */
+const REAL* TRAJECTORY_LOG::chunk_data(unsigned chunk, shared_array<REAL>& owner)
+{
+  const ChunkInfo& info = _chunks[chunk];
+
+  // uncompressed data is used in place
+  if (_codec == TRAJECTORY_RECORDER::eNoCompression)
+  {
+    owner = shared_array<REAL>(_file, (REAL*) info.data);
+    return owner.get();
+  }
+
+  // decode the chunk, unless it is cached
+  if (_decoded_chunk != (int) chunk)
+  {
+    shared_array<REAL> decoded(new REAL[(size_t) info.nframes*_frame_size]);
+    const unsigned char* p = (const unsigned char*) info.data;
+    const unsigned char* end = p + info.stored_bytes;
+    p = decode_xor_delta(p, end, info.nframes, 1, decoded.get());
+    for (unsigned i=0; i< _channels.size() && p; i++)
+      p = decode_xor_delta(p, end, info.nframes, _channels[i].width, decoded.get() + (size_t) info.nframes*(_channels[i].offset+1));
+    if (!p)
+    {
+      std::cerr << "TrajectoryLog - chunk " << chunk << " is corrupt" << std::endl;
+      std::fill(decoded.get(), decoded.get() + (size_t) info.nframes*_frame_size, (REAL) 0.0);
+    }
+    _decoded = decoded;
+    _decoded_chunk = (int) chunk;
+  }
+
+  owner = _decoded;
+  return owner.get();
+}
+
+/// Gets the time of a frame
+REAL TRAJECTORY_LOG::time(unsigned frame)
+{
+  unsigned chunk = find_chunk(frame);
+  shared_array<REAL> owner;
+  return chunk_data(chunk, owner)[frame - _chunks[chunk].first_frame];
+}
+
+/// Finds the last frame whose time is at or before t
+/**
+ * \return the index of the frame, or 0 if t precedes every frame
+ */
+unsigned TRAJECTORY_LOG::find_frame(REAL t)
+{
+  if (_chunks.empty())
+    return 0;
+
+  // find the last chunk starting at or before t, then search its times
+  unsigned lo = 0, hi = _chunks.size();
+  while (hi - lo > 1)
+  {
+    unsigned mid = (lo + hi)/2;
+    if (_chunks[mid].t0 <= (double) t)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  shared_array<REAL> owner;
+  const REAL* times = chunk_data(lo, owner);
+  const REAL* last = std::upper_bound(times, times + _chunks[lo].nframes, t);
+  unsigned i = (last == times) ? 0 : (last - times) - 1;
+  return _chunks[lo].first_frame + i;
+}
+
+/// Gets the values of a channel at a frame
+/**
+ * \return a read-only view of the values, which remains valid (along with
+ *         the memory holding it) as long as the view or a copy of it exists
+ */
+CONST_SHAREDVECTORN TRAJECTORY_LOG::get(unsigned channel, unsigned frame)
+{
+  #ifndef NEXCEPT
+  if (channel >= _channels.size())
+    throw InvalidIndexException();
+  #endif
+
+  unsigned chunk = find_chunk(frame);
+  const ChunkInfo& info = _chunks[chunk];
+  const Channel& c = _channels[channel];
+  shared_array<REAL> owner;
+  chunk_data(chunk, owner);
+  unsigned start = info.nframes*(c.offset+1) + (frame - info.first_frame)*c.width;
+  return CONST_SHAREDVECTORN(c.width, 1, start, SharedResizable<REAL>(owner, info.nframes*_frame_size));
+}
+
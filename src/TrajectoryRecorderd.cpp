@@ -0,0 +1,25 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <Ravelin/InvalidIndexException.h>
+#include <Ravelin/Pose3d.h>
+#include <Ravelin/Transform3d.h>
+#include <Ravelin/TrajectoryRecorderd.h>
+
+using namespace Ravelin;
+
+#include <Ravelin/ddefs.h>
+#include "TrajectoryRecorder.cpp"
+#include <Ravelin/undefs.h>
+
@@ -309,7 +309,7 @@ POSE3 TRANSFORM3::transform(const POSE3& p) const
   #endif
 
   POSE3 result;
-  result.rpose = target;
+  result.rpose = lock_frame(target);
   result.q = q * p.q;
   result.x = ORIGIN3(q * p.x) + x; 
  
@@ -325,7 +325,7 @@ POSE3 TRANSFORM3::inverse_transform(const POSE3& p) const
   #endif
 
   POSE3 result;
-  result.rpose = source;
+  result.rpose = lock_frame(source);
   QUAT qi = QUAT::invert(q);
   result.q = qi * p.q;
   result.x = ORIGIN3(qi * p.x) - qi*x; 
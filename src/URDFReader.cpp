@@ -21,52 +21,17 @@ using boost::dynamic_pointer_cast;
  */
 bool URDFREADER::read(const string& fname, std::string& name, vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
 {
-  // *************************************************************
-  // going to remove any path from the argument and change to that
-  // path; this is done so that all files referenced from the
-  // local path of the XML file are found
-  // *************************************************************
-
-  // set the filename to use as the argument, by default
-  string filename = fname;
-
-  // get the current pathname
-  size_t BUFSIZE = 8192;
-  boost::shared_array<char> cwd;
-  while (true)
-  {
-    cwd = boost::shared_array<char>((new char[BUFSIZE]));
-    if (getcwd(cwd.get(), BUFSIZE) == cwd.get())
-      break;
-    if (errno != ERANGE)
-    {
-      std::cerr << "URDFReader::read() - unable to allocate sufficient memory!" << std::endl;
-      return false;
-    }
-    BUFSIZE *= 2;
-  }
-
-  // separate the path from the filename
-  size_t last_path_sep = fname.find_last_of('/');
-  if (last_path_sep != string::npos)
-  {
-    // get the new working path
-    string pathname = fname.substr(0,last_path_sep+1);
-
-    // change to the new working path
-    chdir(pathname.c_str());
-
-    // get the new filename
-    filename = fname.substr(last_path_sep+1,string::npos);
-  }
+  // NOTE: the file is read using its full path (libxml2 resolves any
+  // references relative to the location of the file), so the working 
+  // directory of the process is never changed and files may be read from
+  // multiple threads concurrently
 
   // read the XML Tree 
-  shared_ptr<const XMLTree> tree = XMLTree::read_from_xml(filename);
+  shared_ptr<const XMLTree> tree = XMLTree::read_from_xml(fname);
   if (!tree)
   {
     std::cerr << "URDFReader::read() - unable to open file " << fname;
     std::cerr << " for reading" << std::endl;
-    chdir(cwd.get());
     return false;
   }
   
@@ -79,7 +44,7 @@ bool URDFREADER::read(const string& fname, std::string& name, vector<shared_ptr<
   // ********************************************************************
 
   // read and construct (single) robot 
-  if (strcasecmp(tree->name.c_str(), "Robot") == 0)
+  if (strcasecmp(tree->get_name().c_str(), "Robot") == 0)
   {
     URDFData data;
     if (!read_robot(tree, data, name, links, joints))
@@ -91,9 +56,6 @@ bool URDFREADER::read(const string& fname, std::string& name, vector<shared_ptr<
     return false;
   }
 
-  // change back to the initial working directory
-  chdir(cwd.get());
-
   return true;
 }
 
@@ -120,7 +82,7 @@ bool URDFREADER::read_from_string(const string& content, std::string& name, vect
   // ********************************************************************
 
   // read and construct (single) robot 
-  if (strcasecmp(tree->name.c_str(), "Robot") == 0)
+  if (strcasecmp(tree->get_name().c_str(), "Robot") == 0)
   {
     URDFData data;
     if (!read_robot(tree, data, name, links, joints))
@@ -135,6 +97,396 @@ bool URDFREADER::read_from_string(const string& content, std::string& name, vect
   return true;
 }
 
+/// Reads a URDF file in a single streaming pass and constructs all read objects
+/**
+ * Unlike read(), no XMLTree is built: the file is parsed with the libxml2
+ * xmlTextReader, links are constructed as they are read, and joints are 
+ * constructed (in file order) once all links have been read, using a hash 
+ * table from link names to links. The constructed links and joints are 
+ * identical to those constructed by read().
+ */
+bool URDFREADER::read_streaming(const string& fname, std::string& name, vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
+{
+  xmlTextReaderPtr raw_reader = xmlReaderForFile(fname.c_str(), NULL, 0);
+  if (!raw_reader)
+  {
+    std::cerr << "URDFReader::read_streaming() - unable to open file " << fname;
+    std::cerr << " for reading" << std::endl;
+    return false;
+  }
+
+  // the reader is freed even if reading throws
+  shared_ptr<xmlTextReader> reader(raw_reader, xmlFreeTextReader);
+  return read_stream(reader.get(), name, links, joints);
+}
+
+/// Reads an XML string in a single streaming pass and constructs all read objects
+/**
+ * \see read_streaming()
+ */
+bool URDFREADER::read_streaming_from_string(const string& content, std::string& name, vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
+{
+  xmlTextReaderPtr raw_reader = xmlReaderForMemory(content.c_str(), content.size(), "urdf.xml", NULL, 0);
+  if (!raw_reader)
+  {
+    std::cerr << "URDFReader::read_streaming() - unable to read xml content " << std::endl;
+    return false;
+  }
+
+  // the reader is freed even if reading throws
+  shared_ptr<xmlTextReader> reader(raw_reader, xmlFreeTextReader);
+  return read_stream(reader.get(), name, links, joints);
+}
+
+/// Reads several URDF files concurrently
+/**
+ * Each file is read with read_streaming() by one of a pool of threads; 
+ * the threads take the next unread file from a shared queue, so that 
+ * large and small models are balanced across the threads.
+ * \param fnames the names of the files to read
+ * \param names on return, names[i] is the name of the robot read from 
+ *        fnames[i]
+ * \param links on return, links[i] are the links read from fnames[i]
+ *        (empty if the file could not be read)
+ * \param joints on return, joints[i] are the joints read from fnames[i]
+ *        (empty if the file could not be read)
+ * \param nthreads the number of threads to use (0 uses one thread per 
+ *        online processor)
+ * \return the number of files read successfully
+ */
+unsigned URDFREADER::read_many(const vector<string>& fnames, vector<string>& names, vector<vector<shared_ptr<RIGIDBODY> > >& links, vector<vector<shared_ptr<JOINT> > >& joints, unsigned nthreads)
+{
+  // setup the output
+  names.clear();
+  links.clear();
+  joints.clear();
+  names.resize(fnames.size());
+  links.resize(fnames.size());
+  joints.resize(fnames.size());
+
+  // setup the queue
+  URDFReadQueue queue;
+  queue.fnames = &fnames;
+  queue.names = &names;
+  queue.links = &links;
+  queue.joints = &joints;
+  queue.success.resize(fnames.size(), 0);
+  queue.next = 0;
+  pthread_mutex_init(&queue.mutex, NULL);
+
+  // libxml2 must be initialized before it is used from multiple threads
+  xmlInitParser();
+
+  // determine the number of threads to use
+  if (nthreads == 0)
+  {
+    long nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = (nproc > 0) ? (unsigned) nproc : 1;
+  }
+  nthreads = std::min(nthreads, (unsigned) fnames.size());
+
+  // start the threads; the calling thread reads files too 
+  vector<pthread_t> threads;
+  for (unsigned i=1; i< nthreads; i++)
+  {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, &read_many_thread, &queue) == 0)
+      threads.push_back(thread);
+  }
+  read_many_thread(&queue);
+
+  // wait for the threads to finish
+  for (unsigned i=0; i< threads.size(); i++)
+    pthread_join(threads[i], NULL);
+  pthread_mutex_destroy(&queue.mutex);
+
+  // count the files read successfully
+  unsigned nread = 0;
+  for (unsigned i=0; i< fnames.size(); i++)
+    if (queue.success[i])
+      nread++;
+
+  return nread;
+}
+
+/// Reads files from the queue of read_many() until the queue is empty
+void* URDFREADER::read_many_thread(void* arg)
+{
+  URDFReadQueue& queue = *((URDFReadQueue*) arg);
+
+  while (true)
+  {
+    // get the next file to read
+    pthread_mutex_lock(&queue.mutex);
+    const unsigned i = queue.next++;
+    pthread_mutex_unlock(&queue.mutex);
+    if (i >= queue.fnames->size())
+      break;
+
+    // read the file; each file is written to separate outputs, and a file
+    // that cannot be parsed (even one that causes an exception) is only
+    // marked as unread
+    bool success;
+    try
+    {
+      success = read_streaming((*queue.fnames)[i], (*queue.names)[i], (*queue.links)[i], (*queue.joints)[i]);
+    }
+    catch (...)
+    {
+      std::cerr << "URDFReader::read_many() - exception thrown while reading " << (*queue.fnames)[i] << std::endl;
+      success = false;
+    }
+    if (success)
+      queue.success[i] = 1;
+    else
+    {
+      (*queue.links)[i].clear();
+      (*queue.joints)[i].clear();
+    }
+  }
+
+  return NULL;
+}
+
+/// Reads the string value of an attribute of the current element of a text reader
+static bool get_stream_attrib(xmlTextReaderPtr reader, const char* attrib_name, std::string& value)
+{
+  if (xmlTextReaderMoveToAttribute(reader, BAD_CAST attrib_name) != 1)
+    return false;
+  value = (const char*) xmlTextReaderConstValue(reader);
+  xmlTextReaderMoveToElement(reader);
+  return true;
+}
+
+/// Reads a space and/or comma delimited list of reals from an attribute of the current element of a text reader
+/**
+ * The values are parsed as XMLAttrib parses them (see NumberParser), so that
+ * the streaming and DOM-based readers agree.
+ * \return the number of values in the attribute (of which at most n are
+ *         stored)
+ */
+static unsigned get_stream_reals(xmlTextReaderPtr reader, const char* attrib_name, REAL* values, unsigned n)
+{
+  if (xmlTextReaderMoveToAttribute(reader, BAD_CAST attrib_name) != 1)
+    return 0;
+
+  // parse the values
+  const char* str = (const char*) xmlTextReaderConstValue(reader);
+  unsigned count = (str) ? NumberParser::parse_reals(str, str + std::strlen(str), values, n) : 0;
+
+  xmlTextReaderMoveToElement(reader);
+  return count;
+}
+
+/// Reads a three dimensional vector from an attribute of the current element of a text reader
+static bool get_stream_vector3(xmlTextReaderPtr reader, const char* attrib_name, ORIGIN3& v)
+{
+  REAL values[3];
+  unsigned n = get_stream_reals(reader, attrib_name, values, 3);
+  if (n == 0)
+    return false;
+  if (n != 3)
+    throw std::runtime_error("Unable to parse vector from attribute!");
+  v = ORIGIN3(values[0], values[1], values[2]);
+  return true;
+}
+
+/// Reads a robot from a text reader in a single pass
+bool URDFREADER::read_stream(xmlTextReaderPtr reader, std::string& name, vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
+{
+  const int ROBOT_DEPTH = 0, ELEMENT_DEPTH = 1, PROPERTY_DEPTH = 2, INERTIAL_DEPTH = 3;
+  URDFData data;
+  vector<URDFJointSpec> joint_specs;
+  bool robot_read = false, robot_named = false;
+
+  // the link or joint currently being read
+  shared_ptr<RIGIDBODY> link;
+  URDFJointSpec* joint = NULL;
+  bool in_inertial = false, inertial_read = false, mass_read = false;
+  bool inertia_read = false, origin_read = false;
+  bool parent_read = false, child_read = false, joint_origin_read = false;
+  REAL mass = (REAL) 0.0;
+  MATRIX3 inertia;
+  ORIGIN3 xyz, rpy;
+
+  // read all nodes
+  int status;
+  while ((status = xmlTextReaderRead(reader)) == 1)
+  {
+    const int type = xmlTextReaderNodeType(reader);
+    if (type != XML_READER_TYPE_ELEMENT && type != XML_READER_TYPE_END_ELEMENT)
+      continue;
+    const int depth = xmlTextReaderDepth(reader);
+    const char* element = (const char*) xmlTextReaderConstLocalName(reader);
+    const bool start = (type == XML_READER_TYPE_ELEMENT);
+    const bool end = !start || xmlTextReaderIsEmptyElement(reader);
+
+    // process the robot tag
+    if (depth == ROBOT_DEPTH && start)
+    {
+      if (strcasecmp(element, "Robot") != 0)
+      {
+        std::cerr << "URDFReader::read_streaming() error - root element of URDF is not a 'Robot' tag" << std::endl;
+        return false;
+      }
+      robot_read = true;
+      robot_named = get_stream_attrib(reader, "name", name);
+    }
+    // process link and joint tags
+    else if (depth == ELEMENT_DEPTH)
+    {
+      if (start && strcasecmp(element, "Link") == 0)
+      {
+        std::string link_id;
+        if (!get_stream_attrib(reader, "name", link_id))
+          std::cerr << "URDFReader::read_link() - link name not specified! not processing further..." << std::endl;
+        else
+        {
+          link = shared_ptr<RIGIDBODY>(new RIGIDBODY);
+          link->body_id = link_id;
+          inertial_read = false;
+        }
+      }
+      else if (start && strcasecmp(element, "Joint") == 0)
+      {
+        joint_specs.push_back(URDFJointSpec());
+        joint = &joint_specs.back();
+        parent_read = child_read = joint_origin_read = false;
+        get_stream_attrib(reader, "name", joint->name);
+        get_stream_attrib(reader, "type", joint->type);
+      }
+
+      // finish the link or joint 
+      if (end && link)
+      {
+        links.push_back(link);
+        data.link_ids.insert(make_pair(link->body_id, link));
+        link.reset();
+      }
+      if (end)
+        joint = NULL;
+    }
+    // process properties of links (inertial) and joints
+    else if (depth == PROPERTY_DEPTH && link)
+    {
+      if (start && !inertial_read && strcasecmp(element, "inertial") == 0)
+      {
+        in_inertial = true;
+        mass_read = inertia_read = origin_read = false;
+        mass = (REAL) 0.0;
+        inertia.set_zero();
+        xyz.set_zero();
+        rpy.set_zero();
+      }
+      if (end && in_inertial)
+      {
+        set_inertial(data, link, mass, inertia, POSE3(QUAT::rpy(rpy[0], rpy[1], rpy[2]), xyz));
+        in_inertial = false;
+        inertial_read = true;
+      }
+    }
+    else if (depth == PROPERTY_DEPTH && joint && start)
+    {
+      if (!parent_read && strcasecmp(element, "parent") == 0)
+        parent_read = get_stream_attrib(reader, "link", joint->parent);
+      else if (!child_read && strcasecmp(element, "child") == 0)
+        child_read = get_stream_attrib(reader, "link", joint->child);
+      else if (!joint_origin_read && strcasecmp(element, "origin") == 0)
+      {
+        get_stream_vector3(reader, "xyz", joint->xyz);
+        get_stream_vector3(reader, "rpy", joint->rpy);
+        joint_origin_read = true;
+      }
+      else if (strcasecmp(element, "axis") == 0 && get_stream_vector3(reader, "xyz", joint->axis))
+        joint->axis_specified = true;
+    }
+    // process inertial properties
+    else if (depth == INERTIAL_DEPTH && in_inertial && start)
+    {
+      if (!mass_read && strcasecmp(element, "mass") == 0)
+        mass_read = (get_stream_reals(reader, "value", &mass, 1) == 1);
+      else if (!inertia_read && strcasecmp(element, "inertia") == 0)
+      {
+        const unsigned X = 0, Y = 1, Z = 2;
+        get_stream_reals(reader, "ixx", &inertia(X,X), 1);
+        get_stream_reals(reader, "iyy", &inertia(Y,Y), 1);
+        get_stream_reals(reader, "izz", &inertia(Z,Z), 1);
+        get_stream_reals(reader, "ixy", &inertia(X,Y), 1);
+        get_stream_reals(reader, "ixz", &inertia(X,Z), 1);
+        get_stream_reals(reader, "iyz", &inertia(Y,Z), 1);
+        inertia(Y,X) = inertia(X,Y);
+        inertia(Z,X) = inertia(X,Z);
+        inertia(Z,Y) = inertia(Y,Z);
+        inertia_read = true;
+      }
+      else if (!origin_read && strcasecmp(element, "origin") == 0)
+      {
+        get_stream_vector3(reader, "xyz", xyz);
+        get_stream_vector3(reader, "rpy", rpy);
+        origin_read = true;
+      }
+    }
+  }
+
+  // check for parse errors
+  if (status != 0)
+  {
+    std::cerr << "URDFReader::read_streaming() - error parsing XML" << std::endl;
+    return false;
+  }
+  if (!robot_read)
+  {
+    std::cerr << "URDFReader::read_streaming() error - root element of URDF is not a 'Robot' tag" << std::endl;
+    return false;
+  }
+  if (!robot_named)
+  {
+    std::cerr << "URDFReader::read_robot() - robot name not specified! not processing further..." << std::endl;
+    return false;
+  }
+
+  // construct the joints
+  for (unsigned i=0; i< joint_specs.size(); i++)
+  {
+    const URDFJointSpec& spec = joint_specs[i];
+    if (spec.name.empty())
+    {
+      std::cerr << "URDFReader::read_joint() - joint name not specified! not processing further..." << std::endl;
+      continue;
+    }
+    if (spec.type.empty())
+    {
+      std::cerr << "URDFReader::read_joint() - joint type not specified! not processing further..." << std::endl;
+      continue;
+    }
+    shared_ptr<JOINT> joint = create_joint(spec.type);
+    if (!joint)
+      continue;
+    joint->joint_id = spec.name;
+
+    // find the inboard and outboard links
+    boost::unordered_map<string, shared_ptr<RIGIDBODY> >::const_iterator inboard = data.link_ids.find(spec.parent);
+    if (inboard == data.link_ids.end())
+    {
+      std::cerr << "URDFReader::read_joint() - failed to properly read parent link! not processing further..." << std::endl;
+      continue;
+    }
+    boost::unordered_map<string, shared_ptr<RIGIDBODY> >::const_iterator outboard = data.link_ids.find(spec.child);
+    if (outboard == data.link_ids.end())
+    {
+      std::cerr << "URDFReader::read_joint() - failed to properly read child link! not processing further..." << std::endl;
+      continue;
+    }
+
+    // setup the joint
+    attach_joint(data, joint, inboard->second, outboard->second, POSE3(QUAT::rpy(spec.rpy[0], spec.rpy[1], spec.rpy[2]), spec.xyz));
+    set_axis(joint, VECTOR3(spec.axis, FRAME_PTR()), spec.axis_specified);
+    joints.push_back(joint);
+  }
+
+  return true;
+}
+
 /// Reads and constructs a robot object
 bool URDFREADER::read_robot(shared_ptr<const XMLTree> node, URDFData& data, string& name, vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
 {
@@ -144,7 +496,7 @@ bool URDFREADER::read_robot(shared_ptr<const XMLTree> node, URDFData& data, stri
   {
     name = name_attrib->get_string_value();
     read_links(node, data, links);
-    read_joints(node, data, links, joints);
+    read_joints(node, data, joints);
   }
   else
   {
@@ -158,24 +510,24 @@ bool URDFREADER::read_robot(shared_ptr<const XMLTree> node, URDFData& data, stri
 /// Reads robot links
 void URDFREADER::read_links(shared_ptr<const XMLTree> node, URDFData& data, vector<shared_ptr<RIGIDBODY> >& links)
 {
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("link");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
     read_link(*i, data, links);
 }
 
 /// Reads robot joints 
-void URDFREADER::read_joints(shared_ptr<const XMLTree> node, URDFData& data, const vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
+void URDFREADER::read_joints(shared_ptr<const XMLTree> node, URDFData& data, vector<shared_ptr<JOINT> >& joints)
 {
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
-    read_joint(*i, data, links, joints);
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("joint");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
+    read_joint(*i, data, joints);
 }
 
 /// Attempts to read a robot link from the given node
 void URDFREADER::read_link(shared_ptr<const XMLTree> node, URDFData& data, vector<shared_ptr<RIGIDBODY> >& links)
 {
   // see whether the node name is correct
-  if (strcasecmp(node->name.c_str(), "Link") != 0)
+  if (strcasecmp(node->get_name().c_str(), "Link") != 0)
     return;
 
   // link must have the name attribute
@@ -192,6 +544,7 @@ void URDFREADER::read_link(shared_ptr<const XMLTree> node, URDFData& data, vecto
 
   // add the link to the set of links
   links.push_back(link);
+  data.link_ids.insert(make_pair(link->body_id, link));
 }
 
 /// Finds all children of the given link
@@ -289,14 +642,13 @@ void URDFREADER::output_data(const URDFData& data, shared_ptr<RIGIDBODY> link)
 }
 
 /// Attempts to read a robot joint from the given node
-void URDFREADER::read_joint(shared_ptr<const XMLTree> node, URDFData& data, const vector<shared_ptr<RIGIDBODY> >& links, vector<shared_ptr<JOINT> >& joints)
+void URDFREADER::read_joint(shared_ptr<const XMLTree> node, URDFData& data, vector<shared_ptr<JOINT> >& joints)
 {
-  const shared_ptr<const POSE3> GLOBAL;
   shared_ptr<JOINT> joint;
   shared_ptr<RIGIDBODY> inboard, outboard;
 
   // see whether the node name is correct
-  if (strcasecmp(node->name.c_str(), "Joint") != 0)
+  if (strcasecmp(node->get_name().c_str(), "Joint") != 0)
     return;
 
   // link must have the name attribute
@@ -316,66 +668,78 @@ void URDFREADER::read_joint(shared_ptr<const XMLTree> node, URDFData& data, cons
   }
 
   // read and construct the joint
-  if (strcasecmp(type_attrib->get_string_value().c_str(), "revolute") == 0)
-  {
-    shared_ptr<REVOLUTEJOINT> rj(new REVOLUTEJOINT);
-    joint = rj;
-  }
-  else if (strcasecmp(type_attrib->get_string_value().c_str(), "continuous") == 0)
-  {
-    shared_ptr<REVOLUTEJOINT> rj(new REVOLUTEJOINT);
-    joint = rj;
-  }
-  else if (strcasecmp(type_attrib->get_string_value().c_str(), "prismatic") == 0)
-  {
-    shared_ptr<PRISMATICJOINT> pj(new PRISMATICJOINT);
-    joint = pj;
-  }
-  else if (strcasecmp(type_attrib->get_string_value().c_str(), "fixed") == 0)
-    joint = shared_ptr<FIXEDJOINT>(new FIXEDJOINT);
-  else if (strcasecmp(type_attrib->get_string_value().c_str(), "floating") == 0)
-  {
-    std::cerr << "URDFReader::read_joint() - [deprecated] floating joint type specified! not processing further..." << std::endl;
+  if (!(joint = create_joint(type_attrib->get_string_value())))
     return;
-  }
-  else if (strcasecmp(type_attrib->get_string_value().c_str(), "planar") == 0)
-  {
-    std::cerr << "URDFReader::read_joint() - planar joint type currently unsupported in Ravelin! not processing further..." << std::endl;
-    return;
-  }
-  else
-  {
-    std::cerr << "URDFReader::read_joint() - invalid joint type specified! not processing further..." << std::endl;
-    return;
-  }
 
   // read and verify required properties
   joint->joint_id = name_attrib->get_string_value();
-  if (!(inboard = read_parent(node, data, links)))
+  if (!(inboard = read_parent(node, data)))
   {
     std::cerr << "URDFReader::read_joint() - failed to properly read parent link! not processing further..." << std::endl;
     return;
   }
-  if (!(outboard = read_child(node, data, links)))
+  if (!(outboard = read_child(node, data)))
   {
     std::cerr << "URDFReader::read_joint() - failed to properly read child link! not processing further..." << std::endl;
     return;
   }
 
+  // setup the joint frame, the outboard link pose, and the links of the joint
+  attach_joint(data, joint, inboard, outboard, read_origin(node, data));
+
+  // read optional properties
+  read_axis(node, data, joint);
+
+  // add the joint to the set of joints 
+  joints.push_back(joint);
+}
+
+/// Constructs a joint of the given URDF type
+/**
+ * \return the joint, or a null pointer if the type is invalid or unsupported
+ */
+shared_ptr<JOINT> URDFREADER::create_joint(const string& type)
+{
+  if (strcasecmp(type.c_str(), "revolute") == 0)
+    return shared_ptr<REVOLUTEJOINT>(new REVOLUTEJOINT);
+  else if (strcasecmp(type.c_str(), "continuous") == 0)
+    return shared_ptr<REVOLUTEJOINT>(new REVOLUTEJOINT);
+  else if (strcasecmp(type.c_str(), "prismatic") == 0)
+    return shared_ptr<PRISMATICJOINT>(new PRISMATICJOINT);
+  else if (strcasecmp(type.c_str(), "fixed") == 0)
+    return shared_ptr<FIXEDJOINT>(new FIXEDJOINT);
+  else if (strcasecmp(type.c_str(), "floating") == 0)
+    std::cerr << "URDFReader::read_joint() - [deprecated] floating joint type specified! not processing further..." << std::endl;
+  else if (strcasecmp(type.c_str(), "planar") == 0)
+    std::cerr << "URDFReader::read_joint() - planar joint type currently unsupported in Ravelin! not processing further..." << std::endl;
+  else
+    std::cerr << "URDFReader::read_joint() - invalid joint type specified! not processing further..." << std::endl;
+
+  return shared_ptr<JOINT>();
+}
+
+/// Sets up the frame of a joint, the pose of its outboard link, and its links 
+/**
+ * \param origin the joint frame, relative to the inboard link frame
+ */
+void URDFREADER::attach_joint(URDFData& data, shared_ptr<JOINT> joint, shared_ptr<RIGIDBODY> inboard, shared_ptr<RIGIDBODY> outboard, const POSE3& origin)
+{
+  const shared_ptr<const POSE3> GLOBAL;
+
   // setup the appropriate pointers
   data.joint_parent[joint] = inboard;
   data.joint_child[joint] = outboard;
 
   // joint frame is defined relative to the parent link frame
-  shared_ptr<POSE3> origin(new POSE3(read_origin(node, data)));
-  origin->rpose = inboard->get_pose(); 
-  VECTOR3 location_origin(0.0, 0.0, 0.0, origin);
+  shared_ptr<POSE3> joint_origin(new POSE3(origin));
+  joint_origin->rpose = inboard->get_pose(); 
+  VECTOR3 location_origin(0.0, 0.0, 0.0, joint_origin);
   VECTOR3 location = POSE3::transform_point(GLOBAL, location_origin);
 
   // setup a second pose, which is the inertial frame
   assert(data.inertial_poses.find(outboard) != data.inertial_poses.end());
   shared_ptr<POSE3> inertial_frame(new POSE3(*data.inertial_poses[outboard]));
-  inertial_frame->rpose = origin;
+  inertial_frame->rpose = joint_origin;
 
   // update the outboard link pose
   inertial_frame->update_relative_pose(outboard->get_pose()->rpose);
@@ -383,59 +747,47 @@ void URDFREADER::read_joint(shared_ptr<const XMLTree> node, URDFData& data, cons
 
   // setup the inboard and outboard links for the joint
   joint->set_location(location, inboard, outboard);
-
-  // read optional properties
-  read_axis(node, data, joint);
-
-  // add the joint to the set of joints 
-  joints.push_back(joint);
 }
 
 /// Attempts to read the parent for the joint
-shared_ptr<RIGIDBODY> URDFREADER::read_parent(shared_ptr<const XMLTree> node, URDFData& data, const vector<shared_ptr<RIGIDBODY> >& links)
+shared_ptr<RIGIDBODY> URDFREADER::read_parent(shared_ptr<const XMLTree> node, URDFData& data)
 {
   // look for the tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("parent");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "parent") == 0)
-    {
-      // read the link attribute
-      XMLAttrib* link_attrib = (*i)->get_attrib("link");
-      if (!link_attrib)
-        continue;
-      string link_id = link_attrib->get_string_value();
-
-      // find parent link
-      for (unsigned j=0; j< links.size(); j++)
-        if (links[j]->body_id == link_id)
-          return links[j];
-    }
+    // read the link attribute
+    XMLAttrib* link_attrib = (*i)->get_attrib("link");
+    if (!link_attrib)
+      continue;
+    string link_id = link_attrib->get_string_value();
+
+    // find parent link
+    boost::unordered_map<string, shared_ptr<RIGIDBODY> >::const_iterator j = data.link_ids.find(link_id);
+    if (j != data.link_ids.end())
+      return j->second;
   }
 
   return shared_ptr<RIGIDBODY>();
 }
 
 /// Attempts to read the child for the joint
-shared_ptr<RIGIDBODY> URDFREADER::read_child(shared_ptr<const XMLTree> node, URDFData& data, const vector<shared_ptr<RIGIDBODY> >& links)
+shared_ptr<RIGIDBODY> URDFREADER::read_child(shared_ptr<const XMLTree> node, URDFData& data)
 {
   // look for the tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("child");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "child") == 0)
-    {
-      // read the link attribute
-      XMLAttrib* link_attrib = (*i)->get_attrib("link");
-      if (!link_attrib)
-        continue;
-      string link_id = link_attrib->get_string_value();
-
-      // find child link
-      for (unsigned j=0; j< links.size(); j++)
-        if (links[j]->body_id == link_id)
-          return links[j];
-    }
+    // read the link attribute
+    XMLAttrib* link_attrib = (*i)->get_attrib("link");
+    if (!link_attrib)
+      continue;
+    string link_id = link_attrib->get_string_value();
+
+    // find child link
+    boost::unordered_map<string, shared_ptr<RIGIDBODY> >::const_iterator j = data.link_ids.find(link_id);
+    if (j != data.link_ids.end())
+      return j->second;
   }
 
   return shared_ptr<RIGIDBODY>();
@@ -448,23 +800,28 @@ void URDFREADER::read_axis(shared_ptr<const XMLTree> node, URDFData& data, share
   bool axis_specified = false;
 
   // look for the axis tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("axis");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "axis") == 0)
-    {
-      // read the attributes first
-      XMLAttrib* xyz_attrib = (*i)->get_attrib("xyz");
-      if (!xyz_attrib)
-        continue;
-      xyz_attrib->get_vector_value(axis);
-      axis_specified = true;
-    }
+    // read the attributes first
+    XMLAttrib* xyz_attrib = (*i)->get_attrib("xyz");
+    if (!xyz_attrib)
+      continue;
+    xyz_attrib->get_vector_value(axis);
+    axis_specified = true;
   }
 
-  // get the outboard link - it's pose is identical to the joint pose
-  shared_ptr<RIGIDBODY> outboard = joint->get_outboard_link();
+  set_axis(joint, axis, axis_specified);
+}
 
+/// Sets the axis of a revolute or prismatic joint
+/**
+ * \param axis the axis (in the joint frame)
+ * \param axis_specified whether the axis was read (used to warn about an 
+ *        axis specified for a joint without one)
+ */
+void URDFREADER::set_axis(shared_ptr<JOINT> joint, VECTOR3 axis, bool axis_specified)
+{
   // setup the axis frame
   axis.pose = joint->get_pose();
 
@@ -487,43 +844,44 @@ void URDFREADER::read_axis(shared_ptr<const XMLTree> node, URDFData& data, share
 /// Attempts to read and set link inertial properties 
 void URDFREADER::read_inertial(shared_ptr<const XMLTree> node, URDFData& data, shared_ptr<RIGIDBODY> link)
 {
-  // setup linear algebra object
-  LINALG LA;
-
   // look for the inertial tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("inertial");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "inertial") == 0)
-    {
-      REAL mass = read_mass(*i, data);
-      MATRIX3 inertia = read_inertia(*i, data);
+    set_inertial(data, link, read_mass(*i, data), read_inertia(*i, data), read_origin(*i, data));
 
-      // verify that inertial properties are good
-      MATRIX3 inertia_copy = inertia;
-      if (mass <= 0.0 || !LA.is_SPD(inertia_copy, -1.0))
-        link->set_enabled(false); 
+    // reading inertial was a success, attempt to read no further...
+    // (multiple inertial tags not supported)
+    return;
+  }
+}
 
-      // read the inertial frame
-      shared_ptr<POSE3> origin(new POSE3(read_origin(*i, data)));
+/// Sets link inertial properties
+/**
+ * \param origin the inertial frame, relative to the link frame
+ */
+void URDFREADER::set_inertial(URDFData& data, shared_ptr<RIGIDBODY> link, REAL mass, const MATRIX3& inertia, const POSE3& origin)
+{
+  // setup linear algebra object
+  LINALG LA;
 
-      // set the inertial frame relative to the link frame
-      origin->rpose = link->get_pose();
+  // verify that inertial properties are good
+  MATRIX3 inertia_copy = inertia;
+  if (mass <= 0.0 || !LA.is_SPD(inertia_copy, -1.0))
+    link->set_enabled(false); 
 
-      // set inertial properties
-      SPATIAL_RB_INERTIA J(link->get_pose());
-      J.m = mass;
-      J.J = inertia;
-      link->set_inertia(J);
+  // set the inertial frame relative to the link frame
+  shared_ptr<POSE3> inertial_origin(new POSE3(origin));
+  inertial_origin->rpose = link->get_pose();
 
-      // add the inertial pose data
-      data.inertial_poses[link] = origin;
+  // set inertial properties
+  SPATIAL_RB_INERTIA J(link->get_pose());
+  J.m = mass;
+  J.J = inertia;
+  link->set_inertia(J);
 
-      // reading inertial was a success, attempt to read no further...
-      // (multiple inertial tags not supported)
-      return;
-    }
-  }
+  // add the inertial pose data
+  data.inertial_poses[link] = inertial_origin;
 }
 
 /// Attempts to read an "origin" tag
@@ -537,25 +895,22 @@ POSE3 URDFREADER::read_origin(shared_ptr<const XMLTree> node, URDFData& data)
   rpy.set_zero();
 
   // look for the tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("origin");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "origin") == 0)
-    {
-      // look for xyz attribute 
-      XMLAttrib* xyz_attrib = (*i)->get_attrib("xyz");
-      if (xyz_attrib)
-        xyz_attrib->get_origin_value(xyz);
-
-      // look for rpy attribute
-      XMLAttrib* rpy_attrib = (*i)->get_attrib("rpy");
-      if (rpy_attrib)
-        rpy_attrib->get_vector_value(rpy);
-
-      // reading tag was a success, attempt to read no further...
-      // (multiple such tags not supported)
-      break;
-    }
+    // look for xyz attribute 
+    XMLAttrib* xyz_attrib = (*i)->get_attrib("xyz");
+    if (xyz_attrib)
+      xyz_attrib->get_origin_value(xyz);
+
+    // look for rpy attribute
+    XMLAttrib* rpy_attrib = (*i)->get_attrib("rpy");
+    if (rpy_attrib)
+      rpy_attrib->get_vector_value(rpy);
+
+    // reading tag was a success, attempt to read no further...
+    // (multiple such tags not supported)
+    break;
   }
 
   QUAT rpy_quat = QUAT::rpy(rpy[0], rpy[1], rpy[2]);
@@ -563,29 +918,26 @@ POSE3 URDFREADER::read_origin(shared_ptr<const XMLTree> node, URDFData& data)
 }
 
 /// Attempts to read a "mass" tag
-double URDFREADER::read_mass(shared_ptr<const XMLTree> node, URDFData& data)
+REAL URDFREADER::read_mass(shared_ptr<const XMLTree> node, URDFData& data)
 {
   // look for the tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("mass");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "mass") == 0)
+    // look for the "value" attribute
+    XMLAttrib* value_attrib = (*i)->get_attrib("value");
+    if (value_attrib)
     {
-      // look for the "value" attribute
-      XMLAttrib* value_attrib = (*i)->get_attrib("value");
-      if (value_attrib)
-      {
-        // reading tag was a success, attempt to read no further...
-        // (multiple such tags not supported)
-        double value;
-        value_attrib->get_real_value(value);
-        return value; 
-      }
+      // reading tag was a success, attempt to read no further...
+      // (multiple such tags not supported)
+      REAL value;
+      value_attrib->get_real_value(value);
+      return value; 
     }
   }
 
   // couldn't find the tag.. return 0
-  return 0.0;
+  return (REAL) 0.0;
 }
 
 /// Attempts to read an "inertia" tag
@@ -597,46 +949,43 @@ MATRIX3 URDFREADER::read_inertia(shared_ptr<const XMLTree> node, URDFData& data)
   MATRIX3 J = MATRIX3::zero();
 
   // look for the tag
-  const list<shared_ptr<XMLTree> >& child_nodes = node->children;
-  for (list<shared_ptr<XMLTree> >::const_iterator i = child_nodes.begin(); i != child_nodes.end(); i++)
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = node->find_children("inertia");
+  for (XMLTree::ChildIterator i = range.first; i != range.second; i++)
   {
-    if (strcasecmp((*i)->name.c_str(), "inertia") == 0)
+    // look for the six attributes
+    XMLAttrib* ixx_attrib = (*i)->get_attrib("ixx");
+    XMLAttrib* ixy_attrib = (*i)->get_attrib("ixy");
+    XMLAttrib* ixz_attrib = (*i)->get_attrib("ixz");
+    XMLAttrib* iyy_attrib = (*i)->get_attrib("iyy");
+    XMLAttrib* iyz_attrib = (*i)->get_attrib("iyz");
+    XMLAttrib* izz_attrib = (*i)->get_attrib("izz");
+
+    // set values from present attributes
+    if (ixx_attrib)
+       ixx_attrib->get_real_value(J(X,X));
+    if (iyy_attrib)
+      iyy_attrib->get_real_value(J(Y,Y));
+    if (izz_attrib)
+      izz_attrib->get_real_value(J(Z,Z));
+    if (ixy_attrib)
     {
-      // look for the six attributes
-      XMLAttrib* ixx_attrib = (*i)->get_attrib("ixx");
-      XMLAttrib* ixy_attrib = (*i)->get_attrib("ixy");
-      XMLAttrib* ixz_attrib = (*i)->get_attrib("ixz");
-      XMLAttrib* iyy_attrib = (*i)->get_attrib("iyy");
-      XMLAttrib* iyz_attrib = (*i)->get_attrib("iyz");
-      XMLAttrib* izz_attrib = (*i)->get_attrib("izz");
-
-      // set values from present attributes
-      if (ixx_attrib)
-         ixx_attrib->get_real_value(J(X,X));
-      if (iyy_attrib)
-        iyy_attrib->get_real_value(J(Y,Y));
-      if (izz_attrib)
-        izz_attrib->get_real_value(J(Z,Z));
-      if (ixy_attrib)
-      {
-        ixy_attrib->get_real_value(J(X,Y));
-        J(Y,X) = J(X,Y);
-      }
-      if (ixz_attrib)
-      {
-        ixz_attrib->get_real_value(J(X,Z));
-        J(Z,X) = J(X,Z);
-      } 
-      if (iyz_attrib)
-      {
-        iyz_attrib->get_real_value(J(Y,Z));
-        J(Z,Y) = J(Y,Z);
-      }
-
-      // reading tag was a success, attempt to read no further...
-      // (multiple such tags not supported)
-      return J;
+      ixy_attrib->get_real_value(J(X,Y));
+      J(Y,X) = J(X,Y);
     }
+    if (ixz_attrib)
+    {
+      ixz_attrib->get_real_value(J(X,Z));
+      J(Z,X) = J(X,Z);
+    } 
+    if (iyz_attrib)
+    {
+      iyz_attrib->get_real_value(J(Y,Z));
+      J(Z,Y) = J(Y,Z);
+    }
+
+    // reading tag was a success, attempt to read no further...
+    // (multiple such tags not supported)
+    return J;
   }
 
   // no inertia read.. return default J (0 matrix)
@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <unistd.h>
 #include <fstream>
 #include <iostream>
 #include <stack>
@@ -19,6 +20,7 @@
 #include <Ravelin/SphericalJointd.h>
 #include <Ravelin/UniversalJointd.h>
 #include <Ravelin/XMLTree.h>
+#include <Ravelin/NumberParser.h>
 #include <Ravelin/SpatialRBInertiad.h>
 #include <Ravelin/URDFReaderd.h>
 
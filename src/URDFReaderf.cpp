@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <unistd.h>
 #include <fstream>
 #include <iostream>
 #include <stack>
@@ -19,6 +20,7 @@
 #include <Ravelin/SphericalJointf.h>
 #include <Ravelin/UniversalJointf.h>
 #include <Ravelin/XMLTree.h>
+#include <Ravelin/NumberParser.h>
 #include <Ravelin/SpatialRBInertiaf.h>
 #include <Ravelin/URDFReaderf.h>
 
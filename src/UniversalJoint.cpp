@@ -376,4 +376,20 @@ void UNIVERSALJOINT::evaluate_constraints(REAL C[])
   C[3] = h1.dot(h2);
 }
 
+/// Creates a copy of this joint, with copies of its frames (see JOINT::copy())
+JOINT* UNIVERSALJOINT::copy(PoseMap& poses) const
+{
+  UNIVERSALJOINT* joint = new UNIVERSALJOINT(*this);
+  joint->copy_frames(poses);
+  return joint;
+}
 
+/// Makes the vectors of this (copied) joint refer to the copied frames (see JOINT::remap_frames())
+void UNIVERSALJOINT::remap_frames(const PoseMap& poses)
+{
+  JOINT::remap_frames(poses);
+  remap_frame(_u[0], poses);
+  remap_frame(_u[1], poses);
+  remap_frame(_h2, poses);
+  remap_frame(_s_dot, poses);
+}
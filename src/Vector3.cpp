@@ -5,7 +5,7 @@
  ****************************************************************************/
 
 /// Constructs this vector with the given values
-VECTOR3::VECTOR3(REAL x, REAL y, REAL z, boost::shared_ptr<const POSE3> pose)
+VECTOR3::VECTOR3(REAL x, REAL y, REAL z, FRAME_PTR pose)
 {
   const unsigned X = 0, Y = 1, Z = 2;
   _data[X] = x;
@@ -28,7 +28,7 @@ VECTOR3::VECTOR3(REAL x, REAL y, REAL z, boost::shared_ptr<POSE3> pose)
 /**
  * \param array a 3-dimensional (or larger) array
  */
-VECTOR3::VECTOR3(const REAL* array, boost::shared_ptr<const POSE3> pose)
+VECTOR3::VECTOR3(const REAL* array, FRAME_PTR pose)
 {
   const unsigned X = 0, Y = 1, Z = 2;
   _data[X] = array[X];
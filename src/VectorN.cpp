@@ -293,66 +293,18 @@ VECTORN& VECTORN::concat(const VECTORN& v1, const VECTORN& v2, VECTORN& result)
 }
 
 /// Parses a string for a vector value
+/**
+ * Values may be separated by whitespace and/or commas; the string is read
+ * in a single pass (see NumberParser), independently of the current locale.
+ */
 VECTORN& VECTORN::parse(const std::string& s, VECTORN& values)
 {
-  std::list<std::string> plist;
-
-  // look for trivial case
-  if (s.size() == 0)
-  {
-    values.resize(0);
-    return values;
-  }
-
-  // make a copy of the string
-  std::string copy = s;
-
-  while (true)
-  {
-    // get the portion of the string before the delimiter
-    size_t space_idx = copy.find_first_of(" \t");
-    size_t comma_idx = copy.find(',');
-        
-    // case 1: no delimiter found
-    if (space_idx == std::string::npos && comma_idx == std::string::npos)
-    {
-      plist.push_back(copy);
-      break;
-    }
-        
-    // case 2: delimiter found
-    if ((space_idx != std::string::npos && space_idx < comma_idx) || comma_idx == std::string::npos)
-    {
-      plist.push_back(copy.substr(0,space_idx));
-      copy = copy.substr(space_idx);
-    }
-    else
-    {
-      plist.push_back(copy.substr(0,comma_idx));
-      copy = copy.substr(comma_idx);
-    }
-        
-    // get the new string
-    size_t firstidx = copy.find_first_not_of(" ,");
-    if (firstidx == std::string::npos)
-      break;
-    else
-      copy = copy.substr(firstidx);        
-  }
-
-  // convert the list to a Vector
-  values.resize(plist.size());
-  unsigned idx = 0;
-  for (std::list<std::string>::const_iterator i=plist.begin(); i != plist.end(); i++)
-  {
-    if (strcasecmp(i->c_str(), "inf") == 0)
-      values[idx] = std::numeric_limits<REAL>::infinity();
-    else if (strcasecmp(i->c_str(), "-inf") == 0)
-      values[idx] = -std::numeric_limits<REAL>::infinity();
-    else
-      values[idx] = (REAL) atof(i->c_str());
-    idx++;
-  }
+  const char* begin = s.c_str();
+  const char* end = begin + s.size();
+
+  // size the vector, then read the values directly into it
+  values.resize(NumberParser::count_reals(begin, end));
+  NumberParser::parse_reals(begin, end, values.data(), values.size());
   
   return values;  
 }
@@ -10,6 +10,7 @@
 #include <Ravelin/Vector3d.h>
 #include <Ravelin/MatrixNd.h>
 #include <Ravelin/VectorNd.h>
+#include <Ravelin/NumberParser.h>
 
 using namespace Ravelin;
 
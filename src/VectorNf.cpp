@@ -10,6 +10,7 @@
 #include <Ravelin/Vector3f.h>
 #include <Ravelin/MatrixNf.h>
 #include <Ravelin/VectorNf.h>
+#include <Ravelin/NumberParser.h>
 
 using namespace Ravelin;
 
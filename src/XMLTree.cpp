@@ -11,8 +11,10 @@
 #include <limits>
 #include <cmath>
 #include <sstream>
+#include <boost/functional/hash.hpp>
 #include <Ravelin/MatrixNd.h>
 #include <Ravelin/MissizeException.h>
+#include <Ravelin/NumberParser.h>
 #include <Ravelin/XMLTree.h>
 
 using boost::shared_ptr;
@@ -67,7 +69,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Origin3d& o)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << o[0] << " " << o[1] << " " << o[2];
+  oss << str(o[0]) << " " << str(o[1]) << " " << str(o[2]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -77,7 +79,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Origin3f& o)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << o[0] << " " << o[1] << " " << o[2];
+  oss << str(o[0]) << " " << str(o[1]) << " " << str(o[2]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -87,7 +89,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Vector2d& v)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << v[0] << " " << v[1];
+  oss << str(v[0]) << " " << str(v[1]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -97,7 +99,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Vector2f& v)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << v[0] << " " << v[1];
+  oss << str(v[0]) << " " << str(v[1]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -107,7 +109,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Vector3d& v)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << v[0] << " " << v[1] << " " << v[2];
+  oss << str(v[0]) << " " << str(v[1]) << " " << str(v[2]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -117,7 +119,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Vector3f& v)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << v[0] << " " << v[1] << " " << v[2];
+  oss << str(v[0]) << " " << str(v[1]) << " " << str(v[2]);
   this->value = oss.str();
   this->processed = false;
 }
@@ -127,7 +129,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Quatd& q)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << q.w << " " << q.x << " " << q.y << " " << q.z;
+  oss << str(q.w) << " " << str(q.x) << " " << str(q.y) << " " << str(q.z);
   this->value = oss.str();
   this->processed = false;
 }
@@ -137,7 +139,7 @@ XMLAttrib::XMLAttrib(const std::string& name, const Quatf& q)
 {
   this->name = name;
   std::ostringstream oss;
-  oss << q.w << " " << q.x << " " << q.y << " " << q.z;
+  oss << str(q.w) << " " << str(q.x) << " " << str(q.y) << " " << str(q.z);
   this->value = oss.str();
   this->processed = false;
 }
@@ -372,33 +374,109 @@ XMLAttrib::XMLAttrib(const std::string& name, long long_value)
   this->value = oss.str();
 }
 
-/// Gets a real value as a string
-std::string XMLAttrib::str(double value)
+/// Formats a real value with the fewest of the given numbers of significant digits that reads back exactly
+template <class Real>
+static std::string format_real(Real value, int digits, int round_trip_digits)
 {
-  if (value == std::numeric_limits<double>::infinity())
+  if (value == std::numeric_limits<Real>::infinity())
     return std::string("inf");
-  else if (value == -std::numeric_limits<double>::infinity())
+  else if (value == -std::numeric_limits<Real>::infinity())
     return std::string("-inf");
-  else
-  {
-    std::ostringstream oss;
-    oss << value;
-    return oss.str();
-  }
+
+  // the short form reads better, but only the long form is guaranteed to
+  // read back exactly 
+  std::ostringstream oss;
+  oss.imbue(std::locale::classic());
+  oss.precision(digits);
+  oss << value;
+  std::string str = oss.str();
+  Real readback = value;
+  NumberParser::parse_real(str.c_str(), str.c_str() + str.size(), readback);
+  if (readback == value || value != value)
+    return str;
+
+  oss.str("");
+  oss.precision(round_trip_digits);
+  oss << value;
+  return oss.str();
+}
+
+/// Gets a real value as a string
+/**
+ * The string is written in the "C" locale, with enough digits that 
+ * get_real_value() reads back the same value.
+ */
+std::string XMLAttrib::str(double value)
+{
+  return format_real(value, std::numeric_limits<double>::digits10, 17);
 }
 
 /// Gets a real value as a string
+/**
+ * The string is written in the "C" locale, with enough digits that 
+ * get_real_value() reads back the same value.
+ */
 std::string XMLAttrib::str(float value)
 {
-  if (value == std::numeric_limits<double>::infinity())
-    return std::string("inf");
-  else if (value == -std::numeric_limits<double>::infinity())
-    return std::string("-inf");
-  else
+  return format_real(value, std::numeric_limits<float>::digits10, 9);
+}
+
+/// Reads exactly n real values from a string, without allocating 
+template <class Real>
+static bool parse_reals(const std::string& str, Real* values, unsigned n)
+{
+  const char* s = str.c_str();
+  return NumberParser::parse_reals(s, s + str.size(), values, n) == n;
+}
+
+/// Determines the size of a matrix stored as a string
+/**
+ * Rows are separated by semicolons and the values in each row by whitespace
+ * and/or commas; empty rows are ignored.
+ * \return <b>false</b> if the rows are not all of the same size
+ */
+static bool matrix_size(const std::string& str, unsigned& rows, unsigned& columns)
+{
+  const char* s = str.c_str();
+  const char* end = s + str.size();
+
+  rows = columns = 0;
+  for (const char* row = s; row < end; row++)
+  {
+    const char* row_end = std::find(row, end, ';');
+    unsigned n = NumberParser::count_reals(row, row_end);
+    if (n > 0)
+    {
+      if (rows > 0 && n != columns)
+        return false;
+      columns = n;
+      rows++;
+    }
+    row = row_end;
+  }
+
+  return true;
+}
+
+/// Reads a matrix stored as a string directly into a matrix of the proper size (see matrix_size())
+template <class M>
+static void read_matrix(const std::string& str, M& m)
+{
+  const char* s = str.c_str();
+  const char* end = s + str.size();
+
+  unsigned r = 0;
+  for (const char* row = s; row < end; row++)
   {
-    std::ostringstream oss;
-    oss << value;
-    return oss.str();
+    const char* row_end = std::find(row, end, ';');
+    if (NumberParser::count_reals(row, row_end) > 0)
+    {
+      const char* t = row;
+      for (unsigned c = 0; c < m.columns(); c++)
+        t = NumberParser::parse_real(t, row_end, m(r,c));
+      r++;
+    }
+    row = row_end;
   }
 }
 
@@ -408,12 +486,8 @@ void XMLAttrib::get_real_value(double& value)
   // indicate this attribute has been processed
   processed = true;
 
-  if (strcasecmp(this->value.c_str(), "inf") == 0)
-    value = std::numeric_limits<double>::infinity();
-  else if (strcasecmp(this->value.c_str(), "-inf") == 0)
-    value = -std::numeric_limits<double>::infinity();
-  else
-    value = (double) std::atof(this->value.c_str());
+  if (!NumberParser::parse_real(this->value.c_str(), this->value.c_str() + this->value.size(), value))
+    value = (double) 0.0;
 }
 
 /// Gets a floating point value from the underlying string representation
@@ -422,12 +496,8 @@ void XMLAttrib::get_real_value(float& value)
   // indicate this attribute has been processed
   processed = true;
 
-  if (strcasecmp(this->value.c_str(), "inf") == 0)
-    value = std::numeric_limits<float>::infinity();
-  else if (strcasecmp(this->value.c_str(), "-inf") == 0)
-    value = -std::numeric_limits<float>::infinity();
-  else
-    value = (float) std::atof(this->value.c_str());
+  if (!NumberParser::parse_real(this->value.c_str(), this->value.c_str() + this->value.size(), value))
+    value = (float) 0.0;
 }
 
 /// Gets a Boolean value from the underlying string representation
@@ -611,22 +681,22 @@ void XMLAttrib::get_origin_value(Origin3d& o)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd v = VectorNd::parse(value);
-  if (v.size() != 3)
+  double v[3];
+  if (!parse_reals(value, v, 3))
     throw std::runtime_error("Unable to parse origin from vector!");
   o.x() = v[0];
   o.y() = v[1];
   o.z() = v[2];
 }
 
-/// Returns an Origin3d value from the attribute
+/// Returns an Origin3f value from the attribute
 void XMLAttrib::get_origin_value(Origin3f& o) 
 {
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf v = VectorNf::parse(value);
-  if (v.size() != 3)
+  float v[3];
+  if (!parse_reals(value, v, 3))
     throw std::runtime_error("Unable to parse origin from vector!");
   o.x() = v[0];
   o.y() = v[1];
@@ -639,8 +709,8 @@ void XMLAttrib::get_quat_value(Quatd& q)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd v = VectorNd::parse(value);
-  if (v.size() != 4)
+  double v[4];
+  if (!parse_reals(value, v, 4))
     throw std::runtime_error("Unable to parse quaternion from vector!");
   q.w = v[0];
   q.x = v[1];
@@ -654,8 +724,8 @@ void XMLAttrib::get_quat_value(Quatf& q)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf v = VectorNf::parse(value);
-  if (v.size() != 4)
+  float v[4];
+  if (!parse_reals(value, v, 4))
     throw std::runtime_error("Unable to parse quaternion from vector!");
   q.w = v[0];
   q.x = v[1];
@@ -669,8 +739,8 @@ void XMLAttrib::get_rpy_value(Quatd& q)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd v = VectorNd::parse(value);
-  if (v.size() != 3)
+  double v[3];
+  if (!parse_reals(value, v, 3))
     throw std::runtime_error("Unable to parse roll-pitch-yaw from vector!");
   q = Quatd::rpy(v[0], v[1], v[2]);
 }
@@ -681,8 +751,8 @@ void XMLAttrib::get_rpy_value(Quatf& q)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf v = VectorNf::parse(value);
-  if (v.size() != 3)
+  float v[3];
+  if (!parse_reals(value, v, 3))
     throw std::runtime_error("Unable to parse roll-pitch-yaw from vector!");
   q = Quatf::rpy(v[0], v[1], v[2]);
 }
@@ -693,10 +763,8 @@ void XMLAttrib::get_vector_value(Vector2d& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd w = VectorNd::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = Vector2d(w[0], w[1]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited vectors from the underlying string value
@@ -705,10 +773,8 @@ void XMLAttrib::get_vector_value(Vector2f& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf w = VectorNf::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = Vector2f(w[0], w[1]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited vectors from the underlying string value
@@ -717,10 +783,8 @@ void XMLAttrib::get_vector_value(Vector3d& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd w = VectorNd::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = Vector3d(w[0], w[1], w[2]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited vectors from the underlying string value
@@ -729,10 +793,8 @@ void XMLAttrib::get_vector_value(Vector3f& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf w = VectorNf::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = Vector3f(w[0], w[1], w[2]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited vectors from the underlying string value
@@ -741,10 +803,8 @@ void XMLAttrib::get_vector_value(SVector6d& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNd w = VectorNd::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = SVector6d(w[0], w[1], w[2], w[3], w[4], w[5]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited vectors from the underlying string value
@@ -753,10 +813,8 @@ void XMLAttrib::get_vector_value(SVector6f& v)
   // indicate this attribute has been processed
   processed = true;
 
-  VectorNf w = VectorNf::parse(value);
-  if (w.size() != v.size())
+  if (!parse_reals(value, v.data(), v.size()))
     throw MissizeException();
-  v = SVector6f(w[0], w[1], w[2], w[3], w[4], w[5]);
 }  
 
 /// Gets a list of space-delimited and/or comma-delimited strings from the underlying string value
@@ -765,11 +823,10 @@ void XMLAttrib::get_matrix_value(Matrix3d& m)
   // indicate this attribute has been processed
   processed = true;
 
-  MatrixNd n;
-  get_matrix_value(n);
-  if (n.rows() != m.rows() || n.columns() != m.rows())
+  unsigned rows, columns;
+  if (!matrix_size(value, rows, columns) || rows != m.rows() || columns != m.columns())
     throw MissizeException();
-  m = Matrix3d(n.data());
+  read_matrix(value, m);
 } 
 
 /// Gets a list of space-delimited and/or comma-delimited strings from the underlying string value
@@ -778,11 +835,10 @@ void XMLAttrib::get_matrix_value(Matrix3f& m)
   // indicate this attribute has been processed
   processed = true;
 
-  MatrixNf n;
-  get_matrix_value(n);
-  if (n.rows() != m.rows() || n.columns() != m.rows())
+  unsigned rows, columns;
+  if (!matrix_size(value, rows, columns) || rows != m.rows() || columns != m.columns())
     throw MissizeException();
-  m = Matrix3f(n.data());
+  read_matrix(value, m);
 } 
 
 /// Gets a list of space-delimited and/or comma-delimited strings from the underlying string value
@@ -791,93 +847,18 @@ void XMLAttrib::get_matrix_value(MatrixNd& m)
   // indicate this attribute has been processed
   processed = true;
 
-  // construct the list of properties
-  std::list<std::list<std::string> > plist;
-  std::list<std::string> clist;
-
-  // extract all space-delimited, comma-delimited, and semi-colon-delimited substrings
-  std::string copy = this->value;
-  while (true)
+  // verify that all rows are the same length
+  unsigned rows, columns;
+  if (!matrix_size(value, rows, columns))
   {
-    // get the portion of the string before the delimiter
-    size_t space_idx = copy.find_first_of("  \t");
-    size_t comma_idx = copy.find(',');
-    size_t semicolon_idx = copy.find(';');
-        
-    // case 1: no delimiter found
-    if (space_idx == std::string::npos && comma_idx == std::string::npos && semicolon_idx == std::string::npos)
-    {
-      clist.push_back(copy);
-      plist.push_back(clist);
-      break;
-    }
-        
-    // convert not founds to maximums for sorting
-    if (space_idx == std::string::npos)
-      space_idx = std::numeric_limits<int>::max();
-    if (comma_idx == std::string::npos)
-      comma_idx = std::numeric_limits<int>::max();
-    if (semicolon_idx == std::string::npos)
-      semicolon_idx = std::numeric_limits<int>::max();
-        
-    // case 2: semicolon delimiter found first
-    if (semicolon_idx < space_idx && semicolon_idx <  comma_idx)
-    {
-      clist.push_back(copy.substr(0,semicolon_idx));
-      plist.push_back(clist);
-      clist = std::list<std::string>();
-      copy = copy.substr(semicolon_idx);
-    }    
-    // case 3: space delimiter found first
-    else if (space_idx < semicolon_idx && space_idx < comma_idx)
-    {
-      clist.push_back(copy.substr(0,space_idx));
-      copy = copy.substr(space_idx);
-    }
-    // case 4: comma delimiter found first
-    else if (comma_idx < semicolon_idx && space_idx > comma_idx)
-    {
-      clist.push_back(copy.substr(0,comma_idx));
-      copy = copy.substr(comma_idx);
-    }
-        
-    // get the new string
-    size_t firstidx = copy.find_first_not_of(" ,;");
-    if (firstidx == std::string::npos)
-      break;
-    else
-      copy = copy.substr(firstidx);        
+    std::cerr << "XMLAttrib::get_matrix_value() - rows are not of the same size!" << std::endl << "  offending string: " << value << std::endl;
+    m.resize(0,0);
+    return;
   }
 
-  // convert the lists to a Matrix
-  // first, verify that all vectors are the same length
-  unsigned len = plist.front().size();
-  for (std::list<std::list<std::string> >::const_iterator i = plist.begin(); i != plist.end(); i++)
-    if (i->size() != len)
-    {
-      std::cerr << "XMLAttrib::get_matrix_value() - rows are not of the same size!" << std::endl << "  offending string: " << value << std::endl;
-      m.resize(0,0);
-      return;
-    }
-      
-  // resize the matrix
-  m.resize(plist.size(), plist.front().size());
-  unsigned r = 0;
-  for (std::list<std::list<std::string> >::const_iterator i = plist.begin(); i != plist.end(); i++)
-  {
-    unsigned s = 0;
-    for (std::list<std::string>::const_iterator j = i->begin(); j != i->end(); j++)
-    {
-      if (strcasecmp(j->c_str(), "inf") == 0)
-        m(r,s) = std::numeric_limits<double>::infinity();
-      else if (strcasecmp(j->c_str(), "-inf") == 0)
-        m(r,s) = -std::numeric_limits<double>::infinity();
-      else
-        m(r,s) = (double) atof(j->c_str());
-      s++;
-    }
-    r++;
-  }
+  // read the values directly into the matrix
+  m.resize(rows, columns);
+  read_matrix(value, m);
 }
 
 /// Gets a list of space-delimited and/or comma-delimited strings from the underlying string value
@@ -886,93 +867,18 @@ void XMLAttrib::get_matrix_value(MatrixNf& m)
   // indicate this attribute has been processed
   processed = true;
 
-  // construct the list of properties
-  std::list<std::list<std::string> > plist;
-  std::list<std::string> clist;
-
-  // extract all space-delimited, comma-delimited, and semi-colon-delimited substrings
-  std::string copy = this->value;
-  while (true)
+  // verify that all rows are the same length
+  unsigned rows, columns;
+  if (!matrix_size(value, rows, columns))
   {
-    // get the portion of the string before the delimiter
-    size_t space_idx = copy.find_first_of("  \t");
-    size_t comma_idx = copy.find(',');
-    size_t semicolon_idx = copy.find(';');
-        
-    // case 1: no delimiter found
-    if (space_idx == std::string::npos && comma_idx == std::string::npos && semicolon_idx == std::string::npos)
-    {
-      clist.push_back(copy);
-      plist.push_back(clist);
-      break;
-    }
-        
-    // convert not founds to maximums for sorting
-    if (space_idx == std::string::npos)
-      space_idx = std::numeric_limits<int>::max();
-    if (comma_idx == std::string::npos)
-      comma_idx = std::numeric_limits<int>::max();
-    if (semicolon_idx == std::string::npos)
-      semicolon_idx = std::numeric_limits<int>::max();
-        
-    // case 2: semicolon delimiter found first
-    if (semicolon_idx < space_idx && semicolon_idx <  comma_idx)
-    {
-      clist.push_back(copy.substr(0,semicolon_idx));
-      plist.push_back(clist);
-      clist = std::list<std::string>();
-      copy = copy.substr(semicolon_idx);
-    }    
-    // case 3: space delimiter found first
-    else if (space_idx < semicolon_idx && space_idx < comma_idx)
-    {
-      clist.push_back(copy.substr(0,space_idx));
-      copy = copy.substr(space_idx);
-    }
-    // case 4: comma delimiter found first
-    else if (comma_idx < semicolon_idx && space_idx > comma_idx)
-    {
-      clist.push_back(copy.substr(0,comma_idx));
-      copy = copy.substr(comma_idx);
-    }
-        
-    // get the new string
-    size_t firstidx = copy.find_first_not_of(" ,;");
-    if (firstidx == std::string::npos)
-      break;
-    else
-      copy = copy.substr(firstidx);        
+    std::cerr << "XMLAttrib::get_matrix_value() - rows are not of the same size!" << std::endl << "  offending string: " << value << std::endl;
+    m.resize(0,0);
+    return;
   }
 
-  // convert the lists to a Matrix
-  // first, verify that all vectors are the same length
-  unsigned len = plist.front().size();
-  for (std::list<std::list<std::string> >::const_iterator i = plist.begin(); i != plist.end(); i++)
-    if (i->size() != len)
-    {
-      std::cerr << "XMLAttrib::get_matrix_value() - rows are not of the same size!" << std::endl << "  offending string: " << value << std::endl;
-      m.resize(0,0);
-      return;
-    }
-      
-  // resize the matrix
-  m.resize(plist.size(), plist.front().size());
-  unsigned r = 0;
-  for (std::list<std::list<std::string> >::const_iterator i = plist.begin(); i != plist.end(); i++)
-  {
-    unsigned s = 0;
-    for (std::list<std::string>::const_iterator j = i->begin(); j != i->end(); j++)
-    {
-      if (strcasecmp(j->c_str(), "inf") == 0)
-        m(r,s) = std::numeric_limits<double>::infinity();
-      else if (strcasecmp(j->c_str(), "-inf") == 0)
-        m(r,s) = -std::numeric_limits<double>::infinity();
-      else
-        m(r,s) = (double) atof(j->c_str());
-      s++;
-    }
-    r++;
-  }
+  // read the values directly into the matrix
+  m.resize(rows, columns);
+  read_matrix(value, m);
 }
 
 /// Sends the specified XMLAttrib to the given stream
@@ -984,20 +890,41 @@ std::ostream& Ravelin::operator<<(std::ostream& out, const XMLAttrib& attr)
 }
 
 /// Constructs a XMLTree with no attributes
-XMLTree::XMLTree(const std::string& name)
+XMLTree::XMLTree(const std::string& name) : name(_name), children(_children)
 {
   this->processed = false;
-  this->name = name;
+  _name = name;
 }
 
 /// Constructs a XMLTree with the specified list of attributes
-XMLTree::XMLTree(const std::string& name, const std::list<XMLAttrib>& attributes)
+XMLTree::XMLTree(const std::string& name, const std::list<XMLAttrib>& attributes) : name(_name), children(_children)
 {
-  this->name = name;
+  _name = name;
   this->attribs = std::set<XMLAttrib>(attributes.begin(), attributes.end());
   this->processed = false;
 }
 
+/// Copies a XMLTree (the copy shares the children of the original)
+XMLTree::XMLTree(const XMLTree& tree) : boost::enable_shared_from_this<XMLTree>(tree), name(_name), children(_children)
+{
+  operator=(tree);
+}
+
+/// Copies a XMLTree (the copy shares the children of the original)
+XMLTree& XMLTree::operator=(const XMLTree& tree)
+{
+  attribs = tree.attribs;
+  id = tree.id;
+  content = tree.content;
+  object = tree.object;
+  processed = tree.processed;
+  _name = tree._name;
+  _children = tree._children;
+  _child_index = tree._child_index;
+  _parent = tree._parent;
+  return *this;
+}
+
 /// Gets the specified attribute
 /**
  * \return a pointer to the attribute with the specified name, or NULL if the
@@ -1005,87 +932,124 @@ XMLTree::XMLTree(const std::string& name, const std::list<XMLAttrib>& attributes
  */
 XMLAttrib* XMLTree::get_attrib(const std::string& attrib_name) const
 {
-  // construct an empty attribute
-  XMLAttrib attr(attrib_name, "");
-
-  // look for the attribute
-  std::set<XMLAttrib>::const_iterator attrib_iter = this->attribs.find(attr);
+  // nodes have only a handful of attributes, so a scan is fast and avoids
+  // constructing an attribute to search with
+  for (std::set<XMLAttrib>::const_iterator i = this->attribs.begin(); i != this->attribs.end(); i++)
+    if (i->name == attrib_name)
+      return (XMLAttrib*) &(*i);
 
-  // return the appropriate value
-  return (attrib_iter == this->attribs.end()) ? NULL : (XMLAttrib*) &(*attrib_iter);
+  return NULL;
 }
 
-/// Returns a list of all child nodes (not including further descendants) matching any of the names in the given list (case insensitive)
-std::list<shared_ptr<const XMLTree> > XMLTree::find_child_nodes(const std::list<std::string>& names) const
+/// Hashes a node name, ignoring case
+std::size_t XMLTree::NameHash::operator()(const std::string& name) const
 {
-  std::list<shared_ptr<const XMLTree> > matches;
+  std::size_t seed = 0;
+  for (std::string::const_iterator i = name.begin(); i != name.end(); i++)
+    boost::hash_combine(seed, std::tolower((unsigned char) *i));
+  return seed;
+}
 
-  // construct a set out of the list of names -- all names are converted to
-  // lowercase first
-  std::set<std::string> names_set;
-  for (std::list<std::string>::const_iterator i = names.begin(); i != names.end(); i++)
-  {
-    // copy the string
-    std::string name = *i;
+/// Compares two node names, ignoring case
+bool XMLTree::NameEqual::operator()(const std::string& name1, const std::string& name2) const
+{
+  return name1.size() == name2.size() && strcasecmp(name1.c_str(), name2.c_str()) == 0;
+}
 
-    // make it lowercase
-    std::transform(name.begin(), name.end(), name.begin(), (int(*)(int)) std::tolower);
+/// Adds a child tree to this tree; also sets the parent node
+void XMLTree::add_child(shared_ptr<XMLTree> child)
+{
+  _children.push_back(child);
+  _child_index[child->_name].push_back(child);
+  child->set_parent(shared_from_this());
+}
 
-    // add it to the set
-    names_set.insert(name);
+/// Renames this node; the parent node (if any) indexes it under the new name
+void XMLTree::set_name(const std::string& name)
+{
+  std::string old_name = _name;
+  _name = name;
+  shared_ptr<XMLTree> parent = _parent.lock();
+  if (parent)
+  {
+    parent->reindex_children(old_name);
+    parent->reindex_children(name);
   }
+}
 
-  // now, look over all nodes, transforming node names to lowercase, and 
-  // checking for a match
-  for (std::list<shared_ptr<XMLTree> >::const_iterator i = this->children.begin(); i != this->children.end(); i++)
-  {
-    // get the name of the node, lowercased
-    std::string node_name = (*i)->name;
-    std::transform(node_name.begin(), node_name.end(), node_name.begin(), (int(*)(int)) std::tolower);
-    
-    // check for a match against the set of names
-    if (names_set.find(node_name) != names_set.end())
+/// Rebuilds the entry of the child index for the given name from the children
+void XMLTree::reindex_children(const std::string& name)
+{
+  std::vector<shared_ptr<XMLTree> > matches;
+  for (std::list<shared_ptr<XMLTree> >::const_iterator i = _children.begin(); i != _children.end(); i++)
+    if (NameEqual()((*i)->_name, name))
       matches.push_back(*i);
-  }  
+  if (matches.empty())
+    _child_index.erase(name);
+  else
+    _child_index[name].swap(matches);
+}
 
-  return matches;
+/// Gets the range of child nodes (not including further descendants) matching the given name (case insensitive), in document order
+/**
+ * The range is valid until another child is added to this node (or a
+ * child is renamed).
+ */
+std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> XMLTree::find_children(const std::string& name) const
+{
+  static const std::vector<shared_ptr<XMLTree> > EMPTY;
+
+  boost::unordered_map<std::string, std::vector<shared_ptr<XMLTree> >, NameHash, NameEqual>::const_iterator i = _child_index.find(name);
+  if (i == _child_index.end())
+    return std::make_pair(EMPTY.begin(), EMPTY.end());
+  return std::make_pair(i->second.begin(), i->second.end());
 }
 
-/// Returns a list of all child nodes (not including further descendants) matching the given name (case insensitive)
-std::list<shared_ptr<const XMLTree> > XMLTree::find_child_nodes(const std::string& name) const
+/// Gets the first child node (not including further descendants) matching the given name (case insensitive)
+/**
+ * \return the child node, or a null pointer if there is no such child
+ */
+shared_ptr<const XMLTree> XMLTree::find_child(const std::string& name) const
+{
+  std::pair<ChildIterator, ChildIterator> range = find_children(name);
+  return (range.first == range.second) ? shared_ptr<const XMLTree>() : *range.first;
+}
+
+/// Returns a list of all child nodes (not including further descendants) matching any of the names in the given list (case insensitive)
+std::list<shared_ptr<const XMLTree> > XMLTree::find_child_nodes(const std::list<std::string>& names) const
 {
   std::list<shared_ptr<const XMLTree> > matches;
 
-  // convert the name to lowercase
-  std::string name_lower = name;
-  std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(), (int(*)(int)) std::tolower);
-
-  // search for a match
-  for (std::list<shared_ptr<XMLTree> >::const_iterator i = this->children.begin(); i != this->children.end(); i++)
-  {
-    // convert the node name to lowercase
-    std::string node_name = (*i)->name;
-    std::transform(node_name.begin(), node_name.end(), node_name.begin(), (int(*)(int)) std::tolower);
-    
-    // check for equality
-    if (name_lower == node_name)
-      matches.push_back(*i);
-  }
+  // look over all nodes, checking for a match against any of the names
+  for (std::list<shared_ptr<XMLTree> >::const_iterator i = _children.begin(); i != _children.end(); i++)
+    for (std::list<std::string>::const_iterator j = names.begin(); j != names.end(); j++)
+      if (NameEqual()((*i)->_name, *j))
+      {
+        matches.push_back(*i);
+        break;
+      }
 
   return matches;
 }
 
+/// Returns a list of all child nodes (not including further descendants) matching the given name (case insensitive)
+std::list<shared_ptr<const XMLTree> > XMLTree::find_child_nodes(const std::string& name) const
+{
+  std::pair<ChildIterator, ChildIterator> range = find_children(name);
+  return std::list<shared_ptr<const XMLTree> >(range.first, range.second);
+}
+
 /// Sends the specified XMLTree node to the given stream
 std::ostream& Ravelin::operator<<(std::ostream& out, const XMLTree& node)
 {
   // get the list of child nodes
-  const std::list<shared_ptr<XMLTree> >& child_nodes = node.children; 
+  const std::list<shared_ptr<XMLTree> >& child_nodes = node.get_children(); 
   
   // get the set of attributes for this node
   const std::set<XMLAttrib>& attribs = node.attribs;
 
   // write the start of the tag, the node name, and the attributes
-  out << "<" << node.name << " ";
+  out << "<" << node.get_name() << " ";
   for (std::set<XMLAttrib>::const_iterator i = attribs.begin(); i != attribs.end(); i++)
     out << *i << " ";
 
@@ -1102,7 +1066,7 @@ std::ostream& Ravelin::operator<<(std::ostream& out, const XMLTree& node)
       out << **i;
 
     // close this tag
-    out << "</" << node.name << ">" << std::endl;
+    out << "</" << node.get_name() << ">" << std::endl;
   }
 
   return out;
@@ -0,0 +1,582 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "blocked_blas.h"
+
+using std::vector;
+using std::min;
+using std::max;
+
+// register block (micro-kernel) sizes
+static const int MR = 4, NR = 4;
+
+// cache block sizes: an MC x KC block of A is sized for the L2 cache and a
+// KC x NC block of B for the L3 cache; NT is the width of the column strips
+// of C distributed among threads
+static const int MC = 128, KC = 256, NC = 4096, NT = 256;
+
+// block size for the blocked triangular solve and factorizations
+static const int NB = 64;
+
+/// Gets the maximum number of threads used by the kernels
+static int max_threads()
+{
+  #ifdef _OPENMP
+  return omp_get_max_threads();
+  #else
+  return 1;
+  #endif
+}
+
+/// Gets the index of the calling thread
+static int thread_id()
+{
+  #ifdef _OPENMP
+  return omp_get_thread_num();
+  #else
+  return 0;
+  #endif
+}
+
+/// Gets a work buffer for the packed blocks of A (one per thread) or B
+template <class T>
+static T* work_buffer(vector<T>& buf, unsigned n)
+{
+  if (buf.size() < n)
+    buf.resize(n);
+  return &buf.front();
+}
+
+/// Packs the mc x kc block of op(A) starting at (i0, p0) into row panels of height MR
+template <class T>
+static void pack_A(CBLAS_TRANSPOSE trans, int mc, int kc, const T* A, int lda, int i0, int p0, T* ap)
+{
+  for (int ir=0; ir< mc; ir += MR)
+  {
+    const int mr = min(MR, mc-ir);
+    for (int p=0; p< kc; p++, ap += MR)
+    {
+      int i=0;
+      if (trans == CblasNoTrans)
+        for (const T* a = A + (i0+ir) + (p0+p)*lda; i< mr; i++)
+          ap[i] = a[i];
+      else
+        for (const T* a = A + (p0+p) + (i0+ir)*lda; i< mr; i++)
+          ap[i] = a[i*lda];
+      for (; i< MR; i++)
+        ap[i] = (T) 0.0;
+    }
+  }
+}
+
+/// Packs the kc x nc block of op(B) starting at (p0, j0) into column panels of width NR
+template <class T>
+static void pack_B(CBLAS_TRANSPOSE trans, int kc, int nc, const T* B, int ldb, int p0, int j0, T* bp)
+{
+  for (int jr=0; jr< nc; jr += NR)
+  {
+    const int nr = min(NR, nc-jr);
+    for (int p=0; p< kc; p++, bp += NR)
+    {
+      int j=0;
+      if (trans == CblasNoTrans)
+        for (const T* b = B + (p0+p) + (j0+jr)*ldb; j< nr; j++)
+          bp[j] = b[j*ldb];
+      else
+        for (const T* b = B + (j0+jr) + (p0+p)*ldb; j< nr; j++)
+          bp[j] = b[j];
+      for (; j< NR; j++)
+        bp[j] = (T) 0.0;
+    }
+  }
+}
+
+/// Computes C += alpha * a * b, where a is a packed MR x kc panel and b is a packed kc x NR panel; only the leading mr x nr part of C is updated
+template <class T>
+static void micro_kernel(int kc, const T* a, const T* b, T alpha, T* C, int ldc, int mr, int nr)
+{
+  T ab[MR*NR];
+  std::fill(ab, ab+MR*NR, (T) 0.0);
+
+  // accumulate the rank-kc update
+  for (int p=0; p< kc; p++, a += MR, b += NR)
+    for (int j=0; j< NR; j++)
+    {
+      const T bj = b[j];
+      for (int i=0; i< MR; i++)
+        ab[i+j*MR] += a[i]*bj;
+    }
+
+  // update C
+  for (int j=0; j< nr; j++)
+    for (int i=0; i< mr; i++)
+      C[i+j*ldc] += alpha*ab[i+j*MR];
+}
+
+/// Computes C = alpha*op(A)*op(B) + beta*C
+/**
+ * The loops over C are blocked so that packed blocks of A and B stay in
+ * cache; the mc x NT tiles of C within each block are distributed among
+ * threads.
+ */
+template <class T>
+void BlockedBLAS::gemm(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int M, int N, int K, T alpha, const T* A, int lda, const T* B, int ldb, T beta, T* C, int ldc)
+{
+  if (M <= 0 || N <= 0)
+    return;
+
+  // scale C by beta
+  if (beta != (T) 1.0)
+    for (int j=0; j< N; j++)
+    {
+      T* c = C + j*ldc;
+      if (beta == (T) 0.0)
+        std::fill(c, c+M, (T) 0.0);
+      else
+        for (int i=0; i< M; i++)
+          c[i] *= beta;
+    }
+
+  // look for easy out
+  if (K <= 0 || alpha == (T) 0.0)
+    return;
+
+  // get the packing buffers
+  #ifdef REENTRANT
+  vector<T> Abuf, Bbuf;
+  #else
+  static vector<T> Abuf, Bbuf;
+  #endif
+  const int KCMAX = min(KC, K);
+  T* Bp = work_buffer(Bbuf, KCMAX*((min(NC, N) + NR - 1)/NR)*NR);
+  T* Ap = work_buffer(Abuf, KCMAX*((min(MC, M) + MR - 1)/MR)*MR*max_threads());
+  const int ASTRIDE = KCMAX*((min(MC, M) + MR - 1)/MR)*MR;
+
+  for (int jc=0; jc< N; jc += NC)
+  {
+    const int nc = min(NC, N-jc);
+    for (int pc=0; pc< K; pc += KC)
+    {
+      const int kc = min(KC, K-pc);
+
+      // pack the block of B (shared by all threads)
+      pack_B(transB, kc, nc, B, ldb, pc, jc, Bp);
+
+      // distribute the tiles of C among threads
+      const int mtiles = (M + MC - 1)/MC;
+      const int ntiles = (nc + NT - 1)/NT;
+      const int ntasks = mtiles*ntiles;
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic) if (ntasks > 1 && (double) M*nc*kc > 1e6)
+      #endif
+      for (int t=0; t< ntasks; t++)
+      {
+        const int ic = (t % mtiles)*MC;
+        const int jt = (t / mtiles)*NT;
+        const int mc = min(MC, M-ic);
+        const int nt = min(NT, nc-jt);
+
+        // pack the block of A
+        T* ap = Ap + thread_id()*ASTRIDE;
+        pack_A(transA, mc, kc, A, lda, ic, pc, ap);
+
+        // compute the tile using the micro-kernel
+        for (int jr=0; jr< nt; jr += NR)
+          for (int ir=0; ir< mc; ir += MR)
+            micro_kernel(kc, ap + ir*kc, Bp + (jt+jr)*kc, alpha, C + (ic+ir) + (jc+jt+jr)*ldc, ldc, min(MR, mc-ir), min(NR, nt-jr));
+      }
+    }
+  }
+}
+
+/// Computes the upper or lower triangle of C = alpha*op(A)*op(A)' + beta*C
+/**
+ * Off-diagonal blocks are computed directly by gemm(); diagonal blocks are
+ * computed into a temporary so that the opposite triangle of C is not
+ * referenced.
+ * \param trans if CblasNoTrans, op(A) = A (N x K); otherwise, op(A) = A' (A is K x N)
+ */
+template <class T>
+void BlockedBLAS::syrk(CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int N, int K, T alpha, const T* A, int lda, T beta, T* C, int ldc)
+{
+  if (N <= 0)
+    return;
+
+  // get the temporary for diagonal blocks
+  #ifdef REENTRANT
+  vector<T> Dbuf;
+  #else
+  static vector<T> Dbuf;
+  #endif
+  const int SB = MC;
+  T* D = work_buffer(Dbuf, SB*SB);
+
+  // setup the transposition of the second factor
+  const CBLAS_TRANSPOSE transT = (trans == CblasNoTrans) ? CblasTrans : CblasNoTrans;
+
+  for (int j0=0; j0< N; j0 += SB)
+  {
+    const int jb = min(SB, N-j0);
+
+    // pointer to rows (or columns, if transposed) j0.. of op(A)
+    const T* Aj = (trans == CblasNoTrans) ? A + j0 : A + j0*lda;
+
+    // compute the off-diagonal block in this block column
+    if (uplo == CblasUpper && j0 > 0)
+      gemm(trans, transT, j0, jb, K, alpha, A, lda, Aj, lda, beta, C + j0*ldc, ldc);
+    else if (uplo == CblasLower && j0+jb < N)
+    {
+      const T* Ai = (trans == CblasNoTrans) ? A + (j0+jb) : A + (j0+jb)*lda;
+      gemm(trans, transT, N-j0-jb, jb, K, alpha, Ai, lda, Aj, lda, beta, C + (j0+jb) + j0*ldc, ldc);
+    }
+
+    // compute the diagonal block and update the proper triangle
+    gemm(trans, transT, jb, jb, K, alpha, Aj, lda, Aj, lda, (T) 0.0, D, jb);
+    for (int j=0; j< jb; j++)
+    {
+      T* c = C + j0 + (j0+j)*ldc;
+      const int i0 = (uplo == CblasUpper) ? 0 : j;
+      const int i1 = (uplo == CblasUpper) ? j+1 : jb;
+      for (int i=i0; i< i1; i++)
+        c[i] = ((beta == (T) 0.0) ? (T) 0.0 : beta*c[i]) + D[i+j*jb];
+    }
+  }
+}
+
+/// Solves op(A)*X = B (left) or X*op(A) = B (right) for a small triangular A, in place
+template <class T>
+static void trsm_unblocked(CBLAS_SIDE side, bool lower, CBLAS_TRANSPOSE trans, CBLAS_DIAG diag, int M, int N, const T* A, int lda, T* B, int ldb)
+{
+  const bool unit = (diag == CblasUnit);
+  const bool notrans = (trans == CblasNoTrans);
+
+  // op(A) is lower triangular if A is lower triangular and not transposed
+  // (or upper triangular and transposed)
+  const bool oplower = (lower == notrans);
+
+  if (side == CblasLeft)
+  {
+    // solve for each column of B independently: op(A)*x = b
+    #ifdef _OPENMP
+    #pragma omp parallel for if ((double) M*M*N > 1e6)
+    #endif
+    for (int j=0; j< N; j++)
+    {
+      T* x = B + j*ldb;
+      if (oplower)
+        for (int i=0; i< M; i++)
+        {
+          T sum = x[i];
+          for (int k=0; k< i; k++)
+            sum -= ((notrans) ? A[i+k*lda] : A[k+i*lda]) * x[k];
+          x[i] = (unit) ? sum : sum / A[i+i*lda];
+        }
+      else
+        for (int i=M-1; i>= 0; i--)
+        {
+          T sum = x[i];
+          for (int k=i+1; k< M; k++)
+            sum -= ((notrans) ? A[i+k*lda] : A[k+i*lda]) * x[k];
+          x[i] = (unit) ? sum : sum / A[i+i*lda];
+        }
+    }
+  }
+  else
+  {
+    // solve for each row of B independently: x'*op(A) = b'
+    #ifdef _OPENMP
+    #pragma omp parallel for if ((double) M*N*N > 1e6)
+    #endif
+    for (int r=0; r< M; r++)
+    {
+      T* x = B + r;
+      if (!oplower)
+        for (int c=0; c< N; c++)
+        {
+          T sum = x[c*ldb];
+          for (int k=0; k< c; k++)
+            sum -= x[k*ldb] * ((notrans) ? A[k+c*lda] : A[c+k*lda]);
+          x[c*ldb] = (unit) ? sum : sum / A[c+c*lda];
+        }
+      else
+        for (int c=N-1; c>= 0; c--)
+        {
+          T sum = x[c*ldb];
+          for (int k=c+1; k< N; k++)
+            sum -= x[k*ldb] * ((notrans) ? A[k+c*lda] : A[c+k*lda]);
+          x[c*ldb] = (unit) ? sum : sum / A[c+c*lda];
+        }
+    }
+  }
+}
+
+/// Solves op(A)*X = alpha*B (left) or X*op(A) = alpha*B (right), where A is triangular; B is overwritten by X
+/**
+ * Diagonal blocks are solved directly and the remainder of B is updated
+ * using gemm().
+ */
+template <class T>
+void BlockedBLAS::trsm(CBLAS_SIDE side, CBLAS_UPLO uplo, CBLAS_TRANSPOSE transA, CBLAS_DIAG diag, int M, int N, T alpha, const T* A, int lda, T* B, int ldb)
+{
+  if (M <= 0 || N <= 0)
+    return;
+
+  // scale B by alpha
+  if (alpha != (T) 1.0)
+    for (int j=0; j< N; j++)
+      for (int i=0; i< M; i++)
+        B[i+j*ldb] *= alpha;
+
+  const bool lower = (uplo == CblasLower);
+  const bool notrans = (transA == CblasNoTrans);
+  const bool oplower = (lower == notrans);
+
+  // gets a pointer to the (i,k) block of op(A)
+  #define OPA_BLOCK(i, k) ((notrans) ? A + (i) + (k)*lda : A + (k) + (i)*lda)
+
+  if (side == CblasLeft)
+  {
+    const int nblocks = (M + NB - 1)/NB;
+    for (int b=0; b< nblocks; b++)
+    {
+      // process blocks from the top (op(A) lower) or bottom (op(A) upper)
+      const int k0 = (oplower) ? b*NB : std::max(0, M - (b+1)*NB);
+      const int k1 = (oplower) ? min(M, k0+NB) : M - b*NB;
+      const int kb = k1 - k0;
+
+      // solve with the diagonal block
+      trsm_unblocked(side, lower, transA, diag, kb, N, A + k0 + k0*lda, lda, B + k0, ldb);
+
+      // update the unsolved rows of B
+      if (oplower && k1 < M)
+        gemm(transA, CblasNoTrans, M-k1, N, kb, (T) -1.0, OPA_BLOCK(k1, k0), lda, B + k0, ldb, (T) 1.0, B + k1, ldb);
+      else if (!oplower && k0 > 0)
+        gemm(transA, CblasNoTrans, k0, N, kb, (T) -1.0, OPA_BLOCK(0, k0), lda, B + k0, ldb, (T) 1.0, B, ldb);
+    }
+  }
+  else
+  {
+    const int nblocks = (N + NB - 1)/NB;
+    for (int b=0; b< nblocks; b++)
+    {
+      // process blocks from the left (op(A) upper) or right (op(A) lower)
+      const int k0 = (!oplower) ? b*NB : std::max(0, N - (b+1)*NB);
+      const int k1 = (!oplower) ? min(N, k0+NB) : N - b*NB;
+      const int kb = k1 - k0;
+
+      // solve with the diagonal block
+      trsm_unblocked(side, lower, transA, diag, M, kb, A + k0 + k0*lda, lda, B + k0*ldb, ldb);
+
+      // update the unsolved columns of B
+      if (!oplower && k1 < N)
+        gemm(CblasNoTrans, transA, M, N-k1, kb, (T) -1.0, B + k0*ldb, ldb, OPA_BLOCK(k0, k1), lda, (T) 1.0, B + k1*ldb, ldb);
+      else if (oplower && k0 > 0)
+        gemm(CblasNoTrans, transA, M, k0, kb, (T) -1.0, B + k0*ldb, ldb, OPA_BLOCK(k0, 0), lda, (T) 1.0, B, ldb);
+    }
+  }
+
+  #undef OPA_BLOCK
+}
+
+/// Computes the unblocked Cholesky factorization of a small matrix
+/**
+ * \return 0 on success, or j > 0 if the leading minor of order j is not
+ *         positive definite
+ */
+template <class T>
+static int potf2(CBLAS_UPLO uplo, int N, T* A, int lda)
+{
+  for (int j=0; j< N; j++)
+  {
+    if (uplo == CblasUpper)
+    {
+      // compute U(j,j)
+      T ajj = A[j+j*lda];
+      for (int k=0; k< j; k++)
+        ajj -= A[k+j*lda]*A[k+j*lda];
+      if (!(ajj > (T) 0.0))
+      {
+        A[j+j*lda] = ajj;
+        return j+1;
+      }
+      ajj = std::sqrt(ajj);
+      A[j+j*lda] = ajj;
+
+      // compute the remainder of row j of U
+      for (int i=j+1; i< N; i++)
+      {
+        T sum = A[j+i*lda];
+        for (int k=0; k< j; k++)
+          sum -= A[k+j*lda]*A[k+i*lda];
+        A[j+i*lda] = sum/ajj;
+      }
+    }
+    else
+    {
+      // compute L(j,j)
+      T ajj = A[j+j*lda];
+      for (int k=0; k< j; k++)
+        ajj -= A[j+k*lda]*A[j+k*lda];
+      if (!(ajj > (T) 0.0))
+      {
+        A[j+j*lda] = ajj;
+        return j+1;
+      }
+      ajj = std::sqrt(ajj);
+      A[j+j*lda] = ajj;
+
+      // compute the remainder of column j of L
+      for (int i=j+1; i< N; i++)
+      {
+        T sum = A[i+j*lda];
+        for (int k=0; k< j; k++)
+          sum -= A[i+k*lda]*A[j+k*lda];
+        A[i+j*lda] = sum/ajj;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/// Computes the blocked (right-looking) Cholesky factorization A = U'*U or A = L*L'
+/**
+ * Only the specified triangle of A is referenced or modified.
+ * \return 0 on success, or j > 0 if the leading minor of order j is not
+ *         positive definite (the same convention as LAPACK's potrf)
+ */
+template <class T>
+int BlockedBLAS::potrf(CBLAS_UPLO uplo, int N, T* A, int lda)
+{
+  for (int k0=0; k0< N; k0 += NB)
+  {
+    const int kb = min(NB, N-k0);
+    const int k1 = k0 + kb;
+    T* Akk = A + k0 + k0*lda;
+
+    // factor the diagonal block
+    int info = potf2(uplo, kb, Akk, lda);
+    if (info > 0)
+      return k0 + info;
+
+    // compute the off-diagonal panel and update the trailing submatrix
+    if (k1 < N)
+    {
+      if (uplo == CblasUpper)
+      {
+        T* Akr = A + k0 + k1*lda;
+        trsm(CblasLeft, CblasUpper, CblasTrans, CblasNonUnit, kb, N-k1, (T) 1.0, Akk, lda, Akr, lda);
+        syrk(CblasUpper, CblasTrans, N-k1, kb, (T) -1.0, Akr, lda, (T) 1.0, A + k1 + k1*lda, lda);
+      }
+      else
+      {
+        T* Ark = A + k1 + k0*lda;
+        trsm(CblasRight, CblasLower, CblasTrans, CblasNonUnit, N-k1, kb, (T) 1.0, Akk, lda, Ark, lda);
+        syrk(CblasLower, CblasNoTrans, N-k1, kb, (T) -1.0, Ark, lda, (T) 1.0, A + k1 + k1*lda, lda);
+      }
+    }
+  }
+
+  return 0;
+}
+
+/// Swaps rows i and p of columns j0..j1-1 of A
+template <class T>
+static void swap_rows(T* A, int lda, int i, int p, int j0, int j1)
+{
+  for (int j=j0; j< j1; j++)
+    std::swap(A[i+j*lda], A[p+j*lda]);
+}
+
+/// Computes the blocked (right-looking) LU factorization with partial pivoting A = P*L*U
+/**
+ * \param ipiv on return, the (1-based) pivot indices: row i was interchanged
+ *        with row ipiv[i] (the same convention as LAPACK's getrf)
+ * \return 0 on success, or j > 0 if U(j,j) is exactly zero
+ */
+template <class T>
+int BlockedBLAS::getrf(int M, int N, T* A, int lda, int* ipiv)
+{
+  const int MINMN = min(M, N);
+  int info = 0;
+
+  for (int k0=0; k0< MINMN; k0 += NB)
+  {
+    const int kb = min(NB, MINMN-k0);
+    const int k1 = k0 + kb;
+
+    // factor the panel (columns k0..k1-1, rows k0..M-1)
+    for (int j=k0; j< k1; j++)
+    {
+      // find the pivot
+      T* aj = A + j*lda;
+      int p = j;
+      for (int i=j+1; i< M; i++)
+        if (std::fabs(aj[i]) > std::fabs(aj[p]))
+          p = i;
+      ipiv[j] = p+1;
+
+      if (aj[p] != (T) 0.0)
+      {
+        // swap rows within the panel and compute the multipliers
+        if (p != j)
+          swap_rows(A, lda, j, p, k0, k1);
+        const T rpiv = (T) 1.0/aj[j];
+        for (int i=j+1; i< M; i++)
+          aj[i] *= rpiv;
+      }
+      else if (info == 0)
+        info = j+1;
+
+      // update the remainder of the panel
+      for (int l=j+1; l< k1; l++)
+      {
+        T* al = A + l*lda;
+        const T ajl = al[j];
+        if (ajl != (T) 0.0)
+          for (int i=j+1; i< M; i++)
+            al[i] -= aj[i]*ajl;
+      }
+    }
+
+    // apply the row interchanges to the columns outside of the panel
+    for (int j=k0; j< k1; j++)
+      if (ipiv[j]-1 != j)
+      {
+        swap_rows(A, lda, j, ipiv[j]-1, 0, k0);
+        swap_rows(A, lda, j, ipiv[j]-1, k1, N);
+      }
+
+    // compute the block row of U and update the trailing submatrix
+    if (k1 < N)
+    {
+      trsm(CblasLeft, CblasLower, CblasNoTrans, CblasUnit, kb, N-k1, (T) 1.0, A + k0 + k0*lda, lda, A + k0 + k1*lda, lda);
+      if (k1 < M)
+        gemm(CblasNoTrans, CblasNoTrans, M-k1, N-k1, kb, (T) -1.0, A + k1 + k0*lda, lda, A + k0 + k1*lda, lda, (T) 1.0, A + k1 + k1*lda, lda);
+    }
+  }
+
+  return info;
+}
+
+// instantiate the kernels for single and double precision
+template void BlockedBLAS::gemm(CBLAS_TRANSPOSE, CBLAS_TRANSPOSE, int, int, int, double, const double*, int, const double*, int, double, double*, int);
+template void BlockedBLAS::gemm(CBLAS_TRANSPOSE, CBLAS_TRANSPOSE, int, int, int, float, const float*, int, const float*, int, float, float*, int);
+template void BlockedBLAS::syrk(CBLAS_UPLO, CBLAS_TRANSPOSE, int, int, double, const double*, int, double, double*, int);
+template void BlockedBLAS::syrk(CBLAS_UPLO, CBLAS_TRANSPOSE, int, int, float, const float*, int, float, float*, int);
+template void BlockedBLAS::trsm(CBLAS_SIDE, CBLAS_UPLO, CBLAS_TRANSPOSE, CBLAS_DIAG, int, int, double, const double*, int, double*, int);
+template void BlockedBLAS::trsm(CBLAS_SIDE, CBLAS_UPLO, CBLAS_TRANSPOSE, CBLAS_DIAG, int, int, float, const float*, int, float*, int);
+template int BlockedBLAS::potrf(CBLAS_UPLO, int, double*, int);
+template int BlockedBLAS::potrf(CBLAS_UPLO, int, float*, int);
+template int BlockedBLAS::getrf(int, int, double*, int, int*);
+template int BlockedBLAS::getrf(int, int, float*, int, int*);
+
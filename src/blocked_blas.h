@@ -0,0 +1,40 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_BLOCKED_BLAS_H
+#define _RAVELIN_BLOCKED_BLAS_H
+
+#include <Ravelin/cblas.h>
+
+/// Built-in cache-blocked, packed, multithreaded dense kernels
+/**
+ * These kernels are used by the CBLAS wrappers (and by the LAPACK wrappers
+ * for Cholesky and LU factorization) when the built-in backend is selected
+ * (see CBLAS::set_backend()), so that performance does not depend on the
+ * BLAS/LAPACK installed. All matrices are column-major. Multithreading uses
+ * OpenMP, if available at build time.
+ */
+class BlockedBLAS
+{
+  public:
+    template <class T>
+    static void gemm(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int M, int N, int K, T alpha, const T* A, int lda, const T* B, int ldb, T beta, T* C, int ldc);
+
+    template <class T>
+    static void syrk(CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int N, int K, T alpha, const T* A, int lda, T beta, T* C, int ldc);
+
+    template <class T>
+    static void trsm(CBLAS_SIDE side, CBLAS_UPLO uplo, CBLAS_TRANSPOSE transA, CBLAS_DIAG diag, int M, int N, T alpha, const T* A, int lda, T* B, int ldb);
+
+    template <class T>
+    static int potrf(CBLAS_UPLO uplo, int N, T* A, int lda);
+
+    template <class T>
+    static int getrf(int M, int N, T* A, int lda, int* ipiv);
+};
+
+#endif
+
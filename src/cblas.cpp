@@ -8,6 +8,13 @@
 #include <stdexcept>
 #include <algorithm>
 #include <Ravelin/cblas.h>
+#include "blocked_blas.h"
+
+#ifdef USE_BUILTIN_BLAS
+CBLAS::Backend CBLAS::_backend = CBLAS::eBuiltin;
+#else
+CBLAS::Backend CBLAS::_backend = CBLAS::eExternal;
+#endif
 
 template <>
 void CBLAS::rot(const int N, double *X, const int incX,
@@ -104,6 +111,12 @@ void CBLAS::ger(enum CBLAS_ORDER order, int M, int N, double alpha, const double
 template <>
 void CBLAS::trsm(enum CBLAS_SIDE side, enum CBLAS_UPLO uplo, enum CBLAS_TRANSPOSE transA, int m, int n, double alpha, const double* A, int lda, double* B, int ldb)
 {
+  if (_backend == eBuiltin)
+  {
+    BlockedBLAS::trsm(side, uplo, transA, CblasNonUnit, m, n, alpha, A, lda, B, ldb);
+    return;
+  }
+
   cblas_dtrsm(CblasColMajor, side, uplo, transA, CblasNonUnit, m, n, alpha, A, lda, B, ldb);  
 }
 
@@ -134,19 +147,77 @@ void CBLAS::gemv(enum CBLAS_ORDER order, CBLAS_TRANSPOSE transA, int M, int N, f
 template <>
 void CBLAS::gemm(enum CBLAS_ORDER order, CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int M, int N, int K, double alpha, const double* A, int lda, const double* B, int ldb, double beta, double* C, int ldc)
 {
+  if (_backend == eBuiltin)
+  {
+    // a row-major product is the column-major product of the transposes
+    if (order == CblasColMajor)
+      BlockedBLAS::gemm(transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    else
+      BlockedBLAS::gemm(transB, transA, N, M, K, alpha, B, ldb, A, lda, beta, C, ldc);
+    return;
+  }
+
   assert(ldc >= 1 && ldc >= M);
   cblas_dgemm(order, transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
+template <>
+void CBLAS::syrk(enum CBLAS_ORDER order, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int N, int K, double alpha, const double* A, int lda, double beta, double* C, int ldc)
+{
+  if (_backend == eBuiltin)
+  {
+    // a row-major matrix is the transpose of a column-major one
+    if (order == CblasColMajor)
+      BlockedBLAS::syrk(uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+    else
+      BlockedBLAS::syrk((uplo == CblasUpper) ? CblasLower : CblasUpper, (trans == CblasNoTrans) ? CblasTrans : CblasNoTrans, N, K, alpha, A, lda, beta, C, ldc);
+    return;
+  }
+
+  cblas_dsyrk(order, uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+}
+
 template <>
 void CBLAS::gemm(enum CBLAS_ORDER order, CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int M, int N, int K, float alpha, const float* A, int lda, const float* B, int ldb, float beta, float* C, int ldc)
 {
+  if (_backend == eBuiltin)
+  {
+    // a row-major product is the column-major product of the transposes
+    if (order == CblasColMajor)
+      BlockedBLAS::gemm(transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    else
+      BlockedBLAS::gemm(transB, transA, N, M, K, alpha, B, ldb, A, lda, beta, C, ldc);
+    return;
+  }
+
   cblas_sgemm(order, transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
+template <>
+void CBLAS::syrk(enum CBLAS_ORDER order, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int N, int K, float alpha, const float* A, int lda, float beta, float* C, int ldc)
+{
+  if (_backend == eBuiltin)
+  {
+    // a row-major matrix is the transpose of a column-major one
+    if (order == CblasColMajor)
+      BlockedBLAS::syrk(uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+    else
+      BlockedBLAS::syrk((uplo == CblasUpper) ? CblasLower : CblasUpper, (trans == CblasNoTrans) ? CblasTrans : CblasNoTrans, N, K, alpha, A, lda, beta, C, ldc);
+    return;
+  }
+
+  cblas_ssyrk(order, uplo, trans, N, K, alpha, A, lda, beta, C, ldc);
+}
+
 template <>
 void CBLAS::trsm(enum CBLAS_SIDE side, enum CBLAS_UPLO uplo, enum CBLAS_TRANSPOSE transA, int m, int n, float alpha, const float* A, int lda, float* B, int ldb)
 {
+  if (_backend == eBuiltin)
+  {
+    BlockedBLAS::trsm(side, uplo, transA, CblasNonUnit, m, n, alpha, A, lda, B, ldb);
+    return;
+  }
+
   cblas_strsm(CblasColMajor, side, uplo, transA, CblasNonUnit, m, n, alpha, A, lda, B, ldb);  
 }
 
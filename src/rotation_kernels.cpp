@@ -0,0 +1,223 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include "rotation_kernels.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define USE_VECTOR_EXTENSIONS
+#endif
+#if defined(USE_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+#define USE_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+// portable versions (16-byte vectors, if the compiler supports them)
+#ifdef USE_VECTOR_EXTENSIONS
+#define RK_TARGET
+#else
+#define RK_SCALAR
+#define RK_TARGET
+#endif
+#define RK_RSQRT(x) rsqrt_lanes(x)
+
+#define RK_NS rk_generic_d
+#define RK_T double
+#define RK_I long long
+#define RK_W 2
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+
+#define RK_NS rk_generic_f
+#define RK_T float
+#define RK_I int
+#define RK_W 4
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+#undef RK_RSQRT
+#undef RK_TARGET
+
+#ifdef USE_SIMD_DISPATCH
+
+// AVX2 versions; double precision uses exact square roots, single precision
+// uses the 12-bit reciprocal square root estimate and one Newton step
+#define RK_TARGET __attribute__((target("avx2,fma")))
+
+#define RK_NS rk_avx2_d
+#define RK_T double
+#define RK_I long long
+#define RK_W 4
+#define RK_RSQRT(x) splat((T) 1.0)/(V) _mm256_sqrt_pd((__m256d) x)
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+#undef RK_RSQRT
+
+#define RK_NS rk_avx2_f
+#define RK_T float
+#define RK_I int
+#define RK_W 8
+#define RK_RSQRT(x) newton(x, (V) _mm256_rsqrt_ps((__m256) x))
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+#undef RK_RSQRT
+#undef RK_TARGET
+
+// AVX-512 versions; the 14-bit reciprocal square root estimate is refined
+// with two Newton steps (double precision) or one (single precision)
+#define RK_TARGET __attribute__((target("avx512f,fma")))
+
+#define RK_NS rk_avx512_d
+#define RK_T double
+#define RK_I long long
+#define RK_W 8
+#define RK_RSQRT(x) newton(x, newton(x, (V) _mm512_maskz_rsqrt14_pd((__mmask8) -1, (__m512d) x)))
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+#undef RK_RSQRT
+
+#define RK_NS rk_avx512_f
+#define RK_T float
+#define RK_I int
+#define RK_W 16
+#define RK_RSQRT(x) newton(x, (V) _mm512_maskz_rsqrt14_ps((__mmask16) -1, (__m512) x))
+#include "rotation_kernels.inl"
+#undef RK_NS
+#undef RK_T
+#undef RK_I
+#undef RK_W
+#undef RK_RSQRT
+#undef RK_TARGET
+
+/// Determines (once) the widest instruction set supported by the processor (2: AVX-512, 1: AVX2 and FMA, 0: neither)
+static int simd_level()
+{
+  static const int LEVEL = (__builtin_cpu_supports("avx512f")) ? 2 : (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? 1 : 0;
+  return LEVEL;
+}
+
+#define DISPATCH(S, F, ARGS) \
+  switch (simd_level()) \
+  { \
+    case 2:  rk_avx512_##S::F ARGS; break; \
+    case 1:  rk_avx2_##S::F ARGS; break; \
+    default: rk_generic_##S::F ARGS; \
+  }
+#else
+#define DISPATCH(S, F, ARGS) rk_generic_##S::F ARGS;
+#endif
+
+/// Computes the products r[i] = a[i]*b[i] of n pairs of quaternions
+void RotationKernels::mult(unsigned n, const double* a, unsigned lda, const double* b, unsigned ldb, double* r, unsigned ldr)
+{
+  DISPATCH(d, mult, (n, a, lda, b, ldb, r, ldr))
+}
+
+/// Computes the products r[i] = a[i]*b[i] of n pairs of quaternions
+void RotationKernels::mult(unsigned n, const float* a, unsigned lda, const float* b, unsigned ldb, float* r, unsigned ldr)
+{
+  DISPATCH(f, mult, (n, a, lda, b, ldb, r, ldr))
+}
+
+/// Computes the products r[i] = a*b[i] for a single quaternion a (given as x, y, z, w)
+void RotationKernels::mult(const double* a, unsigned n, const double* b, unsigned ldb, double* r, unsigned ldr)
+{
+  DISPATCH(d, mult1, (a, n, b, ldb, r, ldr))
+}
+
+/// Computes the products r[i] = a*b[i] for a single quaternion a (given as x, y, z, w)
+void RotationKernels::mult(const float* a, unsigned n, const float* b, unsigned ldb, float* r, unsigned ldr)
+{
+  DISPATCH(f, mult1, (a, n, b, ldb, r, ldr))
+}
+
+/// Rotates each point p[i] by the unit quaternion q[i]
+void RotationKernels::rotate(unsigned n, const double* q, unsigned ldq, const double* p, unsigned ldp, double* r, unsigned ldr)
+{
+  DISPATCH(d, rotate, (n, q, ldq, p, ldp, r, ldr))
+}
+
+/// Rotates each point p[i] by the unit quaternion q[i]
+void RotationKernels::rotate(unsigned n, const float* q, unsigned ldq, const float* p, unsigned ldp, float* r, unsigned ldr)
+{
+  DISPATCH(f, rotate, (n, q, ldq, p, ldp, r, ldr))
+}
+
+/// Multiplies each point p[i] by the 3x3 (column-major) matrix R
+void RotationKernels::rotate(const double* R, unsigned n, const double* p, unsigned ldp, double* r, unsigned ldr)
+{
+  DISPATCH(d, rotate1, (R, n, p, ldp, r, ldr))
+}
+
+/// Multiplies each point p[i] by the 3x3 (column-major) matrix R
+void RotationKernels::rotate(const float* R, unsigned n, const float* p, unsigned ldp, float* r, unsigned ldr)
+{
+  DISPATCH(f, rotate1, (R, n, p, ldp, r, ldr))
+}
+
+/// Normalizes n quaternions in place (zero quaternions become the identity)
+void RotationKernels::normalize(unsigned n, double* q, unsigned ldq)
+{
+  DISPATCH(d, normalize, (n, q, ldq))
+}
+
+/// Normalizes n quaternions in place (zero quaternions become the identity)
+void RotationKernels::normalize(unsigned n, float* q, unsigned ldq)
+{
+  DISPATCH(f, normalize, (n, q, ldq))
+}
+
+/// Linearly interpolates between unit quaternions a[i] and b[i] (taking the shorter arc) and normalizes the result
+void RotationKernels::nlerp(unsigned n, const double* a, unsigned lda, const double* b, unsigned ldb, double t, double* r, unsigned ldr)
+{
+  DISPATCH(d, nlerp, (n, a, lda, b, ldb, t, r, ldr))
+}
+
+/// Linearly interpolates between unit quaternions a[i] and b[i] (taking the shorter arc) and normalizes the result
+void RotationKernels::nlerp(unsigned n, const float* a, unsigned lda, const float* b, unsigned ldb, float t, float* r, unsigned ldr)
+{
+  DISPATCH(f, nlerp, (n, a, lda, b, ldb, t, r, ldr))
+}
+
+/// Computes the time derivatives of n quaternions given n angular velocities (3 x n)
+void RotationKernels::deriv(unsigned n, const double* q, unsigned ldq, const double* w, unsigned ldw, double* qd, unsigned ldqd)
+{
+  DISPATCH(d, deriv, (n, q, ldq, w, ldw, qd, ldqd))
+}
+
+/// Computes the time derivatives of n quaternions given n angular velocities (3 x n)
+void RotationKernels::deriv(unsigned n, const float* q, unsigned ldq, const float* w, unsigned ldw, float* qd, unsigned ldqd)
+{
+  DISPATCH(f, deriv, (n, q, ldq, w, ldw, qd, ldqd))
+}
+
+/// Computes the rotation matrices (n x 9) of n unit quaternions
+void RotationKernels::to_matrix(unsigned n, const double* q, unsigned ldq, double* R, unsigned ldr)
+{
+  DISPATCH(d, to_matrix, (n, q, ldq, R, ldr))
+}
+
+/// Computes the rotation matrices (n x 9) of n unit quaternions
+void RotationKernels::to_matrix(unsigned n, const float* q, unsigned ldq, float* R, unsigned ldr)
+{
+  DISPATCH(f, to_matrix, (n, q, ldq, R, ldr))
+}
+
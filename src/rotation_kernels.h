@@ -0,0 +1,46 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_ROTATION_KERNELS_H
+#define _RAVELIN_ROTATION_KERNELS_H
+
+/// Quaternion and rotation kernels on structure-of-arrays buffers
+/**
+ * A buffer of n quaternions with leading dimension ld stores component k
+ * (x, y, z, w for k = 0, 1, 2, 3) of quaternion i at q[k*ld + i], i.e., it
+ * is a column-major n x 4 matrix. Points (n x 3) and rotation matrices
+ * (n x 9, with the entries of each 3x3 matrix in column-major order) are
+ * stored in the same way. Outputs may alias inputs exactly (with the same
+ * leading dimension).
+ *
+ * Each kernel processes as many lanes at a time as the processor allows:
+ * AVX-512 and AVX2 versions are selected at run time on x86 processors that
+ * support them. For single precision, normalization uses the hardware
+ * reciprocal square root estimate refined by one Newton step.
+ */
+class RotationKernels
+{
+  public:
+    static void mult(unsigned n, const double* a, unsigned lda, const double* b, unsigned ldb, double* r, unsigned ldr);
+    static void mult(unsigned n, const float* a, unsigned lda, const float* b, unsigned ldb, float* r, unsigned ldr);
+    static void mult(const double* a, unsigned n, const double* b, unsigned ldb, double* r, unsigned ldr);
+    static void mult(const float* a, unsigned n, const float* b, unsigned ldb, float* r, unsigned ldr);
+    static void rotate(unsigned n, const double* q, unsigned ldq, const double* p, unsigned ldp, double* r, unsigned ldr);
+    static void rotate(unsigned n, const float* q, unsigned ldq, const float* p, unsigned ldp, float* r, unsigned ldr);
+    static void rotate(const double* R, unsigned n, const double* p, unsigned ldp, double* r, unsigned ldr);
+    static void rotate(const float* R, unsigned n, const float* p, unsigned ldp, float* r, unsigned ldr);
+    static void normalize(unsigned n, double* q, unsigned ldq);
+    static void normalize(unsigned n, float* q, unsigned ldq);
+    static void nlerp(unsigned n, const double* a, unsigned lda, const double* b, unsigned ldb, double t, double* r, unsigned ldr);
+    static void nlerp(unsigned n, const float* a, unsigned lda, const float* b, unsigned ldb, float t, float* r, unsigned ldr);
+    static void deriv(unsigned n, const double* q, unsigned ldq, const double* w, unsigned ldw, double* qd, unsigned ldqd);
+    static void deriv(unsigned n, const float* q, unsigned ldq, const float* w, unsigned ldw, float* qd, unsigned ldqd);
+    static void to_matrix(unsigned n, const double* q, unsigned ldq, double* R, unsigned ldr);
+    static void to_matrix(unsigned n, const float* q, unsigned ldq, float* R, unsigned ldr);
+};
+
+#endif
+
@@ -0,0 +1,350 @@
+/****************************************************************************
+ * Copyright 2015 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+// One instantiation of the rotation kernels; rotation_kernels.cpp includes
+// this file once per scalar type and instruction set after defining
+//   RK_NS      the namespace of the instantiation
+//   RK_T       the scalar type
+//   RK_I       a signed integer type with the same size as RK_T
+//   RK_W       the number of lanes per vector
+//   RK_TARGET  the attributes that select the instruction set
+//   RK_RSQRT   an expression computing the reciprocal square roots of the
+//              vector x (the helpers newton() and rsqrt_lanes() may be used)
+// If RK_SCALAR is defined, only the scalar loops are compiled.
+
+namespace {
+namespace RK_NS {
+
+typedef RK_T T;
+
+#ifdef RK_SCALAR
+#define RK_INLINE inline
+#else
+#define RK_INLINE RK_TARGET __attribute__((always_inline)) inline
+#endif
+
+// the formulas below are templated so that the same code handles vectors and
+// (for the remainders) scalars
+
+/// Computes r = a*b (see QUAT::operator*())
+template <class U>
+RK_INLINE void qmult(U ax, U ay, U az, U aw, U bx, U by, U bz, U bw, U& rx, U& ry, U& rz, U& rw)
+{
+  rw = aw*bw - ax*bx - ay*by - az*bz;
+  rx = aw*bx + ax*bw + ay*bz - az*by;
+  ry = aw*by + ay*bw + az*bx - ax*bz;
+  rz = aw*bz + az*bw + ax*by - ay*bx;
+}
+
+/// Rotates p by the unit quaternion q, using p + w*t + v x t, t = 2 v x p
+template <class U>
+RK_INLINE void qrotate(U qx, U qy, U qz, U qw, U px, U py, U pz, U& rx, U& ry, U& rz)
+{
+  const U tx = (T) 2.0*(qy*pz - qz*py);
+  const U ty = (T) 2.0*(qz*px - qx*pz);
+  const U tz = (T) 2.0*(qx*py - qy*px);
+  rx = px + qw*tx + (qy*tz - qz*ty);
+  ry = py + qw*ty + (qz*tx - qx*tz);
+  rz = pz + qw*tz + (qx*ty - qy*tx);
+}
+
+/// Computes the time derivative of q given angular velocity w (see QUAT::deriv())
+template <class U>
+RK_INLINE void qderiv(U qx, U qy, U qz, U qw, U wx, U wy, U wz, U& dx, U& dy, U& dz, U& dw)
+{
+  dw = (T) 0.5*(-qx*wx - qy*wy - qz*wz);
+  dx = (T) 0.5*(qw*wx + qz*wy - qy*wz);
+  dy = (T) 0.5*(-qz*wx + qw*wy + qx*wz);
+  dz = (T) 0.5*(qy*wx - qx*wy + qw*wz);
+}
+
+/// Computes the (column-major) rotation matrix of a unit quaternion (see MATRIX3::operator=())
+template <class U>
+RK_INLINE void qmatrix(U x, U y, U z, U w, U* R)
+{
+  const U xx = x*x, xy = x*y, xz = x*z, xw = x*w;
+  const U yy = y*y, yz = y*z, yw = y*w;
+  const U zz = z*z, zw = z*w, ww = w*w;
+  R[0] = (T) 2.0*(xx + ww) - (T) 1.0;
+  R[1] = (T) 2.0*(xy + zw);
+  R[2] = (T) 2.0*(xz - yw);
+  R[3] = (T) 2.0*(xy - zw);
+  R[4] = (T) 2.0*(yy + ww) - (T) 1.0;
+  R[5] = (T) 2.0*(yz + xw);
+  R[6] = (T) 2.0*(xz + yw);
+  R[7] = (T) 2.0*(yz - xw);
+  R[8] = (T) 2.0*(zz + ww) - (T) 1.0;
+}
+
+/// Normalizes a single quaternion (see QUAT::normalize())
+RK_INLINE void qnormalize(T& x, T& y, T& z, T& w)
+{
+  const T mag = std::sqrt(x*x + y*y + z*z + w*w);
+  if (mag != (T) 0.0)
+  {
+    const T magi = (T) 1.0/mag;
+    x *= magi;
+    y *= magi;
+    z *= magi;
+    w *= magi;
+  }
+  else
+  {
+    x = y = z = (T) 0.0;
+    w = (T) 1.0;
+  }
+}
+
+#ifndef RK_SCALAR
+typedef RK_T V __attribute__((vector_size(RK_W*sizeof(RK_T))));
+typedef RK_T VU __attribute__((vector_size(RK_W*sizeof(RK_T)), aligned(sizeof(RK_T))));
+typedef RK_I VI __attribute__((vector_size(RK_W*sizeof(RK_T))));
+
+RK_INLINE V load(const T* p) { return *(const VU*) p; }
+RK_INLINE void store(T* p, V v) { *(VU*) p = v; }
+RK_INLINE V splat(T s) { V v = {}; return v + s; }
+
+// refines an estimate y of 1/sqrt(x) using one Newton step
+RK_INLINE V newton(V x, V y) { return y*((T) 1.5 - (T) 0.5*x*y*y); }
+
+// computes 1/sqrt(x) lane by lane
+RK_INLINE V rsqrt_lanes(V x)
+{
+  V r;
+  for (unsigned j=0; j< RK_W; j++)
+    r[j] = (T) 1.0/std::sqrt(x[j]);
+  return r;
+}
+
+// computes reciprocal square roots
+RK_INLINE V rsqrt(V x) { return RK_RSQRT(x); }
+#endif
+
+RK_TARGET void mult(unsigned n, const T* a, unsigned lda, const T* b, unsigned ldb, T* r, unsigned ldr)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    V rx, ry, rz, rw;
+    qmult(load(a+i), load(a+lda+i), load(a+2*lda+i), load(a+3*lda+i), load(b+i), load(b+ldb+i), load(b+2*ldb+i), load(b+3*ldb+i), rx, ry, rz, rw);
+    store(r+i, rx);
+    store(r+ldr+i, ry);
+    store(r+2*ldr+i, rz);
+    store(r+3*ldr+i, rw);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    T rx, ry, rz, rw;
+    qmult(a[i], a[lda+i], a[2*lda+i], a[3*lda+i], b[i], b[ldb+i], b[2*ldb+i], b[3*ldb+i], rx, ry, rz, rw);
+    r[i] = rx;
+    r[ldr+i] = ry;
+    r[2*ldr+i] = rz;
+    r[3*ldr+i] = rw;
+  }
+}
+
+RK_TARGET void mult1(const T* a, unsigned n, const T* b, unsigned ldb, T* r, unsigned ldr)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  const V ax = splat(a[0]), ay = splat(a[1]), az = splat(a[2]), aw = splat(a[3]);
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    V rx, ry, rz, rw;
+    qmult(ax, ay, az, aw, load(b+i), load(b+ldb+i), load(b+2*ldb+i), load(b+3*ldb+i), rx, ry, rz, rw);
+    store(r+i, rx);
+    store(r+ldr+i, ry);
+    store(r+2*ldr+i, rz);
+    store(r+3*ldr+i, rw);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    T rx, ry, rz, rw;
+    qmult(a[0], a[1], a[2], a[3], b[i], b[ldb+i], b[2*ldb+i], b[3*ldb+i], rx, ry, rz, rw);
+    r[i] = rx;
+    r[ldr+i] = ry;
+    r[2*ldr+i] = rz;
+    r[3*ldr+i] = rw;
+  }
+}
+
+RK_TARGET void rotate(unsigned n, const T* q, unsigned ldq, const T* p, unsigned ldp, T* r, unsigned ldr)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    V rx, ry, rz;
+    qrotate(load(q+i), load(q+ldq+i), load(q+2*ldq+i), load(q+3*ldq+i), load(p+i), load(p+ldp+i), load(p+2*ldp+i), rx, ry, rz);
+    store(r+i, rx);
+    store(r+ldr+i, ry);
+    store(r+2*ldr+i, rz);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    T rx, ry, rz;
+    qrotate(q[i], q[ldq+i], q[2*ldq+i], q[3*ldq+i], p[i], p[ldp+i], p[2*ldp+i], rx, ry, rz);
+    r[i] = rx;
+    r[ldr+i] = ry;
+    r[2*ldr+i] = rz;
+  }
+}
+
+RK_TARGET void rotate1(const T* R, unsigned n, const T* p, unsigned ldp, T* r, unsigned ldr)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  const V r0 = splat(R[0]), r1 = splat(R[1]), r2 = splat(R[2]);
+  const V r3 = splat(R[3]), r4 = splat(R[4]), r5 = splat(R[5]);
+  const V r6 = splat(R[6]), r7 = splat(R[7]), r8 = splat(R[8]);
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    const V px = load(p+i), py = load(p+ldp+i), pz = load(p+2*ldp+i);
+    store(r+i, r0*px + r3*py + r6*pz);
+    store(r+ldr+i, r1*px + r4*py + r7*pz);
+    store(r+2*ldr+i, r2*px + r5*py + r8*pz);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    const T px = p[i], py = p[ldp+i], pz = p[2*ldp+i];
+    r[i] = R[0]*px + R[3]*py + R[6]*pz;
+    r[ldr+i] = R[1]*px + R[4]*py + R[7]*pz;
+    r[2*ldr+i] = R[2]*px + R[5]*py + R[8]*pz;
+  }
+}
+
+RK_TARGET void normalize(unsigned n, T* q, unsigned ldq)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    const V x = load(q+i), y = load(q+ldq+i), z = load(q+2*ldq+i), w = load(q+3*ldq+i);
+    const V nsq = x*x + y*y + z*z + w*w;
+
+    // zero quaternions are handled by the scalar code
+    bool zero = false;
+    for (unsigned j=0; j< RK_W; j++)
+      if (nsq[j] == (T) 0.0)
+        zero = true;
+    if (zero)
+    {
+      for (unsigned j=i; j< i+RK_W; j++)
+        qnormalize(q[j], q[ldq+j], q[2*ldq+j], q[3*ldq+j]);
+      continue;
+    }
+
+    const V s = rsqrt(nsq);
+    store(q+i, x*s);
+    store(q+ldq+i, y*s);
+    store(q+2*ldq+i, z*s);
+    store(q+3*ldq+i, w*s);
+  }
+  #endif
+  for (; i< n; i++)
+    qnormalize(q[i], q[ldq+i], q[2*ldq+i], q[3*ldq+i]);
+}
+
+RK_TARGET void nlerp(unsigned n, const T* a, unsigned lda, const T* b, unsigned ldb, T t, T* r, unsigned ldr)
+{
+  const T s = (T) 1.0 - t;
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  VI SIGN = {};
+  SIGN += std::numeric_limits<RK_I>::min();
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    const V ax = load(a+i), ay = load(a+lda+i), az = load(a+2*lda+i), aw = load(a+3*lda+i);
+    V bx = load(b+i), by = load(b+ldb+i), bz = load(b+2*ldb+i), bw = load(b+3*ldb+i);
+
+    // negate b wherever a'b < 0 (by flipping sign bits)
+    const VI flip = (VI) (ax*bx + ay*by + az*bz + aw*bw) & SIGN;
+    bx = (V) ((VI) bx ^ flip);
+    by = (V) ((VI) by ^ flip);
+    bz = (V) ((VI) bz ^ flip);
+    bw = (V) ((VI) bw ^ flip);
+
+    // interpolate and normalize; the norm is at least 1/sqrt(2) for unit a, b
+    const V rx = ax*s + bx*t, ry = ay*s + by*t, rz = az*s + bz*t, rw = aw*s + bw*t;
+    const V m = rsqrt(rx*rx + ry*ry + rz*rz + rw*rw);
+    store(r+i, rx*m);
+    store(r+ldr+i, ry*m);
+    store(r+2*ldr+i, rz*m);
+    store(r+3*ldr+i, rw*m);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    const T dot = a[i]*b[i] + a[lda+i]*b[ldb+i] + a[2*lda+i]*b[2*ldb+i] + a[3*lda+i]*b[3*ldb+i];
+    const T tb = (dot < (T) 0.0) ? -t : t;
+    T x = a[i]*s + b[i]*tb;
+    T y = a[lda+i]*s + b[ldb+i]*tb;
+    T z = a[2*lda+i]*s + b[2*ldb+i]*tb;
+    T w = a[3*lda+i]*s + b[3*ldb+i]*tb;
+    qnormalize(x, y, z, w);
+    r[i] = x;
+    r[ldr+i] = y;
+    r[2*ldr+i] = z;
+    r[3*ldr+i] = w;
+  }
+}
+
+RK_TARGET void deriv(unsigned n, const T* q, unsigned ldq, const T* w, unsigned ldw, T* qd, unsigned ldqd)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    V dx, dy, dz, dw;
+    qderiv(load(q+i), load(q+ldq+i), load(q+2*ldq+i), load(q+3*ldq+i), load(w+i), load(w+ldw+i), load(w+2*ldw+i), dx, dy, dz, dw);
+    store(qd+i, dx);
+    store(qd+ldqd+i, dy);
+    store(qd+2*ldqd+i, dz);
+    store(qd+3*ldqd+i, dw);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    T dx, dy, dz, dw;
+    qderiv(q[i], q[ldq+i], q[2*ldq+i], q[3*ldq+i], w[i], w[ldw+i], w[2*ldw+i], dx, dy, dz, dw);
+    qd[i] = dx;
+    qd[ldqd+i] = dy;
+    qd[2*ldqd+i] = dz;
+    qd[3*ldqd+i] = dw;
+  }
+}
+
+RK_TARGET void to_matrix(unsigned n, const T* q, unsigned ldq, T* R, unsigned ldr)
+{
+  unsigned i = 0;
+  #ifndef RK_SCALAR
+  for (; i+RK_W <= n; i+= RK_W)
+  {
+    V m[9];
+    qmatrix(load(q+i), load(q+ldq+i), load(q+2*ldq+i), load(q+3*ldq+i), m);
+    for (unsigned k=0; k< 9; k++)
+      store(R+k*ldr+i, m[k]);
+  }
+  #endif
+  for (; i< n; i++)
+  {
+    T m[9];
+    qmatrix(q[i], q[ldq+i], q[2*ldq+i], q[3*ldq+i], m);
+    for (unsigned k=0; k< 9; k++)
+      R[k*ldr+i] = m[k];
+  }
+}
+
+#undef RK_INLINE
+
+} // end namespace
+} // end namespace
+
@@ -0,0 +1,318 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "sparse_kernels.h"
+
+using std::vector;
+
+// the minimum number of (estimated) flops for which rows are processed in 
+// parallel
+static const unsigned PAR_MIN = 16384;
+
+/// Computes the number of nonzeros in each row of C = L*R
+/**
+ * \param m the number of rows of L (and C)
+ * \param n the number of columns of R (and C)
+ * \param cptr the row pointers of C (m+1 entries) on return
+ */
+void SparseKernels::gemm_symbolic_count(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const unsigned* rptr, const unsigned* ridx, unsigned* cptr)
+{
+  const int M = (int) m;
+
+  cptr[0] = 0;
+  #ifdef _OPENMP
+  #pragma omp parallel if (lptr[m] > PAR_MIN)
+  #endif
+  {
+    // marks the columns already seen in the current row
+    vector<unsigned> mark(n, std::numeric_limits<unsigned>::max());
+
+    #ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 64)
+    #endif
+    for (int i=0; i< M; i++)
+    {
+      unsigned nz = 0;
+      for (unsigned k=lptr[i]; k< lptr[i+1]; k++)
+      {
+        const unsigned r = lidx[k];
+        for (unsigned l=rptr[r]; l< rptr[r+1]; l++)
+          if (mark[ridx[l]] != (unsigned) i)
+          {
+            mark[ridx[l]] = (unsigned) i;
+            nz++;
+          }
+      }
+      cptr[i+1] = nz;
+    }
+  }
+
+  // convert counts to pointers
+  for (unsigned i=0; i< m; i++)
+    cptr[i+1] += cptr[i];
+}
+
+/// Computes the (sorted) column indices of C = L*R
+/**
+ * \param cptr the row pointers of C computed by gemm_symbolic_count()
+ * \param cidx the column indices of C (cptr[m] entries) on return
+ */
+void SparseKernels::gemm_symbolic_fill(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const unsigned* rptr, const unsigned* ridx, const unsigned* cptr, unsigned* cidx)
+{
+  const int M = (int) m;
+
+  #ifdef _OPENMP
+  #pragma omp parallel if (lptr[m] > PAR_MIN)
+  #endif
+  {
+    vector<unsigned> mark(n, std::numeric_limits<unsigned>::max());
+
+    #ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 64)
+    #endif
+    for (int i=0; i< M; i++)
+    {
+      unsigned nz = cptr[i];
+      for (unsigned k=lptr[i]; k< lptr[i+1]; k++)
+      {
+        const unsigned r = lidx[k];
+        for (unsigned l=rptr[r]; l< rptr[r+1]; l++)
+          if (mark[ridx[l]] != (unsigned) i)
+          {
+            mark[ridx[l]] = (unsigned) i;
+            cidx[nz++] = ridx[l];
+          }
+      }
+      std::sort(cidx+cptr[i], cidx+cptr[i+1]);
+    }
+  }
+}
+
+/// Gets the size of the scratch used by gemm_numeric() for products with n columns (n entries for each thread)
+size_t SparseKernels::gemm_numeric_workspace(unsigned n)
+{
+  #ifdef _OPENMP
+  return (size_t) n*omp_get_max_threads();
+  #else
+  return n;
+  #endif
+}
+
+/// Computes the values of C = L diag(d) R for the pattern of C determined by the symbolic phase
+/**
+ * \param d the diagonal scaling (one entry per column of L), or NULL for
+ *        the identity
+ * \param pos scratch of npos entries (see gemm_numeric_workspace()), which
+ *        holds n entries for each thread; the number of threads is limited
+ *        to npos/n
+ * \param cval the nonzero values of C on return
+ */
+template <class T>
+void SparseKernels::gemm_numeric(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const T* lval, const T* d, const unsigned* rptr, const unsigned* ridx, const T* rval, const unsigned* cptr, const unsigned* cidx, unsigned* pos, size_t npos, T* cval)
+{
+  const int M = (int) m;
+  const int NSLICES = (n > 0) ? std::max((int) (npos/n), 1) : 1;
+
+  #ifdef _OPENMP
+  #pragma omp parallel num_threads(NSLICES) if (cptr[m] > PAR_MIN)
+  #endif
+  {
+    // maps column indices to locations in the current row of C (in the
+    // calling thread's slice of the scratch)
+    #ifdef _OPENMP
+    unsigned* p = pos + (size_t) omp_get_thread_num()*n;
+    #else
+    unsigned* p = pos;
+    #endif
+
+    #ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 64)
+    #endif
+    for (int i=0; i< M; i++)
+    {
+      for (unsigned k=cptr[i]; k< cptr[i+1]; k++)
+      {
+        p[cidx[k]] = k;
+        cval[k] = (T) 0.0;
+      }
+      for (unsigned k=lptr[i]; k< lptr[i+1]; k++)
+      {
+        const unsigned r = lidx[k];
+        const T a = (d) ? lval[k]*d[r] : lval[k];
+        for (unsigned l=rptr[r]; l< rptr[r+1]; l++)
+          cval[p[ridx[l]]] += a*rval[l];
+      }
+    }
+  }
+}
+
+// explicit instantiations
+template void SparseKernels::gemm_numeric(unsigned, unsigned, const unsigned*, const unsigned*, const double*, const double*, const unsigned*, const unsigned*, const double*, const unsigned*, const unsigned*, unsigned*, size_t, double*);
+template void SparseKernels::gemm_numeric(unsigned, unsigned, const unsigned*, const unsigned*, const float*, const float*, const unsigned*, const unsigned*, const float*, const unsigned*, const unsigned*, unsigned*, size_t, float*);
+
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX2_DISPATCH
+#include <immintrin.h>
+
+// the minimum number of nonzeros for which the AVX2 kernels are used
+static const unsigned AVX2_MIN = 8;
+
+/// Determines (once) whether the processor supports AVX2 and FMA
+static bool has_avx2()
+{
+  static const bool AVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return AVX2;
+}
+
+__attribute__((target("avx2,fma")))
+static double doti_avx2(unsigned nnz, const double* x, const unsigned* idx, const double* y)
+{
+  __m256d acc = _mm256_setzero_pd();
+  unsigned k = 0;
+  for (; k+4 <= nnz; k += 4)
+  {
+    const __m128i vidx = _mm_loadu_si128((const __m128i*) (idx+k));
+    acc = _mm256_fmadd_pd(_mm256_loadu_pd(x+k), _mm256_i32gather_pd(y, vidx, 8), acc);
+  }
+  double sum[4];
+  _mm256_storeu_pd(sum, acc);
+  double result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  for (; k< nnz; k++)
+    result += x[k]*y[idx[k]];
+  return result;
+}
+
+__attribute__((target("avx2,fma")))
+static float doti_avx2(unsigned nnz, const float* x, const unsigned* idx, const float* y)
+{
+  __m256 acc = _mm256_setzero_ps();
+  unsigned k = 0;
+  for (; k+8 <= nnz; k += 8)
+  {
+    const __m256i vidx = _mm256_loadu_si256((const __m256i*) (idx+k));
+    acc = _mm256_fmadd_ps(_mm256_loadu_ps(x+k), _mm256_i32gather_ps(y, vidx, 4), acc);
+  }
+  float sum[8];
+  _mm256_storeu_ps(sum, acc);
+  float result = ((sum[0] + sum[1]) + (sum[2] + sum[3])) + ((sum[4] + sum[5]) + (sum[6] + sum[7]));
+  for (; k< nnz; k++)
+    result += x[k]*y[idx[k]];
+  return result;
+}
+
+// AVX2 has no scatter instruction: values are gathered and updated in 
+// vector registers and stored back individually (indices are unique, so
+// there are no conflicts)
+__attribute__((target("avx2,fma")))
+static void axpyi_avx2(unsigned nnz, double alpha, const double* x, const unsigned* idx, double* y)
+{
+  const __m256d va = _mm256_set1_pd(alpha);
+  double r[4];
+  unsigned k = 0;
+  for (; k+4 <= nnz; k += 4)
+  {
+    const __m128i vidx = _mm_loadu_si128((const __m128i*) (idx+k));
+    _mm256_storeu_pd(r, _mm256_fmadd_pd(va, _mm256_loadu_pd(x+k), _mm256_i32gather_pd(y, vidx, 8)));
+    y[idx[k]] = r[0];
+    y[idx[k+1]] = r[1];
+    y[idx[k+2]] = r[2];
+    y[idx[k+3]] = r[3];
+  }
+  for (; k< nnz; k++)
+    y[idx[k]] += alpha*x[k];
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyi_avx2(unsigned nnz, float alpha, const float* x, const unsigned* idx, float* y)
+{
+  const __m256 va = _mm256_set1_ps(alpha);
+  float r[8];
+  unsigned k = 0;
+  for (; k+8 <= nnz; k += 8)
+  {
+    const __m256i vidx = _mm256_loadu_si256((const __m256i*) (idx+k));
+    _mm256_storeu_ps(r, _mm256_fmadd_ps(va, _mm256_loadu_ps(x+k), _mm256_i32gather_ps(y, vidx, 4)));
+    for (unsigned l=0; l< 8; l++)
+      y[idx[k+l]] = r[l];
+  }
+  for (; k< nnz; k++)
+    y[idx[k]] += alpha*x[k];
+}
+#endif
+
+/// Computes the dot product of a sparse vector (x, idx) and a dense vector y
+/**
+ * \param nnz the number of nonzeros in the sparse vector
+ * \param x the nonzero values of the sparse vector
+ * \param idx the (unique) indices of the nonzeros
+ */
+double SparseKernels::doti(unsigned nnz, const double* x, const unsigned* idx, const double* y)
+{
+  #ifdef USE_AVX2_DISPATCH
+  if (nnz >= AVX2_MIN && has_avx2())
+    return doti_avx2(nnz, x, idx, y);
+  #endif
+
+  double result = 0.0;
+  for (unsigned k=0; k< nnz; k++)
+    result += x[k]*y[idx[k]];
+  return result;
+}
+
+/// Computes the dot product of a sparse vector (x, idx) and a dense vector y
+float SparseKernels::doti(unsigned nnz, const float* x, const unsigned* idx, const float* y)
+{
+  #ifdef USE_AVX2_DISPATCH
+  if (nnz >= AVX2_MIN && has_avx2())
+    return doti_avx2(nnz, x, idx, y);
+  #endif
+
+  float result = 0.0f;
+  for (unsigned k=0; k< nnz; k++)
+    result += x[k]*y[idx[k]];
+  return result;
+}
+
+/// Computes y += alpha*x for a sparse vector (x, idx) and a dense vector y
+/**
+ * \param idx the indices of the nonzeros, which must be unique
+ */
+void SparseKernels::axpyi(unsigned nnz, double alpha, const double* x, const unsigned* idx, double* y)
+{
+  #ifdef USE_AVX2_DISPATCH
+  if (nnz >= AVX2_MIN && has_avx2())
+  {
+    axpyi_avx2(nnz, alpha, x, idx, y);
+    return;
+  }
+  #endif
+
+  for (unsigned k=0; k< nnz; k++)
+    y[idx[k]] += alpha*x[k];
+}
+
+/// Computes y += alpha*x for a sparse vector (x, idx) and a dense vector y
+void SparseKernels::axpyi(unsigned nnz, float alpha, const float* x, const unsigned* idx, float* y)
+{
+  #ifdef USE_AVX2_DISPATCH
+  if (nnz >= AVX2_MIN && has_avx2())
+  {
+    axpyi_avx2(nnz, alpha, x, idx, y);
+    return;
+  }
+  #endif
+
+  for (unsigned k=0; k< nnz; k++)
+    y[idx[k]] += alpha*x[k];
+}
+
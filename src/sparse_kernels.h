@@ -0,0 +1,44 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_SPARSE_KERNELS_H
+#define _RAVELIN_SPARSE_KERNELS_H
+
+#include <cstddef>
+
+/// Sparse kernels on raw compressed arrays
+/**
+ * The row-wise (Gustavson) product C = L diag(d) R (d optional) of CSR
+ * matrices is split into a symbolic phase, which determines the (sorted)
+ * nonzero pattern of C, and a numeric phase, which fills the values of C for
+ * a fixed pattern and may be repeated whenever the values of L, d, and R
+ * change; the numeric phase uses scratch (sized by gemm_numeric_workspace())
+ * that the caller keeps with the pattern, so it does not allocate. Rows of C
+ * are distributed among threads using OpenMP, if available at build time.
+ *
+ * The gather (doti) and scatter (axpyi) kernels operate on a sparse vector
+ * given by nnz values x and unique indices idx. On x86 processors that
+ * support AVX2 and FMA, these use hardware gathers (selected at run time).
+ */
+class SparseKernels
+{
+  public:
+    static void gemm_symbolic_count(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const unsigned* rptr, const unsigned* ridx, unsigned* cptr);
+    static void gemm_symbolic_fill(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const unsigned* rptr, const unsigned* ridx, const unsigned* cptr, unsigned* cidx);
+
+    static double doti(unsigned nnz, const double* x, const unsigned* idx, const double* y);
+    static float doti(unsigned nnz, const float* x, const unsigned* idx, const float* y);
+    static void axpyi(unsigned nnz, double alpha, const double* x, const unsigned* idx, double* y);
+    static void axpyi(unsigned nnz, float alpha, const float* x, const unsigned* idx, float* y);
+
+    static size_t gemm_numeric_workspace(unsigned n);
+
+    template <class T>
+    static void gemm_numeric(unsigned m, unsigned n, const unsigned* lptr, const unsigned* lidx, const T* lval, const T* d, const unsigned* rptr, const unsigned* ridx, const T* rval, const unsigned* cptr, const unsigned* cidx, unsigned* pos, size_t npos, T* cval);
+};
+
+#endif
+
@@ -0,0 +1,457 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#include <set>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "sparse_ordering.h"
+
+using std::vector;
+using std::set;
+using std::pair;
+using std::make_pair;
+
+// subgraphs of (at most) this many vertices are not dissected further
+static const unsigned ND_MIN = 64;
+
+// label of vertices that have been removed from all subgraphs
+static const unsigned NO_LABEL = std::numeric_limits<unsigned>::max();
+
+/// Computes the adjacency structure of the graph of A + A' (without self-loops) from a compressed (CSR or CSC) pattern
+/**
+ * \param n the number of rows (and columns) of A
+ * \param ptr the row (column) pointers of A
+ * \param idx the column (row) indices of A
+ * \param xadj the (n+1) adjacency pointers on return
+ * \param adj the (sorted) adjacency lists on return
+ */
+void SparseOrdering::symmetric_graph(unsigned n, const unsigned* ptr, const unsigned* idx, vector<unsigned>& xadj, vector<unsigned>& adj)
+{
+  // count the entries (including duplicates) in each adjacency list
+  xadj.assign(n+1, 0);
+  for (unsigned i=0; i< n; i++)
+    for (unsigned k=ptr[i]; k< ptr[i+1]; k++)
+      if (idx[k] != i)
+      {
+        xadj[i+1]++;
+        xadj[idx[k]+1]++;
+      }
+  for (unsigned i=0; i< n; i++)
+    xadj[i+1] += xadj[i];
+
+  // fill the lists
+  vector<unsigned> next(xadj.begin(), xadj.end()-1);
+  adj.resize(xadj[n]);
+  for (unsigned i=0; i< n; i++)
+    for (unsigned k=ptr[i]; k< ptr[i+1]; k++)
+      if (idx[k] != i)
+      {
+        adj[next[i]++] = idx[k];
+        adj[next[idx[k]]++] = i;
+      }
+
+  // sort the lists and remove duplicates, compacting in place
+  unsigned nz = 0;
+  for (unsigned i=0, start=0; i< n; i++)
+  {
+    const unsigned end = xadj[i+1];
+    std::sort(adj.begin()+start, adj.begin()+end);
+    const unsigned list_start = nz;
+    for (unsigned k=start; k< end; k++)
+      if (nz == list_start || adj[nz-1] != adj[k])
+        adj[nz++] = adj[k];
+    xadj[i+1] = nz;
+    start = end;
+  }
+  adj.resize(nz);
+}
+
+/// Computes the rooted level structure of the subgraph containing root (vertices with the same label as root)
+/**
+ * \param order the vertices in breadth-first order on return
+ * \param level_ptr the starting index in order of each level (plus one
+ *        entry for the end) on return
+ */
+void SparseOrdering::level_structure(Graph& g, unsigned root, vector<unsigned>& order, vector<unsigned>& level_ptr)
+{
+  const vector<unsigned>& xadj = *g.xadj;
+  const vector<unsigned>& adj = *g.adj;
+  const unsigned LABEL = g.label[root];
+
+  order.clear();
+  level_ptr.clear();
+  order.push_back(root);
+  g.mark[root] = true;
+  for (unsigned start=0; start < order.size(); )
+  {
+    const unsigned end = order.size();
+    level_ptr.push_back(start);
+    for (unsigned k=start; k< end; k++)
+    {
+      const unsigned v = order[k];
+      for (unsigned l=xadj[v]; l< xadj[v+1]; l++)
+        if (!g.mark[adj[l]] && g.label[adj[l]] == LABEL)
+        {
+          g.mark[adj[l]] = true;
+          order.push_back(adj[l]);
+        }
+    }
+    start = end;
+  }
+  level_ptr.push_back(order.size());
+
+  // clear the marks
+  for (unsigned k=0; k< order.size(); k++)
+    g.mark[order[k]] = false;
+}
+
+/// Finds a pseudo-peripheral vertex (George and Liu) of the subgraph containing root
+/**
+ * \param order the breadth-first order from the returned vertex on return
+ * \param level_ptr the level structure from the returned vertex on return
+ * \return the pseudo-peripheral vertex
+ */
+unsigned SparseOrdering::pseudo_peripheral(Graph& g, unsigned root, vector<unsigned>& order, vector<unsigned>& level_ptr)
+{
+  const vector<unsigned>& xadj = *g.xadj;
+
+  level_structure(g, root, order, level_ptr);
+  while (true)
+  {
+    // pick the vertex of minimum degree in the last level
+    const unsigned NLEVELS = level_ptr.size()-1;
+    unsigned best = order[level_ptr[NLEVELS-1]];
+    for (unsigned k=level_ptr[NLEVELS-1]+1; k< level_ptr[NLEVELS]; k++)
+      if (xadj[order[k]+1] - xadj[order[k]] < xadj[best+1] - xadj[best])
+        best = order[k];
+
+    // stop if the eccentricity does not increase
+    vector<unsigned> order2, level_ptr2;
+    level_structure(g, best, order2, level_ptr2);
+    if (level_ptr2.size() <= level_ptr.size())
+      return root;
+    root = best;
+    order.swap(order2);
+    level_ptr.swap(level_ptr2);
+  }
+}
+
+/// Computes the reverse Cuthill-McKee ordering
+/**
+ * Each connected component is numbered breadth-first from a
+ * pseudo-peripheral vertex, visiting the neighbors of each vertex in order
+ * of increasing degree; the resulting order is then reversed. This reduces
+ * the bandwidth and profile of the matrix, improving locality for
+ * matrix/vector products.
+ */
+void SparseOrdering::rcm(unsigned n, const vector<unsigned>& xadj, const vector<unsigned>& adj, vector<unsigned>& perm)
+{
+  Graph g;
+  g.xadj = &xadj;
+  g.adj = &adj;
+  g.label.assign(n, 0);
+  g.mark.assign(n, false);
+  g.next_label = 1;
+
+  vector<bool> numbered(n, false);
+  vector<unsigned> order, level_ptr;
+  vector<pair<unsigned, unsigned> > nbrs;
+  perm.clear();
+  perm.reserve(n);
+  for (unsigned s=0; s< n; s++)
+  {
+    if (numbered[s])
+      continue;
+
+    // number the component of s (Cuthill-McKee), using perm as the queue
+    const unsigned root = pseudo_peripheral(g, s, order, level_ptr);
+    perm.push_back(root);
+    numbered[root] = true;
+    for (unsigned head = perm.size()-1; head < perm.size(); head++)
+    {
+      const unsigned v = perm[head];
+      nbrs.clear();
+      for (unsigned k=xadj[v]; k< xadj[v+1]; k++)
+        if (!numbered[adj[k]])
+        {
+          numbered[adj[k]] = true;
+          nbrs.push_back(make_pair(xadj[adj[k]+1] - xadj[adj[k]], adj[k]));
+        }
+      std::sort(nbrs.begin(), nbrs.end());
+      for (unsigned k=0; k< nbrs.size(); k++)
+        perm.push_back(nbrs[k].second);
+    }
+  }
+
+  std::reverse(perm.begin(), perm.end());
+}
+
+/// Computes an approximate minimum degree ordering
+/**
+ * Elimination is simulated on the quotient graph: each eliminated vertex
+ * becomes an element (a clique of its uneliminated neighbors) that absorbs
+ * the elements adjacent to it. Degrees are the approximate external degrees
+ * of Amestoy, Davis, and Duff, which are upper bounds computed from
+ * |Le \ Lp| for each element e adjacent to the pivot element p; elements
+ * that are subsets of Lp are absorbed (aggressive absorption). Supervariable
+ * detection and dense row handling are not performed.
+ */
+void SparseOrdering::amd(unsigned n, const vector<unsigned>& xadj, const vector<unsigned>& adj, vector<unsigned>& perm)
+{
+  const unsigned NONE = std::numeric_limits<unsigned>::max();
+
+  // vars[i] and elems[i] are the variables and elements adjacent to variable
+  // i; L[e] is the set of (uneliminated) variables of element e
+  vector<vector<unsigned> > vars(n), elems(n), L(n);
+  vector<unsigned> degree(n), w(n), wstamp(n, NONE), mark(n, NONE);
+  vector<bool> eliminated(n, false), absorbed(n, false);
+  set<pair<unsigned, unsigned> > queue;
+  for (unsigned i=0; i< n; i++)
+  {
+    vars[i].assign(adj.begin()+xadj[i], adj.begin()+xadj[i+1]);
+    degree[i] = vars[i].size();
+    queue.insert(make_pair(degree[i], i));
+  }
+
+  perm.clear();
+  perm.reserve(n);
+  for (unsigned k=0; k< n; k++)
+  {
+    // select the pivot of minimum (approximate) degree
+    const unsigned p = queue.begin()->second;
+    queue.erase(queue.begin());
+    perm.push_back(p);
+    eliminated[p] = true;
+
+    // form the new element from the variables adjacent to p and the
+    // elements that p absorbs
+    vector<unsigned>& Lp = L[p];
+    mark[p] = p;
+    for (unsigned l=0; l< vars[p].size(); l++)
+    {
+      const unsigned v = vars[p][l];
+      if (!eliminated[v] && mark[v] != p)
+      {
+        mark[v] = p;
+        Lp.push_back(v);
+      }
+    }
+    for (unsigned l=0; l< elems[p].size(); l++)
+    {
+      const unsigned e = elems[p][l];
+      if (absorbed[e])
+        continue;
+      for (unsigned m=0; m< L[e].size(); m++)
+      {
+        const unsigned v = L[e][m];
+        if (!eliminated[v] && mark[v] != p)
+        {
+          mark[v] = p;
+          Lp.push_back(v);
+        }
+      }
+      absorbed[e] = true;
+      vector<unsigned>().swap(L[e]);
+    }
+    vector<unsigned>().swap(vars[p]);
+    vector<unsigned>().swap(elems[p]);
+
+    // compute |Le \ Lp| for every element adjacent to Lp
+    for (unsigned l=0; l< Lp.size(); l++)
+    {
+      const vector<unsigned>& ei = elems[Lp[l]];
+      for (unsigned m=0; m< ei.size(); m++)
+      {
+        const unsigned e = ei[m];
+        if (absorbed[e])
+          continue;
+        if (wstamp[e] != k)
+        {
+          wstamp[e] = k;
+          w[e] = L[e].size();
+        }
+        w[e]--;
+      }
+    }
+
+    // update the variables in Lp
+    const unsigned NREMAIN = n-k-1;
+    for (unsigned l=0; l< Lp.size(); l++)
+    {
+      const unsigned i = Lp[l];
+
+      // remove absorbed elements (aggressively absorbing those covered by p)
+      // and add the new element
+      vector<unsigned>& ei = elems[i];
+      unsigned ext = 0, ne = 0;
+      for (unsigned m=0; m< ei.size(); m++)
+      {
+        const unsigned e = ei[m];
+        if (absorbed[e])
+          continue;
+        if (w[e] == 0)
+        {
+          absorbed[e] = true;
+          vector<unsigned>().swap(L[e]);
+          continue;
+        }
+        ext += w[e];
+        ei[ne++] = e;
+      }
+      ei.resize(ne);
+      ei.push_back(p);
+
+      // remove variables covered by the new element
+      vector<unsigned>& vi = vars[i];
+      unsigned nv = 0;
+      for (unsigned m=0; m< vi.size(); m++)
+        if (!eliminated[vi[m]] && mark[vi[m]] != p)
+          vi[nv++] = vi[m];
+      vi.resize(nv);
+
+      // compute the approximate external degree
+      unsigned d = nv + (Lp.size()-1) + ext;
+      d = std::min(d, degree[i] + (unsigned) Lp.size()-1);
+      d = std::min(d, NREMAIN-1);
+      queue.erase(make_pair(degree[i], i));
+      degree[i] = d;
+      queue.insert(make_pair(d, i));
+    }
+  }
+}
+
+/// Orders the subgraph with vertices nodes (all with the same label) by nested dissection, appending to perm
+void SparseOrdering::dissect(Graph& g, const vector<unsigned>& nodes, vector<unsigned>& perm)
+{
+  vector<unsigned> order, level_ptr;
+
+  if (nodes.empty())
+    return;
+
+  // dissect each connected component separately
+  const unsigned LABEL0 = g.label[nodes[0]];
+  for (unsigned k=0; k< nodes.size(); k++)
+  {
+    const unsigned v = nodes[k];
+    if (g.label[v] != LABEL0)
+      continue;
+
+    // relabel the component containing v
+    level_structure(g, v, order, level_ptr);
+    const unsigned LABEL = g.next_label++;
+    for (unsigned l=0; l< order.size(); l++)
+      g.label[order[l]] = LABEL;
+    dissect_component(g, order, perm);
+  }
+}
+
+/// Orders the connected subgraph with vertices nodes (all with the same label) by nested dissection, appending to perm
+/**
+ * The subgraph is bisected using the level structure rooted at a
+ * pseudo-peripheral vertex: the level containing the median vertex is the
+ * separator, less any of its vertices that have no neighbors in the next
+ * level. The two halves are ordered recursively, followed by the separator.
+ */
+void SparseOrdering::dissect_component(Graph& g, const vector<unsigned>& nodes, vector<unsigned>& perm)
+{
+  const vector<unsigned>& xadj = *g.xadj;
+  const vector<unsigned>& adj = *g.adj;
+  const unsigned N = nodes.size();
+
+  // small subgraphs are ordered by minimum degree
+  vector<unsigned> order, level_ptr;
+  pseudo_peripheral(g, nodes[0], order, level_ptr);
+  const unsigned NLEVELS = level_ptr.size()-1;
+  if (N <= ND_MIN || NLEVELS < 3)
+  {
+    // build the induced subgraph (order doubles as the local -> global map)
+    vector<unsigned> sub_xadj(1, 0), sub_adj, sub_perm;
+    for (unsigned k=0; k< N; k++)
+      g.local[order[k]] = k;
+    for (unsigned k=0; k< N; k++)
+    {
+      const unsigned v = order[k];
+      for (unsigned l=xadj[v]; l< xadj[v+1]; l++)
+        if (g.local[adj[l]] != NO_LABEL)
+          sub_adj.push_back(g.local[adj[l]]);
+      sub_xadj.push_back(sub_adj.size());
+    }
+    amd(N, sub_xadj, sub_adj, sub_perm);
+    for (unsigned k=0; k< N; k++)
+    {
+      perm.push_back(order[sub_perm[k]]);
+      g.label[order[k]] = NO_LABEL;
+      g.local[order[k]] = NO_LABEL;
+    }
+    return;
+  }
+
+  // find the median level
+  unsigned m = 1;
+  while (m < NLEVELS-2 && level_ptr[m+1] <= N/2)
+    m++;
+
+  // split the subgraph
+  const unsigned LA = g.next_label++, LB = g.next_label++;
+  vector<unsigned> A, B, S;
+  for (unsigned k=0; k< level_ptr[m]; k++)
+    A.push_back(order[k]);
+  for (unsigned k=level_ptr[m+1]; k< N; k++)
+    B.push_back(order[k]);
+  for (unsigned k=0; k< A.size(); k++)
+    g.label[A[k]] = LA;
+  for (unsigned k=0; k< B.size(); k++)
+    g.label[B[k]] = LB;
+  for (unsigned k=level_ptr[m]; k< level_ptr[m+1]; k++)
+  {
+    const unsigned v = order[k];
+    bool touches_b = false;
+    for (unsigned l=xadj[v]; l< xadj[v+1] && !touches_b; l++)
+      touches_b = (g.label[adj[l]] == LB);
+    if (touches_b)
+    {
+      S.push_back(v);
+      g.label[v] = NO_LABEL;
+    }
+    else
+    {
+      A.push_back(v);
+      g.label[v] = LA;
+    }
+  }
+
+  // order the halves, then the separator
+  dissect(g, A, perm);
+  dissect(g, B, perm);
+  perm.insert(perm.end(), S.begin(), S.end());
+}
+
+/// Computes a nested dissection ordering by recursive graph bisection
+/**
+ * Separators are numbered last, so that the factors of the two halves do
+ * not fill in with respect to each other. This generally produces less fill
+ * than minimum degree orderings for large two- and three-dimensional
+ * meshes.
+ */
+void SparseOrdering::nested_dissection(unsigned n, const vector<unsigned>& xadj, const vector<unsigned>& adj, vector<unsigned>& perm)
+{
+  Graph g;
+  g.xadj = &xadj;
+  g.adj = &adj;
+  g.label.assign(n, 0);
+  g.mark.assign(n, false);
+  g.local.assign(n, NO_LABEL);
+  g.next_label = 1;
+
+  vector<unsigned> nodes(n);
+  for (unsigned i=0; i< n; i++)
+    nodes[i] = i;
+  perm.clear();
+  perm.reserve(n);
+  dissect(g, nodes, perm);
+}
+
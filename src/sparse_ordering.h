@@ -0,0 +1,45 @@
+/****************************************************************************
+ * Copyright 2013 Evan Drumwright
+ * This library is distributed under the terms of the Apache V2.0
+ * License (obtainable from http://www.apache.org/licenses/LICENSE-2.0).
+ ****************************************************************************/
+
+#ifndef _RAVELIN_SPARSE_ORDERING_H
+#define _RAVELIN_SPARSE_ORDERING_H
+
+#include <vector>
+
+/// Fill-reducing and bandwidth-reducing orderings of symmetric sparsity patterns
+/**
+ * The orderings operate on the adjacency structure (xadj, adj) of the graph
+ * of A + A' (without self-loops): the neighbors of vertex i are
+ * adj[xadj[i]], ..., adj[xadj[i+1]-1]. All orderings return a permutation
+ * perm in which perm[k] is the (original) vertex that is numbered k.
+ */
+class SparseOrdering
+{
+  public:
+    static void symmetric_graph(unsigned n, const unsigned* ptr, const unsigned* idx, std::vector<unsigned>& xadj, std::vector<unsigned>& adj);
+    static void amd(unsigned n, const std::vector<unsigned>& xadj, const std::vector<unsigned>& adj, std::vector<unsigned>& perm);
+    static void rcm(unsigned n, const std::vector<unsigned>& xadj, const std::vector<unsigned>& adj, std::vector<unsigned>& perm);
+    static void nested_dissection(unsigned n, const std::vector<unsigned>& xadj, const std::vector<unsigned>& adj, std::vector<unsigned>& perm);
+
+  private:
+    struct Graph
+    {
+      const std::vector<unsigned>* xadj;
+      const std::vector<unsigned>* adj;
+      std::vector<unsigned> label;       // the subgraph that each vertex belongs to
+      std::vector<bool> mark;            // work array (all false between calls)
+      std::vector<unsigned> local;       // work array for subgraph numbering
+      unsigned next_label;               // the next unused subgraph label
+    };
+
+    static unsigned pseudo_peripheral(Graph& g, unsigned root, std::vector<unsigned>& order, std::vector<unsigned>& level_ptr);
+    static void level_structure(Graph& g, unsigned root, std::vector<unsigned>& order, std::vector<unsigned>& level_ptr);
+    static void dissect(Graph& g, const std::vector<unsigned>& nodes, std::vector<unsigned>& perm);
+    static void dissect_component(Graph& g, const std::vector<unsigned>& nodes, std::vector<unsigned>& perm);
+};
+
+#endif
+
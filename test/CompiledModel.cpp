@@ -0,0 +1,349 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include <Ravelin/URDFReaderd.h>
+#include <Ravelin/RCArticulatedBodyd.h>
+#include <Ravelin/RCArticulatedBodyf.h>
+#include <Ravelin/RigidBodyd.h>
+#include <Ravelin/Jointd.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+
+// a fixed-base (the massless base link is disabled) branched model with revolute, prismatic and fixed joints
+static const char* URDF =
+  "<robot name=\"compiled\">"
+  "  <link name=\"base\">"
+  "    <inertial> <mass value=\"0\"/>"
+  "      <inertia ixx=\"0\" ixy=\"0\" ixz=\"0\" iyy=\"0\" iyz=\"0\" izz=\"0\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l1\">"
+  "    <inertial> <origin xyz=\"0 0 0.25\" rpy=\"0 0 0.5\"/> <mass value=\"1\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0.001\" ixz=\"0\" iyy=\"0.02\" iyz=\"0\" izz=\"0.03\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l2\">"
+  "    <inertial> <mass value=\"0.5\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l3\">"
+  "    <inertial> <origin xyz=\"0.1 0 0\" rpy=\"0.2 0 0\"/> <mass value=\"0.25\"/>"
+  "      <inertia ixx=\"0.002\" ixy=\"0\" ixz=\"0\" iyy=\"0.003\" iyz=\"0\" izz=\"0.004\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l4\">"
+  "    <inertial> <mass value=\"0.1\"/>"
+  "      <inertia ixx=\"0.001\" ixy=\"0\" ixz=\"0\" iyy=\"0.001\" iyz=\"0\" izz=\"0.001\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <joint name=\"j1\" type=\"revolute\">"
+  "    <parent link=\"base\"/> <child link=\"l1\"/>"
+  "    <origin xyz=\"0 0 0.5\" rpy=\"0 0.3 0\"/> <axis xyz=\"1 1 0\"/>"
+  "  </joint>"
+  "  <joint name=\"j2\" type=\"prismatic\">"
+  "    <parent link=\"base\"/> <child link=\"l2\"/>"
+  "    <origin xyz=\"0.1 0 0\" rpy=\"0.1 0.2 0.3\"/> <axis xyz=\"0 0 1\"/>"
+  "  </joint>"
+  "  <joint name=\"j3\" type=\"revolute\">"
+  "    <parent link=\"l1\"/> <child link=\"l3\"/>"
+  "    <origin xyz=\"0 0.2 0.1\" rpy=\"0 0 0\"/> <axis xyz=\"0 1 0\"/>"
+  "  </joint>"
+  "  <joint name=\"j4\" type=\"fixed\">"
+  "    <parent link=\"l3\"/> <child link=\"l4\"/>"
+  "    <origin xyz=\"0.3 0 0\" rpy=\"0 0 0\"/>"
+  "  </joint>"
+  "</robot>";
+
+static const char* FNAME = "compiled-model-test.rcab";
+
+// constructs the model from the URDF and moves it away from its initial configuration
+static shared_ptr<RCArticulatedBodyd> construct_body()
+{
+  vector<shared_ptr<RigidBodyd> > links;
+  vector<shared_ptr<Jointd> > joints;
+  string name;
+  URDFReaderd::read_from_string(URDF, name, links, joints);
+  shared_ptr<RCArticulatedBodyd> body(new RCArticulatedBodyd);
+  body->body_id = name;
+  body->algorithm_type = RCArticulatedBodyd::eFeatherstone;
+  body->set_links_and_joints(links, joints);
+
+  VectorNd gc, gv;
+  body->get_generalized_coordinates_euler(gc);
+  body->get_generalized_velocity(DynamicBodyd::eSpatial, gv);
+  for (unsigned i=0; i< gc.size(); i++)
+  {
+    gc[i] = 0.1*(i+1);
+    gv[i] = -0.2*(i+1);
+  }
+  body->set_generalized_coordinates_euler(gc);
+  body->set_generalized_velocity(DynamicBodyd::eSpatial, gv);
+  return body;
+}
+
+// computes the generalized acceleration of a body under gravity
+static VectorNd calc_accel(shared_ptr<RCArticulatedBodyd> body)
+{
+  body->reset_accumulators();
+  for (unsigned i=0; i< body->get_links().size(); i++)
+  {
+    shared_ptr<RigidBodyd> link = body->get_links()[i];
+    link->add_force(SForced(0.0, 0.0, -9.8*link->get_inertia().m, 0.0, 0.0, 0.0, link->get_mixed_pose()));
+  }
+  body->calc_fwd_dyn();
+  VectorNd ga;
+  body->get_generalized_acceleration(ga);
+  return ga;
+}
+
+TEST(CompiledModelTest, RoundTrip)
+{
+  shared_ptr<RCArticulatedBodyd> body1 = construct_body();
+  ASSERT_TRUE(body1->save_compiled(FNAME, 12345));
+  shared_ptr<RCArticulatedBodyd> body2 = RCArticulatedBodyd::load_compiled(FNAME, 12345);
+  ASSERT_TRUE(body2);
+
+  // check the topology and the indices
+  EXPECT_EQ(body1->body_id, body2->body_id);
+  EXPECT_EQ(body1->algorithm_type, body2->algorithm_type);
+  EXPECT_EQ(body1->is_floating_base(), body2->is_floating_base());
+  ASSERT_EQ(body1->get_links().size(), body2->get_links().size());
+  ASSERT_EQ(body1->get_joints().size(), body2->get_joints().size());
+  for (unsigned i=0; i< body1->get_links().size(); i++)
+    EXPECT_EQ(body1->get_links()[i]->body_id, body2->get_links()[i]->body_id);
+  for (unsigned i=0; i< body1->get_joints().size(); i++)
+  {
+    shared_ptr<Jointd> j1 = body1->get_joints()[i], j2 = body2->get_joints()[i];
+    EXPECT_EQ(j1->joint_id, j2->joint_id);
+    EXPECT_EQ(j1->num_dof(), j2->num_dof());
+    EXPECT_EQ(j1->get_coord_index(), j2->get_coord_index());
+    EXPECT_EQ(j1->get_inboard_link()->get_index(), j2->get_inboard_link()->get_index());
+    EXPECT_EQ(j1->get_outboard_link()->get_index(), j2->get_outboard_link()->get_index());
+  }
+
+  // check the state and the link poses
+  VectorNd gc1, gc2, gv1, gv2;
+  body1->get_generalized_coordinates_euler(gc1);
+  body2->get_generalized_coordinates_euler(gc2);
+  body1->get_generalized_velocity(DynamicBodyd::eSpatial, gv1);
+  body2->get_generalized_velocity(DynamicBodyd::eSpatial, gv2);
+  ASSERT_EQ(gc1.size(), gc2.size());
+  ASSERT_EQ(gv1.size(), gv2.size());
+  for (unsigned i=0; i< gc1.size(); i++)
+    EXPECT_NEAR(gc1[i], gc2[i], 1e-12);
+  for (unsigned i=0; i< gv1.size(); i++)
+    EXPECT_NEAR(gv1[i], gv2[i], 1e-12);
+  for (unsigned i=0; i< body1->get_links().size(); i++)
+  {
+    Transform3d T = Pose3d::calc_relative_pose(body1->get_links()[i]->get_pose(), body2->get_links()[i]->get_pose());
+    EXPECT_NEAR(T.x.norm(), 0.0, 1e-10);
+    EXPECT_NEAR(Quatd::calc_angle(T.q, Quatd::identity()), 0.0, 1e-6);
+  }
+
+  // check the dynamics
+  MatrixNd M1, M2;
+  body1->get_generalized_inertia(M1);
+  body2->get_generalized_inertia(M2);
+  ASSERT_EQ(M1.rows(), M2.rows());
+  for (unsigned i=0; i< M1.rows(); i++)
+    for (unsigned j=0; j< M1.columns(); j++)
+      EXPECT_NEAR(M1(i,j), M2(i,j), 1e-10);
+  VectorNd ga1 = calc_accel(body1), ga2 = calc_accel(body2);
+  ASSERT_EQ(ga1.size(), ga2.size());
+  for (unsigned i=0; i< ga1.size(); i++)
+    EXPECT_NEAR(ga1[i], ga2[i], 1e-8);
+
+  std::remove(FNAME);
+}
+
+TEST(CompiledModelTest, RejectsStaleAndMismatched)
+{
+  shared_ptr<RCArticulatedBodyd> body = construct_body();
+  ASSERT_TRUE(body->save_compiled(FNAME, 12345));
+
+  // a different source hash indicates a stale file; zero skips the check
+  EXPECT_FALSE(RCArticulatedBodyd::load_compiled(FNAME, 54321));
+  EXPECT_TRUE(RCArticulatedBodyd::load_compiled(FNAME));
+
+  // the single precision library cannot read a double precision model
+  EXPECT_FALSE(RCArticulatedBodyf::load_compiled(FNAME));
+
+  // truncated files are rejected
+  std::ifstream in(FNAME, std::ios::binary);
+  string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out(FNAME, std::ios::binary | std::ios::trunc);
+  out.write(content.c_str(), content.size()/2);
+  out.close();
+  EXPECT_FALSE(RCArticulatedBodyd::load_compiled(FNAME));
+
+  std::remove(FNAME);
+}
+
+// writes a compiled model with a 32-bit field overwritten and verifies that
+// it is rejected
+static void expect_rejects_patched(const string& content, size_t offset, boost::uint32_t value)
+{
+  string patched = content;
+  std::memcpy(&patched[offset], &value, sizeof(value));
+  std::ofstream out(FNAME, std::ios::binary | std::ios::trunc);
+  out.write(patched.c_str(), patched.size());
+  out.close();
+  EXPECT_FALSE(RCArticulatedBodyd::load_compiled(FNAME));
+}
+
+TEST(CompiledModelTest, RejectsCorrupt)
+{
+  // the layout of the (double precision) compiled model records
+  const size_t HEADER_SIZE = 56, LINK_SIZE = 224, JOINT_SIZE = 312;
+  const size_t NLINKS = 16, ALGORITHM = 24, RFTYPE = 28;
+  const size_t IMPLICIT = 12, ORDER = 24;
+
+  shared_ptr<RCArticulatedBodyd> body = construct_body();
+  ASSERT_TRUE(body->save_compiled(FNAME));
+  std::ifstream in(FNAME, std::ios::binary);
+  string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  ASSERT_TRUE(RCArticulatedBodyd::load_compiled(FNAME));
+
+  // out of range enumerations
+  expect_rejects_patched(content, ALGORITHM, 2);
+  expect_rejects_patched(content, RFTYPE, 1000);
+
+  // joint orders that are out of range or shared by two joints
+  boost::uint32_t nlinks, implicit, order;
+  std::memcpy(&nlinks, &content[NLINKS], sizeof(nlinks));
+  const size_t JOINT0 = HEADER_SIZE + LINK_SIZE*nlinks, JOINT1 = JOINT0 + JOINT_SIZE;
+  std::memcpy(&implicit, &content[JOINT0 + IMPLICIT], sizeof(implicit));
+  std::memcpy(&order, &content[JOINT0 + ORDER], sizeof(order));
+  expect_rejects_patched(content, JOINT0 + ORDER, 0x7fffffff);
+  string duplicate = content;
+  std::memcpy(&duplicate[JOINT1 + IMPLICIT], &implicit, sizeof(implicit));
+  expect_rejects_patched(duplicate, JOINT1 + ORDER, order);
+
+  // too short for a header
+  std::ofstream out(FNAME, std::ios::binary | std::ios::trunc);
+  out.write(content.c_str(), HEADER_SIZE/2);
+  out.close();
+  EXPECT_FALSE(RCArticulatedBodyd::load_compiled(FNAME));
+
+  std::remove(FNAME);
+}
+
+TEST(CompiledModelTest, Clone)
+{
+  shared_ptr<RCArticulatedBodyd> body1 = construct_body();
+  Jointd& joint = *body1->get_joints().front();
+  joint.force.set_zero(joint.num_dof());
+  joint.force[0] = 0.5;
+  shared_ptr<RCArticulatedBodyd> body2 = body1->clone();
+  ASSERT_TRUE(body2);
+  ASSERT_EQ(body1->get_links().size(), body2->get_links().size());
+  ASSERT_EQ(body1->get_joints().size(), body2->get_joints().size());
+
+  // the clone has its own links and joints 
+  for (unsigned i=0; i< body1->get_links().size(); i++)
+    EXPECT_NE(body1->get_links()[i], body2->get_links()[i]);
+  for (unsigned i=0; i< body1->get_joints().size(); i++)
+  {
+    EXPECT_NE(body1->get_joints()[i], body2->get_joints()[i]);
+    EXPECT_EQ(body1->get_joints()[i]->get_coord_index(), body2->get_joints()[i]->get_coord_index());
+  }
+  EXPECT_NEAR(body2->get_joints().front()->force[0], 0.5, 1e-12);
+
+  // no frame of the clone refers to a frame of the original 
+  std::set<const Pose3d*> frames1;
+  for (unsigned i=0; i< body1->get_links().size(); i++)
+    frames1.insert(body1->get_links()[i]->get_pose().get());
+  for (unsigned i=0; i< body1->get_joints().size(); i++)
+    frames1.insert(body1->get_joints()[i]->get_pose().get());
+  for (unsigned i=0; i< body2->get_links().size(); i++)
+  {
+    shared_ptr<RigidBodyd> link = body2->get_links()[i];
+    for (shared_ptr<const Pose3d> P = link->get_pose(); P; P = P->rpose)
+      EXPECT_EQ(frames1.count(P.get()), 0u);
+    EXPECT_EQ(frames1.count(link->get_velocity().pose.get()), 0u);
+    EXPECT_EQ(frames1.count(link->get_inertia().pose.get()), 0u);
+  }
+
+  // the clone has the same state and dynamics
+  VectorNd gv1, gv2;
+  body1->get_generalized_velocity(DynamicBodyd::eSpatial, gv1);
+  body2->get_generalized_velocity(DynamicBodyd::eSpatial, gv2);
+  ASSERT_EQ(gv1.size(), gv2.size());
+  for (unsigned i=0; i< gv1.size(); i++)
+    EXPECT_NEAR(gv1[i], gv2[i], 1e-12);
+  VectorNd ga1 = calc_accel(body1), ga2 = calc_accel(body2);
+  ASSERT_EQ(ga1.size(), ga2.size());
+  for (unsigned i=0; i< ga1.size(); i++)
+    EXPECT_NEAR(ga1[i], ga2[i], 1e-8);
+
+  // changing the state of the clone does not change the original 
+  VectorNd gc1, gc2;
+  body1->get_generalized_coordinates_euler(gc1);
+  body2->get_generalized_coordinates_euler(gc2);
+  for (unsigned i=0; i< gc2.size(); i++)
+    gc2[i] += 1.0;
+  body2->set_generalized_coordinates_euler(gc2);
+  VectorNd gc1_after;
+  body1->get_generalized_coordinates_euler(gc1_after);
+  for (unsigned i=0; i< gc1.size(); i++)
+    EXPECT_EQ(gc1[i], gc1_after[i]);
+  double diff = 0.0;
+  for (unsigned i=0; i< body1->get_links().size(); i++)
+  {
+    Transform3d T = Pose3d::calc_relative_pose(body1->get_links()[i]->get_pose(), body2->get_links()[i]->get_pose());
+    diff = std::max(diff, T.x.norm() + Quatd::calc_angle(T.q, Quatd::identity()));
+  }
+  EXPECT_GT(diff, 0.1);
+}
+
+TEST(CompiledModelTest, CloneTopology)
+{
+  shared_ptr<RCArticulatedBodyd> body1 = construct_body();
+  shared_ptr<RCArticulatedBodyd> body2 = body1->clone();
+  ASSERT_TRUE(body2);
+
+  // the copied links and joints refer only to one another and to the clone,
+  // in the same order as the original
+  const vector<shared_ptr<RigidBodyd> >& links1 = body1->get_links();
+  const vector<shared_ptr<RigidBodyd> >& links2 = body2->get_links();
+  for (unsigned i=0; i< links2.size(); i++)
+  {
+    EXPECT_EQ(links2[i]->get_articulated_body(), body2);
+    EXPECT_EQ(links2[i]->get_index(), links1[i]->get_index());
+  }
+  for (unsigned i=0; i< body2->get_joints().size(); i++)
+  {
+    shared_ptr<Jointd> joint1 = body1->get_joints()[i];
+    shared_ptr<Jointd> joint2 = body2->get_joints()[i];
+    EXPECT_EQ(joint2->get_articulated_body(), body2);
+    EXPECT_EQ(joint2->get_index(), joint1->get_index());
+    EXPECT_EQ(joint2->get_inboard_link(), links2[joint1->get_inboard_link()->get_index()]);
+    EXPECT_EQ(joint2->get_outboard_link(), links2[joint1->get_outboard_link()->get_index()]);
+  }
+
+  // the joint state of each body is its own
+  unsigned j = 0;
+  while (body1->get_joints()[j]->num_dof() == 0)
+    j++;
+  shared_ptr<Jointd> joint1 = body1->get_joints()[j];
+  shared_ptr<Jointd> joint2 = body2->get_joints()[j];
+  double q1 = joint1->q[0], qd1 = joint1->qd[0];
+  joint1->force.set_zero(joint1->num_dof());
+  joint2->q[0] += 0.25;
+  joint2->qd[0] += 1.0;
+  joint2->force.set_zero(joint2->num_dof());
+  joint2->force[0] = 2.0;
+  EXPECT_EQ(joint1->q[0], q1);
+  EXPECT_EQ(joint1->qd[0], qd1);
+  EXPECT_EQ(joint1->force[0], 0.0);
+}
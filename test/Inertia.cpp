@@ -1,8 +1,12 @@
 #include <Ravelin/Matrix3d.h>
 #include <Ravelin/SpatialRBInertiad.h>
 #include <Ravelin/SpatialABInertiad.h>
+#include <Ravelin/PackedSpatialABInertiad.h>
+#include <Ravelin/LinAlgd.h>
 #include <Ravelin/Pose3d.h>
 #include <Ravelin/MatrixNd.h>
+#include <Ravelin/SpatialArrayd.h>
+#include <Ravelin/FrameRegistryd.h>
 #include "gtest/gtest.h"
 
 using boost::shared_ptr;
@@ -224,3 +228,175 @@ TEST(InertiaTest, SubInertias)
       EXPECT_NEAR(Jm(i,j), Ja1m(i,j), 1e-6);
 }
 
+// verifies that the packed AB inertia kernels match the full AB inertia 
+TEST(InertiaTest, PackedABInertia)
+{
+  // setup two poses
+  shared_ptr<Pose3d> P(new Pose3d), Q(new Pose3d);
+  P->x = Origin3d(rand_double(), rand_double(), rand_double());
+  P->q = Quatd(rand_double(), rand_double(), rand_double(), rand_double());
+  P->q.normalize();
+  Q->x = Origin3d(rand_double(), rand_double(), rand_double());
+  Q->q = Quatd(rand_double(), rand_double(), rand_double(), rand_double());
+  Q->q.normalize();
+
+  // setup an articulated body inertia in P
+  SpatialRBInertiad J(P);
+  J.m = 2.0;
+  J.h = Origin3d(rand_double(), rand_double(), rand_double());
+  J.J = Matrix3d(1.0, 0.1, 0.1, 0.1, 1.0, 0.1, 0.1, 0.1, 1.0);
+  SpatialABInertiad I = J;
+  PackedSpatialABInertiad Ip(J);
+
+  // setup a random velocity
+  SVelocityd v(P);
+  for (unsigned i=0; i< 6; i++)
+    v[i] = rand_double();
+
+  // multiplication 
+  SMomentumd m = I*v, mp = Ip*v;
+  for (unsigned i=0; i< 6; i++)
+    EXPECT_NEAR(m[i], mp[i], 1e-10);
+
+  // transformation (out of place, then accumulated in place)
+  MatrixNd IQm, IpQm;
+  Pose3d::transform(Q, I).to_matrix(IQm);
+  PackedSpatialABInertiad IpQ = PackedSpatialABInertiad::transform(Q, Ip);
+  IpQ.to_ab_inertia().to_matrix(IpQm);
+  EXPECT_TRUE(IpQ.pose == Q);
+  for (unsigned i=0; i< 6; i++)
+    for (unsigned j=0; j< 6; j++)
+      EXPECT_NEAR(IQm(i,j), IpQm(i,j), 1e-10);
+  IpQ.add_transformed(Ip);
+  IpQ.to_ab_inertia().to_matrix(IpQm);
+  for (unsigned i=0; i< 6; i++)
+    for (unsigned j=0; j< 6; j++)
+      EXPECT_NEAR(IQm(i,j)*2.0, IpQm(i,j), 1e-10);
+
+  // rank-2 update I - U*inv(D)*U', where U = I*s and D = s'*I*s
+  std::vector<SVelocityd> s(2, SVelocityd(P));
+  for (unsigned i=0; i< s.size(); i++)
+    for (unsigned j=0; j< 6; j++)
+      s[i][j] = rand_double();
+  std::vector<SMomentumd> U;
+  I.mult(s, U);
+  MatrixNd D(2,2), W(2,6), Dinv;
+  for (unsigned i=0; i< 2; i++)
+  {
+    for (unsigned j=0; j< 2; j++)
+      D(i,j) = s[i].dot(U[j]);
+    for (unsigned j=0; j< 6; j++)
+      W(i,j) = U[i][j];
+  }
+  Dinv = D;
+  LinAlgd LA;
+  LA.invert(Dinv);
+  LA.solve_fast(D, W);
+  PackedSpatialABInertiad Ip2 = Ip;
+  Ip2.rank_update(U, W);
+
+  // the update applied to v is I*v - U*inv(D)*(s'*I*v)
+  SMomentumd m2 = m;
+  for (unsigned i=0; i< 2; i++)
+    for (unsigned j=0; j< 2; j++)
+      m2 -= U[i]*(Dinv(i,j)*s[j].dot(m));
+  mp = Ip2*v;
+  for (unsigned i=0; i< 6; i++)
+    EXPECT_NEAR(m2[i], mp[i], 1e-8);
+
+  // rank-1 update 
+  Ip.rank_update(U[0], 1.0/s[0].dot(U[0]));
+  m2 = m - U[0]*(s[0].dot(m)/s[0].dot(U[0]));
+  mp = Ip*v;
+  for (unsigned i=0; i< 6; i++)
+    EXPECT_NEAR(m2[i], mp[i], 1e-8);
+}
+
+// verifies that batch transforms of spatial arrays match individual transforms
+TEST(SpatialArrayTest, Transform)
+{
+  // setup two poses
+  shared_ptr<Pose3d> P(new Pose3d), Q(new Pose3d);
+  P->x = Origin3d(rand_double(), rand_double(), rand_double());
+  P->q = Quatd(rand_double(), rand_double(), rand_double(), rand_double());
+  P->q.normalize();
+  Q->x = Origin3d(rand_double(), rand_double(), rand_double());
+  Q->q = Quatd(rand_double(), rand_double(), rand_double(), rand_double());
+  Q->q.normalize();
+
+  // setup random forces in P
+  std::vector<SForced> f(7), fQ, fQ2;
+  for (unsigned i=0; i< f.size(); i++)
+  {
+    f[i].pose = P;
+    for (unsigned j=0; j< 6; j++)
+      f[i][j] = rand_double();
+  }
+
+  // transform individually and as an array (out of place and in place)
+  Pose3d::transform(Q, f, fQ);
+  SpatialArrayd A(f), B;
+  A.transform(Q, B);
+  A.transform(Q);
+  B.to_vector(fQ2);
+  EXPECT_TRUE(A.pose == Q && B.pose == Q);
+  for (unsigned i=0; i< f.size(); i++)
+    for (unsigned j=0; j< 6; j++)
+    {
+      EXPECT_NEAR(fQ[i][j], fQ2[i][j], 1e-10);
+      EXPECT_NEAR(fQ[i][j], A.get<SForced>(i)[j], 1e-10);
+    }
+
+  // verify the matrix view and linear combinations 
+  VectorNd x(f.size()), y;
+  SVelocityd v = SVelocityd::zero(Q);
+  for (unsigned i=0; i< f.size(); i++)
+  {
+    x[i] = rand_double();
+    v += SVelocityd(A.column_data(i), Q)*x[i];
+  }
+  A.mult(x, y);
+  EXPECT_EQ(A.matrix().rows(), 6u);
+  EXPECT_EQ(A.matrix().columns(), f.size());
+  for (unsigned j=0; j< 6; j++)
+    EXPECT_NEAR(v[j], y[j], 1e-10);
+}
+
+// verifies that frame handles refer to registered poses and behave like the 
+// shared pointers that they replace
+TEST(FrameRegistryTest, Handles)
+{
+  FrameRegistryd registry;
+  shared_ptr<Pose3d> P(new Pose3d), Q(new Pose3d);
+  P->x = Origin3d(rand_double(), rand_double(), rand_double());
+  Q->rpose = P;
+  const unsigned IDP = registry.add(P);
+  const unsigned IDQ = registry.add(Q);
+  EXPECT_EQ(registry.add(P), IDP);
+  EXPECT_EQ(registry.size(), 2u);
+
+  // handles compare equal to the poses they refer to
+  FrameHandled hP = registry[IDP], hQ = registry.get_handle(IDQ);
+  EXPECT_TRUE(hP == P && P == hP && hP != hQ && !(hQ != Q));
+  EXPECT_TRUE(hP.get() == P.get() && registry.contains(hQ));
+  EXPECT_EQ(registry.find(hQ), IDQ);
+  EXPECT_FALSE(!hP);
+  EXPECT_TRUE(!FrameHandled());
+
+  // handles are locked to get shared pointers
+  shared_ptr<const Pose3d> sQ = hQ.lock();
+  EXPECT_TRUE(sQ == Q && sQ->rpose == P && lock_frame(hQ) == Q);
+
+  // frame checks still apply to vectors defined through handles (vectors
+  // store shared pointers unless the library uses handles)
+  #ifdef RAVELIN_FRAME_HANDLES
+  Vector3d v(1.0, 2.0, 3.0, hP), w(1.0, 2.0, 3.0, P);
+  #else
+  Vector3d v(1.0, 2.0, 3.0, hP.lock()), w(1.0, 2.0, 3.0, P);
+  #endif
+  EXPECT_TRUE(v.pose == w.pose);
+  Vector3d vQ = Pose3d::transform_vector(Q, v);
+  EXPECT_TRUE(vQ.pose == Q);
+  EXPECT_NEAR((Pose3d::transform_vector(P, vQ) - w).norm(), 0.0, 1e-10);
+  EXPECT_THROW(v + vQ, FrameException);
+}
@@ -5,9 +5,14 @@ static const unsigned MIN_SIZE = 0, MAX_SIZE = 7;
 #ifdef SINGLE_PRECISION
     #include <Ravelin/LinAlgf.h>
     typedef Ravelin::LinAlgf LinAlg;
+    typedef float Real;
 #else
     #include <Ravelin/LinAlgd.h>
     typedef Ravelin::LinAlgd LinAlg;
+    typedef double Real;
+    #include <Ravelin/LinAlgMixed.h>
+    #include <Ravelin/ContactSolverd.h>
+    #include <Ravelin/RigidBodyd.h>
 #endif
 
 #include <gtest/gtest.h>
@@ -97,6 +102,308 @@ TEST(LinAlgTest,SVD){
     }
 }
 
+TEST(LinAlgTest,LowRank){
+    LinAlg * LA = new LinAlg();
+    const unsigned m = 60, n = 40, k = 3;
+
+    // create a rank k matrix A = L*R'
+    MatR L = randM(m,k), R = randM(n,k), A(m,n), B, U, V, US, AB;
+    VecR s;
+    L.mult_transpose(R,A);
+
+    /// Test the randomized SVD (exact for rank k matrices)
+    LA->svd_randomized(A,k,U,s,V);
+    MatR S(k,k);
+    S.set_zero();
+    for(unsigned i=0;i<k;i++)
+        S(i,i) = s[i];
+    U.mult(S,US);
+    US.mult_transpose(V,AB);
+    checkError(std::cerr, "svd_randomized", A,AB);
+
+    /// Test the truncated SVD
+    B = A;
+    LA->svd_truncated(B,k,U,s,V);
+    for(unsigned i=0;i<k;i++)
+        S(i,i) = s[i];
+    U.mult(S,US);
+    US.mult_transpose(V,AB);
+    checkError(std::cerr, "svd_truncated", A,AB);
+
+    /// Test rank and nullspace determination
+    B = A;
+    EXPECT_EQ(LA->calc_rank_lowrank(B,k+2),k);
+    MatR ns, Ans;
+    LA->nullspace_lowrank(A,k+2,ns);
+    EXPECT_EQ(ns.columns(),n-k);
+    A.mult(ns,Ans);
+    checkError(std::cerr, "nullspace_lowrank", MatR::zero(m,n-k),Ans);
+
+    /// Test the low rank pseudo-inverse: A*pinv(A)*A = A
+    B = A;
+    LA->pseudo_invert_lowrank(B,k+2);
+    A.mult(B,US);
+    US.mult(A,AB);
+    checkError(std::cerr, "pseudo_invert_lowrank", A,AB);
+
+    /// Test the Lanczos eigensolver against eig_symm
+    MatR P = randM(n,n), SYM(n,n), evecs, evecs2, Ax, lx;
+    VecR evals, evals2;
+    P.mult_transpose(P,SYM);
+    B = SYM;
+    LA->eig_symm(B,evals);
+    LA->eig_symm_lanczos(SYM,k,evals2,evecs);
+    for(unsigned i=0;i<k;i++)
+        EXPECT_NEAR(evals2[i],evals[n-k+i],NEAR_ZERO*std::max(1.0,(double) evals[n-1]));
+    SYM.mult(evecs,Ax);
+    lx = evecs;
+    for(unsigned i=0;i<k;i++)
+        lx.column(i) *= evals2[i];
+    checkError(std::cerr, "eig_symm_lanczos", lx,Ax);
+}
+
+TEST(LinAlgTest,Reserve){
+#if defined(NDEBUG) || defined(REENTRANT)
+    GTEST_SKIP() << "allocations are only counted in debug, non-reentrant builds";
+#endif
+    LinAlg * LA = new LinAlg();
+    const unsigned MAX = 16;
+    LA->reserve(MAX,MAX);
+
+    MatR A(MAX,MAX), B(MAX,MAX), U(MAX,MAX), V(MAX,MAX), AB(MAX,MAX), x(MAX,1), b(MAX,1);
+    VecR s(MAX), evals(MAX);
+    std::vector<int> piv(MAX);
+    std::vector<MatR> As, xs;
+    for(unsigned r=1;r<=MAX;r++){
+        As.push_back(randM(r,r));
+        xs.push_back(randM(r,1));
+    }
+
+    // solves and factorizations should not allocate after reserve()
+    const unsigned long NALLOCS = LA->allocations();
+    for(unsigned r=1;r<=MAX;r++){
+        A = As[r-1];
+        B.resize(r,r);
+        A.mult_transpose(A,B);
+        AB = B;
+        LA->svd1(AB,U,s,V);
+        AB = B;
+        LA->eig_symm(AB,evals);
+        AB = B;
+        x = xs[r-1];
+        B.mult(x,b);
+        LA->solve_fast(AB,b);
+        AB = B;
+        LA->factor_chol(AB);
+        AB = A;
+        LA->factor_LU(AB,piv);
+    }
+    EXPECT_EQ(LA->allocations(),NALLOCS);
+
+    // factorizations should remain correct using the cached workspaces
+    A = randM(MAX,MAX);
+    x = randM(MAX,1);
+    A.mult(x,b);
+    AB = A;
+    LA->solve_fast(AB,b);
+    checkError(std::cerr, "solve_fast (reserved)", x,b);
+}
+
+#ifndef SINGLE_PRECISION
+TEST(LinAlgTest,MixedPrecision){
+    Ravelin::LinAlgMixed LA;
+    const unsigned n = 50;
+    MatR A = randM(n,n), SPD(n,n), SYM(n,n), x = randM(n,3), b(n,3), xb(n,3);
+    A.mult_transpose(A,SPD);
+    for(unsigned i=0;i<n;i++)
+        SPD(i,i) += 1.0;
+    SYM = SPD;
+    for(unsigned i=0;i<n;i++)
+        SYM(i,i) -= 5.0;
+
+    /// Test LU with refinement
+    A.mult(x,b);
+    xb = b;
+    LA.solve_LU(A,xb);
+    EXPECT_FALSE(LA.fallback);
+    checkError(std::cerr, "solve_LU (mixed)", x,xb);
+
+    /// Test Cholesky with refinement
+    SPD.mult(x,b);
+    xb = b;
+    LA.solve_chol(SPD,xb);
+    EXPECT_FALSE(LA.fallback);
+    checkError(std::cerr, "solve_chol (mixed)", x,xb);
+
+    /// Test LDL' with refinement (single right hand side)
+    VecR v = randV(n), vb(n);
+    SYM.mult(v,vb);
+    LA.solve_LDL(SYM,vb);
+    checkError(std::cerr, "solve_LDL (mixed)", v,vb);
+
+    /// Test fallback to double precision for a matrix that cannot be 
+    /// represented in single precision
+    MatR H = A;
+    for(unsigned j=0;j<n;j++)
+        H(0,j) *= 1e40;
+    H.mult(x,b);
+    xb = b;
+    LA.solve_LU(H,xb);
+    EXPECT_TRUE(LA.fallback);
+    checkError(std::cerr, "solve_LU (mixed, fallback)", x,xb);
+}
+#endif
+
+#ifndef SINGLE_PRECISION
+TEST(LinAlgTest,ContactSolver){
+    Ravelin::ContactSolverd CS;
+    LinAlg * LA = new LinAlg();
+
+    /// Setup two rigid bodies
+    boost::shared_ptr<Ravelin::RigidBodyd> rb[2];
+    for(unsigned b=0;b<2;b++){
+        rb[b] = boost::shared_ptr<Ravelin::RigidBodyd>(new Ravelin::RigidBodyd);
+        rb[b]->set_pose(Ravelin::Pose3d(Ravelin::Quatd::normalize(Ravelin::Quatd(0.1,0.2*b,0.3,1.0)), Ravelin::Origin3d(b,0,0)));
+        Ravelin::SpatialRBInertiad J;
+        J.m = 2.0+b;
+        J.J = Ravelin::Matrix3d(1.0,0.1,0.0,0.1,2.0,0.2,0.0,0.2,3.0+b);
+        J.pose = rb[b]->get_pose();
+        rb[b]->set_inertia(J);
+    }
+
+    /// Test Delassus assembly: rows 0-2 act on the first body, rows 2-4 on
+    /// the second (row 2 is shared)
+    const unsigned m = 5;
+    std::vector<Ravelin::ContactSolverd::JacobianBlock> blocks(2);
+    MatR Jfull(m,12);
+    Jfull.set_zero();
+    for(unsigned b=0;b<2;b++){
+        blocks[b].body = rb[b];
+        blocks[b].row_start = 2*b;
+        blocks[b].J = randM(3,6);
+        Jfull.block(2*b,2*b+3,6*b,6*b+6) = blocks[b].J;
+    }
+    MatR M(12,12), Mb, iMJt, Wdense, Wsparse;
+    M.set_zero();
+    for(unsigned b=0;b<2;b++)
+        M.block(6*b,6*b+6,6*b,6*b+6) = rb[b]->get_generalized_inertia(Mb);
+    MatR::transpose(Jfull,iMJt);
+    LA->solve_fast(M,iMJt);
+    MatR W;
+    Jfull.mult(iMJt,W);
+    CS.calc_delassus(m,blocks,Wdense);
+    checkError(std::cerr, "calc_delassus (dense)", W,Wdense);
+    Ravelin::SparseMatrixNd S;
+    CS.calc_delassus(m,blocks,S);
+    EXPECT_EQ(S.get_nnz(), 17);
+    checkError(std::cerr, "calc_delassus (sparse)", W,S.to_dense(Wsparse));
+
+    /// Test PGS and Lemke on an LCP
+    const unsigned n = 20;
+    MatR A = randM(n,n), SPD(n,n);
+    A.mult_transpose(A,SPD);
+    for(unsigned i=0;i<n;i++)
+        SPD(i,i) += 1.0;
+    VecR q = randV(n), lo(n), hi(n), z, zl, w;
+    for(unsigned i=0;i<n;i++){
+        q[i] -= 0.5;
+        lo[i] = 0.0;
+        hi[i] = std::numeric_limits<double>::max();
+    }
+    EXPECT_TRUE(CS.solve_lemke(SPD,q,zl));
+    SPD.mult(zl,w) += q;
+    for(unsigned i=0;i<n;i++){
+        EXPECT_GT(zl[i], -NEAR_ZERO);
+        EXPECT_GT(w[i], -NEAR_ZERO);
+        EXPECT_NEAR(zl[i]*w[i], 0.0, NEAR_ZERO);
+    }
+    CS.max_iterations = 100000;
+    CS.tolerance = 1e-10;
+    EXPECT_TRUE(CS.solve_pgs(Ravelin::SparseMatrixNd(SPD),q,lo,hi,z));
+    EXPECT_EQ(CS.residuals.size(), CS.iterations);
+    checkError(std::cerr, "solve_pgs", zl,z);
+
+    /// Test Lemke with enough pivots to refactor the updated basis (every
+    /// variable is nonzero at the solution of an LCP with an M-matrix and q < 0)
+    MatR MM = randM(n,n);
+    MM *= -0.5;
+    for(unsigned i=0;i<n;i++)
+        MM(i,i) = (Real) n;
+    VecR qneg(n), zneg;
+    for(unsigned i=0;i<n;i++)
+        qneg[i] = -1.0 - q[i];
+    EXPECT_TRUE(CS.solve_lemke(MM,qneg,zneg));
+    EXPECT_EQ(CS.iterations, n);
+    MM.mult(zneg,w) += qneg;
+    for(unsigned i=0;i<n;i++){
+        EXPECT_GT(zneg[i], -NEAR_ZERO);
+        EXPECT_GT(w[i], -NEAR_ZERO);
+        EXPECT_NEAR(zneg[i]*w[i], 0.0, NEAR_ZERO);
+    }
+
+    /// Test warm starting
+    CS.solve_pgs(SPD,q,lo,hi,z);
+    EXPECT_EQ(CS.iterations, 1);
+    EXPECT_TRUE(CS.solve_lemke(SPD,q,zl));
+    EXPECT_EQ(CS.iterations, 0);
+    delete LA;
+}
+#endif
+
+TEST(LinAlgTest,BuiltinBLAS){
+    LinAlg * LA = new LinAlg();
+    const unsigned m = 150, n = 90, k = 300;
+    const CBLAS_TRANSPOSE TRANS[2] = { CblasNoTrans, CblasTrans };
+
+    /// Test gemm for all transpositions against the external BLAS
+    for(unsigned ta=0;ta<2;ta++)
+        for(unsigned tb=0;tb<2;tb++){
+            MatR A = (ta == 0) ? randM(m,k) : randM(k,m);
+            MatR B = (tb == 0) ? randM(k,n) : randM(n,k);
+            MatR C = randM(m,n), C2 = C;
+            CBLAS::set_backend(CBLAS::eExternal);
+            CBLAS::gemm(CblasColMajor, TRANS[ta], TRANS[tb], m, n, k, (Real) 0.5, A.data(), A.leading_dim(), B.data(), B.leading_dim(), (Real) -2.0, C.data(), C.leading_dim());
+            CBLAS::set_backend(CBLAS::eBuiltin);
+            CBLAS::gemm(CblasColMajor, TRANS[ta], TRANS[tb], m, n, k, (Real) 0.5, A.data(), A.leading_dim(), B.data(), B.leading_dim(), (Real) -2.0, C2.data(), C2.leading_dim());
+            checkError(std::cerr, "gemm (built-in)", C,C2);
+        }
+
+    /// Test trsm for all sides, triangles, and transpositions
+    const CBLAS_SIDE SIDE[2] = { CblasLeft, CblasRight };
+    const CBLAS_UPLO UPLO[2] = { CblasUpper, CblasLower };
+    for(unsigned s=0;s<2;s++)
+        for(unsigned u=0;u<2;u++)
+            for(unsigned t=0;t<2;t++){
+                unsigned na = (s == 0) ? m : n;
+                MatR A = randM(na,na);
+                for(unsigned i=0;i<na;i++)
+                    A(i,i) += (Real) na;
+                MatR B = randM(m,n), B2 = B;
+                CBLAS::set_backend(CBLAS::eExternal);
+                CBLAS::trsm(SIDE[s], UPLO[u], TRANS[t], m, n, (Real) 2.0, A.data(), A.leading_dim(), B.data(), B.leading_dim());
+                CBLAS::set_backend(CBLAS::eBuiltin);
+                CBLAS::trsm(SIDE[s], UPLO[u], TRANS[t], m, n, (Real) 2.0, A.data(), A.leading_dim(), B2.data(), B2.leading_dim());
+                checkError(std::cerr, "trsm (built-in)", B,B2);
+            }
+
+    /// Test the blocked Cholesky and LU factorizations 
+    MatR A = randM(m,m), SPD(m,m), x = randM(m,1), b(m,1), AB;
+    A.mult_transpose(A,SPD);
+    for(unsigned i=0;i<m;i++)
+        SPD(i,i) += (Real) 1.0;
+    CBLAS::set_backend(CBLAS::eBuiltin);
+    SPD.mult(x,b);
+    AB = SPD;
+    EXPECT_TRUE(LA->factor_chol(AB));
+    LA->solve_chol_fast(AB,b);
+    checkError(std::cerr, "factor_chol (built-in)", x,b);
+    A.mult(x,b);
+    AB = A;
+    LA->solve_fast(AB,b);
+    checkError(std::cerr, "solve_fast (built-in)", x,b);
+    CBLAS::set_backend(CBLAS::eExternal);
+}
+
 TEST(LinAlgTest,factor_QR_AR_Q){
     LinAlg * LA = new LinAlg();
     for(int j=2;j<MAX_SIZE;j++){
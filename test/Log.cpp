@@ -0,0 +1,124 @@
+#include <pthread.h>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Ravelin/Log.h>
+#include <Ravelin/Vector3d.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using std::vector;
+
+static const unsigned LOG_TEST = 1 << 20;
+static const unsigned NMESSAGES = 2000;
+
+// logs numbered messages from another thread
+static void* log_thread(void* arg)
+{
+  long id = (long) arg;
+  for (unsigned i=0; i< NMESSAGES; i++)
+    FILE_LOG(LOG_TEST) << "thread " << id << " message " << i << std::endl;
+  return NULL;
+}
+
+// reads the lines of a file, without their "- h:m:s level: " prefixes
+static vector<string> read_messages(const char* fname)
+{
+  std::ifstream in(fname);
+  vector<string> messages;
+  string line;
+  while (std::getline(in, line))
+  {
+    size_t colon = line.find(": ");
+    messages.push_back((colon == string::npos) ? line : line.substr(colon+2));
+  }
+  return messages;
+}
+
+// verifies that messages are formatted as an ostream would format them
+TEST(Log, Format)
+{
+  const char* FNAME = "log-format-test.log";
+  Log<OutputToFile>::reporting_level = LOG_TEST;
+  OutputToFile::stream.open(FNAME);
+
+  Vector3d v(1.0, 2.5, -3.0);
+  string s = "text";
+  FILE_LOG(LOG_TEST) << "a " << 1 << " " << 2u << " " << -3L << " " << 0.1 << " " << 1e-20f << " " << true << " " << 'c' << " " << s << std::endl;
+  FILE_LOG(LOG_TEST) << "v = " << v << std::endl;
+  FILE_LOG(LOG_TEST) << std::setprecision(12) << 1.0/3.0 << " " << std::fixed << 2.0 << std::endl;
+  FILE_LOG(LOG_TEST) << 1.0/3.0 << std::endl;
+  FILE_LOG(LOG_TEST << 1) << "not logged" << std::endl;
+  OutputToFile::stream.close();
+  Log<OutputToFile>::reporting_level = 0;
+
+  std::ostringstream expected[4];
+  expected[0] << "a " << 1 << " " << 2u << " " << -3L << " " << 0.1 << " " << 1e-20f << " " << true << " " << 'c' << " " << s;
+  expected[1] << "v = " << v;
+  expected[2] << std::setprecision(12) << 1.0/3.0 << " " << std::fixed << 2.0;
+  expected[3] << 1.0/3.0;
+
+  vector<string> messages = read_messages(FNAME);
+  std::remove(FNAME);
+  ASSERT_EQ(messages.size(), 4u);
+  for (unsigned i=0; i< 4; i++)
+    EXPECT_EQ(messages[i], expected[i].str());
+}
+
+// verifies that messages from several threads are all written, in order
+TEST(Log, Threads)
+{
+  const char* FNAME = "log-threads-test.log";
+  const long NTHREADS = 3;
+  Log<OutputToFile>::reporting_level = LOG_TEST;
+  OutputToFile::stream.open(FNAME);
+
+  pthread_t threads[NTHREADS];
+  for (long i=0; i< NTHREADS; i++)
+    ASSERT_EQ(pthread_create(&threads[i], NULL, &log_thread, (void*) i), 0);
+  for (long i=0; i< NTHREADS; i++)
+    pthread_join(threads[i], NULL);
+  OutputToFile::stream.close();
+  Log<OutputToFile>::reporting_level = 0;
+
+  vector<string> messages = read_messages(FNAME);
+  std::remove(FNAME);
+  ASSERT_EQ(messages.size(), NTHREADS*NMESSAGES);
+  vector<unsigned> next(NTHREADS, 0);
+  for (unsigned i=0; i< messages.size(); i++)
+  {
+    long id;
+    unsigned j;
+    ASSERT_EQ(std::sscanf(messages[i].c_str(), "thread %ld message %u", &id, &j), 2);
+    ASSERT_LT(id, NTHREADS);
+    EXPECT_EQ(j, next[id]++);
+  }
+}
+
+// verifies that flush_fatal() writes the queued messages without closing the file
+TEST(Log, FlushFatal)
+{
+  const char* FNAME = "log-fatal-test.log";
+  Log<OutputToFile>::reporting_level = LOG_TEST;
+  OutputToFile::stream.open(FNAME);
+
+  for (unsigned i=0; i< 10; i++)
+    FILE_LOG(LOG_TEST) << "fatal " << i << std::endl;
+  OutputToFile::flush_fatal();
+
+  vector<string> messages = read_messages(FNAME);
+  OutputToFile::stream.close();
+  Log<OutputToFile>::reporting_level = 0;
+  std::remove(FNAME);
+  ASSERT_EQ(messages.size(), 10u);
+  for (unsigned i=0; i< 10; i++)
+  {
+    std::ostringstream expected;
+    expected << "fatal " << i;
+    EXPECT_EQ(messages[i], expected.str());
+  }
+}
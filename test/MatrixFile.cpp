@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <Ravelin/MatrixFiled.h>
+#include <Ravelin/MatrixFilef.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using boost::shared_ptr;
+
+// verifies that vectors and dense matrices, including strided views of them,
+// are written and mapped back exactly
+TEST(MatrixFile, DenseRoundTrip)
+{
+  const char* FNAME = "matrixfile_dense.bin";
+
+  MatrixNd A(7,5);
+  for (unsigned i=0; i< A.rows(); i++)
+    for (unsigned j=0; j< A.columns(); j++)
+      A(i,j) = 1.0/(i+j+1.0) - 0.25*j;
+  const MatrixNd& Ac = A;
+
+  // the matrix and a block of it (whose leading dimension is not its number
+  // of rows), with and without checksums
+  SharedConstMatrixNd blocks[2] = { Ac.block(0, 7, 0, 5), Ac.block(2, 6, 1, 4) };
+  for (unsigned k=0; k< 2; k++)
+  {
+    ASSERT_TRUE(MatrixFiled::write(FNAME, blocks[k], k == 1));
+    SharedConstMatrixNd B;
+    ASSERT_TRUE(MatrixFiled::read(FNAME, B));
+    ASSERT_EQ(B.rows(), blocks[k].rows());
+    ASSERT_EQ(B.columns(), blocks[k].columns());
+    for (unsigned i=0; i< B.rows(); i++)
+      for (unsigned j=0; j< B.columns(); j++)
+        EXPECT_EQ(B(i,j), blocks[k](i,j));
+  }
+
+  // a vector and a strided view of it (a row of the matrix); the view stays
+  // valid after the file is removed
+  ASSERT_TRUE(MatrixFiled::write(FNAME, Ac.row(3), true));
+  SharedConstVectorNd v;
+  ASSERT_TRUE(MatrixFiled::read(FNAME, v));
+  std::remove(FNAME);
+  ASSERT_EQ(v.size(), A.columns());
+  for (unsigned j=0; j< v.size(); j++)
+    EXPECT_EQ(v[j], A(3,j));
+
+  // floats, written to a stream
+  VectorNf w(3);
+  w[0] = 0.1f;  w[1] = -2.0f;  w[2] = 3e-20f;
+  {
+    std::ofstream out(FNAME, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(MatrixFilef::write(out, w));
+  }
+  SharedConstVectorNf wf;
+  ASSERT_TRUE(MatrixFilef::read(FNAME, wf));
+  ASSERT_EQ(wf.size(), 3u);
+  EXPECT_EQ(wf[2], w[2]);
+
+  // the wrong type or precision of object is rejected
+  SharedConstVectorNd vd;
+  SharedConstMatrixNf Af;
+  EXPECT_FALSE(MatrixFiled::read(FNAME, vd));
+  EXPECT_FALSE(MatrixFilef::read(FNAME, Af));
+  std::remove(FNAME);
+}
+
+// verifies that sparse matrices are written and mapped back exactly and
+// that corruption is detected by the checksum
+TEST(MatrixFile, SparseRoundTrip)
+{
+  const char* FNAME = "matrixfile_sparse.bin";
+
+  SparseMatrixNd::Triplets t;
+  for (unsigned i=0; i< 20; i++)
+  {
+    t.add(i, i % 15, 4.0 + i);
+    t.add(i, (i*7 + 3) % 15, -1.0/(i+1));
+  }
+  SparseMatrixNd S(SparseMatrixNd::eCSR, 20, 15, t), Sc;
+  S.convert(SparseMatrixNd::eCSC, Sc);
+
+  const SparseMatrixNd* matrices[2] = { &S, &Sc };
+  for (unsigned k=0; k< 2; k++)
+  {
+    ASSERT_TRUE(MatrixFiled::write(FNAME, *matrices[k], true));
+    shared_ptr<const SparseMatrixNd> R;
+    ASSERT_TRUE(MatrixFiled::read(FNAME, R));
+    ASSERT_EQ(R->get_storage_type(), matrices[k]->get_storage_type());
+    ASSERT_EQ(R->get_nnz(), matrices[k]->get_nnz());
+    MatrixNd D1, D2;
+    matrices[k]->to_dense(D1);
+    R->to_dense(D2);
+    ASSERT_EQ(D1.rows(), D2.rows());
+    ASSERT_EQ(D1.columns(), D2.columns());
+    for (unsigned i=0; i< D1.rows(); i++)
+      for (unsigned j=0; j< D1.columns(); j++)
+        EXPECT_EQ(D1(i,j), D2(i,j));
+  }
+
+  // flip a byte in the nonzeros; the checksum catches it unless it is skipped
+  {
+    std::fstream f(FNAME, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(-12, std::ios::end);
+    f.put('\x7f');
+  }
+  shared_ptr<const SparseMatrixNd> R;
+  EXPECT_FALSE(MatrixFiled::read(FNAME, R));
+  EXPECT_TRUE(MatrixFiled::read(FNAME, R, false));
+  std::remove(FNAME);
+}
+
+
+// overwrites a 32-bit field of a file's header
+static void patch_header(const char* fname, long offset, boost::uint32_t value)
+{
+  std::fstream f(fname, std::ios::in | std::ios::out | std::ios::binary);
+  f.seekp(offset);
+  f.write((const char*) &value, sizeof(value));
+}
+
+// verifies that headers with overflowing sizes or invalid storage types are
+// rejected rather than mapped
+TEST(MatrixFile, CraftedHeaders)
+{
+  const char* FNAME = "matrixfile_crafted.bin";
+  const long STORAGE = 24, ROWS = 32, COLUMNS = 36, LEADING_DIM = 40;
+
+  SparseMatrixNd::Triplets t;
+  t.add(0, 0, 1.0);
+  t.add(1, 2, 2.0);
+  SparseMatrixNd S(SparseMatrixNd::eCSR, 3, 3, t);
+  shared_ptr<const SparseMatrixNd> R;
+
+  // the row count wraps the number of row pointers to zero
+  ASSERT_TRUE(MatrixFiled::write(FNAME, S, false));
+  patch_header(FNAME, ROWS, 0xFFFFFFFF);
+  EXPECT_FALSE(MatrixFiled::read(FNAME, R));
+
+  // unknown storage type
+  ASSERT_TRUE(MatrixFiled::write(FNAME, S, false));
+  ASSERT_TRUE(MatrixFiled::read(FNAME, R));
+  patch_header(FNAME, STORAGE, 7);
+  EXPECT_FALSE(MatrixFiled::read(FNAME, R));
+
+  // the size of a dense matrix overflows 32 bits
+  MatrixNd M(2, 2);
+  M.set_zero();
+  SharedConstMatrixNd V;
+  ASSERT_TRUE(MatrixFiled::write(FNAME, M, false));
+  patch_header(FNAME, ROWS, 0x10000);
+  patch_header(FNAME, COLUMNS, 0x10000);
+  patch_header(FNAME, LEADING_DIM, 0x10000);
+  EXPECT_FALSE(MatrixFiled::read(FNAME, V));
+
+  // a vector with no columns but a huge number of rows (whose stored size is
+  // zero), and one whose leading dimension is not its size
+  VectorNd v(2);
+  v.set_zero();
+  SharedConstVectorNd W;
+  ASSERT_TRUE(MatrixFiled::write(FNAME, v, false));
+  ASSERT_TRUE(MatrixFiled::read(FNAME, W));
+  patch_header(FNAME, ROWS, 100000000);
+  patch_header(FNAME, COLUMNS, 0);
+  patch_header(FNAME, LEADING_DIM, 100000000);
+  EXPECT_FALSE(MatrixFiled::read(FNAME, W));
+  ASSERT_TRUE(MatrixFiled::write(FNAME, v, false));
+  patch_header(FNAME, ROWS, 1);
+  EXPECT_FALSE(MatrixFiled::read(FNAME, W));
+  std::remove(FNAME);
+}
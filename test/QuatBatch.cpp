@@ -0,0 +1,172 @@
+#include <cmath>
+#include <vector>
+#include <Ravelin/QuatBatchd.h>
+#include <Ravelin/QuatBatchf.h>
+#include <Ravelin/Matrix3d.h>
+#include <Ravelin/AAngled.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+
+// number of quaternions (not a multiple of any vector width, to exercise
+// the remainder loops)
+static const unsigned N = 37;
+
+static double rand_unit()
+{
+  return (double) rand() / RAND_MAX * 2.0 - 1.0;
+}
+
+static Quatd rand_quat()
+{
+  Quatd q(rand_unit(), rand_unit(), rand_unit(), rand_unit());
+  q.normalize();
+  return q;
+}
+
+// gets the angle of the rotation between two unit quaternions
+static double rotation_angle(const Quatd& a, const Quatd& b)
+{
+  double dot = std::fabs(a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w);
+  return 2.0*std::acos(std::min(dot, 1.0));
+}
+
+// verifies composition, rotation, and conversions against the scalar Quatd operations
+TEST(QuatBatchTest, Compose)
+{
+  std::vector<Quatd> a(N), b(N), r;
+  for (unsigned i=0; i< N; i++)
+  {
+    a[i] = rand_quat();
+    b[i] = rand_quat();
+  }
+  MatrixNd A, B, R;
+  QuatBatchd::pack(a, A);
+  QuatBatchd::pack(b, B);
+
+  // compose pairs, and one with many
+  R.resize(N, 4);
+  QuatBatchd::mult(N, A.data(), N, B.data(), N, R.data(), N);
+  QuatBatchd::unpack(R, r);
+  for (unsigned i=0; i< N; i++)
+    EXPECT_LT(rotation_angle(r[i], a[i]*b[i]), 1e-7);
+  QuatBatchd::mult(a[0], N, B.data(), N, R.data(), N);
+  QuatBatchd::unpack(R, r);
+  for (unsigned i=0; i< N; i++)
+    EXPECT_LT(rotation_angle(r[i], a[0]*b[i]), 1e-7);
+
+  // rotate points, by one and by many quaternions (in place)
+  MatrixNd P(N, 3), P1(N, 3), P2;
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 3; j++)
+      P(i,j) = rand_unit();
+  P2 = P;
+  QuatBatchd::rotate(a[1], N, P.data(), N, P1.data(), N);
+  QuatBatchd::rotate(N, A.data(), N, P2.data(), N, P2.data(), N);
+  for (unsigned i=0; i< N; i++)
+  {
+    Origin3d p(P(i,0), P(i,1), P(i,2));
+    Origin3d r1 = a[1]*p, r2 = a[i]*p;
+    for (unsigned j=0; j< 3; j++)
+    {
+      EXPECT_NEAR(P1(i,j), r1[j], 1e-10);
+      EXPECT_NEAR(P2(i,j), r2[j], 1e-10);
+    }
+  }
+
+  // convert to matrices and from axis-angle
+  MatrixNd M(N, 9), AX(N, 3), Q(N, 4);
+  std::vector<double> angle(N);
+  QuatBatchd::to_matrix(N, A.data(), N, M.data(), N);
+  for (unsigned i=0; i< N; i++)
+  {
+    AAngled aa(a[i]);
+    AX(i,0) = aa.x; AX(i,1) = aa.y; AX(i,2) = aa.z;
+    angle[i] = aa.angle;
+    Matrix3d Ri(a[i]);
+    for (unsigned k=0; k< 9; k++)
+      EXPECT_NEAR(M(i,k), Ri.data()[k], 1e-10);
+  }
+  QuatBatchd::from_axis_angle(N, AX.data(), N, &angle.front(), Q.data(), N);
+  QuatBatchd::unpack(Q, r);
+  for (unsigned i=0; i< N; i++)
+    EXPECT_LT(rotation_angle(r[i], a[i]), 1e-6);
+
+  // compute derivatives
+  MatrixNd W(N, 3), QD(N, 4);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 3; j++)
+      W(i,j) = rand_unit();
+  QuatBatchd::deriv(N, A.data(), N, W.data(), N, QD.data(), N);
+  for (unsigned i=0; i< N; i++)
+  {
+    Quatd qd = Quatd::deriv(a[i], Vector3d(W(i,0), W(i,1), W(i,2)));
+    EXPECT_NEAR(QD(i,0), qd.x, 1e-12);
+    EXPECT_NEAR(QD(i,1), qd.y, 1e-12);
+    EXPECT_NEAR(QD(i,2), qd.z, 1e-12);
+    EXPECT_NEAR(QD(i,3), qd.w, 1e-12);
+  }
+}
+
+// verifies normalization and interpolation in double and single precision
+TEST(QuatBatchTest, NormalizeInterpolate)
+{
+  // normalize (including a zero quaternion)
+  MatrixNd Q(N, 4);
+  MatrixNf Qf(N, 4);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 4; j++)
+      Qf(i,j) = (float) (Q(i,j) = 3.0*rand_unit());
+  for (unsigned j=0; j< 4; j++)
+    Q(5,j) = Qf(5,j) = 0.0;
+  std::vector<Quatd> q;
+  QuatBatchd::unpack(Q, q);
+  QuatBatchd::normalize(N, Q.data(), N);
+  QuatBatchf::normalize(N, Qf.data(), N);
+  for (unsigned i=0; i< N; i++)
+  {
+    q[i].normalize();
+    EXPECT_NEAR(Q(i,0), q[i].x, 1e-14);
+    EXPECT_NEAR(Q(i,3), q[i].w, 1e-14);
+    for (unsigned j=0; j< 4; j++)
+      EXPECT_NEAR(Qf(i,j), Q(i,j), 1e-6);
+  }
+
+  // nlerp matches lerp, and approximates slerp within the error bound
+  std::vector<Quatd> a(N), b(N), rn, rs;
+  for (unsigned i=0; i< N; i++)
+  {
+    a[i] = rand_quat();
+    b[i] = (i % 2 == 0) ? rand_quat() : a[i]*Quatd(AAngled(0.0, 0.0, 1.0, 0.1*i));
+  }
+  MatrixNd A, B, RN(N, 4), RS(N, 4);
+  QuatBatchd::pack(a, A);
+  QuatBatchd::pack(b, B);
+  const double ALPHA = 0.3;
+  QuatBatchd::nlerp(N, A.data(), N, B.data(), N, ALPHA, RN.data(), N);
+  QuatBatchd::slerp(N, A.data(), N, B.data(), N, ALPHA, RS.data(), N);
+  QuatBatchd::unpack(RN, rn);
+  QuatBatchd::unpack(RS, rs);
+  for (unsigned i=0; i< N; i++)
+  {
+    EXPECT_LT(rotation_angle(rn[i], Quatd::lerp(a[i], b[i], ALPHA)), 1e-7);
+    EXPECT_LE(rotation_angle(rn[i], rs[i]), QuatBatchd::nlerp_error(rotation_angle(a[i], b[i])) + 1e-7);
+
+    // slerp moves at a constant rate
+    EXPECT_NEAR(rotation_angle(a[i], rs[i]), ALPHA*rotation_angle(a[i], b[i]), 1e-7);
+  }
+
+  // single precision nlerp
+  MatrixNf Af(N, 4), Bf(N, 4), RNf(N, 4);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 4; j++)
+    {
+      Af(i,j) = (float) A(i,j);
+      Bf(i,j) = (float) B(i,j);
+    }
+  QuatBatchf::nlerp(N, Af.data(), N, Bf.data(), N, (float) ALPHA, RNf.data(), N);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< 4; j++)
+      EXPECT_NEAR(RNf(i,j), RN(i,j), 1e-5);
+}
+
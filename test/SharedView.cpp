@@ -0,0 +1,124 @@
+#include <vector>
+#include <Ravelin/NullPointerException.h>
+#include <Ravelin/LinAlgd.h>
+#include <Ravelin/SharedMatrixNd.h>
+#include <Ravelin/SharedVectorNd.h>
+#include <Ravelin/MatrixNd.h>
+#include <Ravelin/VectorNd.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+
+// verifies that views of memory owned elsewhere see and modify that memory
+// without copying or allocating
+TEST(SharedView, ExternalBuffers)
+{
+  // a 3x2 matrix stored in a buffer with a leading dimension of 4
+  double buffer[8] = { 1, 2, 3, -1, 4, 5, 6, -1 };
+  unsigned long nallocs = SharedResizable<double>::allocations();
+  SharedMatrixNd M(buffer, 3, 2, 4);
+  const SharedConstMatrixNd Mc(buffer, 3, 2, 4);
+  EXPECT_EQ(M.leading_dim(), 4u);
+  EXPECT_EQ(M(2,1), 6.0);
+  EXPECT_EQ(Mc(1,1), 5.0);
+  M(0,1) = 7.0;
+  EXPECT_EQ(buffer[4], 7.0);
+  EXPECT_EQ(Mc(0,1), 7.0);
+
+  // copies of the view keep its leading dimension
+  SharedMatrixNd M2(M);
+  EXPECT_EQ(M2.leading_dim(), 4u);
+  EXPECT_EQ(M2(2,1), 6.0);
+
+  // a vector with a stride of 2
+  double xbuf[4] = { 1.0, 0.0, -2.0, 0.0 };
+  SharedConstVectorNd x(xbuf, 2, 2);
+  EXPECT_EQ(x[1], -2.0);
+  EXPECT_EQ(SharedResizable<double>::allocations(), nallocs);
+
+  // multiplication with strided vectors; y = M*x is [-13 -8 -9]
+  std::vector<double> ybuf(6, 100.0);
+  SharedVectorNd y(&ybuf[0], 3, 2);
+  M.mult(x, y);
+  EXPECT_EQ(ybuf[0], -13.0);
+  EXPECT_EQ(ybuf[2], -8.0);
+  EXPECT_EQ(ybuf[4], -9.0);
+  EXPECT_EQ(ybuf[1], 100.0);
+
+  // transpose_mult with a contiguous vector; z = M'*[1 1 1] is [6 18]
+  double ones[3] = { 1.0, 1.0, 1.0 }, zbuf[2];
+  SharedVectorNd z(zbuf, 2);
+  Mc.transpose_mult(SharedConstVectorNd(ones, 3), z);
+  EXPECT_EQ(zbuf[0], 6.0);
+  EXPECT_EQ(zbuf[1], 18.0);
+
+  #ifndef NEXCEPT
+  EXPECT_THROW(SharedMatrixNd(buffer, 3, 2, 2), MissizeException);
+  EXPECT_THROW(SharedConstVectorNd((const double*) 0, 3), NullPointerException);
+  #endif
+}
+
+// verifies that the dense solvers operate in place on external buffers
+TEST(SharedView, Solve)
+{
+  // an SPD matrix stored in a buffer with a leading dimension of 3
+  const unsigned N = 2, LD = 3;
+  std::vector<double> A(LD*N, 0.0);
+  A[0] = 4.0;  A[1] = 1.0;
+  A[3] = 1.0;  A[4] = 3.0;
+  MatrixNd Acopy(2,2);
+  Acopy(0,0) = 4.0;  Acopy(1,0) = 1.0;  Acopy(0,1) = 1.0;  Acopy(1,1) = 3.0;
+
+  double b[2] = { 1.0, 2.0 };
+  LinAlgd LA;
+  SharedMatrixNd Av(&A[0], N, N, LD);
+  SharedVectorNd bv(b, N);
+  LA.solve_fast(Av, bv);
+
+  // check that the solution satisfies the original system
+  VectorNd x(N), r;
+  x[0] = b[0];  x[1] = b[1];
+  Acopy.mult(x, r);
+  EXPECT_NEAR(r[0], 1.0, 1e-12);
+  EXPECT_NEAR(r[1], 2.0, 1e-12);
+}
+
+
+// verifies that the dense solvers solve strided vectors without touching the
+// elements between them
+TEST(SharedView, SolveStrided)
+{
+  LinAlgd LA;
+  MatrixNd D(2,2), A;
+  D.set_zero();
+  D(0,0) = 2.0;  D(1,1) = 4.0;
+
+  // LU (general), Cholesky (SPD), symmetric, and least squares solvers
+  for (unsigned k=0; k< 4; k++)
+  {
+    double b[3] = { 2.0, 4.0, 4.0 };
+    SharedVectorNd bv(b, 2, 2);
+    A = D;
+    switch (k)
+    {
+      case 0:  LA.solve_fast(A, bv); break;
+      case 1:  LA.solve_SPD_fast(A, bv); break;
+      case 2:  LA.solve_symmetric_fast(A, bv); break;
+      default: LA.solve_LS_fast(A, bv, LinAlgd::eSVD1, -1.0); break;
+    }
+    EXPECT_NEAR(b[0], 1.0, 1e-12);
+    EXPECT_EQ(b[1], 4.0);
+    EXPECT_NEAR(b[2], 1.0, 1e-12);
+  }
+
+  // solves with a factorization
+  double b[3] = { 2.0, 4.0, 4.0 };
+  SharedVectorNd bv(b, 2, 2);
+  std::vector<int> piv;
+  A = D;
+  ASSERT_TRUE(LA.factor_LU(A, piv));
+  LA.solve_LU_fast(A, false, piv, bv);
+  EXPECT_NEAR(b[0], 1.0, 1e-12);
+  EXPECT_EQ(b[1], 4.0);
+  EXPECT_NEAR(b[2], 1.0, 1e-12);
+}
@@ -1,7 +1,11 @@
 #include <iostream>
+#include <cmath>
+#include <cstdlib>
 #include <Ravelin/MatrixNd.h>
 #include <Ravelin/SparseMatrixNd.h>
+#include <Ravelin/SparseVectorNd.h>
 #include <Ravelin/LinAlgd.h>
+#include <Ravelin/BlockSparseMatrixNd.h>
 
 using namespace Ravelin;
 using std::endl;
@@ -87,6 +91,354 @@ void test_plus(SparseMatrixNd& s1, const SparseMatrixNd& s2, const MatrixNd& d)
   cout << "negation and addition error: " << s1.norm_inf() << std::endl;
 }
 
+void test_triplets(const MatrixNd& d)
+{
+  const unsigned M = d.rows(), N = d.columns();
+
+  // build the matrix from shuffled triplets, splitting every nonzero into 
+  // two duplicates 
+  SparseMatrixNd::Triplets t;
+  for (unsigned j=N; j> 0; j--)
+    for (unsigned i=0; i< M; i++)
+      if (d(i,j-1) != 0.0)
+      {
+        t.add(i, j-1, 0.25*d(i,j-1));
+        t.add(i, j-1, 0.75*d(i,j-1));
+      }
+  SparseMatrixNd s1(SparseMatrixNd::eCSR, M, N, t);
+  SparseMatrixNd s2(SparseMatrixNd::eCSC, M, N, t);
+  MatrixNd d1, d2;
+  (s1.to_dense(d1) -= d);
+  (s2.to_dense(d2) -= d);
+  cout << "testing triplets (CSR): " << d1.norm_inf() << endl;
+  cout << "testing triplets (CSC): " << d2.norm_inf() << endl;
+
+  // test axpy with the same and with different patterns / storage types
+  SparseMatrixNd s3 = SparseMatrixNd(SparseMatrixNd::eCSR, d);
+  s3.axpy(-2.0, s1);
+  (s3.to_dense(d1) += d);
+  cout << "testing axpy (same pattern): " << d1.norm_inf() << endl;
+  SparseMatrixNd eye = SparseMatrixNd::identity(SparseMatrixNd::eCSC, M);
+  s3 = s1;
+  s3.axpy(3.0, eye);
+  MatrixNd d3 = MatrixNd::identity(M);
+  d3 *= 3.0;
+  d3 += d;
+  (s3.to_dense(d1) -= d3);
+  cout << "testing axpy (different pattern): " << d1.norm_inf() << endl;
+
+  // test setting a column of a CSR matrix
+  VectorNd col(M);
+  for (unsigned i=0; i< M; i++)
+    col[i] = (i % 2 == 0) ? 0.0 : (double) i;
+  s1.set_column(0, col);
+  d3 = d;
+  d3.set_column(0, col);
+  (s1.to_dense(d1) -= d3);
+  cout << "testing set_column (CSR): " << d1.norm_inf() << endl;
+}
+
+void test_pattern_updates(const MatrixNd& d)
+{
+  const unsigned M = d.rows(), N = d.columns();
+
+  // build the pattern from triplets (with duplicates)
+  SparseMatrixNd::Triplets t;
+  for (unsigned i=0; i< M; i++)
+    for (unsigned j=0; j< N; j++)
+      if (d(i,j) != 0.0)
+      {
+        t.add(i, j, 0.5*d(i,j));
+        t.add(i, j, 0.5*d(i,j));
+      }
+  SparseMatrixNd s1(SparseMatrixNd::eCSR, M, N, t);
+  SparseMatrixNd s2(SparseMatrixNd::eCSC, M, N, t);
+  MatrixNd d1, d2, d3 = d;
+  d3 *= 2.0;
+
+  // refill with doubled values, using lookups and using precomputed slots
+  std::vector<unsigned> slots;
+  s2.get_slots(t, slots);
+  for (unsigned k=0; k< t.size(); k++)
+    t.values[k] *= 2.0;
+  s1.refill(t);
+  s2.refill(slots, t.values);
+  cout << "testing refill (CSR): " << (s1.to_dense(d1) -= d3).norm_inf() << endl;
+  cout << "testing refill (slots, CSC): " << (s2.to_dense(d2) -= d3).norm_inf() << endl;
+
+  // set the values of a row and add to single entries
+  std::vector<unsigned> cols;
+  std::vector<double> vals;
+  for (unsigned j=0; j< N; j++)
+    if (d(0,j) != 0.0)
+    {
+      cols.push_back(j);
+      vals.push_back((double) j);
+    }
+  for (unsigned i=0; i< M; i++)
+    for (unsigned j=0; j< N; j++)
+      if (d(i,j) != 0.0 && (i+j) % 2 == 0)
+      {
+        s1.add_to(i, j, 1.0);
+        s2.add_to(i, j, 1.0);
+        d3(i,j) += 1.0;
+      }
+  if (!cols.empty())
+  {
+    s1.set_values(0, cols.size(), &cols.front(), &vals.front());
+    s2.set_values(0, cols.size(), &cols.front(), &vals.front());
+  }
+  for (unsigned k=0; k< cols.size(); k++)
+    d3(0,cols[k]) = vals[k];
+  cout << "testing set_values/add_to (CSR): " << (s1.to_dense(d1) -= d3).norm_inf() << endl;
+  cout << "testing set_values/add_to (CSC): " << (s2.to_dense(d2) -= d3).norm_inf() << endl;
+}
+
+// counts the nonzeros in the Cholesky factor of a symmetric positive definite matrix
+unsigned chol_fill(const SparseMatrixNd& s)
+{
+  MatrixNd d;
+  s.to_dense(d);
+  LinAlgd().factor_chol(d);
+  unsigned nnz = 0;
+  for (unsigned i=0; i< d.rows(); i++)
+    for (unsigned j=i; j< d.columns(); j++)
+      if (std::fabs(d(i,j)) > 1e-12)
+        nnz++;
+  return nnz;
+}
+
+// computes the bandwidth of a sparse matrix
+unsigned bandwidth(const SparseMatrixNd& s)
+{
+  unsigned bw = 0;
+  for (unsigned i=0; i< s.rows(); i++)
+    for (unsigned k=s.get_ptr()[i]; k< s.get_ptr()[i+1]; k++)
+      bw = std::max(bw, (unsigned) std::abs((int) s.get_indices()[k] - (int) i));
+  return bw;
+}
+
+void test_orderings()
+{
+  // setup the 2D Laplacian on a G x G grid with randomly numbered vertices
+  const unsigned G = 16, N = G*G;
+  std::vector<unsigned> shuffle(N);
+  for (unsigned i=0; i< N; i++)
+    shuffle[i] = i;
+  for (unsigned i=N-1; i> 0; i--)
+    std::swap(shuffle[i], shuffle[rand() % (i+1)]);
+  SparseMatrixNd::Triplets t;
+  for (unsigned x=0; x< G; x++)
+    for (unsigned y=0; y< G; y++)
+    {
+      const unsigned v = shuffle[x*G+y];
+      t.add(v, v, 4.0);
+      if (x > 0) t.add(v, shuffle[(x-1)*G+y], -1.0);
+      if (x < G-1) t.add(v, shuffle[(x+1)*G+y], -1.0);
+      if (y > 0) t.add(v, shuffle[x*G+y-1], -1.0);
+      if (y < G-1) t.add(v, shuffle[x*G+y+1], -1.0);
+    }
+  SparseMatrixNd A(SparseMatrixNd::eCSR, N, N, t), P;
+
+  // test symmetric and unsymmetric permutation against dense permutation
+  MatrixNd d, dp(N, N), r;
+  A.to_dense(d);
+  std::vector<unsigned> rperm, cperm;
+  A.calc_rcm_ordering(rperm);
+  SparseMatrixNd(SparseMatrixNd::eCSC, d).permute_symmetric(rperm, P);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< N; j++)
+      dp(i,j) = d(rperm[i], rperm[j]);
+  cout << "testing symmetric permutation (CSC): " << (P.to_dense(r) -= dp).norm_inf() << endl;
+  SparseMatrixNd::invert_permutation(rperm, cperm);
+  A.permute(rperm, cperm, P);
+  for (unsigned i=0; i< N; i++)
+    for (unsigned j=0; j< N; j++)
+      dp(i,j) = d(rperm[i], cperm[j]);
+  cout << "testing permutation (CSR): " << (P.to_dense(r) -= dp).norm_inf() << endl;
+
+  // test the orderings
+  std::vector<unsigned> perm;
+  A.permute_symmetric(rperm, P);
+  cout << "bandwidth (original, RCM): " << bandwidth(A) << " " << bandwidth(P) << endl;
+  cout << "Cholesky fill (original, RCM";
+  unsigned fill[4];
+  fill[0] = chol_fill(A);
+  fill[1] = chol_fill(P);
+  A.calc_amd_ordering(perm);
+  fill[2] = chol_fill(A.permute_symmetric(perm, P));
+  A.calc_nested_dissection_ordering(perm);
+  fill[3] = chol_fill(A.permute_symmetric(perm, P));
+  cout << ", AMD, ND): " << fill[0] << " " << fill[1] << " " << fill[2] << " " << fill[3] << endl;
+}
+
+VectorNd random_sparse_vector(unsigned n)
+{
+  VectorNd v(n);
+  for (unsigned i=0; i< n; i++)
+    v[i] = (rand() % 3 == 0) ? (double) rand() / RAND_MAX : 0.0;
+  return v;
+}
+
+void test_sparse_vector()
+{
+  const unsigned N = 53;
+  VectorNd a = random_sparse_vector(N), b = random_sparse_vector(N), r, y;
+  VectorNd c(N);
+  c.set_zero();
+  c[7] = 2.0;
+  SparseVectorNd sa(a), sb(b), sc(c), ss;
+
+  // test the dot products (merge, search, and gather)
+  cout << "testing sparse/sparse dot: " << std::fabs(sa.dot(sb) - a.dot(b)) << endl;
+  cout << "testing sparse/sparse dot (search): " << std::fabs(sc.dot(sa) - c.dot(a)) << endl;
+  cout << "testing sparse/dense dot: " << std::fabs(sa.dot(b) - a.dot(b)) << endl;
+
+  // test axpy into dense and sparse vectors
+  y = b;
+  sa.add_to(-3.0, y);
+  r = a;
+  r *= -3.0;
+  r += b;
+  cout << "testing sparse axpy (dense): " << (y -= r).norm_inf() << endl;
+  SparseVectorNd::axpy(-3.0, sa, sb, ss);
+  cout << "testing sparse axpy (sparse): " << (ss.to_dense(y) -= r).norm_inf() << endl;
+  sb += sa;
+  r = a;
+  r += b;
+  cout << "testing sparse += sparse: " << (sb.to_dense(y) -= r).norm_inf() << endl;
+
+  // test batched dot products with matrix rows
+  MatrixNd d = random_sparse(N, N);
+  SparseMatrixNd s1(SparseMatrixNd::eCSR, d), s2(SparseMatrixNd::eCSC, d);
+  std::vector<unsigned> rows;
+  rows.push_back(5);
+  rows.push_back(0);
+  rows.push_back(N-1);
+  d.mult(a, r);
+  double err = 0.0;
+  s1.dot_rows(rows, a, y);
+  for (unsigned k=0; k< rows.size(); k++)
+    err = std::max(err, std::fabs(y[k] - r[rows[k]]));
+  s2.dot_rows(rows, a, y);
+  for (unsigned k=0; k< rows.size(); k++)
+    err = std::max(err, std::fabs(y[k] - r[rows[k]]));
+  cout << "testing batched row dot products: " << err << endl;
+}
+
+void test_products(const MatrixNd& d)
+{
+  const unsigned M = d.rows(), N = d.columns();
+  MatrixNd e = random_sparse(N, M), r, dt, x;
+  SparseMatrixNd s1(SparseMatrixNd::eCSR, d), s2(SparseMatrixNd::eCSC, d);
+  SparseMatrixNd t1(SparseMatrixNd::eCSC, e), c;
+
+  // test transposition and conversion
+  MatrixNd::transpose(d, dt);
+  s1.transpose(c);
+  cout << "testing transpose (CSR): " << (c.to_dense(r) -= dt).norm_inf() << endl;
+  s2.convert(SparseMatrixNd::eCSR, c);
+  cout << "testing CSC -> CSR conversion: " << (c.to_dense(r) -= d).norm_inf() << endl;
+
+  // test sparse/sparse multiplication
+  d.mult(e, x);
+  SparseMatrixNd::mult(s1, t1, c);
+  cout << "testing sparse/sparse multiplication: " << (c.to_dense(r) -= x).norm_inf() << endl;
+
+  // test fused products
+  d.transpose_mult(d, x);
+  SparseMatrixNd::transpose_mult_self(s2, c);
+  cout << "testing A'*A: " << (c.to_dense(r) -= x).norm_inf() << endl;
+  d.mult_transpose(d, x);
+  SparseMatrixNd::mult_transpose_self(s1, c);
+  cout << "testing A*A': " << (c.to_dense(r) -= x).norm_inf() << endl;
+
+  // test A*diag(v)*A', reusing the pattern of A*A'
+  VectorNd v(N);
+  MatrixNd dv = d;
+  for (unsigned j=0; j< N; j++)
+  {
+    v[j] = (double) (j+1);
+    for (unsigned i=0; i< M; i++)
+      dv(i,j) *= v[j];
+  }
+  dv.mult_transpose(d, x);
+  SparseMatrixNd::mult_diag_transpose_numeric(s1, v, c);
+  cout << "testing A*diag(d)*A': " << (c.to_dense(r) -= x).norm_inf() << endl;
+}
+
+void test_block_sparse(const MatrixNd& d)
+{
+  const unsigned B = 3;
+  MatrixNd r, x, y, X(d.columns(), 2), Y(d.rows(), 2);
+  VectorNd v(d.columns()), w(d.rows()), z;
+  for (unsigned i=0; i< X.rows(); i++)
+    v[i] = X(i,0) = X(i,1) = (double) rand() / RAND_MAX;
+  for (unsigned i=0; i< Y.rows(); i++)
+    w[i] = Y(i,0) = Y(i,1) = (double) rand() / RAND_MAX;
+
+  // test conversion from and to sparse matrices
+  BlockSparseMatrixNd<B> b(SparseMatrixNd(SparseMatrixNd::eCSC, d));
+  SparseMatrixNd s;
+  cout << "testing sparse -> BSR -> dense: " << (b.to_dense(r) -= d).norm_inf() << endl;
+  cout << "testing BSR -> sparse: " << (b.to_sparse(s).to_dense(r) -= d).norm_inf() << endl;
+
+  // test products
+  VectorNd u;
+  d.mult(v, z);
+  cout << "testing BSR SpMV: " << (b.mult(v, u) -= z).norm_inf() << endl;
+  d.transpose_mult(w, z);
+  cout << "testing BSR transpose SpMV: " << (b.transpose_mult(w, u) -= z).norm_inf() << endl;
+  d.mult(X, x);
+  cout << "testing BSR SpMM: " << (b.mult(X, y) -= x).norm_inf() << endl;
+  d.transpose_mult(Y, x);
+  cout << "testing BSR transpose SpMM: " << (b.transpose_mult(Y, y) -= x).norm_inf() << endl;
+
+  // test the block-Jacobi inverse on a block diagonally dominant matrix
+  const unsigned NB = d.rows()/B;
+  std::vector<unsigned> brows, bcols;
+  std::vector<double> values;
+  for (unsigned i=0; i< NB; i++)
+    for (unsigned j=0; j< NB; j++)
+      if (i == j || rand() % 2 == 0)
+      {
+        brows.push_back(i);
+        bcols.push_back(j);
+        for (unsigned k=0; k< B*B; k++)
+          values.push_back((i == j && k % (B+1) == 0) ? 10.0 : (double) rand() / RAND_MAX);
+      }
+  BlockSparseMatrixNd<B> a, ainv;
+  a.set_from_blocks(NB, NB, brows, bcols, values);
+  a.block_jacobi_inverse(ainv);
+  MatrixNd ad, aid, adb, aidb, prod;
+  double err = 0.0;
+  a.to_dense(ad);
+  ainv.to_dense(aid);
+  for (unsigned i=0; i< NB; i++)
+  {
+    ad.get_sub_mat(i*B, (i+1)*B, i*B, (i+1)*B, adb);
+    aid.get_sub_mat(i*B, (i+1)*B, i*B, (i+1)*B, aidb);
+    adb.mult(aidb, prod);
+    err = std::max(err, (prod -= MatrixNd::identity(B)).norm_inf());
+  }
+  cout << "testing BSR block-Jacobi inverse: " << err << endl;
+
+  // test setting blocks from spatial vectors
+  std::vector<SVelocityd> sv(4);
+  for (unsigned j=0; j< sv.size(); j++)
+    for (unsigned k=0; k< 6; k++)
+      sv[j][k] = (double) rand() / RAND_MAX;
+  BlockSparseMatrixNd<6> b6;
+  b6.set_pattern(1, 1, std::vector<unsigned>(1, 0), std::vector<unsigned>(1, 0));
+  b6.set_block(0, sv);
+  MatrixNd svm(6, 6);
+  svm.set_zero();
+  for (unsigned j=0; j< sv.size(); j++)
+    for (unsigned k=0; k< 6; k++)
+      svm(k,j) = sv[j][k];
+  cout << "testing BSR set_block (SVelocity): " << (b6.to_dense(r) -= svm).norm_inf() << endl;
+}
+
 void test_to_dense(const SparseMatrixNd& s1, const SparseMatrixNd& s2, const MatrixNd& d)
 {
   MatrixNd d1, d2;
@@ -127,6 +479,24 @@ int main()
   // test addition/subtraction arithmetic 
   test_plus(s1, s2, dense);
 
+  // test building from triplets 
+  test_triplets(dense);
+
+  // test pattern-preserving updates
+  test_pattern_updates(dense);
+
+  // test sparse/sparse products
+  test_products(random_sparse(SZ, SZ+2));
+
+  // test sparse vectors
+  test_sparse_vector();
+
+  // test orderings and permutations
+  test_orderings();
+
+  // test block sparse matrices
+  test_block_sparse(random_sparse(SZ*3, SZ*3+3));
+
   // setup a couple of identity matrices
   MatrixNd eye = MatrixNd::identity(SZ*SZ);
   SparseMatrixNd i1(SparseMatrixNd::eCSR, eye);
@@ -0,0 +1,194 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <Ravelin/URDFReaderd.h>
+#include <Ravelin/RCArticulatedBodyd.h>
+#include <Ravelin/TrajectoryRecorderd.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+
+// a fixed-base double pendulum
+static const char* URDF =
+  "<robot name=\"pendulum\">"
+  "  <link name=\"base\">"
+  "    <inertial> <mass value=\"0\"/>"
+  "      <inertia ixx=\"0\" ixy=\"0\" ixz=\"0\" iyy=\"0\" iyz=\"0\" izz=\"0\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l1\">"
+  "    <inertial> <origin xyz=\"0 0 -0.5\"/> <mass value=\"1\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l2\">"
+  "    <inertial> <origin xyz=\"0 0 -0.5\"/> <mass value=\"1\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <joint name=\"j1\" type=\"revolute\">"
+  "    <parent link=\"base\"/> <child link=\"l1\"/> <axis xyz=\"0 1 0\"/>"
+  "  </joint>"
+  "  <joint name=\"j2\" type=\"revolute\">"
+  "    <parent link=\"l1\"/> <child link=\"l2\"/>"
+  "    <origin xyz=\"0 0 -1\"/> <axis xyz=\"0 1 0\"/>"
+  "  </joint>"
+  "</robot>";
+
+// records a trajectory with the given codec and verifies that the log
+// reproduces it exactly
+static void record_and_read(TrajectoryRecorderd::Codec codec)
+{
+  const char* FNAME = "trajectory-test.log";
+  const unsigned NFRAMES = 1050;
+  const double DT = 1e-3;
+
+  vector<shared_ptr<RigidBodyd> > links;
+  vector<shared_ptr<Jointd> > joints;
+  string name;
+  ASSERT_TRUE(URDFReaderd::read_from_string(URDF, name, links, joints));
+  shared_ptr<RCArticulatedBodyd> body(new RCArticulatedBodyd);
+  body->body_id = name;
+  body->set_links_and_joints(links, joints);
+
+  TrajectoryRecorderd recorder;
+  recorder.add_body(body, TrajectoryRecorderd::eQ | TrajectoryRecorderd::eQd);
+  recorder.add_link_pose(links.back());
+  ASSERT_TRUE(recorder.open(FNAME, codec, 100, 4));
+
+  // move the pendulum and record it, keeping the expected values
+  vector<VectorNd> q(NFRAMES), qd(NFRAMES);
+  vector<double> z(NFRAMES);
+  unsigned long nallocs = 0;
+  for (unsigned i=0; i< NFRAMES; i++)
+  {
+    double t = i*DT;
+    q[i].resize(2);
+    qd[i].resize(2);
+    q[i][0] = std::sin(t);
+    q[i][1] = 0.5*std::cos(3.0*t);
+    qd[i][0] = std::cos(t);
+    qd[i][1] = -1.5*std::sin(3.0*t);
+    body->set_generalized_coordinates_euler(q[i]);
+    body->set_generalized_velocity(DynamicBodyd::eSpatial, qd[i]);
+    z[i] = Pose3d::calc_relative_pose(links.back()->get_pose(), shared_ptr<const Pose3d>()).x[2];
+
+    unsigned long nallocs0 = SharedResizable<double>::allocations();
+    while (!recorder.record(t))
+      ;
+    nallocs += SharedResizable<double>::allocations() - nallocs0;
+  }
+  EXPECT_EQ(nallocs, 0u);
+  ASSERT_TRUE(recorder.close());
+  EXPECT_EQ(recorder.recorded_frames(), NFRAMES);
+
+  // read the log
+  TrajectoryLogd log;
+  ASSERT_TRUE(log.open(FNAME));
+  std::remove(FNAME);
+  ASSERT_EQ(log.num_frames(), NFRAMES);
+  ASSERT_EQ(log.num_channels(), 3u);
+  int qc = log.find_channel("pendulum/q");
+  int qdc = log.find_channel("pendulum/qd");
+  int pc = log.find_channel("l2/pose");
+  ASSERT_GE(qc, 0);
+  ASSERT_GE(qdc, 0);
+  ASSERT_GE(pc, 0);
+  EXPECT_EQ(log.find_channel("pendulum/tau"), -1);
+  EXPECT_EQ(log.channel_width(pc), 7u);
+
+  // access the frames out of order
+  for (unsigned k=0; k< NFRAMES; k++)
+  {
+    unsigned i = (k*37) % NFRAMES;
+    EXPECT_EQ(log.time(i), i*DT);
+    SharedConstVectorNd v = log.get(qc, i);
+    ASSERT_EQ(v.size(), 2u);
+    EXPECT_EQ(v[0], q[i][0]);
+    EXPECT_EQ(v[1], q[i][1]);
+    v = log.get(qdc, i);
+    EXPECT_EQ(v[1], qd[i][1]);
+    EXPECT_EQ(log.get(pc, i)[2], z[i]);
+  }
+
+  // views remain valid after the log is closed
+  SharedConstVectorNd last = log.get(qc, NFRAMES-1);
+  log.close();
+  EXPECT_EQ(last[0], q[NFRAMES-1][0]);
+}
+
+TEST(TrajectoryRecorder, Uncompressed)
+{
+  record_and_read(TrajectoryRecorderd::eNoCompression);
+}
+
+TEST(TrajectoryRecorder, Compressed)
+{
+  record_and_read(TrajectoryRecorderd::eXorDelta);
+}
+
+// verifies random access by time
+TEST(TrajectoryRecorder, FindFrame)
+{
+  const char* FNAME = "trajectory-time-test.log";
+
+  vector<shared_ptr<RigidBodyd> > links;
+  vector<shared_ptr<Jointd> > joints;
+  string name;
+  ASSERT_TRUE(URDFReaderd::read_from_string(URDF, name, links, joints));
+  shared_ptr<RCArticulatedBodyd> body(new RCArticulatedBodyd);
+  body->set_links_and_joints(links, joints);
+
+  TrajectoryRecorderd recorder;
+  recorder.add_body(body, TrajectoryRecorderd::eQ);
+  ASSERT_TRUE(recorder.open(FNAME, TrajectoryRecorderd::eXorDelta, 16, 2));
+  for (unsigned i=0; i< 100; i++)
+    while (!recorder.record(0.5*i))
+      ;
+  ASSERT_TRUE(recorder.close());
+
+  TrajectoryLogd log;
+  ASSERT_TRUE(log.open(FNAME));
+  std::remove(FNAME);
+  EXPECT_EQ(log.channel_name(0), "body0/q");
+  EXPECT_EQ(log.find_frame(-1.0), 0u);
+  EXPECT_EQ(log.find_frame(0.0), 0u);
+  EXPECT_EQ(log.find_frame(7.9), 15u);
+  EXPECT_EQ(log.find_frame(8.0), 16u);
+  EXPECT_EQ(log.find_frame(33.25), 66u);
+  EXPECT_EQ(log.find_frame(1000.0), 99u);
+}
+
+
+// a log whose header cannot be written is not left open
+TEST(TrajectoryRecorder, OpenFailure)
+{
+  const char* FNAME = "trajectory-reopen-test.log";
+
+  vector<shared_ptr<RigidBodyd> > links;
+  vector<shared_ptr<Jointd> > joints;
+  string name;
+  ASSERT_TRUE(URDFReaderd::read_from_string(URDF, name, links, joints));
+  shared_ptr<RCArticulatedBodyd> body(new RCArticulatedBodyd);
+  body->set_links_and_joints(links, joints);
+
+  TrajectoryRecorderd recorder;
+  recorder.add_body(body, TrajectoryRecorderd::eQ);
+  if (std::FILE* full = std::fopen("/dev/full", "wb"))
+  {
+    std::fclose(full);
+    EXPECT_FALSE(recorder.open("/dev/full", TrajectoryRecorderd::eNoCompression, 16, 2));
+    EXPECT_FALSE(recorder.is_open());
+    EXPECT_FALSE(recorder.record(0.0));
+  }
+
+  // a retry succeeds
+  ASSERT_TRUE(recorder.open(FNAME, TrajectoryRecorderd::eNoCompression, 16, 2));
+  EXPECT_TRUE(recorder.record(0.0));
+  EXPECT_TRUE(recorder.close());
+  std::remove(FNAME);
+}
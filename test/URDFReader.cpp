@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <Ravelin/URDFReaderd.h>
+#include <Ravelin/URDFReaderf.h>
+#include <Ravelin/RigidBodyf.h>
+#include <Ravelin/Jointf.h>
+#include <Ravelin/RigidBodyd.h>
+#include <Ravelin/Jointd.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+
+// a small model with a branch, inertial frames and joint axes; the joints
+// are listed out of order, before the links they connect
+static const char* URDF =
+  "<robot name=\"branched\">"
+  "  <joint name=\"j2\" type=\"prismatic\">"
+  "    <parent link=\"l0\"/> <child link=\"l2\"/>"
+  "    <origin xyz=\"0.1 0 0\" rpy=\"0.1 0.2 0.3\"/>"
+  "    <axis xyz=\"0 0 1\"/>"
+  "    <limit lower=\"-1\" upper=\"1\" effort=\"1\" velocity=\"1\"/>"
+  "  </joint>"
+  "  <link name=\"l0\">"
+  "    <inertial> <mass value=\"2\"/>"
+  "      <inertia ixx=\"0.1\" ixy=\"0\" ixz=\"0\" iyy=\"0.2\" iyz=\"0\" izz=\"0.3\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l1\">"
+  "    <inertial> <origin xyz=\"0 0 0.25\" rpy=\"0 0 0.5\"/> <mass value=\"1\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0.001\" ixz=\"0\" iyy=\"0.02\" iyz=\"0\" izz=\"0.03\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <link name=\"l2\">"
+  "    <inertial> <mass value=\"0.5\"/>"
+  "      <inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+  "    </inertial>"
+  "  </link>"
+  "  <joint name=\"j1\" type=\"revolute\">"
+  "    <parent link=\"l0\"/> <child link=\"l1\"/>"
+  "    <origin xyz=\"0 0 0.5\" rpy=\"0 0.3 0\"/>"
+  "    <axis xyz=\"1 1 0\"/>"
+  "  </joint>"
+  "</robot>";
+
+// checks that two poses coincide in the global frame
+static void expect_same_pose(shared_ptr<const Pose3d> P1, shared_ptr<const Pose3d> P2)
+{
+  Transform3d T = Pose3d::calc_relative_pose(P1, P2);
+  EXPECT_NEAR(T.x.norm(), 0.0, 1e-12);
+  EXPECT_NEAR(Quatd::calc_angle(T.q, Quatd::identity()), 0.0, 1e-7);
+}
+
+TEST(URDFReaderTest, StreamingMatchesDOM)
+{
+  vector<shared_ptr<RigidBodyd> > links1, links2;
+  vector<shared_ptr<Jointd> > joints1, joints2;
+  string name1, name2;
+
+  ASSERT_TRUE(URDFReaderd::read_from_string(URDF, name1, links1, joints1));
+  ASSERT_TRUE(URDFReaderd::read_streaming_from_string(URDF, name2, links2, joints2));
+
+  EXPECT_EQ(name1, name2);
+  ASSERT_EQ(links1.size(), 3);
+  ASSERT_EQ(links1.size(), links2.size());
+  ASSERT_EQ(joints1.size(), 2);
+  ASSERT_EQ(joints1.size(), joints2.size());
+
+  for (unsigned i=0; i< links1.size(); i++)
+  {
+    EXPECT_EQ(links1[i]->body_id, links2[i]->body_id);
+    expect_same_pose(links1[i]->get_pose(), links2[i]->get_pose());
+    SpatialRBInertiad J1 = links1[i]->get_inertia(), J2 = links2[i]->get_inertia();
+    EXPECT_NEAR(J1.m, J2.m, 1e-12);
+    for (unsigned r=0; r< 3; r++)
+      for (unsigned c=0; c< 3; c++)
+        EXPECT_NEAR(J1.J(r,c), J2.J(r,c), 1e-12);
+    expect_same_pose(lock_frame(J1.pose), lock_frame(J2.pose));
+  }
+
+  for (unsigned i=0; i< joints1.size(); i++)
+  {
+    EXPECT_EQ(joints1[i]->joint_id, joints2[i]->joint_id);
+    EXPECT_EQ(joints1[i]->num_dof(), joints2[i]->num_dof());
+    EXPECT_EQ(joints1[i]->get_inboard_link()->body_id, joints2[i]->get_inboard_link()->body_id);
+    EXPECT_EQ(joints1[i]->get_outboard_link()->body_id, joints2[i]->get_outboard_link()->body_id);
+    expect_same_pose(joints1[i]->get_pose(), joints2[i]->get_pose());
+  }
+}
+
+// single precision values are rounded once (not via double) by both readers;
+// the mass lies just above the midpoint between 1 and the next float
+TEST(URDFReaderTest, StreamingMatchesDOMFloat)
+{
+  const char* FURDF =
+    "<robot name=\"single\">"
+    "  <link name=\"l0\">"
+    "    <inertial> <mass value=\"1.0000000596046448\"/>"
+    "      <inertia ixx=\"0.1\" ixy=\"0\" ixz=\"0\" iyy=\"0.2\" iyz=\"0\" izz=\"0.3\"/>"
+    "    </inertial>"
+    "  </link>"
+    "</robot>";
+  vector<shared_ptr<RigidBodyf> > links1, links2;
+  vector<shared_ptr<Jointf> > joints1, joints2;
+  string name1, name2;
+
+  ASSERT_TRUE(URDFReaderf::read_from_string(FURDF, name1, links1, joints1));
+  ASSERT_TRUE(URDFReaderf::read_streaming_from_string(FURDF, name2, links2, joints2));
+  ASSERT_EQ(links1.size(), 1u);
+  ASSERT_EQ(links2.size(), 1u);
+  EXPECT_EQ(links1[0]->get_inertia().m, std::strtof("1.0000000596046448", NULL));
+  EXPECT_EQ(links2[0]->get_inertia().m, links1[0]->get_inertia().m);
+  EXPECT_EQ(links2[0]->get_inertia().J(0,0), links1[0]->get_inertia().J(0,0));
+}
+
+// a joint that refers to an unknown link is skipped by both readers
+TEST(URDFReaderTest, StreamingSkipsJointWithMissingLink)
+{
+  vector<shared_ptr<RigidBodyd> > links1, links2;
+  vector<shared_ptr<Jointd> > joints1, joints2;
+  string name;
+  const char* bad =
+    "<robot name=\"bad\">"
+    "  <link name=\"a\"/>"
+    "  <joint name=\"j\" type=\"revolute\"> <parent link=\"a\"/> <child link=\"b\"/> </joint>"
+    "</robot>";
+
+  ASSERT_TRUE(URDFReaderd::read_from_string(bad, name, links1, joints1));
+  ASSERT_TRUE(URDFReaderd::read_streaming_from_string(bad, name, links2, joints2));
+  EXPECT_EQ(links1.size(), links2.size());
+  EXPECT_EQ(joints1.size(), joints2.size());
+  EXPECT_TRUE(joints2.empty());
+}
+
+// reading several files concurrently gives the same models as reading them
+// one at a time
+TEST(URDFReaderTest, ReadMany)
+{
+  const unsigned NFILES = 6;
+  vector<string> fnames;
+  for (unsigned i=0; i< NFILES; i++)
+  {
+    char fname[64];
+    std::sprintf(fname, "urdf-read-many-%u.urdf", i);
+    std::ofstream out(fname);
+    out << URDF;
+    fnames.push_back(fname);
+  }
+  fnames.push_back("urdf-read-many-missing.urdf");
+
+  vector<string> names;
+  vector<vector<shared_ptr<RigidBodyd> > > links;
+  vector<vector<shared_ptr<Jointd> > > joints;
+  EXPECT_EQ(URDFReaderd::read_many(fnames, names, links, joints, 4), NFILES);
+  ASSERT_EQ(links.size(), fnames.size());
+  ASSERT_EQ(joints.size(), fnames.size());
+  EXPECT_TRUE(links.back().empty());
+
+  for (unsigned i=0; i< NFILES; i++)
+  {
+    vector<shared_ptr<RigidBodyd> > links1;
+    vector<shared_ptr<Jointd> > joints1;
+    string name1;
+    ASSERT_TRUE(URDFReaderd::read(fnames[i], name1, links1, joints1));
+    EXPECT_EQ(names[i], name1);
+    ASSERT_EQ(links[i].size(), links1.size());
+    ASSERT_EQ(joints[i].size(), joints1.size());
+    for (unsigned j=0; j< links1.size(); j++)
+      expect_same_pose(links[i][j]->get_pose(), links1[j]->get_pose());
+    for (unsigned j=0; j< joints1.size(); j++)
+      expect_same_pose(joints[i][j]->get_pose(), joints1[j]->get_pose());
+    std::remove(fnames[i].c_str());
+  }
+}
+
+// a file whose parsing throws is reported as unread, without disturbing
+// the other files (whether it is read by the calling thread or a worker)
+TEST(URDFReaderTest, ReadManyMalformed)
+{
+  const unsigned NFILES = 5, BAD = 2;
+  string bad = URDF;
+  bad.replace(bad.find("0 0 0.5\""), 8, "0 0.5\"");
+
+  vector<string> fnames;
+  for (unsigned i=0; i< NFILES; i++)
+  {
+    char fname[64];
+    std::sprintf(fname, "urdf-read-many-malformed-%u.urdf", i);
+    std::ofstream out(fname);
+    out << ((i == BAD) ? bad : string(URDF));
+    fnames.push_back(fname);
+  }
+
+  // the malformed file throws when read by itself
+  vector<shared_ptr<RigidBodyd> > links1;
+  vector<shared_ptr<Jointd> > joints1;
+  string name1;
+  EXPECT_ANY_THROW(URDFReaderd::read_streaming(fnames[BAD], name1, links1, joints1));
+
+  for (unsigned nthreads=1; nthreads<= 3; nthreads += 2)
+  {
+    vector<string> names;
+    vector<vector<shared_ptr<RigidBodyd> > > links;
+    vector<vector<shared_ptr<Jointd> > > joints;
+    EXPECT_EQ(URDFReaderd::read_many(fnames, names, links, joints, nthreads), NFILES-1);
+    ASSERT_EQ(links.size(), fnames.size());
+    for (unsigned i=0; i< NFILES; i++)
+    {
+      EXPECT_EQ(links[i].empty(), i == BAD);
+      EXPECT_EQ(joints[i].empty(), i == BAD);
+    }
+  }
+
+  for (unsigned i=0; i< NFILES; i++)
+    std::remove(fnames[i].c_str());
+}
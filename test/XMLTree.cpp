@@ -0,0 +1,197 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <Ravelin/NumberParser.h>
+#include <Ravelin/MissizeException.h>
+#include <Ravelin/XMLTree.h>
+#include "gtest/gtest.h"
+
+using namespace Ravelin;
+using std::string;
+using std::vector;
+using boost::shared_ptr;
+
+static const char* XML =
+  "<Robot name=\"r\">"
+  "  <link name=\"a\"/>"
+  "  <joint name=\"j\"/>"
+  "  <LINK name=\"b\" x=\"1\"/>"
+  "  <Link name=\"c\"/>"
+  "</Robot>";
+
+// collects the names of the nodes it is called on
+struct NameCollector
+{
+  NameCollector(vector<string>& names) : names(&names) { }
+  void operator()(shared_ptr<const XMLTree> node) { names->push_back(node->get_attrib("name")->value); }
+  vector<string>* names;
+};
+
+// verifies that the indexed child queries match names case insensitively and 
+// return the children in document order
+TEST(XMLTree, FindChildren)
+{
+  shared_ptr<const XMLTree> root = XMLTree::read_from_string(XML);
+  ASSERT_TRUE(root);
+
+  // the range and for_each_child() queries
+  std::pair<XMLTree::ChildIterator, XMLTree::ChildIterator> range = root->find_children("link");
+  EXPECT_EQ(std::distance(range.first, range.second), 3);
+  vector<string> names;
+  root->for_each_child("lInK", NameCollector(names));
+  ASSERT_EQ(names.size(), 3u);
+  EXPECT_EQ(names[0], "a");
+  EXPECT_EQ(names[1], "b");
+  EXPECT_EQ(names[2], "c");
+
+  // the list-based queries
+  EXPECT_EQ(root->find_child_nodes("Link").size(), 3u);
+  std::list<string> both;
+  both.push_back("JOINT");
+  both.push_back("link");
+  std::list<shared_ptr<const XMLTree> > nodes = root->find_child_nodes(both);
+  ASSERT_EQ(nodes.size(), 4u);
+  EXPECT_EQ((*++nodes.begin())->get_name(), "joint");
+
+  // missing children
+  range = root->find_children("inertial");
+  EXPECT_TRUE(range.first == range.second);
+  EXPECT_FALSE(root->find_child("inertial"));
+  EXPECT_EQ(root->find_child("joint")->get_attrib("name")->value, "j");
+
+  // attributes
+  shared_ptr<const XMLTree> b = *++root->find_children("link").first;
+  ASSERT_TRUE(b->get_attrib("x"));
+  EXPECT_EQ(b->get_attrib("x")->value, "1");
+  EXPECT_FALSE(b->get_attrib("y"));
+}
+
+// verifies that the child index follows nodes that are added or renamed
+TEST(XMLTree, RenameChildren)
+{
+  shared_ptr<XMLTree> root(new XMLTree("robot"));
+  const char* names[] = { "link", "joint", "link" };
+  vector<shared_ptr<XMLTree> > children;
+  for (unsigned i=0; i< 3; i++)
+  {
+    children.push_back(shared_ptr<XMLTree>(new XMLTree(names[i])));
+    root->add_child(children.back());
+  }
+  EXPECT_EQ(root->get_children().size(), 3u);
+  EXPECT_EQ(root->find_child_nodes("link").size(), 2u);
+
+  // renaming the middle child places it between the others in the index 
+  children[1]->set_name("Link");
+  EXPECT_FALSE(root->find_child("joint"));
+  std::list<shared_ptr<const XMLTree> > links = root->find_child_nodes("link");
+  ASSERT_EQ(links.size(), 3u);
+  EXPECT_EQ(*++links.begin(), children[1]);
+
+  // renaming the first child removes it from the index for its old name 
+  children[0]->set_name("inertial");
+  EXPECT_EQ(root->find_child("inertial"), children[0]);
+  EXPECT_EQ(root->find_child("link"), children[1]);
+  EXPECT_EQ(root->find_child_nodes("link").size(), 2u);
+
+  // a node without a parent can be renamed
+  shared_ptr<XMLTree> orphan(new XMLTree("a"));
+  orphan->set_name("b");
+  EXPECT_EQ(orphan->get_name(), "b");
+
+  // the read-only members track the name and the children, also in copies
+  EXPECT_EQ(children[0]->name, "inertial");
+  EXPECT_EQ(&root->children, &root->get_children());
+  EXPECT_EQ(root->children.size(), 3u);
+  XMLTree copy(*root);
+  EXPECT_EQ(&copy.name, &copy.get_name());
+  EXPECT_EQ(copy.children.size(), 3u);
+  EXPECT_EQ(copy.find_child("inertial"), children[0]);
+}
+
+// verifies that real values written by XMLAttrib read back exactly, and that
+// the parser agrees with strtod()/strtof() on random decimal strings 
+TEST(XMLTree, RealRoundTrip)
+{
+  srand(0);
+  for (unsigned i=0; i< 10000; i++)
+  {
+    // random values over a wide range of magnitudes
+    double x = (double) rand() / RAND_MAX * std::pow(10.0, rand() % 40 - 20);
+    if (i % 2 == 0)
+      x = -x;
+    double xd;
+    XMLAttrib("x", x).get_real_value(xd);
+    EXPECT_EQ(x, xd);
+    float y = (float) x, yf;
+    XMLAttrib("y", y).get_real_value(yf);
+    EXPECT_EQ(y, yf);
+
+    // random decimal strings with few digits (the fast path)
+    char buffer[64];
+    std::sprintf(buffer, "%d.%de%d", rand() % 100000, rand() % 1000, rand() % 30 - 15);
+    NumberParser::parse_real(buffer, buffer + std::strlen(buffer), xd);
+    NumberParser::parse_real(buffer, buffer + std::strlen(buffer), yf);
+    EXPECT_EQ(xd, std::strtod(buffer, NULL)) << buffer;
+    EXPECT_EQ(yf, std::strtof(buffer, NULL)) << buffer;
+  }
+
+  // special values
+  double z;
+  XMLAttrib("z", string("-inf")).get_real_value(z);
+  EXPECT_EQ(z, -std::numeric_limits<double>::infinity());
+  XMLAttrib("z", string("1.5x")).get_real_value(z);
+  EXPECT_EQ(z, 1.5);
+  XMLAttrib("z", string("")).get_real_value(z);
+  EXPECT_EQ(z, 0.0);
+}
+
+// verifies that vector and matrix values are parsed with all delimiters
+TEST(XMLTree, ParseVectorsAndMatrices)
+{
+  VectorNd v;
+  XMLAttrib("v", string(" 1, 2.5\t-3e2 ,inf ")).get_vector_value(v);
+  ASSERT_EQ(v.size(), 4u);
+  EXPECT_EQ(v[0], 1.0);
+  EXPECT_EQ(v[1], 2.5);
+  EXPECT_EQ(v[2], -300.0);
+  EXPECT_EQ(v[3], std::numeric_limits<double>::infinity());
+
+  Vector3f w;
+  XMLAttrib("w", string("0.1 0.2 0.3")).get_vector_value(w);
+  EXPECT_EQ(w[0], 0.1f);
+  EXPECT_EQ(w[2], 0.3f);
+  EXPECT_THROW(XMLAttrib("w", string("0.1 0.2")).get_vector_value(w), MissizeException);
+
+  // matrices are written and read back exactly
+  MatrixNd M(2,3), N;
+  for (unsigned i=0; i< M.rows(); i++)
+    for (unsigned j=0; j< M.columns(); j++)
+      M(i,j) = 1.0/(i*M.columns()+j+1.0);
+  XMLAttrib("M", M).get_matrix_value(N);
+  ASSERT_EQ(N.rows(), 2u);
+  ASSERT_EQ(N.columns(), 3u);
+  for (unsigned i=0; i< M.rows(); i++)
+    for (unsigned j=0; j< M.columns(); j++)
+      EXPECT_EQ(M(i,j), N(i,j));
+
+  // empty rows are ignored and rows of different sizes are rejected
+  XMLAttrib("N", string("1 2; ; 3,4;")).get_matrix_value(N);
+  ASSERT_EQ(N.rows(), 2u);
+  EXPECT_EQ(N(1,0), 3.0);
+  EXPECT_EQ(N(1,1), 4.0);
+  Matrix3d J;
+  XMLAttrib("J", string("1 0 0; 0 2 0; 0 0 3")).get_matrix_value(J);
+  EXPECT_EQ(J(2,2), 3.0);
+  EXPECT_THROW(XMLAttrib("J", string("1 0 0; 0 2 0")).get_matrix_value(J), MissizeException);
+
+  Origin3d o;
+  XMLAttrib("o", Origin3d(0.1, -0.2, 1e-30)).get_origin_value(o);
+  EXPECT_EQ(o.x(), 0.1);
+  EXPECT_EQ(o.y(), -0.2);
+  EXPECT_EQ(o.z(), 1e-30);
+}
+